@@ -0,0 +1,228 @@
+#pragma once
+
+// ======= bench_harness =======
+// Tiny benchmark runner: ns/op, heap allocations/op and (Linux, when permitted) cache misses/op.
+// Define BENCH_HARNESS_IMPLEMENTATION in exactly one TU to install the counting operator new/delete (allocation_tracker).
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// ======= ALLOCATION COUNTERS =======
+
+#ifdef BENCH_HARNESS_IMPLEMENTATION
+#define ALLOCATION_TRACKER_IMPLEMENTATION
+#endif
+
+#include "../src/helpers/memory/allocation_tracker.hpp"
+
+// ======= perf_counter =======
+
+/// @brief Hardware cache-miss counter for the calling thread (Linux perf_event_open); inert elsewhere
+class perf_counter
+{
+private:
+    int fd = -1;
+
+public:
+    perf_counter()
+    {
+#ifdef __linux__
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~perf_counter()
+    {
+#ifdef __linux__
+        if (fd >= 0)
+            close(fd);
+#endif
+    }
+
+    perf_counter(const perf_counter &) = delete;
+    perf_counter &operator=(const perf_counter &) = delete;
+
+    /// @brief If the counter could be opened (needs perf_event_paranoid <= 2 or CAP_PERFMON)
+    /// @return bool
+    bool available() const { return fd >= 0; }
+
+    /// @brief Reset and start counting
+    void start()
+    {
+#ifdef __linux__
+        if (fd >= 0)
+        {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    /// @brief Stop counting
+    /// @return uint64_t: Cache misses since start()
+    uint64_t stop()
+    {
+#ifdef __linux__
+        if (fd >= 0)
+        {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+
+            uint64_t value = 0;
+
+            if (read(fd, &value, sizeof(value)) == sizeof(value))
+                return value;
+        }
+#endif
+        return 0;
+    }
+};
+
+// ======= STRUCTS =======
+
+struct bench_report
+{
+    std::string name;
+
+    uint64_t scale;
+    uint64_t iterations;
+
+    double ns_per_op;
+    double allocs_per_op;
+    double bytes_per_op;
+    double cache_misses_per_op; // -1 when perf counters are unavailable
+};
+
+// ======= bench_runner =======
+
+class bench_runner
+{
+private:
+    std::vector<bench_report> reports;
+
+    perf_counter cache_misses;
+
+    std::string filter;
+    double min_time_s;
+
+public:
+    // ======= CONSTRUCTOR =======
+
+    /// @brief Constructor for bench_runner
+    /// @param name_filter: Only run benchmarks whose name contains this (default: all)
+    /// @param min_time: Minimum measured time per case in seconds (default: 0.2)
+    explicit bench_runner(std::string name_filter = "", double min_time = 0.2)
+        : filter(std::move(name_filter)), min_time_s(min_time) {}
+
+    // ======= MAIN API =======
+
+    /// @brief If a benchmark passes the name filter
+    /// @param name
+    /// @return bool
+    bool enabled(const std::string &name) const
+    {
+        return filter.empty() || name.find(filter) != std::string::npos;
+    }
+
+    /// @brief Measure body; setup runs before every iteration and is not measured
+    /// @param name: Benchmark name
+    /// @param scale: Problem size (objects / entities / segments)
+    /// @param ops: Operations done by one body() call
+    /// @param setup: void()
+    /// @param body: void()
+    void run(const std::string &name, uint64_t scale, uint64_t ops,
+             const std::function<void()> &setup, const std::function<void()> &body)
+    {
+        if (!enabled(name))
+            return;
+
+        uint64_t iterations = 0;
+        uint64_t allocations = 0;
+        uint64_t bytes = 0;
+        uint64_t misses = 0;
+
+        std::chrono::nanoseconds elapsed{0};
+
+        while (iterations == 0 || (elapsed.count() < min_time_s * 1e9 && iterations < 1000))
+        {
+            setup();
+
+            uint64_t alloc_before = allocation_tracker::total_allocations().load(std::memory_order_relaxed);
+            uint64_t bytes_before = allocation_tracker::total_bytes().load(std::memory_order_relaxed);
+
+            cache_misses.start();
+            auto start = std::chrono::steady_clock::now();
+
+            body();
+
+            auto end = std::chrono::steady_clock::now();
+            misses += cache_misses.stop();
+
+            allocations += allocation_tracker::total_allocations().load(std::memory_order_relaxed) - alloc_before;
+            bytes += allocation_tracker::total_bytes().load(std::memory_order_relaxed) - bytes_before;
+
+            elapsed += end - start;
+            ++iterations;
+        }
+
+        double total_ops = static_cast<double>(iterations) * (ops ? ops : 1);
+
+        bench_report report{name, scale, iterations,
+                            elapsed.count() / total_ops,
+                            allocations / total_ops,
+                            bytes / total_ops,
+                            cache_misses.available() ? misses / total_ops : -1.0};
+
+        std::cerr << name << " [" << scale << "]: " << report.ns_per_op << " ns/op, "
+                  << report.allocs_per_op << " allocs/op" << std::endl;
+
+        reports.push_back(report);
+    }
+
+    // ======= OUTPUT =======
+
+    /// @brief Write every report as JSON
+    /// @param out
+    void write_json(std::ostream &out) const
+    {
+        out << "{\n  \"cache_misses_available\": " << (cache_misses.available() ? "true" : "false")
+            << ",\n  \"results\": [\n";
+
+        for (size_t i = 0; i < reports.size(); ++i)
+        {
+            const bench_report &r = reports[i];
+
+            out << "    {\"name\": \"" << r.name << "\", \"scale\": " << r.scale
+                << ", \"iterations\": " << r.iterations
+                << ", \"ns_per_op\": " << r.ns_per_op
+                << ", \"allocs_per_op\": " << r.allocs_per_op
+                << ", \"bytes_per_op\": " << r.bytes_per_op
+                << ", \"cache_misses_per_op\": " << r.cache_misses_per_op << "}"
+                << (i + 1 < reports.size() ? "," : "") << "\n";
+        }
+
+        out << "  ]\n}\n";
+    }
+};
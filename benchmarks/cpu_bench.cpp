@@ -0,0 +1,796 @@
+#define BENCH_HARNESS_IMPLEMENTATION
+
+#include "./bench_harness.hpp"
+
+#include "../src/rendering/objects/management/object_manager.hpp"
+#include "../src/rendering/objects/creation/object_lib.hpp"
+
+#include "../src/helpers/logic/logic_presets.hpp"
+#include "../src/helpers/logic/preset_tables.hpp"
+#include "../src/helpers/architecture/ecs_class.hpp"
+#include "../src/helpers/architecture/archetype_ecs.hpp"
+#include "../src/helpers/architecture/sparse_set.hpp"
+#include "../src/helpers/architecture/system_scheduler.hpp"
+
+#include "../src/physics/force_generators.hpp"
+#include "../src/physics/contact_solver.hpp"
+
+#include "../src/particles/particle_system.hpp"
+
+#include "../src/rendering/views/view_culler.hpp"
+#include "../src/rendering/views/occlusion_culler.hpp"
+
+#include "../src/rendering/software/software_rasterizer.hpp"
+
+#include "../src/rendering/lighting/light_clusters.hpp"
+#include "../src/rendering/lighting/shadow_cascades.hpp"
+
+#include "../src/rendering/objects/batching/static_batches.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <memory>
+
+#ifndef ENGINE_SHADER_DIR
+#define ENGINE_SHADER_DIR "src/rendering/graphics/shaders/glsl_files"
+#endif
+
+// ======= STRUCTS =======
+
+struct bench_position : IComponent
+{
+    float x = 0.0f, y = 0.0f, z = 0.0f;
+};
+
+struct bench_velocity : IComponent
+{
+    float x = 1.0f, y = 0.0f, z = 0.0f;
+};
+
+struct plain_position
+{
+    float x, y, z;
+};
+
+struct plain_velocity
+{
+    float x, y, z;
+};
+
+// ======= HELPERS =======
+
+/// @brief Fill a manager with count cubes laid out on a line
+/// @param manager
+/// @param shader
+/// @param count
+static void fill_objects(object_manager &manager, shader_class &shader, uint64_t count)
+{
+    static const auto cube = object_lib::cube();
+
+    for (uint64_t i = 0; i < count; ++i)
+        manager.spawn_object(shader, cube, {1, 1, 1}, {static_cast<float>(i), 0, 0}, {0, 0, 0});
+}
+
+// ======= MAIN =======
+
+/// @brief cpu_bench [--filter substring] [--max-scale N] [--min-time seconds] [--out file.json]
+int main(int argc, char **argv)
+{
+    std::string filter;
+    std::string out;
+    uint64_t max_scale = 1000000;
+    double min_time = 0.2;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!std::strcmp(argv[i], "--filter") && i + 1 < argc)
+            filter = argv[++i];
+        else if (!std::strcmp(argv[i], "--max-scale") && i + 1 < argc)
+            max_scale = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--min-time") && i + 1 < argc)
+            min_time = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--out") && i + 1 < argc)
+            out = argv[++i];
+        else
+        {
+            std::cerr << "usage: cpu_bench [--filter substring] [--max-scale N] [--min-time seconds] [--out file.json]" << std::endl;
+            return 1;
+        }
+    }
+
+    shader_class shader(ENGINE_SHADER_DIR "/vertex_shader.glsl", ENGINE_SHADER_DIR "/fragment_shader.glsl");
+
+    bench_runner runner(filter, min_time);
+
+    std::vector<uint64_t> scales;
+
+    for (uint64_t scale = 100; scale <= max_scale; scale *= 10)
+        scales.push_back(scale);
+
+    for (uint64_t scale : scales)
+    {
+        // ======= object_interface::updateModelMatrix (through move_add) =======
+
+        if (runner.enabled("object_interface::updateModelMatrix"))
+        {
+            auto manager = std::make_unique<object_manager>();
+            fill_objects(*manager, shader, scale);
+
+            runner.run("object_interface::updateModelMatrix", scale, scale, [] {}, [&]
+                       {
+                           for (auto &obj : manager->get_objects())
+                               obj.move_add(0.001f, 0.0f, 0.0f);
+                       });
+        }
+
+        // ======= object_manager::spawn_object =======
+
+        {
+            std::unique_ptr<object_manager> manager;
+            const auto cube = object_lib::cube();
+
+            runner.run("object_manager::spawn_object", scale, scale, [&]
+                       { manager = std::make_unique<object_manager>(); },
+                       [&]
+                       {
+                           for (uint64_t i = 0; i < scale; ++i)
+                               manager->spawn_object(shader, cube, {1, 1, 1}, {0, 0, 0}, {0, 0, 0});
+                       });
+        }
+
+        // ======= object_manager::delete_object (from the back, O(1) each) =======
+
+        {
+            std::unique_ptr<object_manager> manager;
+
+            runner.run("object_manager::delete_object/back", scale, scale, [&]
+                       {
+                           if (!runner.enabled("object_manager::delete_object/back"))
+                               return;
+
+                           manager = std::make_unique<object_manager>();
+                           fill_objects(*manager, shader, scale);
+                       },
+                       [&]
+                       {
+                           for (uint64_t i = scale; i > 0; --i)
+                               manager->delete_object(i - 1);
+                       });
+        }
+
+        // ======= object_manager::delete_object (from the front, shifts every object) =======
+
+        if (scale <= 10000)
+        {
+            std::unique_ptr<object_manager> manager;
+
+            runner.run("object_manager::delete_object/front", scale, scale, [&]
+                       {
+                           if (!runner.enabled("object_manager::delete_object/front"))
+                               return;
+
+                           manager = std::make_unique<object_manager>();
+                           fill_objects(*manager, shader, scale);
+                       },
+                       [&]
+                       {
+                           for (uint64_t i = 0; i < scale; ++i)
+                               manager->delete_object(0);
+                       });
+        }
+
+        // ======= ecs_class::run_all =======
+
+        if (runner.enabled("ecs_class::run_all"))
+        {
+            ecs_class::ecs_storage.clear();
+            ecs_class::allocator.clear();
+            ecs_class::ecs_storage.reserve(scale);
+
+            for (uint64_t i = 0; i < scale; ++i)
+            {
+                ECS_Instance &entity = ecs_class::get_entity(ecs_class::create_entity());
+
+                entity.add_component<bench_position>();
+                entity.create_system("move", [](ECS_Instance &self)
+                                     { self.get_component<bench_position>()->x += 1.0f; });
+            }
+
+            runner.run("ecs_class::run_all", scale, scale, [] {}, []
+                       { ecs_class::run_all(); });
+
+            ecs_class::ecs_storage.clear();
+        }
+
+        // ======= two-component iteration: ecs_class::run_all vs archetype_world::each =======
+
+        if (runner.enabled("ecs_iterate2/ecs_class::run_all"))
+        {
+            ecs_class::ecs_storage.clear();
+            ecs_class::allocator.clear();
+            ecs_class::ecs_storage.reserve(scale);
+
+            for (uint64_t i = 0; i < scale; ++i)
+            {
+                ECS_Instance &entity = ecs_class::get_entity(ecs_class::create_entity());
+
+                entity.add_component<bench_position>();
+                entity.add_component<bench_velocity>();
+                entity.create_system("integrate", [](ECS_Instance &self)
+                                     {
+                                         bench_position *p = self.get_component<bench_position>();
+                                         bench_velocity *v = self.get_component<bench_velocity>();
+
+                                         p->x += v->x;
+                                         p->y += v->y;
+                                         p->z += v->z;
+                                     });
+            }
+
+            runner.run("ecs_iterate2/ecs_class::run_all", scale, scale, [] {}, []
+                       { ecs_class::run_all(); });
+
+            ecs_class::ecs_storage.clear();
+        }
+
+        if (runner.enabled("ecs_iterate2/archetype_world::each"))
+        {
+            archetype_world world;
+
+            for (uint64_t i = 0; i < scale; ++i)
+                world.create_entity_with(plain_position{0, 0, 0}, plain_velocity{1, 0, 0});
+
+            runner.run("ecs_iterate2/archetype_world::each", scale, scale, [] {}, [&]
+                       {
+                           world.each<plain_position, const plain_velocity>([](plain_position &p, const plain_velocity &v)
+                                                                            {
+                                                                                p.x += v.x;
+                                                                                p.y += v.y;
+                                                                                p.z += v.z;
+                                                                            });
+                       });
+        }
+
+        if (runner.enabled("ecs_iterate2/sparse_registry::view"))
+        {
+            sparse_registry registry;
+
+            for (uint64_t i = 0; i < scale; ++i)
+            {
+                entity e = registry.create();
+
+                registry.emplace<plain_position>(e, 0.0f, 0.0f, 0.0f);
+                registry.emplace<plain_velocity>(e, 1.0f, 0.0f, 0.0f);
+            }
+
+            runner.run("ecs_iterate2/sparse_registry::view", scale, scale, [] {}, [&]
+                       {
+                           registry.view<plain_position, plain_velocity>().each([](plain_position &p, plain_velocity &v)
+                                                                               {
+                                                                                   p.x += v.x;
+                                                                                   p.y += v.y;
+                                                                                   p.z += v.z;
+                                                                               });
+                       });
+        }
+
+        if (runner.enabled("ecs_iterate2/system_scheduler::par_each"))
+        {
+            archetype_world world;
+            system_scheduler scheduler;
+
+            for (uint64_t i = 0; i < scale; ++i)
+                world.create_entity_with(plain_position{0, 0, 0}, plain_velocity{1, 0, 0});
+
+            scheduler.add_system<reads<plain_velocity>, writes<plain_position>>("integrate", [](system_context &context)
+                                                                                {
+                                                                                    context.par_each<plain_position, const plain_velocity>([](plain_position &p, const plain_velocity &v)
+                                                                                                                                           {
+                                                                                                                                               p.x += v.x;
+                                                                                                                                               p.y += v.y;
+                                                                                                                                               p.z += v.z;
+                                                                                                                                           });
+                                                                                });
+
+            runner.run("ecs_iterate2/system_scheduler::par_each", scale, scale, [] {}, [&]
+                       { scheduler.run(world); });
+        }
+
+        // ======= change detection: 1% of entities written per frame, consumer skips untouched chunks =======
+
+        if (runner.enabled("ecs_changed/each_filtered"))
+        {
+            archetype_world world;
+            std::vector<entity> handles;
+
+            handles.reserve(scale);
+
+            for (uint64_t i = 0; i < scale; ++i)
+                handles.push_back(world.create_entity_with(plain_position{0, 0, 0}, plain_velocity{1, 0, 0}));
+
+            uint64_t cursor = 0;
+            uint32_t since = world.get_tick();
+
+            volatile float sink = 0.0f;
+
+            runner.run("ecs_changed/each_filtered", scale, scale, [] {}, [&]
+                       {
+                           world.advance_tick();
+
+                           for (uint64_t i = 0; i < (scale + 99) / 100; ++i)
+                               world.get_component<plain_position>(handles[(cursor += 7919) % scale])->x += 1.0f;
+
+                           float sum = 0.0f;
+
+                           world.each_filtered<changed<plain_position>, const plain_position>(since, [&sum](const plain_position &p)
+                                                                                             { sum += p.x; });
+
+                           since = world.get_tick();
+                           sink = sum;
+                       });
+        }
+
+        // ======= logic_presets::gravity =======
+
+        if (runner.enabled("logic_presets::gravity"))
+        {
+            auto manager = std::make_unique<object_manager>();
+            fill_objects(*manager, shader, scale);
+
+            runner.run("logic_presets::gravity", scale, scale, [] {}, [&]
+                       {
+                           for (auto &obj : manager->get_objects())
+                               obj.apply_preset(logic_presets::gravity(1.0f, 1.0f / 60.0f));
+                       });
+        }
+
+        // ======= preset_tables::run (gravity registered once, same work as logic_presets::gravity) =======
+
+        if (runner.enabled("preset_tables::run/gravity"))
+        {
+            auto manager = std::make_unique<object_manager>();
+            fill_objects(*manager, shader, scale);
+
+            preset_tables presets;
+
+            for (uint64_t i = 0; i < scale; ++i)
+                presets.add_gravity(i, 1.0f);
+
+            runner.run("preset_tables::run/gravity", scale, scale, [] {}, [&]
+                       { presets.run(manager->get_objects(), 1.0f / 60.0f); });
+        }
+
+        // ======= preset_tables::run (orbit + spin + follow path, one table loop each) =======
+
+        if (runner.enabled("preset_tables::run/mixed"))
+        {
+            auto manager = std::make_unique<object_manager>();
+            fill_objects(*manager, shader, scale);
+
+            preset_tables presets;
+            uint32_t path = presets.add_path({{0, 0, 0}, {10, 0, 0}, {10, 0, 10}, {0, 0, 10}}, true);
+
+            for (uint64_t i = 0; i < scale; ++i)
+            {
+                if (i % 3 == 0)
+                    presets.add_orbit(i, {0, 0, 0}, 5.0f, 1.0f);
+                else if (i % 3 == 1)
+                    presets.add_spin(i, {0, 90, 0});
+                else
+                    presets.add_follow_path(i, path, 2.0f);
+            }
+
+            runner.run("preset_tables::run/mixed", scale, scale, [] {}, [&]
+                       { presets.run(manager->get_objects(), 1.0f / 60.0f); });
+        }
+
+        // ======= view_culler::cull (objects scattered in a cube, main camera + 3 extra views in one pass) =======
+
+        if (runner.enabled("view_culler::cull"))
+        {
+            auto manager = std::make_unique<object_manager>();
+            static const auto cube = object_lib::cube();
+
+            uint32_t seed = 1;
+
+            auto random = [&seed]
+            {
+                seed = seed * 1664525u + 1013904223u;
+                return (seed >> 8) * (200.0f / 16777216.0f) - 100.0f;
+            };
+
+            for (uint64_t i = 0; i < scale; ++i)
+                manager->spawn_object(shader, cube, {1, 1, 1}, {random(), random(), random()}, {0, 0, 0});
+
+            view_set views;
+            glm::mat4 projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+
+            for (int v = 0; v < 4; ++v)
+            {
+                render_view view;
+                view.view = glm::lookAt(glm::vec3(v * 10.0f, 0, 0), glm::vec3(v * 10.0f, 0, -1), glm::vec3(0, 1, 0));
+                view.projection = projection;
+
+                if (v == 0)
+                    views.get(view_set::main_view) = view;
+                else
+                    views.add(view);
+            }
+
+            view_culler culler;
+
+            runner.run("view_culler::cull", scale, scale, [] {}, [&]
+                       { culler.cull(manager->get_objects(), views.data(), views.active_mask()); });
+        }
+
+        // ======= occlusion_culler::cull (a wall in front of the camera plus 32 box occluders over the same cube of objects) =======
+
+        if (runner.enabled("occlusion_culler::cull"))
+        {
+            auto manager = std::make_unique<object_manager>();
+            static const auto cube = object_lib::cube();
+
+            uint32_t seed = 1;
+
+            auto random = [&seed]
+            {
+                seed = seed * 1664525u + 1013904223u;
+                return (seed >> 8) * (200.0f / 16777216.0f) - 100.0f;
+            };
+
+            occlusion_culler occlusion;
+
+            occlusion.add_occluder(manager->spawn_object(shader, cube, {16, 8, 1}, {0, 0, -20}, {0, 0, 0}), occluder_mesh::box());
+
+            for (int i = 0; i < 32; ++i)
+                occlusion.add_occluder(manager->spawn_object(shader, cube, {4, 4, 4}, {random() * 0.3f, random() * 0.1f, -std::abs(random()) * 0.5f - 5.0f}, {0, 0, 0}),
+                                       occluder_mesh::box());
+
+            for (uint64_t i = 0; i < scale; ++i)
+                manager->spawn_object(shader, cube, {1, 1, 1}, {random(), random(), random()}, {0, 0, 0});
+
+            view_set views;
+            render_view &main = views.get(view_set::main_view);
+            main.view = glm::lookAt(glm::vec3(0, 0, 0), glm::vec3(0, 0, -1), glm::vec3(0, 1, 0));
+            main.projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+
+            view_culler culler;
+
+            runner.run("occlusion_culler::cull", scale, scale, [&]
+                       { culler.cull(manager->get_objects(), views.data(), views.active_mask()); }, [&]
+                       { occlusion.cull(manager->get_objects(), main.projection * main.view, culler, view_set::main_view); });
+        }
+
+        // ======= software_rasterizer::draw (scale = cubes scattered in front of the camera, one 1280x720 frame) =======
+
+        if (runner.enabled("software_rasterizer::draw"))
+        {
+            software_assets::get().set_capture(true);
+
+            auto manager = std::make_unique<object_manager>();
+            static const auto cube = object_lib::cube();
+
+            uint32_t seed = 1;
+
+            auto random = [&seed]
+            {
+                seed = seed * 1664525u + 1013904223u;
+                return (seed >> 8) * (1.0f / 16777216.0f);
+            };
+
+            for (uint64_t i = 0; i < scale; ++i)
+                manager->spawn_object(shader, cube, {1, 1, 1}, {random() * 60.0f - 30.0f, random() * 34.0f - 17.0f, -random() * 60.0f - 10.0f}, {0, 0, 0});
+
+            software_assets::get().set_capture(false);
+
+            glm::mat4 view_projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f) *
+                                        glm::lookAt(glm::vec3(0, 0, 0), glm::vec3(0, 0, -1), glm::vec3(0, 1, 0));
+
+            const int viewport[4] = {0, 0, 1280, 720};
+
+            software_framebuffer target;
+            target.resize(viewport[2], viewport[3]);
+
+            software_rasterizer raster;
+
+            runner.run("software_rasterizer::draw", scale, scale, [&]
+                       {
+                           target.clear();
+
+                           for (const object_interface &obj : manager->get_objects())
+                               raster.submit(obj.get_model_matrix(), obj.get_mesh().VAO, obj.get_mesh().vertexCount, obj.get_texture_id(), obj.has_texture());
+                       }, [&]
+                       { raster.draw(target, view_projection, viewport); });
+
+            software_assets::get().clear();
+        }
+
+        // ======= light_clusters::build (scale = point lights scattered in front of the camera) =======
+
+        if (runner.enabled("light_clusters::build"))
+        {
+            uint32_t seed = 1;
+
+            auto random = [&seed]
+            {
+                seed = seed * 1664525u + 1013904223u;
+                return (seed >> 8) * (1.0f / 16777216.0f);
+            };
+
+            point_lights lights;
+
+            for (uint64_t i = 0; i < scale; ++i)
+                lights.add_light({random() * 120.0f - 60.0f, random() * 40.0f - 20.0f, -random() * 100.0f}, 0.5f + random() * 3.5f);
+
+            glm::mat4 view = glm::lookAt(glm::vec3(0, 0, 0), glm::vec3(0, 0, -1), glm::vec3(0, 1, 0));
+            glm::mat4 projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+
+            light_clusters clusters;
+
+            runner.run("light_clusters::build", scale, scale, [] {}, [&]
+                       { clusters.build(lights, view, projection); });
+        }
+
+        // ======= shadow_cascades::update (scale = bounding spheres on a plane, all dynamic or all stationary casters) =======
+
+        if (runner.enabled("shadow_cascades::update") || runner.enabled("shadow_cascades::update_stationary"))
+        {
+            uint32_t seed = 1;
+
+            auto random = [&seed]
+            {
+                seed = seed * 1664525u + 1013904223u;
+                return (seed >> 8) * (1.0f / 16777216.0f);
+            };
+
+            size_t padded = (scale + 7) / 8 * 8;
+            aligned_vector<float> x(padded, 0.0f), y(padded, 0.0f), z(padded, 0.0f), radius(padded, 0.0f);
+
+            for (uint64_t i = 0; i < scale; ++i)
+            {
+                x[i] = random() * 400.0f - 200.0f;
+                y[i] = random() * 4.0f;
+                z[i] = random() * 400.0f - 200.0f;
+                radius[i] = 0.5f + random() * 2.0f;
+            }
+
+            view_cull_spheres spheres{x.data(), y.data(), z.data(), radius.data(), static_cast<size_t>(scale)};
+
+            glm::mat4 view = glm::lookAt(glm::vec3(0, 2, 0), glm::vec3(1, 1.8f, 0), glm::vec3(0, 1, 0));
+            glm::mat4 projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+
+            for (bool stationary : {false, true})
+            {
+                const char *name = stationary ? "shadow_cascades::update_stationary" : "shadow_cascades::update";
+
+                if (!runner.enabled(name))
+                    continue;
+
+                shadow_cascades cascades;
+                cascades.set_light({-0.4f, -1.0f, -0.3f}, glm::vec3(1.0f), true);
+
+                for (uint64_t i = 0; stationary && i < scale; ++i)
+                    cascades.set_caster(i, shadow_caster::stationary, glm::vec4(x[i], y[i], z[i], radius[i]));
+
+                // ======= the first update draws the whole cache; the timed ones are a still camera =======
+
+                cascades.update(view, projection, spheres);
+
+                runner.run(name, scale, scale, [] {}, [&]
+                           { cascades.update(view, projection, spheres); });
+            }
+        }
+
+        // ======= static_batches::build / readd / cull (scale = cubes on a plane, one batch per cell) =======
+
+        if (runner.enabled("static_batches::build") || runner.enabled("static_batches::readd") || runner.enabled("static_batches::cull"))
+        {
+            auto cube = object_lib::cube();
+
+            static_mesh_data mesh;
+            mesh.vertices = std::get<std::vector<float>>(cube.at("vertices"));
+            mesh.colors = std::get<std::vector<float>>(cube.at("colors"));
+            mesh.texcoords = std::get<std::vector<float>>(cube.at("texture_coords"));
+            mesh.normals = std::get<std::vector<float>>(cube.at("normals"));
+            mesh.vertex_count = std::get<int>(cube.at("count"));
+
+            int side = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(scale))));
+
+            std::vector<glm::mat4> models(scale);
+
+            for (uint64_t i = 0; i < scale; ++i)
+                models[i] = glm::translate(glm::mat4(1.0f), glm::vec3((i % side) * 2.0f - side, 0.0f, (i / side) * 2.0f - side));
+
+            static_batches batches;
+
+            runner.run("static_batches::build", scale, scale, [&]
+                       { batches.clear(); }, [&]
+                       {
+                           for (uint64_t i = 0; i < scale; ++i)
+                               batches.add(i, mesh, models[i], 0); });
+
+            if (batches.object_count() != scale)
+                for (uint64_t i = 0; i < scale; ++i)
+                    batches.add(i, mesh, models[i], 0);
+
+            // ======= one object leaves its batch and comes back: only its cell is touched =======
+
+            uint64_t next = 0;
+
+            runner.run("static_batches::readd", scale, 64, [] {}, [&]
+                       {
+                           for (int i = 0; i < 64; ++i)
+                           {
+                               uint64_t id = (next++ * 7919) % scale;
+
+                               batches.remove(id);
+                               batches.add(id, mesh, models[id], 0);
+                           }
+
+                           batches.clear_dirty(); });
+
+            render_view view;
+            view.view = glm::lookAt(glm::vec3(0, 2, 0), glm::vec3(1, 1.8f, 0), glm::vec3(0, 1, 0));
+            view.projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+
+            runner.run("static_batches::cull", scale, scale, [] {}, [&]
+                       { batches.cull(&view, 1u); });
+        }
+
+        // ======= particle_system::update / pack (scale = live particles, 4 emitters, steady state) =======
+
+        if (runner.enabled("particle_system::update") || runner.enabled("particle_system::pack"))
+        {
+            const float dt = 1.0f / 60.0f;
+
+            particle_system particles;
+
+            emitter_params params;
+            params.spawn_extent = {5.0f, 0.0f, 5.0f};
+            params.drag = 0.1f;
+
+            // ======= spawn rate matches the death rate, so the live count stays near scale =======
+
+            params.max_particles = scale / 4 + 1;
+            params.rate = (scale / 4) / 1.5f;
+
+            for (int i = 0; i < 4; ++i)
+                particles.add_emitter(params);
+
+            for (int frame = 0; frame < 120; ++frame)
+                particles.update(dt);
+
+            runner.run("particle_system::update", scale, particles.size(), [] {}, [&]
+                       { particles.update(dt); });
+
+            particle_frame frame;
+            particles.pack(frame);
+
+            runner.run("particle_system::pack", scale, particles.size(), [] {}, [&]
+                       { particles.pack(frame); });
+        }
+
+        // ======= physics_world::step (gravity + drag, one SIMD pass) =======
+
+        if (runner.enabled("physics_world::step"))
+        {
+            physics_world physics;
+
+            physics.add_force_generator<gravity_force>();
+            physics.add_force_generator<drag_force>(0.1f);
+
+            for (uint64_t i = 0; i < scale; ++i)
+                physics.add_body({static_cast<float>(i), 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, 1.0f + (i % 4));
+
+            runner.run("physics_world::step", scale, scale, [] {}, [&]
+                       { physics.step(1.0f / 60.0f); });
+        }
+    }
+
+    // ======= broadphase::update (moving bodies in a cube sized for ~1 neighbour each) =======
+
+    for (uint64_t bodies : {10000, 50000, 100000, 500000})
+    {
+        if (bodies > max_scale || !runner.enabled("broadphase::update"))
+            continue;
+
+        physics_world physics;
+        broadphase collisions;
+
+        float side = std::cbrt(static_cast<float>(bodies)) * 2.0f;
+        uint32_t seed = 12345;
+
+        auto random = [&seed]
+        {
+            seed = seed * 1664525u + 1013904223u;
+            return (seed >> 8) * (1.0f / 16777216.0f);
+        };
+
+        for (uint64_t i = 0; i < bodies; ++i)
+            physics.add_body({random() * side, random() * side, random() * side}, {random() - 0.5f, random() - 0.5f, random() - 0.5f});
+
+        collisions.update(physics);
+
+        runner.run("broadphase::update", bodies, bodies, [&]
+                   { physics.step(1.0f / 60.0f); },
+                   [&]
+                   { collisions.update(physics); });
+
+        std::cerr << "broadphase::update [" << bodies << "]: " << collisions.get_stats().pairs << " pairs, cell " << collisions.get_stats().cell_size << std::endl;
+    }
+
+    // ======= contact_solver::solve (columns of cubes resting on a floor; awake = sleeping disabled, settled = all asleep) =======
+
+    for (uint64_t cubes : {10000, 50000})
+    {
+        if (cubes > max_scale)
+            continue;
+
+        for (bool settled : {false, true})
+        {
+            const char *name = settled ? "contact_solver::settled_step" : "contact_solver::resting_step";
+
+            if (!runner.enabled(name))
+                continue;
+
+            physics_world physics;
+            broadphase collisions;
+            contact_solver contacts;
+
+            physics.add_force_generator<gravity_force>();
+            contacts.set_sleeping(settled);
+
+            int columns = static_cast<int>(std::sqrt(static_cast<float>(cubes) / 10.0f));
+
+            physics.add_body({columns * 0.55f, -1.0f, columns * 0.55f}, glm::vec3(0.0f), 0.0f, SIZE_MAX, {columns * 0.6f + 1.0f, 1.0f, columns * 0.6f + 1.0f});
+
+            for (int y = 0; y < 10; ++y)
+            {
+                for (int x = 0; x < columns; ++x)
+                {
+                    for (int z = 0; z < columns; ++z)
+                        physics.add_body({x * 1.1f, 0.5f + y * 1.01f, z * 1.1f});
+                }
+            }
+
+            auto step = [&]
+            {
+                physics.integrate_velocities(1.0f / 60.0f);
+                collisions.update(physics);
+                contacts.solve(physics, collisions, 1.0f / 60.0f);
+                physics.integrate_positions(1.0f / 60.0f);
+            };
+
+            for (int frame = 0; frame < 120; ++frame)
+                step();
+
+            runner.run(name, cubes, physics.size(), [] {}, step);
+
+            std::cerr << name << " [" << cubes << "]: " << contacts.get_stats().manifolds << " manifolds, " << contacts.get_stats().awake_bodies << " awake, " << contacts.get_stats().islands << " sleeping islands" << std::endl;
+        }
+    }
+
+    // ======= object_lib::sphere (scale = segments) =======
+
+    for (uint64_t segments : {8, 16, 32, 64, 128})
+    {
+        runner.run("object_lib::sphere", segments, 1, [] {}, [segments]
+                   {
+                       auto sphere = object_lib::sphere(static_cast<int>(segments), static_cast<int>(segments));
+                       (void)sphere;
+                   });
+    }
+
+    if (out.empty())
+    {
+        runner.write_json(std::cout);
+    }
+    else
+    {
+        std::ofstream file(out);
+        runner.write_json(file);
+    }
+
+    return 0;
+}
@@ -0,0 +1,286 @@
+#include "../src/engine/game_engine.hpp"
+
+#include "../src/helpers/logic/logic_presets.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+
+// ======= STRUCTS =======
+
+struct bench_scene
+{
+    std::string name;
+    std::string shape;
+
+    int count;
+
+    bool textured;
+    bool gravity;
+
+    int lights = 0; // point lights scattered through the grid
+
+    bool sun = false;        // directional light with cascaded shadow maps
+    bool stationary = false; // every object is a stationary shadow caster
+
+    bool batched = false; // every object is merged into the static batches
+};
+
+struct bench_result
+{
+    std::string scene;
+
+    int frames;
+
+    double mean_ms;
+    double p50_ms;
+    double p95_ms;
+    double p99_ms;
+    double max_ms;
+};
+
+// ======= HELPERS =======
+
+/// @brief Percentile of a sorted list
+/// @param sorted
+/// @param p: [0, 1]
+/// @return double
+static double percentile(const std::vector<float> &sorted, double p)
+{
+    if (sorted.empty())
+        return 0.0;
+
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+    return sorted[index];
+}
+
+/// @brief Deterministic checkerboard texture
+/// @return std::vector<unsigned char>: 64x64 RGB
+static std::vector<unsigned char> checkerboard()
+{
+    std::vector<unsigned char> pixels(64 * 64 * 3);
+
+    for (int y = 0; y < 64; ++y)
+        for (int x = 0; x < 64; ++x)
+        {
+            unsigned char v = ((x / 8 + y / 8) % 2) ? 255 : 40;
+            unsigned char *p = &pixels[(y * 64 + x) * 3];
+            p[0] = v;
+            p[1] = v;
+            p[2] = v;
+        }
+
+    return pixels;
+}
+
+/// @brief Build the scene list
+/// @return std::vector<bench_scene>
+static std::vector<bench_scene> default_scenes()
+{
+    std::vector<bench_scene> scenes;
+
+    for (const char *shape : {"cube", "sphere"})
+        for (int count : {100, 1000, 5000})
+            for (bool textured : {false, true})
+                for (bool gravity : {false, true})
+                {
+                    std::string name = std::string(shape) + "_" + std::to_string(count) +
+                                       (textured ? "_tex" : "") + (gravity ? "_grav" : "");
+
+                    scenes.push_back({name, shape, count, textured, gravity});
+                }
+
+    for (int lights : {1000, 10000})
+        scenes.push_back({"cube_5000_lights_" + std::to_string(lights), "cube", 5000, false, false, lights});
+
+    scenes.push_back({"cube_5000_sun", "cube", 5000, false, false, 0, true, false});
+    scenes.push_back({"cube_5000_sun_stationary", "cube", 5000, false, false, 0, true, true});
+
+    scenes.push_back({"cube_5000_static", "cube", 5000, false, false, 0, false, false, true});
+
+    return scenes;
+}
+
+/// @brief Run one scene
+/// @param engine
+/// @param scene
+/// @param frames
+/// @param warmup
+/// @param replay: Recording that drives the measured frames instead of a static camera (empty: none)
+/// @return bench_result
+static bench_result run_scene(game_engine &engine, const bench_scene &scene, int frames, int warmup, const std::string &replay)
+{
+    static const std::vector<unsigned char> texture = checkerboard();
+
+    engine.clear_world();
+
+    auto shape = scene.shape == "sphere" ? object_lib::sphere() : object_lib::cube();
+
+    // ======= fixed grid layout so every run draws the exact same scene =======
+
+    int side = static_cast<int>(std::ceil(std::cbrt(static_cast<double>(scene.count))));
+    float spacing = 1.5f;
+    float half = side * spacing * 0.5f;
+
+    std::vector<size_t> ids;
+
+    for (int i = 0; i < scene.count; ++i)
+    {
+        int x = i % side;
+        int y = (i / side) % side;
+        int z = i / (side * side);
+
+        size_t id = engine.create_new_object(shape, {1, 1, 1},
+                                             {x * spacing - half, y * spacing - half, -z * spacing - 5.0f});
+
+        if (scene.textured)
+            engine.get_object(id).apply_texture_pixels(texture.data(), 64, 64, 3);
+
+        if (scene.stationary)
+            engine.set_shadow_caster(id, shadow_caster::stationary);
+
+        ids.push_back(id);
+    }
+
+    if (scene.batched)
+        engine.set_static(ids);
+
+    if (scene.sun)
+        engine.set_directional_light({-0.4f, -1.0f, -0.3f});
+    else
+        engine.remove_directional_light();
+
+    // ======= lights scattered through the same volume =======
+
+    uint32_t seed = 1;
+
+    auto random = [&seed]
+    {
+        seed = seed * 1664525u + 1013904223u;
+        return (seed >> 8) * (1.0f / 16777216.0f);
+    };
+
+    for (int i = 0; i < scene.lights; ++i)
+        engine.lights.add_light({random() * 2.0f * half - half, random() * 2.0f * half - half, -random() * 2.0f * half - 5.0f},
+                                1.0f + random() * 3.0f, {random(), random(), random()}, 2.0f);
+
+    std::optional<std::function<void(float)>> logic = std::nullopt;
+
+    if (scene.gravity)
+    {
+        logic = [&engine](float delta_time)
+        {
+            for (auto &obj : engine.world_objects.get_objects())
+                obj.apply_preset(logic_presets::gravity(1.0f, delta_time));
+        };
+    }
+
+    engine.run_frames(warmup, 1.0f / 60.0f, logic);
+
+    std::vector<float> times = replay.empty() ? engine.run_frames(frames, 1.0f / 60.0f, logic)
+                                              : engine.run_replay(replay, 1.0f / 60.0f, logic);
+    std::sort(times.begin(), times.end());
+
+    bench_result result;
+    result.scene = scene.name;
+    result.frames = static_cast<int>(times.size());
+    result.mean_ms = times.empty() ? 0.0 : std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+    result.p50_ms = percentile(times, 0.50);
+    result.p95_ms = percentile(times, 0.95);
+    result.p99_ms = percentile(times, 0.99);
+    result.max_ms = times.empty() ? 0.0 : times.back();
+
+    return result;
+}
+
+// ======= MAIN =======
+
+/// @brief frame_bench [--frames N] [--warmup N] [--scene substring] [--out prefix] [--replay file] [--backend gl|software] [--window]
+int main(int argc, char **argv)
+{
+    int frames = 300;
+    int warmup = 30;
+    std::string filter;
+    std::string out = "frame_bench";
+    std::string replay;
+    bool headless = true;
+    render_backend backend = render_backend::gl;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        auto next = [&](const char *flag) -> const char *
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << flag << " needs a value" << std::endl;
+                std::exit(1);
+            }
+            return argv[++i];
+        };
+
+        if (!std::strcmp(argv[i], "--frames"))
+            frames = std::atoi(next("--frames"));
+        else if (!std::strcmp(argv[i], "--warmup"))
+            warmup = std::atoi(next("--warmup"));
+        else if (!std::strcmp(argv[i], "--scene"))
+            filter = next("--scene");
+        else if (!std::strcmp(argv[i], "--out"))
+            out = next("--out");
+        else if (!std::strcmp(argv[i], "--replay"))
+            replay = next("--replay");
+        else if (!std::strcmp(argv[i], "--backend"))
+            backend = !std::strcmp(next("--backend"), "software") ? render_backend::software : render_backend::gl;
+        else if (!std::strcmp(argv[i], "--window"))
+            headless = false;
+        else
+        {
+            std::cerr << "usage: frame_bench [--frames N] [--warmup N] [--scene substring] [--out prefix] [--replay file] [--backend gl|software] [--window]" << std::endl;
+            return 1;
+        }
+    }
+
+    game_engine engine(1280, 720, "frame_bench", {}, headless, backend);
+
+    const char *renderer = reinterpret_cast<const char *>(glGetString(GL_RENDERER));
+
+    std::vector<bench_result> results;
+
+    for (const bench_scene &scene : default_scenes())
+    {
+        if (!filter.empty() && scene.name.find(filter) == std::string::npos)
+            continue;
+
+        results.push_back(run_scene(engine, scene, frames, warmup, replay));
+
+        const bench_result &r = results.back();
+        std::cout << r.scene << ": mean " << r.mean_ms << " ms, p95 " << r.p95_ms << " ms, p99 " << r.p99_ms << " ms" << std::endl;
+    }
+
+    std::ofstream csv(out + ".csv");
+    csv << "scene,frames,mean_ms,p50_ms,p95_ms,p99_ms,max_ms\n";
+
+    for (const bench_result &r : results)
+        csv << r.scene << "," << r.frames << "," << r.mean_ms << "," << r.p50_ms << ","
+            << r.p95_ms << "," << r.p99_ms << "," << r.max_ms << "\n";
+
+    std::ofstream json(out + ".json");
+    json << "{\n  \"renderer\": \"" << (renderer ? renderer : "unknown") << "\",\n  \"backend\": \""
+         << (backend == render_backend::software ? "software" : "gl") << "\",\n  \"frames\": " << frames
+         << ",\n  \"warmup\": " << warmup << ",\n  \"results\": [\n";
+
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const bench_result &r = results[i];
+
+        json << "    {\"scene\": \"" << r.scene << "\", \"frames\": " << r.frames
+             << ", \"mean_ms\": " << r.mean_ms << ", \"p50_ms\": " << r.p50_ms
+             << ", \"p95_ms\": " << r.p95_ms << ", \"p99_ms\": " << r.p99_ms
+             << ", \"max_ms\": " << r.max_ms << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+
+    json << "  ]\n}\n";
+
+    return 0;
+}
@@ -0,0 +1,242 @@
+#pragma once
+
+// ======= mock_gl_device =======
+// Drop-in replacement for <glad/glad.h> used by the CPU benchmarks: every GL entry point the engine
+// calls is a no-op that only bumps counters, so engine code runs without a context or a GPU.
+
+#include <cstddef>
+#include <cstdint>
+
+// ======= TYPES =======
+
+typedef unsigned int GLenum;
+typedef unsigned char GLboolean;
+typedef unsigned int GLbitfield;
+typedef int GLint;
+typedef unsigned int GLuint;
+typedef int GLsizei;
+typedef float GLfloat;
+typedef double GLdouble;
+typedef char GLchar;
+typedef unsigned char GLubyte;
+typedef std::ptrdiff_t GLsizeiptr;
+typedef std::ptrdiff_t GLintptr;
+typedef uint64_t GLuint64;
+typedef int64_t GLint64;
+
+typedef void *(*GLADloadproc)(const char *name);
+
+// ======= CONSTANTS =======
+
+#define GL_FALSE 0
+#define GL_TRUE 1
+#define GL_TRIANGLES 0x0004
+#define GL_UNSIGNED_BYTE 0x1401
+#define GL_UNSIGNED_INT 0x1405
+#define GL_FLOAT 0x1406
+#define GL_RED 0x1903
+#define GL_RGB 0x1907
+#define GL_RGBA 0x1908
+#define GL_RGBA8 0x8058
+#define GL_DEPTH_TEST 0x0B71
+#define GL_BLEND 0x0BE2
+#define GL_SCISSOR_TEST 0x0C11
+#define GL_SRC_ALPHA 0x0302
+#define GL_ONE_MINUS_SRC_ALPHA 0x0303
+#define GL_DEPTH_BUFFER_BIT 0x00000100
+#define GL_COLOR_BUFFER_BIT 0x00004000
+#define GL_TEXTURE_2D 0x0DE1
+#define GL_TEXTURE0 0x84C0
+#define GL_TEXTURE_BUFFER 0x8C2A
+#define GL_RGBA32F 0x8814
+#define GL_R32UI 0x8236
+#define GL_RG32UI 0x823C
+#define GL_TEXTURE_WRAP_S 0x2802
+#define GL_TEXTURE_WRAP_T 0x2803
+#define GL_TEXTURE_MIN_FILTER 0x2801
+#define GL_TEXTURE_MAG_FILTER 0x2800
+#define GL_REPEAT 0x2901
+#define GL_LINEAR 0x2601
+#define GL_NEAREST 0x2600
+#define GL_CLAMP_TO_EDGE 0x812F
+#define GL_LINEAR_MIPMAP_LINEAR 0x2703
+#define GL_UNPACK_ALIGNMENT 0x0CF5
+#define GL_PACK_ALIGNMENT 0x0D05
+#define GL_ARRAY_BUFFER 0x8892
+#define GL_ELEMENT_ARRAY_BUFFER 0x8893
+#define GL_STATIC_DRAW 0x88E4
+#define GL_DYNAMIC_DRAW 0x88E8
+#define GL_STREAM_DRAW 0x88E0
+#define GL_BUFFER_SIZE 0x8764
+#define GL_VERTEX_ATTRIB_ARRAY_ENABLED 0x8622
+#define GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING 0x889F
+#define GL_VERTEX_SHADER 0x8B31
+#define GL_FRAGMENT_SHADER 0x8B30
+#define GL_COMPILE_STATUS 0x8B81
+#define GL_LINK_STATUS 0x8B82
+#define GL_TIME_ELAPSED 0x88BF
+#define GL_QUERY_RESULT 0x8866
+#define GL_QUERY_RESULT_AVAILABLE 0x8867
+#define GL_FRAMEBUFFER 0x8D40
+#define GL_RENDERBUFFER 0x8D41
+#define GL_COLOR_ATTACHMENT0 0x8CE0
+#define GL_DEPTH_STENCIL_ATTACHMENT 0x821A
+#define GL_DEPTH24_STENCIL8 0x88F0
+#define GL_FRAMEBUFFER_COMPLETE 0x8CD5
+#define GL_READ_FRAMEBUFFER 0x8CA8
+#define GL_DRAW_FRAMEBUFFER 0x8CA9
+#define GL_DEPTH_ATTACHMENT 0x8D00
+#define GL_DEPTH_COMPONENT 0x1902
+#define GL_DEPTH_COMPONENT32F 0x8CAC
+#define GL_TEXTURE_2D_ARRAY 0x8C1A
+#define GL_TEXTURE_COMPARE_MODE 0x884C
+#define GL_TEXTURE_COMPARE_FUNC 0x884D
+#define GL_COMPARE_REF_TO_TEXTURE 0x884E
+#define GL_LEQUAL 0x0203
+#define GL_NONE 0
+#define GL_DEPTH_CLAMP 0x864F
+#define GL_POLYGON_OFFSET_FILL 0x8037
+#define GL_RENDERER 0x1F01
+
+// ======= DEVICE =======
+
+struct mock_gl_device
+{
+    uint64_t objects_created = 0;
+    uint64_t bytes_uploaded = 0;
+    uint64_t uniform_sets = 0;
+    uint64_t draw_calls = 0;
+    uint64_t vertices_submitted = 0;
+    uint64_t state_changes = 0;
+
+    /// @brief Get the global mock device
+    /// @return mock_gl_device&
+    static mock_gl_device &get()
+    {
+        static mock_gl_device device;
+        return device;
+    }
+
+    /// @brief Hand out a fresh object name
+    /// @return GLuint
+    GLuint create() { return static_cast<GLuint>(++objects_created); }
+
+    /// @brief Reset every counter
+    void reset() { *this = mock_gl_device{}; }
+};
+
+inline int gladLoadGLLoader(GLADloadproc) { return 1; }
+
+// ======= OBJECTS =======
+
+inline void glGenVertexArrays(GLsizei n, GLuint *out) { for (GLsizei i = 0; i < n; ++i) out[i] = mock_gl_device::get().create(); }
+inline void glGenBuffers(GLsizei n, GLuint *out) { for (GLsizei i = 0; i < n; ++i) out[i] = mock_gl_device::get().create(); }
+inline void glGenTextures(GLsizei n, GLuint *out) { for (GLsizei i = 0; i < n; ++i) out[i] = mock_gl_device::get().create(); }
+inline void glGenQueries(GLsizei n, GLuint *out) { for (GLsizei i = 0; i < n; ++i) out[i] = mock_gl_device::get().create(); }
+inline void glGenFramebuffers(GLsizei n, GLuint *out) { for (GLsizei i = 0; i < n; ++i) out[i] = mock_gl_device::get().create(); }
+inline void glGenRenderbuffers(GLsizei n, GLuint *out) { for (GLsizei i = 0; i < n; ++i) out[i] = mock_gl_device::get().create(); }
+inline void glDeleteVertexArrays(GLsizei, const GLuint *) {}
+inline void glDeleteBuffers(GLsizei, const GLuint *) {}
+inline void glDeleteTextures(GLsizei, const GLuint *) {}
+inline void glDeleteFramebuffers(GLsizei, const GLuint *) {}
+inline void glDeleteRenderbuffers(GLsizei, const GLuint *) {}
+
+// ======= STATE =======
+
+inline void glBindVertexArray(GLuint) { ++mock_gl_device::get().state_changes; }
+inline void glBindBuffer(GLenum, GLuint) { ++mock_gl_device::get().state_changes; }
+inline void glBindTexture(GLenum, GLuint) { ++mock_gl_device::get().state_changes; }
+inline void glBindFramebuffer(GLenum, GLuint) { ++mock_gl_device::get().state_changes; }
+inline void glBindRenderbuffer(GLenum, GLuint) { ++mock_gl_device::get().state_changes; }
+inline void glActiveTexture(GLenum) { ++mock_gl_device::get().state_changes; }
+inline void glUseProgram(GLuint) { ++mock_gl_device::get().state_changes; }
+inline void glEnable(GLenum) {}
+inline void glDisable(GLenum) {}
+inline void glBlendFunc(GLenum, GLenum) {}
+inline void glDepthMask(GLboolean) {}
+inline void glPolygonOffset(GLfloat, GLfloat) {}
+inline void glViewport(GLint, GLint, GLsizei, GLsizei) {}
+inline void glScissor(GLint, GLint, GLsizei, GLsizei) {}
+inline void glClearColor(GLfloat, GLfloat, GLfloat, GLfloat) {}
+inline void glClear(GLbitfield) {}
+inline void glPixelStorei(GLenum, GLint) {}
+inline void glFlush() {}
+inline void glFinish() {}
+inline const GLubyte *glGetString(GLenum) { return reinterpret_cast<const GLubyte *>("mock_gl_device"); }
+
+// ======= BUFFERS / TEXTURES =======
+
+inline void glBufferData(GLenum, GLsizeiptr size, const void *, GLenum) { mock_gl_device::get().bytes_uploaded += size; }
+inline void glBufferSubData(GLenum, GLintptr, GLsizeiptr size, const void *) { mock_gl_device::get().bytes_uploaded += size; }
+inline void glGetBufferSubData(GLenum, GLintptr, GLsizeiptr, void *) {}
+inline void glGetBufferParameteriv(GLenum, GLenum, GLint *out) { *out = 0x7FFFFFFF; }
+inline void glGetVertexAttribiv(GLuint, GLenum, GLint *out) { *out = 1; }
+inline void glVertexAttribPointer(GLuint, GLint, GLenum, GLboolean, GLsizei, const void *) {}
+inline void glVertexAttribIPointer(GLuint, GLint, GLenum, GLsizei, const void *) {}
+inline void glEnableVertexAttribArray(GLuint) {}
+inline void glVertexAttribDivisor(GLuint, GLuint) {}
+inline void glTexParameteri(GLenum, GLenum, GLint) {}
+inline void glTexImage2D(GLenum, GLint, GLint, GLsizei w, GLsizei h, GLint, GLenum, GLenum, const void *) { mock_gl_device::get().bytes_uploaded += static_cast<uint64_t>(w) * h * 4; }
+inline void glTexImage3D(GLenum, GLint, GLint, GLsizei w, GLsizei h, GLsizei d, GLint, GLenum, GLenum, const void *) { mock_gl_device::get().bytes_uploaded += static_cast<uint64_t>(w) * h * d * 4; }
+inline void glTexSubImage2D(GLenum, GLint, GLint, GLint, GLsizei w, GLsizei h, GLenum, GLenum, const void *) { mock_gl_device::get().bytes_uploaded += static_cast<uint64_t>(w) * h * 4; }
+inline void glGenerateMipmap(GLenum) {}
+inline void glTexBuffer(GLenum, GLenum, GLuint) {}
+inline void glReadPixels(GLint, GLint, GLsizei, GLsizei, GLenum, GLenum, void *) {}
+
+// ======= SHADERS =======
+
+inline GLuint glCreateShader(GLenum) { return mock_gl_device::get().create(); }
+inline GLuint glCreateProgram() { return mock_gl_device::get().create(); }
+inline void glShaderSource(GLuint, GLsizei, const GLchar *const *, const GLint *) {}
+inline void glCompileShader(GLuint) {}
+inline void glGetShaderiv(GLuint, GLenum, GLint *out) { *out = 1; }
+inline void glGetShaderInfoLog(GLuint, GLsizei, GLsizei *, GLchar *log) { log[0] = '\0'; }
+inline void glAttachShader(GLuint, GLuint) {}
+inline void glLinkProgram(GLuint) {}
+inline void glGetProgramiv(GLuint, GLenum, GLint *out) { *out = 1; }
+inline void glGetProgramInfoLog(GLuint, GLsizei, GLsizei *, GLchar *log) { log[0] = '\0'; }
+inline void glDeleteShader(GLuint) {}
+inline void glDeleteProgram(GLuint) {}
+inline GLint glGetUniformLocation(GLuint, const GLchar *) { return 0; }
+inline void glUniformMatrix4fv(GLint, GLsizei, GLboolean, const GLfloat *) { ++mock_gl_device::get().uniform_sets; }
+inline void glUniform1i(GLint, GLint) { ++mock_gl_device::get().uniform_sets; }
+inline void glUniform1f(GLint, GLfloat) { ++mock_gl_device::get().uniform_sets; }
+inline void glUniform2f(GLint, GLfloat, GLfloat) { ++mock_gl_device::get().uniform_sets; }
+inline void glUniform3f(GLint, GLfloat, GLfloat, GLfloat) { ++mock_gl_device::get().uniform_sets; }
+inline void glUniform3i(GLint, GLint, GLint, GLint) { ++mock_gl_device::get().uniform_sets; }
+inline void glUniform4f(GLint, GLfloat, GLfloat, GLfloat, GLfloat) { ++mock_gl_device::get().uniform_sets; }
+
+// ======= DRAWING =======
+
+inline void glDrawArrays(GLenum, GLint, GLsizei count)
+{
+    ++mock_gl_device::get().draw_calls;
+    mock_gl_device::get().vertices_submitted += count;
+}
+
+inline void glDrawElements(GLenum, GLsizei count, GLenum, const void *)
+{
+    ++mock_gl_device::get().draw_calls;
+    mock_gl_device::get().vertices_submitted += count;
+}
+
+inline void glDrawArraysInstanced(GLenum, GLint, GLsizei count, GLsizei instances)
+{
+    ++mock_gl_device::get().draw_calls;
+    mock_gl_device::get().vertices_submitted += static_cast<uint64_t>(count) * instances;
+}
+
+// ======= QUERIES / FRAMEBUFFERS =======
+
+inline void glBeginQuery(GLenum, GLuint) {}
+inline void glEndQuery(GLenum) {}
+inline void glGetQueryObjectiv(GLuint, GLenum, GLint *out) { *out = 1; }
+inline void glGetQueryObjectui64v(GLuint, GLenum, GLuint64 *out) { *out = 0; }
+inline void glRenderbufferStorage(GLenum, GLenum, GLsizei, GLsizei) {}
+inline void glFramebufferRenderbuffer(GLenum, GLenum, GLenum, GLuint) {}
+inline GLenum glCheckFramebufferStatus(GLenum) { return GL_FRAMEBUFFER_COMPLETE; }
+inline void glFramebufferTexture2D(GLenum, GLenum, GLenum, GLuint, GLint) {}
+inline void glFramebufferTextureLayer(GLenum, GLenum, GLuint, GLint, GLint) {}
+inline void glDrawBuffer(GLenum) {}
+inline void glReadBuffer(GLenum) {}
+inline void glBlitFramebuffer(GLint, GLint, GLint, GLint, GLint, GLint, GLint, GLint, GLbitfield, GLenum) { ++mock_gl_device::get().state_changes; }
@@ -2,11 +2,27 @@
 
 #include <optional>
 #include <chrono>
+#include <thread>
 #include <functional>
 #include <iostream>
 #include <vector>
 #include <string>
 
+#include "./timing/fixed_timestep.hpp"
+#include "./threading/render_handoff.hpp"
+
+#include "../helpers/profiling/frame_profiler.hpp"
+#include "../helpers/memory/memory_resources.hpp"
+#include "../helpers/memory/allocation_tracker.hpp"
+
+#include "../physics/force_generators.hpp"
+#include "../physics/broadphase.hpp"
+#include "../physics/contact_solver.hpp"
+
+#include "../helpers/logic/preset_tables.hpp"
+
+#include "../particles/particle_system.hpp"
+
 #include "../rendering/screen/screen_class.hpp"
 #include "../rendering/screen/input/keybind_handler.hpp"
 
@@ -16,10 +32,28 @@
 
 #include "../rendering/graphics/textures/texture_handler.hpp"
 
+#include "../rendering/particles/particle_renderer.hpp"
+
+#include "../rendering/views/render_view.hpp"
+#include "../rendering/views/view_culler.hpp"
+#include "../rendering/views/occlusion_culler.hpp"
+#include "../rendering/views/occlusion_debug_view.hpp"
+
+#include "../rendering/lighting/light_clusters.hpp"
+#include "../rendering/lighting/light_buffers.hpp"
+#include "../rendering/lighting/shadow_cascades.hpp"
+#include "../rendering/lighting/shadow_maps.hpp"
+
+#include "../rendering/software/software_rasterizer.hpp"
+#include "../rendering/software/software_presenter.hpp"
+
 #include "../rendering/objects/management/object_manager.hpp"
 #include "../rendering/objects/creation/object_lib.hpp"
+#include "../rendering/objects/batching/static_batches.hpp"
+#include "../rendering/objects/batching/static_batch_buffers.hpp"
 
 #include "../rendering/screen/input/movement_listener.hpp"
+#include "../rendering/screen/input/input_recording.hpp"
 #include "../rendering/screen/camera/player_camera_controller.hpp"
 
 #include <glad/glad.h>
@@ -43,11 +77,51 @@ private:
     player_camera_controller camera;
     movement_listener mover;
 
+    input_recording recording;
+    bool recording_input = false;
+
     // ======= RENDERING =======
 
     unsigned int VAO;
     int vertexCount;
 
+    particle_renderer particle_draw;
+    particle_frame particle_staging; // packed every frame on the single-threaded paths
+
+    view_set views;
+    view_culler culler;
+
+    occlusion_culler occlusion;
+    occlusion_debug_view occlusion_debug;
+    bool show_occlusion = false;
+    std::vector<unsigned char> occlusion_image; // debug overlay pixels on the single-threaded paths
+
+    light_clusters light_grid;
+    light_buffers light_gpu;
+    glm::vec3 ambient_light = glm::vec3(0.15f);
+
+    shadow_cascades shadow_fit;
+    shadow_maps shadow_gpu;
+
+    static_batches static_geometry; // changed on the GL thread (run_gl), culled on the logic thread
+    static_batch_buffers static_gpu;
+
+    render_backend backend = render_backend::gl;
+    software_rasterizer software_raster;
+    software_framebuffer software_target; // drawn by the thread that renders (the render thread in run_threaded)
+    software_presenter software_present;
+
+    // ======= THREADING =======
+
+    render_handoff handoff;
+
+    bool threaded = false;
+
+    // ======= MEMORY =======
+
+    frame_arena frame_memory;
+    arena_resource frame_resource;
+
 private:
     /// @brief Used for window resizing
     /// @param window
@@ -55,31 +129,590 @@ private:
     /// @param height
     static void framebuffer_size_callback(GLFWwindow *window, int width, int height)
     {
-        glViewport(0, 0, width, height);
+        // ======= the render thread applies the viewport itself when it owns the context =======
 
-        if (height > 0)
-        {
-            player_camera_controller *cam = static_cast<player_camera_controller *>(glfwGetWindowUserPointer(window));
-            cam->setAspectRatio(width / (float)height);
-        }
+        if (glfwGetCurrentContext() == window)
+            glViewport(0, 0, width, height);
+
+        // ======= the camera picks the new aspect ratio up with the rest of the frame's input =======
+
+        if (keybind_handler *handler = keybind_handler::from_window(window))
+            handler->push_event({input_event_type::resize, 0, 0, static_cast<double>(width), static_cast<double>(height), input_now_ns()});
     }
 
     /// @brief Setup User Input
     void setup_input()
     {
-        glfwSetWindowUserPointer(screen.get_window(), &camera);
         glfwSetInputMode(screen.get_window(), GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-        glfwSetCursorPosCallback(screen.get_window(), player_camera_controller::mouse_callback);
         glfwSetFramebufferSizeCallback(screen.get_window(), framebuffer_size_callback);
     }
 
-    /// @brief Render 3D World
-    void render()
+    /// @brief Apply this frame's input to the camera and append it to the recording if one is running
+    /// @param delta_time
+    void update_input(float delta_time)
+    {
+        mover.update(delta_time);
+
+        if (recording_input)
+        {
+            const std::vector<input_event> &events = key_handler.get_frame_events();
+            recording.add_frame(delta_time, camera.getState(), events.data(), events.size());
+        }
+    }
+
+    /// @brief Grow the running recording for the coming frame; called before the frame's allocation guard opens
+    void reserve_input_frame()
+    {
+        if (recording_input)
+            recording.reserve_frame(INPUT_QUEUE_CAPACITY);
+    }
+
+    /// @brief Copy the camera into the main view and cull every object against every active view in one pass
+    void update_views()
+    {
+        render_view &main = views.get(view_set::main_view);
+        main.view = camera.getViewMatrix();
+        main.projection = camera.getProjectionMatrix();
+
+        culler.cull(world_objects.get_objects(), views.data(), views.active_mask());
+
+        if (occlusion.occluder_count() > 0 && (views.active_mask() & (1u << view_set::main_view)))
+        {
+            PROFILE_SCOPE("occlusion");
+            occlusion.cull(world_objects.get_objects(), camera.getViewProjectionMatrix(), culler, view_set::main_view);
+        }
+
+        if (backend == render_backend::gl && static_geometry.batch_count() > 0)
+        {
+            PROFILE_SCOPE("static_batches");
+
+            static_geometry.cull(views.data(), views.active_mask());
+            static_geometry.hide_members(culler);
+        }
+
+        if (backend == render_backend::gl && (views.active_mask() & (1u << view_set::main_view)))
+        {
+            PROFILE_SCOPE("light_clusters");
+            light_grid.build(lights, main.view, main.projection);
+        }
+
+        if (backend == render_backend::gl && (views.active_mask() & (1u << view_set::main_view)))
+        {
+            PROFILE_SCOPE("shadow_cascades");
+            shadow_fit.update(main.view, main.projection, culler.get_spheres());
+        }
+    }
+
+    /// @brief Draw the occlusion buffer into the bottom left corner of the framebuffer and restore the full viewport
+    /// @param image: occlusion_culler::debug_image pixels
+    /// @param width
+    /// @param height
+    /// @param framebuffer_width
+    /// @param framebuffer_height
+    void render_occlusion_overlay(const std::vector<unsigned char> &image, int width, int height, int framebuffer_width, int framebuffer_height)
+    {
+        int overlay_width = framebuffer_width / 3;
+        int rect[4] = {0, 0, overlay_width, overlay_width * height / width};
+
+        occlusion_debug.render(image, width, height, rect);
+
+        glViewport(0, 0, framebuffer_width, framebuffer_height);
+        shader.use();
+    }
+
+    /// @brief Rasterize every active view into the software framebuffer and present it over the full viewport
+    /// @note Particles and point lights aren't drawn by the software backend
+    /// @tparam SubmitView: void(uint32_t view_bit), queues the draws visible in one view on software_raster
+    /// @param views: Indexed by view ID
+    /// @param view_mask: Views to draw
+    /// @param framebuffer_width
+    /// @param framebuffer_height
+    /// @param submit_view
+    template <typename SubmitView>
+    void render_software(const render_view *views, uint32_t view_mask, int framebuffer_width, int framebuffer_height, SubmitView &&submit_view)
+    {
+        software_target.resize(framebuffer_width, framebuffer_height);
+        software_target.clear();
+
+        for (uint32_t id = 0; id < RENDER_VIEW_MAX; ++id)
+        {
+            if (!(view_mask & (1u << id)))
+                continue;
+
+            const render_view &view = views[id];
+
+            int rect[4];
+            view.pixel_rect(framebuffer_width, framebuffer_height, rect);
+
+            if (view.clear_depth)
+                software_target.clear_depth(rect);
+
+            submit_view(1u << id);
+
+            PROFILE_SCOPE("software_raster");
+            software_raster.draw(software_target, view.projection * view.view, rect);
+        }
+
+        glViewport(0, 0, framebuffer_width, framebuffer_height);
+
+        software_present.render(software_target);
+        shader.use();
+    }
+
+    /// @brief Light the main view with the clustered point lights and the directional light and leave the other views unlit
+    /// @param data: Uploaded cluster grid of the main view
+    /// @param shadows: Rendered cascades of the main view
+    /// @param id: View ID
+    /// @param view
+    /// @param framebuffer_width
+    /// @param framebuffer_height
+    void bind_lighting(const light_cluster_data &data, const shadow_cascade_data &shadows, uint32_t id, const render_view &view, int framebuffer_width, int framebuffer_height)
+    {
+        if (id != view_set::main_view)
+        {
+            shader.set_uniform1i("use_lighting", 0);
+            shader.set_uniform1i("use_sun", 0);
+            return;
+        }
+
+        int rect[4];
+        view.pixel_rect(framebuffer_width, framebuffer_height, rect);
+
+        shader.setVec3("ambient_light", ambient_light);
+
+        light_gpu.bind(shader, data, rect);
+        shadow_gpu.bind(shader, shadows);
+    }
+
+    /// @brief Update the shadow maps of the directional light and draw into the screen again
+    /// @tparam SubmitCasters: void(uint32_t bit), calls shadow_gpu.draw() for every caster whose shadow mask has the bit
+    /// @param data: Cascades of the main view
+    /// @param submit_casters
+    template <typename SubmitCasters>
+    void render_shadows(const shadow_cascade_data &data, SubmitCasters &&submit_casters)
+    {
+        PROFILE_SCOPE("shadows");
+
+        // ======= the render thread skipped an update (mailbox), so the logic thread redraws those caches =======
+
+        if (uint32_t lost = shadow_gpu.render(data, submit_casters))
+            shadow_fit.invalidate(lost);
+
+        if (shadow_gpu.drew())
+        {
+            screen.bind_target();
+            shader.use();
+        }
+    }
+
+    /// @brief Point the viewport at a view and clear its depth if asked to
+    /// @param view
+    /// @param framebuffer_width
+    /// @param framebuffer_height
+    static void begin_view(const render_view &view, int framebuffer_width, int framebuffer_height)
+    {
+        int rect[4];
+        view.pixel_rect(framebuffer_width, framebuffer_height, rect);
+
+        glViewport(rect[0], rect[1], rect[2], rect[3]);
+
+        if (view.clear_depth)
+        {
+            glEnable(GL_SCISSOR_TEST);
+            glScissor(rect[0], rect[1], rect[2], rect[3]);
+            glClear(GL_DEPTH_BUFFER_BIT);
+            glDisable(GL_SCISSOR_TEST);
+        }
+    }
+
+    /// @brief Render 3D World once per active view
+    /// @param alpha: Interpolation factor between the previous and current simulation state (default: 1)
+    void render(float alpha = 1.0f)
+    {
+        {
+            PROFILE_SCOPE("cull");
+            update_views();
+        }
+
+        int framebuffer_width, framebuffer_height;
+        screen.get_framebuffer_size(framebuffer_width, framebuffer_height);
+
+        uint32_t active = views.active_mask();
+        bool particles_packed = false;
+
+        if (backend == render_backend::software)
+        {
+            const std::vector<object_interface> &objects = world_objects.get_objects();
+            const std::vector<uint32_t> &masks = culler.get_masks();
+
+            render_software(views.data(), active, framebuffer_width, framebuffer_height, [&](uint32_t view_bit)
+                            {
+                                for (size_t i = 0; i < objects.size(); ++i)
+                                {
+                                    if (!(masks[i] & view_bit))
+                                        continue;
+
+                                    const object_interface &obj = objects[i];
+                                    const Mesh &mesh = obj.get_mesh();
+
+                                    software_raster.submit(obj.get_interpolated_matrix(alpha), mesh.VAO, mesh.vertexCount, obj.get_texture_id(), obj.has_texture());
+                                } });
+
+            active = 0;
+        }
+        else
+        {
+            light_gpu.upload(light_grid.get_data());
+
+            if (active & (1u << view_set::main_view))
+            {
+                const std::vector<object_interface> &objects = world_objects.get_objects();
+                const std::vector<uint32_t> &casters = shadow_fit.get_masks();
+
+                render_shadows(shadow_fit.get_data(), [&](uint32_t bit)
+                               {
+                                   for (size_t i = 0; i < casters.size(); ++i)
+                                   {
+                                       if (!(casters[i] & bit))
+                                           continue;
+
+                                       const Mesh &mesh = objects[i].get_mesh();
+                                       shadow_gpu.draw(objects[i].get_interpolated_matrix(alpha), mesh.VAO, mesh.vertexCount);
+                                   } });
+            }
+        }
+
+        for (uint32_t id = 0; id < RENDER_VIEW_MAX; ++id)
+        {
+            if (!(active & (1u << id)))
+                continue;
+
+            const render_view &view = views.get(id);
+            begin_view(view, framebuffer_width, framebuffer_height);
+            bind_lighting(light_grid.get_data(), shadow_fit.get_data(), id, view, framebuffer_width, framebuffer_height);
+
+            shader.setMat4("view", view.view);
+            shader.setMat4("projection", view.projection);
+
+            world_objects.render_visible(culler.get_masks(), 1u << id, alpha);
+            static_gpu.draw(shader, static_geometry.get_masks(), 1u << id);
+
+            if (view.particles && particles.size() > 0)
+            {
+                if (!particles_packed)
+                {
+                    particles.pack(particle_staging);
+                    particles_packed = true;
+                }
+
+                particle_draw.render(particle_staging, view.view, view.projection);
+                shader.use();
+            }
+        }
+
+        glViewport(0, 0, framebuffer_width, framebuffer_height);
+
+        if (show_occlusion && occlusion.occluder_count() > 0)
+        {
+            int width, height;
+            occlusion.debug_image(occlusion_image, width, height);
+
+            render_occlusion_overlay(occlusion_image, width, height, framebuffer_width, framebuffer_height);
+        }
+    }
+
+    /// @brief Run the registered presets, advance the particles, integrate the physics world, resolve contacts and copy linked bodies onto their objects
+    /// @param delta_time
+    void step_simulation(float delta_time)
+    {
+        if (presets.size() > 0)
+        {
+            PROFILE_SCOPE("presets");
+            presets.run(world_objects.get_objects(), delta_time);
+        }
+
+        if (particles.emitter_count() > 0)
+        {
+            PROFILE_SCOPE("particles");
+            particles.update(delta_time);
+        }
+
+        if (physics.size() == 0)
+            return;
+
+        {
+            PROFILE_SCOPE("physics");
+            physics.integrate_velocities(delta_time);
+        }
+
+        {
+            PROFILE_SCOPE("broadphase");
+            collisions.update(physics);
+        }
+
+        {
+            PROFILE_SCOPE("contacts");
+            contacts.solve(physics, collisions, delta_time);
+        }
+
+        {
+            PROFILE_SCOPE("physics");
+
+            physics.integrate_positions(delta_time);
+            physics.sync_to(world_objects.get_objects());
+        }
+    }
+
+    /// @brief Run a GL function on whichever thread owns the context
+    /// @tparam Function
+    /// @param function
+    /// @return The value returned by function
+    template <typename Function>
+    auto run_gl(Function &&function) -> decltype(function())
+    {
+        if (threaded)
+            return handoff.run_on_render_thread(std::forward<Function>(function));
+
+        return function();
+    }
+
+    /// @brief Merge objects into the static batches or take them out, then upload what changed (on the GL thread)
+    /// @param obj_ids
+    /// @param count
+    /// @param is_static
+    void update_static(const size_t *obj_ids, size_t count, bool is_static)
+    {
+        if (backend != render_backend::gl)
+            return;
+
+        run_gl([&]
+               {
+                   static_mesh_data mesh;
+
+                   for (size_t i = 0; i < count; ++i)
+                   {
+                       if (!is_static)
+                       {
+                           static_geometry.remove(obj_ids[i]);
+                           continue;
+                       }
+
+                       const object_interface &obj = world_objects.get_object(obj_ids[i]);
+
+                       if (static_batch_buffers::read_mesh(obj.get_mesh(), mesh))
+                           static_geometry.add(obj_ids[i], mesh, obj.get_model_matrix(), obj.has_texture() ? obj.get_texture_id() : 0);
+                   }
+
+                   static_gpu.upload(static_geometry); });
+    }
+
+    /// @brief Copy everything needed to draw the current frame into a snapshot
+    /// @param snapshot: The snapshot to fill
+    /// @param frame: Frame index
+    void write_snapshot(frame_snapshot &snapshot, uint64_t frame)
+    {
+        snapshot.clear();
+
+        snapshot.frame = frame;
+        snapshot.input_ns = key_handler.take_unpresented_input();
+
+        update_views();
+
+        snapshot.view_mask = views.active_mask();
+
+        for (uint32_t id = 0; id < RENDER_VIEW_MAX; ++id)
+            if (snapshot.view_mask & (1u << id))
+                snapshot.views[id] = views.get(id);
+
+        screen.get_framebuffer_size(snapshot.viewport_width, snapshot.viewport_height);
+
+        const std::vector<object_interface> &objects = world_objects.get_objects();
+        const std::vector<uint32_t> &masks = culler.get_masks();
+
+        // ======= shadow casters are kept even when no view sees them =======
+
+        const std::vector<uint32_t> &casters = shadow_fit.get_masks();
+        bool shadowed = shadow_fit.get_data().valid && (snapshot.view_mask & (1u << view_set::main_view)) && casters.size() == objects.size();
+
+        for (size_t i = 0; i < objects.size(); ++i)
+        {
+            uint32_t shadow_mask = shadowed ? casters[i] : 0;
+
+            if (masks[i] == 0 && shadow_mask == 0)
+                continue;
+
+            const object_interface &obj = objects[i];
+            const Mesh &mesh = obj.get_mesh();
+
+            snapshot.items.push_back({obj.get_model_matrix(),
+                                      mesh.VAO,
+                                      mesh.vertexCount,
+                                      obj.get_texture_id(),
+                                      obj.has_texture(),
+                                      masks[i],
+                                      shadow_mask});
+        }
+
+        if (shadowed)
+            snapshot.shadows = shadow_fit.get_data();
+
+        if (static_geometry.batch_count() > 0)
+            snapshot.batch_masks = static_geometry.get_masks();
+
+        particles.pack(snapshot.particles);
+
+        if (light_grid.get_data().valid && (snapshot.view_mask & (1u << view_set::main_view)))
+            snapshot.lighting = light_grid.get_data();
+
+        if (show_occlusion && occlusion.occluder_count() > 0)
+            occlusion.debug_image(snapshot.occlusion_image, snapshot.occlusion_width, snapshot.occlusion_height);
+    }
+
+    /// @brief Draw a snapshot (render thread)
+    /// @param snapshot
+    void render_snapshot(const frame_snapshot &snapshot)
+    {
+        uint32_t active = snapshot.view_mask;
+
+        if (backend == render_backend::software)
+        {
+            render_software(snapshot.views, active, snapshot.viewport_width, snapshot.viewport_height, [&](uint32_t view_bit)
+                            {
+                                for (const draw_item &item : snapshot.items)
+                                    if (item.view_mask & view_bit)
+                                        software_raster.submit(item.model, item.VAO, item.vertexCount, item.textureID, item.hasTexture); });
+
+            active = 0;
+        }
+        else
+        {
+            light_gpu.upload(snapshot.lighting);
+
+            render_shadows(snapshot.shadows, [&](uint32_t bit)
+                           {
+                               for (const draw_item &item : snapshot.items)
+                                   if (item.shadow_mask & bit)
+                                       shadow_gpu.draw(item.model, item.VAO, item.vertexCount); });
+        }
+
+        for (uint32_t id = 0; id < RENDER_VIEW_MAX; ++id)
+        {
+            if (!(active & (1u << id)))
+                continue;
+
+            const render_view &view = snapshot.views[id];
+            begin_view(view, snapshot.viewport_width, snapshot.viewport_height);
+            bind_lighting(snapshot.lighting, snapshot.shadows, id, view, snapshot.viewport_width, snapshot.viewport_height);
+
+            render_snapshot_view(snapshot, view, 1u << id);
+        }
+
+        glViewport(0, 0, snapshot.viewport_width, snapshot.viewport_height);
+
+        if (!snapshot.occlusion_image.empty())
+            render_occlusion_overlay(snapshot.occlusion_image, snapshot.occlusion_width, snapshot.occlusion_height, snapshot.viewport_width, snapshot.viewport_height);
+    }
+
+    /// @brief Draw the items of a snapshot visible in one view (render thread)
+    /// @param snapshot
+    /// @param view
+    /// @param view_bit
+    void render_snapshot_view(const frame_snapshot &snapshot, const render_view &view, uint32_t view_bit)
+    {
+        shader.setMat4("view", view.view);
+        shader.setMat4("projection", view.projection);
+
+        for (const draw_item &item : snapshot.items)
+        {
+            if (!(item.view_mask & view_bit))
+                continue;
+
+            shader.setMat4("model", item.model);
+
+            shader.set_uniform1i("use_texture", item.hasTexture);
+
+            if (item.hasTexture)
+            {
+                glActiveTexture(GL_TEXTURE0);
+                glBindTexture(GL_TEXTURE_2D, item.textureID);
+                shader.set_uniform1i("texture_diffuse", 0);
+            }
+
+            glBindVertexArray(item.VAO);
+            glDrawArrays(GL_TRIANGLES, 0, item.vertexCount);
+        }
+
+        static_gpu.draw(shader, snapshot.batch_masks, view_bit);
+
+        if (view.particles && snapshot.particles.size() > 0)
+        {
+            particle_draw.render(snapshot.particles, view.view, view.projection);
+            shader.use();
+        }
+    }
+
+    /// @brief Render thread loop: owns the GL context, runs queued GL commands and draws snapshots
+    void render_loop()
     {
-        shader.setMat4("view", camera.getViewMatrix());
-        shader.setMat4("projection", camera.getProjectionMatrix());
+        screen.make_context_current();
+        shader.use();
+
+        int viewport_width = 0;
+        int viewport_height = 0;
+
+        std::vector<std::function<void()>> pending;
+        bool running = true;
+
+        while (true)
+        {
+            const frame_snapshot *snapshot = handoff.acquire(pending, running);
+
+            for (auto &command : pending)
+            {
+                PROFILE_SCOPE("gl_command");
+                command();
+            }
+
+            pending.clear();
+
+            ALLOCATION_FRAME_GUARD("game_engine::render_loop");
+
+            if (!snapshot)
+            {
+                if (!running)
+                    break;
+
+                continue;
+            }
+
+            if ((snapshot->viewport_width != viewport_width || snapshot->viewport_height != viewport_height) &&
+                snapshot->viewport_width > 0 && snapshot->viewport_height > 0)
+            {
+                viewport_width = snapshot->viewport_width;
+                viewport_height = snapshot->viewport_height;
+
+                glViewport(0, 0, viewport_width, viewport_height);
+            }
+
+            {
+                PROFILE_SCOPE("render");
+                PROFILE_GPU_SCOPE("gpu_render");
+
+                screen.clear();
+                render_snapshot(*snapshot);
+            }
+
+            {
+                PROFILE_SCOPE("swap_buffers");
+                screen.swap_buffers();
+            }
+
+            key_handler.presented(snapshot->input_ns);
+
+            PROFILE_GPU_FRAME_END();
+        }
 
-        world_objects.render_all();
+        screen.release_context();
     }
 
 public:
@@ -87,6 +720,16 @@ public:
 
     object_manager world_objects;
 
+    physics_world physics;
+    broadphase collisions;
+    contact_solver contacts;
+
+    preset_tables presets;
+
+    particle_system particles;
+
+    point_lights lights; // clustered on the main view every frame
+
 public:
     // ======= CONSTRUCTOR =======
 
@@ -95,17 +738,42 @@ public:
     /// @param height: Starting Height of window
     /// @param title: Title of the window
     /// @param valid_keys: Keys that should be tracked
-    game_engine(int width, int height, const char *title, const std::vector<int> &valid_keys)
-        : screen(width, height, title),
+    /// @param headless: Render offscreen without a display (default: false)
+    /// @param renderer: render_backend::software rasterizes on the CPU and only presents through GL (default: render_backend::gl)
+    game_engine(int width, int height, const char *title, const std::vector<int> &valid_keys, bool headless = false, render_backend renderer = render_backend::gl)
+        : screen(width, height, title, headless),
           shader(
               "shaders/glsl_files/vertex_shader.glsl",
               "shaders/glsl_files/fragment_shader.glsl"),
           key_handler(screen, valid_keys),
           camera(),
-          mover(key_handler, camera)
+          mover(key_handler, camera),
+          particle_draw(
+              "shaders/glsl_files/particle_vertex_shader.glsl",
+              "shaders/glsl_files/particle_fragment_shader.glsl"),
+          occlusion_debug(
+              "shaders/glsl_files/occlusion_debug_vertex_shader.glsl",
+              "shaders/glsl_files/occlusion_debug_fragment_shader.glsl"),
+          shadow_gpu(
+              "shaders/glsl_files/shadow_depth_vertex_shader.glsl",
+              "shaders/glsl_files/shadow_depth_fragment_shader.glsl"),
+          backend(renderer),
+          software_present(
+              "shaders/glsl_files/present_vertex_shader.glsl",
+              "shaders/glsl_files/present_fragment_shader.glsl"),
+          frame_memory(1 << 20, "frame_arena"),
+          frame_resource(frame_memory)
     {
         glEnable(GL_DEPTH_TEST);
 
+        shader.use();
+        light_gpu.attach(shader);
+        shadow_gpu.attach(shader);
+
+        // ======= meshes and textures are copied for the CPU as they're uploaded, so this has to precede any object =======
+
+        software_assets::get().set_capture(backend == render_backend::software);
+
         setup_input();
 
         camera.setAspectRatio(static_cast<float>(width) / static_cast<float>(height));
@@ -125,11 +793,21 @@ public:
         const glm::vec3 &pos = {0.0f, 0.0f, 0.0f},
         const glm::vec3 &rotation = {0.0f, 0.0f, 0.0f})
     {
-        size_t obj_id = world_objects.spawn_object(shader, shapeData, scale, pos, rotation);
+        size_t obj_id = run_gl([&]
+                               { return world_objects.spawn_object(shader, shapeData, scale, pos, rotation); });
 
         return obj_id;
     }
 
+    /// @brief Apply an image as a texture to an object (use this instead of object_interface::apply_texture inside run_threaded)
+    /// @param obj_id: The object ID
+    /// @param image_path: Path to the texture
+    void apply_texture(size_t obj_id, const std::string &image_path)
+    {
+        run_gl([&]
+               { world_objects.get_object(obj_id).apply_texture(image_path); });
+    }
+
     /// @brief Get an object using its ID
     /// @param obj_id: The object ID
     /// @return object_interface
@@ -138,17 +816,69 @@ public:
         return world_objects.get_object(obj_id);
     }
 
+    /// @brief Let the physics world drive an object; its AABB comes from the object's offset and scale
+    /// @note Deleting the object removes the body; deleting earlier objects keeps the link pointing at it
+    /// @param obj_id: The object ID
+    /// @param mass: <= 0 makes the body static (default: object mass)
+    /// @return body_handle
+    body_handle add_physics_body(size_t obj_id, std::optional<float> mass = std::nullopt)
+    {
+        object_interface &obj = world_objects.get_object(obj_id);
+
+        return physics.add_body(obj.get_offset(), obj.get_velocity(), mass.value_or(obj.get_mass()), obj_id, obj.get_scale() * 0.5f);
+    }
+
+    /// @brief Merge an object that never moves into a pre-transformed vertex / index buffer shared with the other static
+    /// objects of its texture and STATIC_BATCH_CELL_SIZE world cell; each batch is culled as a whole and drawn with one call
+    /// @note The merged copy keeps the object's current transform and texture, so call set_static() again after changing
+    /// them. GL backend only (the software backend keeps drawing static objects one by one); shadows are still cast per object
+    /// @param obj_id: The object ID
+    /// @param is_static: false takes the object out of its batch again (default: true)
+    void set_static(size_t obj_id, bool is_static = true) { update_static(&obj_id, 1, is_static); }
+
+    /// @brief set_static() for many objects with a single upload (and a single render thread round trip inside run_threaded)
+    /// @param obj_ids: The object IDs
+    /// @param is_static (default: true)
+    void set_static(const std::vector<size_t> &obj_ids, bool is_static = true) { update_static(obj_ids.data(), obj_ids.size(), is_static); }
+
     /// @brief Delete a specfic object
     /// @param obj_id: The ID of the object
     void delete_object(size_t obj_id)
     {
+        if (static_geometry.is_static(obj_id))
+            run_gl([&]
+                   {
+                       static_geometry.remove(obj_id);
+                       static_gpu.upload(static_geometry); });
+
+        static_geometry.object_deleted(obj_id);
+        shadow_fit.object_deleted(obj_id, world_objects.get_object(obj_id).get_bounding_sphere());
+
         world_objects.delete_object(obj_id);
+        presets.object_deleted(obj_id);
+        occlusion.object_deleted(obj_id);
+        physics.object_deleted(obj_id);
     }
 
     /// @brief Clear all objects in the world
     void clear_world()
     {
         world_objects.clear_world();
+        presets.clear();
+        particles.clear();
+        occlusion.clear();
+        lights.clear();
+        shadow_fit.clear();
+
+        physics.clear();
+        collisions.clear();
+        contacts.clear();
+
+        if (static_geometry.batch_count() > 0)
+            run_gl([&]
+                   { static_gpu.destroy(); });
+
+        static_geometry.clear();
     }
 
     // ======= RENDERING API =======
@@ -163,6 +893,10 @@ public:
 
         while (!screen.should_close())
         {
+            frame_memory.reset();
+            reserve_input_frame();
+            ALLOCATION_FRAME_GUARD("game_engine::run");
+
             auto now = std::chrono::high_resolution_clock().now();
 
             float delta_time =
@@ -170,18 +904,414 @@ public:
 
             last_time = now;
 
-            screen.clear();
-            mover.update();
+            {
+                PROFILE_SCOPE("input");
+                update_input(delta_time);
+            }
 
             if (logic)
+            {
+                PROFILE_SCOPE("logic");
                 (*logic)(delta_time);
+            }
+
+            step_simulation(delta_time);
+
+            {
+                PROFILE_SCOPE("render");
+                PROFILE_GPU_SCOPE("gpu_render");
+
+                screen.clear();
+                render();
+            }
+
+            {
+                PROFILE_SCOPE("swap_buffers");
+                screen.swap_buffers();
+            }
+
+            key_handler.presented(key_handler.take_unpresented_input());
+
+            {
+                PROFILE_SCOPE("poll_events");
+                screen.poll_events();
+            }
+
+            PROFILE_GPU_FRAME_END();
+            PROFILE_FRAME_END();
+        }
+
+        screen.destroy();
+    }
 
+    /// @brief Run exactly frame_count frames with a fixed delta_time; deterministic, used by benchmarks
+    /// @param frame_count: Amount of frames to run
+    /// @param fixed_delta_time: delta_time handed to logic every frame (default: 1 / 60)
+    /// @param logic: Optional Logic to run every frame; @returns fixed_delta_time (default: std::nullopt)
+    /// @return std::vector<float>: Time of every frame in milliseconds, GPU work included (glFinish)
+    std::vector<float> run_frames(int frame_count, float fixed_delta_time = 1.0f / 60.0f, std::optional<std::function<void(float)>> logic = std::nullopt)
+    {
+        shader.use();
+
+        std::vector<float> frame_times;
+        frame_times.reserve(frame_count > 0 ? frame_count : 0);
+
+        for (int frame = 0; frame < frame_count && !screen.should_close(); ++frame)
+        {
+            frame_memory.reset();
+            reserve_input_frame();
+            ALLOCATION_FRAME_GUARD("game_engine::run_frames");
+
+            auto start = std::chrono::high_resolution_clock().now();
+
+            update_input(fixed_delta_time);
+
+            if (logic)
+                (*logic)(fixed_delta_time);
+
+            step_simulation(fixed_delta_time);
+
+            screen.clear();
             render();
 
             screen.swap_buffers();
+            key_handler.presented(key_handler.take_unpresented_input());
+
+            screen.finish();
             screen.poll_events();
+
+            frame_times.push_back(std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock().now() - start).count());
+
+            PROFILE_FRAME_END();
         }
 
+        return frame_times;
+    }
+
+    /// @brief Replay a recording made with start_recording(): every frame gets the recorded input and camera state and a
+    /// fixed delta_time, so the same flythrough can be timed headless and compared frame by frame across builds
+    /// @param path: Recording file
+    /// @param fixed_delta_time: delta_time handed to logic every frame (default: 1 / 60)
+    /// @param logic: Optional Logic to run every frame; @returns fixed_delta_time (default: std::nullopt)
+    /// @return std::vector<float>: Time of every frame in milliseconds, GPU work included (glFinish)
+    std::vector<float> run_replay(const std::string &path, float fixed_delta_time = 1.0f / 60.0f, std::optional<std::function<void(float)>> logic = std::nullopt)
+    {
+        input_recording replay = input_recording::load(path);
+
+        shader.use();
+
+        std::vector<float> frame_times;
+        frame_times.reserve(replay.size());
+
+        for (size_t frame = 0; frame < replay.size() && !screen.should_close(); ++frame)
+        {
+            frame_memory.reset();
+            ALLOCATION_FRAME_GUARD("game_engine::run_replay");
+
+            auto start = std::chrono::high_resolution_clock().now();
+
+            const recorded_frame &recorded = replay.get_frame(frame);
+
+            key_handler.replay(replay.get_events(recorded), recorded.event_count);
+            camera.setState(recorded.camera);
+
+            if (logic)
+                (*logic)(fixed_delta_time);
+
+            step_simulation(fixed_delta_time);
+
+            screen.clear();
+            render();
+
+            screen.swap_buffers();
+            key_handler.presented(key_handler.take_unpresented_input());
+
+            screen.finish();
+            screen.poll_events();
+
+            frame_times.push_back(std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock().now() - start).count());
+
+            PROFILE_FRAME_END();
+        }
+
+        return frame_times;
+    }
+
+    /// @brief Start recording input and camera state of every frame (any run loop); replaces an unsaved recording
+    /// @param expected_frames: Frames to reserve for (default: 1 minute at 60 fps)
+    void start_recording(size_t expected_frames = 3600)
+    {
+        recording.begin(expected_frames);
+        key_handler.set_capture(true);
+
+        recording_input = true;
+    }
+
+    /// @brief Stop recording and write the recording to a file for run_replay()
+    /// @param path
+    void stop_recording(const std::string &path)
+    {
+        recording_input = false;
+        key_handler.set_capture(false);
+
+        recording.save(path);
+        recording.clear();
+    }
+
+    /// @brief If input is being recorded
+    /// @return bool
+    bool is_recording() const { return recording_input; }
+
+    /// @brief Get the screen
+    /// @return screen_class&
+    screen_class &get_screen() { return screen; }
+
+    /// @brief Register an extra view (split screen, picture-in-picture, shadow / reflection camera); every active view is
+    /// culled in the same pass and drawn after the main camera in ID order
+    /// @param view
+    /// @return uint32_t: View ID
+    uint32_t add_view(const render_view &view) { return views.add(view); }
+
+    /// @brief Unregister a view
+    /// @param view_id
+    void remove_view(uint32_t view_id) { views.remove(view_id); }
+
+    /// @brief Get a view to move or resize it; view 0 is the main camera, whose matrices are refreshed every frame
+    /// @param view_id
+    /// @return render_view&
+    render_view &get_view(uint32_t view_id) { return views.get(view_id); }
+
+    /// @brief Visibility masks and statistics of the last cull
+    /// @return const view_culler&
+    const view_culler &get_culler() const { return culler; }
+
+    /// @brief Static batches and the statistics of the last batch cull
+    /// @return const static_batches&
+    const static_batches &get_static_batches() const { return static_geometry; }
+
+    /// @brief Let an object hide what's behind it from the main camera; occluders are rasterized into a small software
+    /// depth buffer every frame, so keep their meshes coarse (a box or a few quads) and inside the real geometry
+    /// @param obj_id: The object ID
+    /// @param mesh: Object space occluder geometry (default: the unit cube of object_lib::cube())
+    void add_occluder(size_t obj_id, const occluder_mesh &mesh = occluder_mesh::box()) { occlusion.add_occluder(obj_id, mesh); }
+
+    /// @brief Stop an object from occluding
+    /// @param obj_id: The object ID
+    void remove_occluder(size_t obj_id) { occlusion.remove_occluder(obj_id); }
+
+    /// @brief Draw the occlusion buffer as an overlay in the bottom left corner
+    /// @param enabled
+    void show_occlusion_buffer(bool enabled) { show_occlusion = enabled; }
+
+    /// @brief Occluded counts and the depth pyramid of the last occlusion pass
+    /// @return const occlusion_culler&
+    const occlusion_culler &get_occlusion() const { return occlusion; }
+
+    /// @brief Light every surface gets on top of the point and directional lights (main view, once a light exists)
+    /// @param color (default: 0.15, 0.15, 0.15)
+    void set_ambient_light(const glm::vec3 &color) { ambient_light = color; }
+
+    /// @brief Light the main view with a directional light (sun), shadowed by cascaded shadow maps fitted to the camera
+    /// @param direction: From the light into the scene
+    /// @param color (default: white)
+    /// @param intensity: Multiplies color (default: 1)
+    /// @param shadows: Draw its shadow maps (default: true)
+    void set_directional_light(const glm::vec3 &direction, const glm::vec3 &color = glm::vec3(1.0f), float intensity = 1.0f, bool shadows = true)
+    {
+        shadow_fit.set_light(direction, color * intensity, shadows);
+    }
+
+    /// @brief Turn the directional light off
+    void remove_directional_light() { shadow_fit.remove_light(); }
+
+    /// @brief Limit how far from the camera shadows are drawn; shorter distances give sharper shadows
+    /// @param distance: 0 uses the camera's far plane (default)
+    void set_shadow_distance(float distance) { shadow_fit.set_distance(distance); }
+
+    /// @brief Choose how an object casts shadows; stationary casters are drawn into a cached shadow map that is only
+    /// redrawn where the cascades scroll, so a mostly static scene costs next to nothing per frame
+    /// @note Call invalidate_static_shadows() after moving a stationary caster
+    /// @param obj_id: The object ID
+    /// @param mode: shadow_caster::dynamic (default for every object), stationary or none
+    void set_shadow_caster(size_t obj_id, shadow_caster mode)
+    {
+        shadow_fit.set_caster(obj_id, mode, world_objects.get_object(obj_id).get_bounding_sphere());
+    }
+
+    /// @brief Redraw the cached shadows of stationary casters, e.g. after moving some
+    void invalidate_static_shadows() { shadow_fit.invalidate_static(); }
+
+    /// @brief Cascades, caster masks and statistics of the last shadow update
+    /// @return const shadow_cascades&
+    const shadow_cascades &get_shadows() const { return shadow_fit; }
+
+    /// @brief Cluster grid and statistics of the last light assignment
+    /// @return const light_clusters&
+    const light_clusters &get_light_clusters() const { return light_grid; }
+
+    /// @brief Backend chosen at construction
+    /// @return render_backend
+    render_backend get_render_backend() const { return backend; }
+
+    /// @brief CPU framebuffer of the last software frame, e.g. get_software_framebuffer().save_ppm(path)
+    /// @return const software_framebuffer&
+    const software_framebuffer &get_software_framebuffer() const { return software_target; }
+
+    /// @brief Draw and triangle counts of the last view the software backend rasterized
+    /// @return const software_raster_stats&
+    const software_raster_stats &get_software_stats() const { return software_raster.get_stats(); }
+
+    /// @brief Input state, action bindings and input-to-present latency
+    /// @return keybind_handler&
+    keybind_handler &get_input() { return key_handler; }
+
+    /// @brief Per-frame arena for transient data, reset at the top of every frame (logic thread only)
+    /// @return frame_arena&
+    frame_arena &get_frame_arena() { return frame_memory; }
+
+    /// @brief std::pmr view of the per-frame arena, e.g. std::pmr::vector<int> list(&engine.get_frame_resource())
+    /// @return std::pmr::memory_resource&
+    std::pmr::memory_resource &get_frame_resource() { return frame_resource; }
+
+    /// @brief Run the engine loop with a fixed simulation tick rate; rendering interpolates between ticks
+    /// @param logic: Optional Logic to run once per tick; @returns The fixed delta_time of a tick (default: std::nullopt)
+    /// @param tick_rate: Simulation ticks per second (default: 60)
+    /// @param max_catch_up_steps: Max ticks ran in a single frame, extra time is dropped (default: 5)
+    void run_fixed(std::optional<std::function<void(float)>> logic = std::nullopt, float tick_rate = 60.0f, int max_catch_up_steps = 5)
+    {
+        shader.use();
+
+        fixed_timestep timestep(tick_rate, max_catch_up_steps);
+
+        auto last_time = std::chrono::high_resolution_clock().now();
+
+        while (!screen.should_close())
+        {
+            frame_memory.reset();
+            reserve_input_frame();
+            ALLOCATION_FRAME_GUARD("game_engine::run_fixed");
+
+            auto now = std::chrono::high_resolution_clock().now();
+
+            double frame_time =
+                std::chrono::duration<double>(now - last_time).count();
+
+            last_time = now;
+
+            {
+                PROFILE_SCOPE("input");
+                update_input(static_cast<float>(frame_time));
+            }
+
+            int steps = timestep.advance(frame_time);
+
+            for (int i = 0; i < steps; ++i)
+            {
+                PROFILE_SCOPE("tick");
+
+                world_objects.store_previous_states();
+
+                if (logic)
+                    (*logic)(timestep.delta());
+
+                step_simulation(timestep.delta());
+            }
+
+            {
+                PROFILE_SCOPE("render");
+                PROFILE_GPU_SCOPE("gpu_render");
+
+                screen.clear();
+                render(timestep.alpha());
+            }
+
+            {
+                PROFILE_SCOPE("swap_buffers");
+                screen.swap_buffers();
+            }
+
+            key_handler.presented(key_handler.take_unpresented_input());
+
+            {
+                PROFILE_SCOPE("poll_events");
+                screen.poll_events();
+            }
+
+            PROFILE_GPU_FRAME_END();
+            PROFILE_FRAME_END();
+        }
+
+        screen.destroy();
+    }
+
+    /// @brief Run the engine loop with GL submission on a dedicated render thread (draws frame N while logic runs frame N + 1)
+    /// @note Only touch objects from the logic callback; GL work must go through create_new_object / apply_texture
+    /// @param logic: Optional Logic to run while in the game loop; @returns The delta_time between each frame (default: std::nullopt)
+    /// @param mode: handoff_mode::fifo keeps logic at most one frame ahead, handoff_mode::mailbox never blocks logic (default: fifo)
+    void run_threaded(std::optional<std::function<void(float)>> logic = std::nullopt, handoff_mode mode = handoff_mode::fifo)
+    {
+        handoff.reset(mode);
+
+        screen.release_context();
+        threaded = true;
+
+        std::thread render_thread([this]
+                                  { render_loop(); });
+
+        uint64_t frame = 0;
+
+        auto last_time = std::chrono::high_resolution_clock().now();
+
+        while (!screen.should_close())
+        {
+            frame_memory.reset();
+            reserve_input_frame();
+            ALLOCATION_FRAME_GUARD("game_engine::run_threaded");
+
+            auto now = std::chrono::high_resolution_clock().now();
+
+            float delta_time =
+                std::chrono::duration<float>(now - last_time).count();
+
+            last_time = now;
+
+            {
+                PROFILE_SCOPE("poll_events");
+                screen.poll_events();
+            }
+
+            {
+                PROFILE_SCOPE("input");
+                update_input(delta_time);
+            }
+
+            if (logic)
+            {
+                PROFILE_SCOPE("logic");
+                (*logic)(delta_time);
+            }
+
+            step_simulation(delta_time);
+
+            {
+                PROFILE_SCOPE("snapshot");
+                write_snapshot(handoff.begin_write(), frame++);
+            }
+
+            {
+                PROFILE_SCOPE("publish_wait");
+                handoff.publish();
+            }
+
+            PROFILE_FRAME_END();
+        }
+
+        handoff.stop();
+        render_thread.join();
+
+        threaded = false;
+        screen.make_context_current();
+
         screen.destroy();
     }
 };
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "../../rendering/particles/particle_frame.hpp"
+#include "../../rendering/lighting/light_cluster_data.hpp"
+#include "../../rendering/lighting/shadow_cascade_data.hpp"
+#include "../../rendering/views/render_view.hpp"
+
+// ======= STRUCTS =======
+
+struct draw_item
+{
+    glm::mat4 model;
+
+    unsigned int VAO;
+    int vertexCount;
+
+    unsigned int textureID;
+    bool hasTexture;
+
+    uint32_t view_mask;   // views the item is visible in
+    uint32_t shadow_mask; // shadow cascades and static passes it's drawn into (shadow_cascades::get_masks)
+};
+
+// ======= frame_snapshot =======
+
+/// @brief Immutable copy of everything the render thread needs to draw a frame
+struct frame_snapshot
+{
+    uint64_t frame = 0;
+    uint64_t input_ns = 0; // oldest input this frame consumed (keybind_handler::take_unpresented_input), 0 if none
+
+    render_view views[RENDER_VIEW_MAX]; // only the slots in view_mask are filled
+    uint32_t view_mask = 0;
+
+    int viewport_width = 0;
+    int viewport_height = 0;
+
+    std::vector<draw_item> items;
+    particle_frame particles;
+    light_cluster_data lighting;       // main view clusters, only copied while valid
+    shadow_cascade_data shadows;       // directional light and its cascades, fitted to the main view
+    std::vector<uint32_t> batch_masks; // visibility bitmask per static batch (static_batches::get_masks)
+
+    std::vector<unsigned char> occlusion_image; // occlusion buffer overlay, empty unless it's shown
+    int occlusion_width = 0;
+    int occlusion_height = 0;
+
+    /// @brief Reset the snapshot while keeping the item, particle, light and overlay capacity
+    void clear()
+    {
+        items.clear();
+        particles.clear();
+        occlusion_image.clear();
+        batch_masks.clear();
+        lighting.valid = false;
+        shadows.valid = false;
+    }
+};
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+#include <utility>
+
+#include "./frame_snapshot.hpp"
+
+// ======= ENUMS =======
+
+enum class handoff_mode
+{
+    fifo,   // logic waits until the render thread took the previous frame (max 1 frame ahead)
+    mailbox // logic never waits, the render thread always takes the newest frame
+};
+
+// ======= render_handoff =======
+
+/// @brief Triple-buffered frame_snapshot exchange + GL command queue between the logic and render thread
+class render_handoff
+{
+private:
+    frame_snapshot buffers[3];
+
+    int write_index = 0;
+    int ready_index = 1;
+    int read_index = 2;
+
+    bool has_new = false;
+    bool stopping = false;
+
+    handoff_mode mode;
+
+    std::vector<std::function<void()>> commands;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+
+public:
+    // ======= CONSTRUCTOR =======
+
+    /// @brief Constructor for render_handoff
+    /// @param handoff: How the logic thread hands frames over (default: handoff_mode::fifo)
+    render_handoff(handoff_mode handoff = handoff_mode::fifo) : mode(handoff) {}
+
+    // ======= LOGIC THREAD =======
+
+    /// @brief Get the snapshot the logic thread is allowed to write into
+    /// @return frame_snapshot&
+    frame_snapshot &begin_write() { return buffers[write_index]; }
+
+    /// @brief Publish the snapshot returned by begin_write() to the render thread
+    void publish()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        if (mode == handoff_mode::fifo)
+            cv.wait(lock, [this]
+                    { return !has_new || stopping; });
+
+        std::swap(write_index, ready_index);
+        has_new = true;
+
+        cv.notify_all();
+    }
+
+    /// @brief Run a function on the render thread (which owns the GL context) and wait for its result
+    /// @tparam Function
+    /// @param function
+    /// @return The value returned by function
+    template <typename Function>
+    auto run_on_render_thread(Function &&function) -> decltype(function())
+    {
+        using result_t = decltype(function());
+
+        auto task = std::make_shared<std::packaged_task<result_t()>>(std::forward<Function>(function));
+        std::future<result_t> result = task->get_future();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            commands.emplace_back([task]
+                                  { (*task)(); });
+        }
+
+        cv.notify_all();
+
+        return result.get();
+    }
+
+    /// @brief Tell the render thread to finish
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+
+        cv.notify_all();
+    }
+
+    // ======= RENDER THREAD =======
+
+    /// @brief Wait for a new frame or pending GL commands
+    /// @param pending: Receives the queued GL commands
+    /// @return const frame_snapshot* || nullptr if only commands are pending; sets running to false once stopped
+    const frame_snapshot *acquire(std::vector<std::function<void()>> &pending, bool &running)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        cv.wait(lock, [this]
+                { return has_new || !commands.empty() || stopping; });
+
+        pending.swap(commands);
+
+        running = !stopping;
+
+        if (!has_new)
+            return nullptr;
+
+        std::swap(read_index, ready_index);
+        has_new = false;
+
+        cv.notify_all();
+
+        return &buffers[read_index];
+    }
+
+    // ======= UTILITY API =======
+
+    /// @brief Reset the handoff so it can be reused for another run
+    /// @param handoff: How the logic thread hands frames over
+    void reset(handoff_mode handoff)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        mode = handoff;
+        has_new = false;
+        stopping = false;
+        commands.clear();
+    }
+};
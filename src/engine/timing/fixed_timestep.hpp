@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cmath>
+
+// ======= fixed_timestep =======
+
+class fixed_timestep
+{
+private:
+    double step;
+    double accumulator = 0.0;
+
+    int max_steps;
+
+public:
+    // ======= CONSTRUCTOR =======
+
+    /// @brief Constructor for fixed_timestep
+    /// @param tick_rate: Simulation ticks per second (default: 60)
+    /// @param max_catch_up_steps: Max ticks ran in a single frame before time is dropped (default: 5)
+    fixed_timestep(float tick_rate = 60.0f, int max_catch_up_steps = 5)
+        : step(1.0 / (tick_rate > 0.0f ? tick_rate : 60.0f)),
+          max_steps(max_catch_up_steps > 0 ? max_catch_up_steps : 1) {}
+
+    // ======= MAIN API =======
+
+    /// @brief Feed the time of the last frame into the accumulator
+    /// @param frame_time: Real time elapsed since the last frame (seconds)
+    /// @return int: How many fixed ticks should run this frame
+    int advance(double frame_time)
+    {
+        if (frame_time > 0.0 && std::isfinite(frame_time))
+            accumulator += frame_time;
+
+        int steps = static_cast<int>(accumulator / step);
+
+        if (steps >= max_steps)
+        {
+            // ======= spiral of death guard: drop whatever we can't catch up on =======
+
+            steps = max_steps;
+            accumulator = std::fmod(accumulator, step);
+        }
+        else
+        {
+            accumulator -= steps * step;
+        }
+
+        return steps;
+    }
+
+    /// @brief Reset the accumulator (e.g. after a long stall or a scene load)
+    void reset() { accumulator = 0.0; }
+
+    // ======= UTILITY API =======
+
+    /// @brief Interpolation factor between the previous and current simulation state
+    /// @return float: [0, 1)
+    float alpha() const { return static_cast<float>(accumulator / step); }
+
+    /// @brief Get the fixed delta time of a single tick
+    /// @return float
+    float delta() const { return static_cast<float>(step); }
+
+    /// @brief Get the max amount of ticks per frame
+    /// @return int
+    int get_max_steps() const { return max_steps; }
+};
@@ -0,0 +1,1150 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <tuple>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "./entity_allocator.hpp"
+
+// ======= MACROS =======
+
+#define ECS_MAX_COMPONENTS 128
+#define ECS_CHUNK_BYTES (16 * 1024)
+
+// ======= TYPES =======
+
+using component_id = uint32_t;
+using component_mask = std::bitset<ECS_MAX_COMPONENTS>;
+
+// ======= STRUCTS =======
+
+struct component_type_info
+{
+    component_id id;
+
+    size_t size;
+    size_t align;
+
+    std::string name;
+
+    uint64_t schema_hash; // name + layout + component_schema<T>::version, checked when loading snapshots
+};
+
+// ======= component_schema =======
+
+/// @brief Specialise and bump version whenever the layout of a component changes meaning, so old snapshots are rejected
+/// @tparam T
+template <typename T>
+struct component_schema
+{
+    static constexpr uint32_t version = 0;
+};
+
+// ======= component_registry =======
+
+class component_registry
+{
+private:
+    /// @brief Register a new component type
+    /// @tparam T
+    /// @return component_id
+    template <typename T>
+    static component_id register_type()
+    {
+        std::vector<component_type_info> &list = types();
+
+        if (list.size() >= ECS_MAX_COMPONENTS)
+            throw std::runtime_error("component_registry: Too many component types (raise ECS_MAX_COMPONENTS)");
+
+        component_id id = static_cast<component_id>(list.size());
+        list.push_back({id, sizeof(T), alignof(T), typeid(T).name(), schema_hash(typeid(T).name(), sizeof(T), alignof(T), component_schema<T>::version)});
+
+        return id;
+    }
+
+    /// @brief FNV-1a over a type's name, size, alignment and schema version
+    static uint64_t schema_hash(const std::string &name, size_t size, size_t align, uint32_t version)
+    {
+        uint64_t hash = 14695981039346656037ull;
+
+        auto mix = [&hash](uint64_t value)
+        {
+            hash ^= value;
+            hash *= 1099511628211ull;
+        };
+
+        for (unsigned char c : name)
+            mix(c);
+
+        mix(size);
+        mix(align);
+        mix(version);
+
+        return hash;
+    }
+
+public:
+    /// @brief Every registered component type, indexed by component_id
+    /// @return std::vector<component_type_info>&
+    static std::vector<component_type_info> &types()
+    {
+        static std::vector<component_type_info> list;
+        return list;
+    }
+
+    /// @brief Get the ID of a component type (registers it on first use)
+    /// @tparam T: Plain component type (trivially copyable, no virtuals)
+    /// @return component_id
+    template <typename T>
+    static component_id id()
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "archetype components must be plain (trivially copyable) types");
+        static_assert(!std::is_polymorphic<T>::value, "archetype components can not be virtual");
+
+        static const component_id value = register_type<T>();
+        return value;
+    }
+
+    /// @brief Get the info of a registered type
+    /// @param id
+    /// @return const component_type_info&
+    static const component_type_info &info(component_id id) { return types()[id]; }
+
+    /// @brief Find a registered type by name
+    /// @param name
+    /// @return component_id: UINT32_MAX if no type with that name was registered in this process
+    static component_id find(const std::string &name)
+    {
+        for (const component_type_info &info : types())
+        {
+            if (info.name == name)
+                return info.id;
+        }
+
+        return UINT32_MAX;
+    }
+};
+
+// ======= archetype =======
+
+/// @brief All entities sharing one component signature, stored as SoA columns inside fixed-size chunks
+class archetype
+{
+public:
+    struct column
+    {
+        component_id id;
+
+        size_t size;
+        size_t offset; // byte offset of the column inside a chunk
+    };
+
+    struct chunk_deleter
+    {
+        void operator()(unsigned char *ptr) const { ::operator delete(ptr, std::align_val_t(64)); }
+    };
+
+    struct chunk
+    {
+        std::unique_ptr<unsigned char, chunk_deleter> data;
+
+        std::vector<uint32_t> added_ticks;   // per column: last tick a row of this chunk gained the component
+        std::vector<uint32_t> changed_ticks; // per column: last tick the column was written (or added)
+
+        uint32_t count = 0;
+    };
+
+private:
+    component_mask mask;
+
+    std::vector<component_id> component_types;
+    std::vector<column> columns;
+
+    std::vector<int> column_lookup; // component_id -> column index, -1 if absent
+
+    std::vector<chunk> chunks;
+
+    uint32_t chunk_capacity = 1;
+    uint32_t row_count = 0;
+
+    size_t chunk_bytes = 64;
+
+private:
+    /// @brief Align a value up
+    static size_t align_up(size_t value, size_t align) { return (value + align - 1) & ~(align - 1); }
+
+    /// @brief Append an empty chunk
+    void allocate_chunk()
+    {
+        chunk fresh;
+        fresh.data.reset(static_cast<unsigned char *>(::operator new(chunk_bytes, std::align_val_t(64))));
+        fresh.added_ticks.assign(columns.size(), 0);
+        fresh.changed_ticks.assign(columns.size(), 0);
+
+        chunks.push_back(std::move(fresh));
+    }
+
+    /// @brief Compute column offsets for a given capacity
+    /// @return size_t: Bytes needed
+    size_t layout(uint32_t capacity)
+    {
+        size_t offset = sizeof(entity) * capacity;
+
+        for (column &col : columns)
+        {
+            offset = align_up(offset, component_registry::info(col.id).align);
+            col.offset = offset;
+            offset += col.size * capacity;
+        }
+
+        return offset;
+    }
+
+public:
+    std::vector<uint32_t> add_edges;    // component_id -> archetype index (UINT32_MAX if unknown)
+    std::vector<uint32_t> remove_edges; // component_id -> archetype index (UINT32_MAX if unknown)
+
+    // ======= CONSTRUCTOR =======
+
+    /// @brief Constructor for archetype
+    /// @param types: Sorted component IDs of the signature
+    explicit archetype(const std::vector<component_id> &types)
+        : component_types(types),
+          column_lookup(ECS_MAX_COMPONENTS, -1),
+          add_edges(ECS_MAX_COMPONENTS, UINT32_MAX),
+          remove_edges(ECS_MAX_COMPONENTS, UINT32_MAX)
+    {
+        size_t row_size = sizeof(entity);
+
+        for (component_id id : component_types)
+        {
+            const component_type_info &info = component_registry::info(id);
+
+            mask.set(id);
+            column_lookup[id] = static_cast<int>(columns.size());
+            columns.push_back({id, info.size, 0});
+
+            row_size += info.size;
+        }
+
+        chunk_capacity = static_cast<uint32_t>(ECS_CHUNK_BYTES / row_size);
+
+        if (chunk_capacity == 0)
+            chunk_capacity = 1;
+
+        while (chunk_capacity > 1 && layout(chunk_capacity) > ECS_CHUNK_BYTES)
+            --chunk_capacity;
+
+        chunk_bytes = std::max<size_t>(layout(chunk_capacity), 64);
+    }
+
+    // ======= ROWS =======
+
+    /// @brief Append an uninitialised row
+    /// @param owner: The entity stored in the row
+    /// @return uint32_t: Row index
+    uint32_t push_row(entity owner)
+    {
+        uint32_t chunk_index = row_count / chunk_capacity;
+
+        if (chunk_index == chunks.size())
+            allocate_chunk();
+
+        chunk &target = chunks[chunk_index];
+        reinterpret_cast<entity *>(target.data.get())[target.count++] = owner;
+
+        return row_count++;
+    }
+
+    /// @brief Append many rows at once, copying whole column runs per chunk
+    /// @param owners: count entities
+    /// @param sources: Per column (same order as get_columns()), count packed components
+    /// @param count
+    /// @param tick: Stamped as added/changed on every touched chunk
+    void append_rows(const entity *owners, const std::vector<const unsigned char *> &sources, uint32_t count, uint32_t tick)
+    {
+        uint32_t done = 0;
+
+        while (done < count)
+        {
+            uint32_t chunk_index = row_count / chunk_capacity;
+
+            if (chunk_index == chunks.size())
+                allocate_chunk();
+
+            chunk &target = chunks[chunk_index];
+            uint32_t run = std::min(count - done, chunk_capacity - target.count);
+
+            std::memcpy(reinterpret_cast<entity *>(target.data.get()) + target.count, owners + done, sizeof(entity) * run);
+
+            for (size_t c = 0; c < columns.size(); ++c)
+            {
+                const column &col = columns[c];
+
+                std::memcpy(target.data.get() + col.offset + col.size * target.count, sources[c] + col.size * done, col.size * run);
+
+                target.added_ticks[c] = std::max(target.added_ticks[c], tick);
+                target.changed_ticks[c] = std::max(target.changed_ticks[c], tick);
+            }
+
+            target.count += run;
+            row_count += run;
+            done += run;
+        }
+    }
+
+    /// @brief Remove a row by moving the last row into it
+    /// @param row
+    /// @return entity: The entity that was moved into row (null_entity if row was the last one)
+    entity remove_row(uint32_t row)
+    {
+        uint32_t last = row_count - 1;
+        entity moved = null_entity;
+
+        if (row != last)
+        {
+            unsigned char *dst = chunks[row / chunk_capacity].data.get();
+            unsigned char *src = chunks[last / chunk_capacity].data.get();
+
+            uint32_t dst_index = row % chunk_capacity;
+            uint32_t src_index = last % chunk_capacity;
+
+            moved = reinterpret_cast<entity *>(src)[src_index];
+            reinterpret_cast<entity *>(dst)[dst_index] = moved;
+
+            for (const column &col : columns)
+                std::memcpy(dst + col.offset + col.size * dst_index, src + col.offset + col.size * src_index, col.size);
+
+            // ======= the moved row keeps its history, so filters on its new chunk still see it =======
+
+            chunk &from = chunks[last / chunk_capacity];
+            chunk &to = chunks[row / chunk_capacity];
+
+            for (size_t c = 0; c < columns.size(); ++c)
+            {
+                to.added_ticks[c] = std::max(to.added_ticks[c], from.added_ticks[c]);
+                to.changed_ticks[c] = std::max(to.changed_ticks[c], from.changed_ticks[c]);
+            }
+        }
+
+        chunk &tail = chunks[last / chunk_capacity];
+        --tail.count;
+        --row_count;
+
+        if (tail.count == 0)
+            chunks.pop_back();
+
+        return moved;
+    }
+
+    /// @brief Pointer to a component inside a row
+    /// @param row
+    /// @param id
+    /// @return void* || nullptr if the archetype doesn't have the component
+    void *component_at(uint32_t row, component_id id)
+    {
+        int index = column_lookup[id];
+
+        if (index < 0)
+            return nullptr;
+
+        const column &col = columns[index];
+        return chunks[row / chunk_capacity].data.get() + col.offset + col.size * (row % chunk_capacity);
+    }
+
+    /// @brief Entity stored in a row
+    /// @param row
+    /// @return entity
+    entity entity_at(uint32_t row) const
+    {
+        return reinterpret_cast<const entity *>(chunks[row / chunk_capacity].data.get())[row % chunk_capacity];
+    }
+
+    // ======= CHUNK ACCESS =======
+
+    /// @brief Start of a component column inside a chunk
+    /// @param chunk_index
+    /// @param id
+    /// @return void* || nullptr if the archetype doesn't have the component
+    void *column_data(size_t chunk_index, component_id id)
+    {
+        int index = column_lookup[id];
+
+        if (index < 0)
+            return nullptr;
+
+        return chunks[chunk_index].data.get() + columns[index].offset;
+    }
+
+    /// @brief Entity column of a chunk
+    /// @param chunk_index
+    /// @return entity*
+    entity *entities(size_t chunk_index) { return reinterpret_cast<entity *>(chunks[chunk_index].data.get()); }
+
+    // ======= CHANGE TICKS =======
+
+    /// @brief Mark a column of a chunk as written
+    /// @param chunk_index
+    /// @param id
+    /// @param tick
+    void mark_changed(size_t chunk_index, component_id id, uint32_t tick)
+    {
+        int index = column_lookup[id];
+
+        if (index >= 0)
+            chunks[chunk_index].changed_ticks[index] = std::max(chunks[chunk_index].changed_ticks[index], tick);
+    }
+
+    /// @brief Mark a component of a row as newly added (which also counts as changed)
+    /// @param row
+    /// @param id
+    /// @param tick
+    void mark_added(uint32_t row, component_id id, uint32_t tick)
+    {
+        int index = column_lookup[id];
+
+        if (index < 0)
+            return;
+
+        chunk &target = chunks[row / chunk_capacity];
+
+        target.added_ticks[index] = std::max(target.added_ticks[index], tick);
+        target.changed_ticks[index] = std::max(target.changed_ticks[index], tick);
+    }
+
+    /// @brief Carry the ticks of a row in another archetype over to a row of this one (shared columns only)
+    /// @param row
+    /// @param source
+    /// @param source_row
+    void inherit_ticks(uint32_t row, const archetype &source, uint32_t source_row)
+    {
+        chunk &target = chunks[row / chunk_capacity];
+        const chunk &from = source.chunks[source_row / source.chunk_capacity];
+
+        for (size_t c = 0; c < columns.size(); ++c)
+        {
+            int index = source.column_lookup[columns[c].id];
+
+            if (index < 0)
+                continue;
+
+            target.added_ticks[c] = std::max(target.added_ticks[c], from.added_ticks[index]);
+            target.changed_ticks[c] = std::max(target.changed_ticks[c], from.changed_ticks[index]);
+        }
+    }
+
+    /// @brief If a column of a chunk was written after a tick
+    /// @param chunk_index
+    /// @param id
+    /// @param since
+    /// @return bool
+    bool changed_since(size_t chunk_index, component_id id, uint32_t since) const
+    {
+        int index = column_lookup[id];
+        return index >= 0 && chunks[chunk_index].changed_ticks[index] > since;
+    }
+
+    /// @brief If a row of a chunk gained a component after a tick
+    /// @param chunk_index
+    /// @param id
+    /// @param since
+    /// @return bool
+    bool added_since(size_t chunk_index, component_id id, uint32_t since) const
+    {
+        int index = column_lookup[id];
+        return index >= 0 && chunks[chunk_index].added_ticks[index] > since;
+    }
+
+    // ======= UTILITY API =======
+
+    bool has(component_id id) const { return mask.test(id); }
+
+    const component_mask &get_mask() const { return mask; }
+    const std::vector<component_id> &get_types() const { return component_types; }
+    const std::vector<column> &get_columns() const { return columns; }
+
+    std::vector<chunk> &get_chunks() { return chunks; }
+    size_t chunk_count() const { return chunks.size(); }
+    uint32_t get_chunk_capacity() const { return chunk_capacity; }
+    uint32_t size() const { return row_count; }
+};
+
+// ======= QUERY FILTERS =======
+
+/// @brief Matches every chunk
+struct no_filter
+{
+    static void require(component_mask &) {}
+    static bool passes(const archetype &, size_t, uint32_t) { return true; }
+};
+
+/// @brief Matches chunks where any of Ts was written after the given tick
+template <typename... Ts>
+struct changed
+{
+    static void require(component_mask &mask) { (mask.set(component_registry::id<Ts>()), ...); }
+
+    static bool passes(const archetype &arch, size_t chunk_index, uint32_t since)
+    {
+        return (arch.changed_since(chunk_index, component_registry::id<Ts>(), since) || ...);
+    }
+};
+
+/// @brief Matches chunks where a row gained any of Ts after the given tick
+template <typename... Ts>
+struct added
+{
+    static void require(component_mask &mask) { (mask.set(component_registry::id<Ts>()), ...); }
+
+    static bool passes(const archetype &arch, size_t chunk_index, uint32_t since)
+    {
+        return (arch.added_since(chunk_index, component_registry::id<Ts>(), since) || ...);
+    }
+};
+
+// ======= archetype_world =======
+
+/// @brief Archetype storage; every write is stamped with a tick so queries can skip chunks that didn't change
+
+class archetype_world
+{
+public:
+    struct chunk_ref
+    {
+        uint32_t archetype;
+        uint32_t chunk;
+    };
+
+private:
+    struct entity_record
+    {
+        uint32_t archetype;
+        uint32_t row;
+    };
+
+    struct removed_entry
+    {
+        entity owner;
+        uint32_t tick;
+    };
+
+    struct query_cache
+    {
+        std::vector<uint32_t> archetypes;
+        size_t checked = 0; // archetypes[0, checked) of the world were already tested
+    };
+
+    std::vector<std::unique_ptr<archetype>> archetypes;
+    std::unordered_map<component_mask, uint32_t> archetype_lookup;
+
+    entity_allocator allocator;
+    std::vector<entity_record> records; // indexed by entity_allocator::index_of
+
+    std::unordered_map<component_mask, query_cache> queries;
+
+    std::vector<std::vector<removed_entry>> removed_log; // indexed by component_id
+
+    std::atomic<uint32_t> tick{1};
+
+private:
+    /// @brief Find or create the archetype for a signature
+    /// @param types: Sorted component IDs
+    /// @return uint32_t: Archetype index
+    uint32_t find_or_create(const std::vector<component_id> &types)
+    {
+        component_mask mask;
+
+        for (component_id id : types)
+            mask.set(id);
+
+        auto it = archetype_lookup.find(mask);
+
+        if (it != archetype_lookup.end())
+            return it->second;
+
+        uint32_t index = static_cast<uint32_t>(archetypes.size());
+
+        archetypes.push_back(std::make_unique<archetype>(types));
+        archetype_lookup.emplace(mask, index);
+
+        return index;
+    }
+
+    /// @brief Archetype reached by adding (or removing) one component
+    /// @param from: Source archetype index
+    /// @param id: Component to toggle
+    /// @param add: true to add, false to remove
+    /// @return uint32_t: Target archetype index
+    uint32_t traverse(uint32_t from, component_id id, bool add)
+    {
+        std::vector<uint32_t> &edges = add ? archetypes[from]->add_edges : archetypes[from]->remove_edges;
+
+        if (edges[id] != UINT32_MAX)
+            return edges[id];
+
+        std::vector<component_id> types = archetypes[from]->get_types();
+
+        if (add)
+        {
+            types.insert(std::lower_bound(types.begin(), types.end(), id), id);
+        }
+        else
+        {
+            types.erase(std::lower_bound(types.begin(), types.end(), id));
+        }
+
+        uint32_t target = find_or_create(types);
+
+        edges[id] = target;
+        (add ? archetypes[target]->remove_edges : archetypes[target]->add_edges)[id] = from;
+
+        return target;
+    }
+
+    /// @brief Move an entity to another archetype, copying every shared component
+    /// @param e
+    /// @param target: Target archetype index
+    /// @return uint32_t: New row
+    uint32_t move_entity(entity e, uint32_t target)
+    {
+        entity_record &record = records[entity_allocator::index_of(e)];
+
+        archetype &src = *archetypes[record.archetype];
+        archetype &dst = *archetypes[target];
+
+        uint32_t new_row = dst.push_row(e);
+
+        for (const archetype::column &col : src.get_columns())
+        {
+            if (void *to = dst.component_at(new_row, col.id))
+                std::memcpy(to, src.component_at(record.row, col.id), col.size);
+        }
+
+        dst.inherit_ticks(new_row, src, record.row);
+
+        entity moved = src.remove_row(record.row);
+
+        if (moved != null_entity)
+            records[entity_allocator::index_of(moved)].row = record.row;
+
+        record.archetype = target;
+        record.row = new_row;
+
+        return new_row;
+    }
+
+    /// @brief Get (and extend) the list of archetypes matching a mask
+    /// @param required
+    /// @return const std::vector<uint32_t>&
+    const std::vector<uint32_t> &matching(const component_mask &required)
+    {
+        // ======= read-only fast path: lets scheduled systems query concurrently once the cache is warm =======
+
+        auto it = queries.find(required);
+
+        if (it != queries.end() && it->second.checked == archetypes.size())
+            return it->second.archetypes;
+
+        query_cache &cache = it != queries.end() ? it->second : queries[required];
+
+        for (; cache.checked < archetypes.size(); ++cache.checked)
+        {
+            if ((archetypes[cache.checked]->get_mask() & required) == required)
+                cache.archetypes.push_back(static_cast<uint32_t>(cache.checked));
+        }
+
+        return cache.archetypes;
+    }
+
+    /// @brief Allocate an entity handle and make room for its record
+    /// @return entity
+    entity allocate()
+    {
+        entity e = allocator.create();
+
+        if (allocator.capacity() > records.size())
+            records.resize(allocator.capacity(), {0, 0});
+
+        return e;
+    }
+
+    /// @brief Remember that an entity lost a component
+    /// @param e
+    /// @param id
+    void log_removed(entity e, component_id id)
+    {
+        if (id >= removed_log.size())
+            removed_log.resize(id + 1);
+
+        removed_log[id].push_back({e, get_tick()});
+    }
+
+    /// @brief Visit every matching chunk that passes Filter, stamping written (non-const) columns with write_tick
+    template <typename Filter, typename... Ts, typename Function>
+    void visit_chunks(uint32_t since, uint32_t write_tick, Function &function)
+    {
+        component_mask required = mask_of<Ts...>();
+        Filter::require(required);
+
+        for (uint32_t index : matching(required))
+        {
+            archetype &arch = *archetypes[index];
+
+            for (size_t c = 0; c < arch.chunk_count(); ++c)
+            {
+                if (!Filter::passes(arch, c, since))
+                    continue;
+
+                (mark_write<Ts>(arch, c, write_tick), ...);
+
+                function(arch.get_chunks()[c].count,
+                         arch.entities(c),
+                         static_cast<Ts *>(arch.column_data(c, component_registry::id<std::remove_const_t<Ts>>()))...);
+            }
+        }
+    }
+
+    /// @brief Stamp a column as changed unless it is only read
+    template <typename T>
+    static void mark_write(archetype &arch, size_t chunk_index, uint32_t write_tick)
+    {
+        if constexpr (!std::is_const<T>::value)
+            arch.mark_changed(chunk_index, component_registry::id<T>(), write_tick);
+    }
+
+    /// @brief Invoke a function on row i of a chunk
+    template <typename Function, typename... Ts, size_t... I>
+    static void invoke_row(Function &function, entity owner, std::tuple<Ts *...> &cols, uint32_t i, std::index_sequence<I...>)
+    {
+        if constexpr (std::is_invocable<Function &, entity, Ts &...>::value)
+            function(owner, std::get<I>(cols)[i]...);
+        else
+            function(std::get<I>(cols)[i]...);
+    }
+
+public:
+    // ======= CONSTRUCTOR =======
+
+    /// @brief Constructor for archetype_world
+    archetype_world()
+    {
+        find_or_create({}); // archetype 0: entities without components
+    }
+
+    // ======= ENTITY =======
+
+    /// @brief Create an entity without components
+    /// @return entity
+    entity create_entity()
+    {
+        entity e = allocate();
+
+        records[entity_allocator::index_of(e)] = {0, archetypes[0]->push_row(e)};
+
+        return e;
+    }
+
+    /// @brief Create an entity directly inside the archetype of its components (no intermediate moves)
+    /// @tparam ...Ts
+    /// @param ...components
+    /// @return entity
+    template <typename... Ts>
+    entity create_entity_with(const Ts &...components)
+    {
+        std::vector<component_id> types = {component_registry::id<Ts>()...};
+        std::sort(types.begin(), types.end());
+
+        uint32_t target = find_or_create(types);
+
+        entity e = allocate();
+        uint32_t row = archetypes[target]->push_row(e);
+
+        records[entity_allocator::index_of(e)] = {target, row};
+
+        (std::memcpy(archetypes[target]->component_at(row, component_registry::id<Ts>()), &components, sizeof(Ts)), ...);
+        (archetypes[target]->mark_added(row, component_registry::id<Ts>(), get_tick()), ...);
+
+        return e;
+    }
+
+    /// @brief Destroy an entity and its components; its handle becomes stale
+    /// @param e
+    void destroy_entity(entity e)
+    {
+        if (!alive(e))
+            return;
+
+        entity_record &record = records[entity_allocator::index_of(e)];
+
+        for (component_id id : archetypes[record.archetype]->get_types())
+            log_removed(e, id);
+
+        entity moved = archetypes[record.archetype]->remove_row(record.row);
+
+        if (moved != null_entity)
+            records[entity_allocator::index_of(moved)].row = record.row;
+
+        allocator.destroy(e);
+    }
+
+    /// @brief If a handle still refers to a live entity
+    /// @param e
+    /// @return bool
+    bool alive(entity e) const
+    {
+        return allocator.alive(e);
+    }
+
+    // ======= COMPONENTS =======
+
+    /// @brief Add (or overwrite) a component, moving the entity to its new archetype
+    /// @tparam T
+    /// @param e
+    /// @param value
+    /// @return T* || nullptr if the entity is dead
+    template <typename T>
+    T *add_component(entity e, const T &value = T{})
+    {
+        if (!alive(e))
+            return nullptr;
+
+        component_id id = component_registry::id<T>();
+        entity_record &record = records[entity_allocator::index_of(e)];
+
+        if (!archetypes[record.archetype]->has(id))
+        {
+            move_entity(e, traverse(record.archetype, id, true));
+            archetypes[record.archetype]->mark_added(record.row, id, get_tick());
+        }
+        else
+        {
+            archetypes[record.archetype]->mark_changed(record.row / archetypes[record.archetype]->get_chunk_capacity(), id, get_tick());
+        }
+
+        T *slot = static_cast<T *>(archetypes[record.archetype]->component_at(record.row, id));
+        std::memcpy(static_cast<void *>(slot), &value, sizeof(T));
+
+        return slot;
+    }
+
+    /// @brief Remove a component, moving the entity to its new archetype
+    /// @tparam T
+    /// @param e
+    template <typename T>
+    void remove_component(entity e)
+    {
+        if (!alive(e))
+            return;
+
+        component_id id = component_registry::id<T>();
+        entity_record &record = records[entity_allocator::index_of(e)];
+
+        if (archetypes[record.archetype]->has(id))
+        {
+            log_removed(e, id);
+            move_entity(e, traverse(record.archetype, id, false));
+        }
+    }
+
+    /// @brief Get a component of an entity; non-const access marks its chunk as changed
+    /// @tparam T: const T for read-only access
+    /// @param e
+    /// @return T* || nullptr if the entity is dead or lacks the component
+    template <typename T>
+    T *get_component(entity e) { return get_component<T>(e, get_tick()); }
+
+    /// @brief Get a component of an entity, stamping non-const access with a given tick
+    /// @tparam T: const T for read-only access
+    /// @param e
+    /// @param write_tick
+    /// @return T* || nullptr if the entity is dead or lacks the component
+    template <typename T>
+    T *get_component(entity e, uint32_t write_tick)
+    {
+        if (!alive(e))
+            return nullptr;
+
+        const entity_record &record = records[entity_allocator::index_of(e)];
+        archetype &arch = *archetypes[record.archetype];
+
+        component_id id = component_registry::id<std::remove_const_t<T>>();
+        T *component = static_cast<T *>(arch.component_at(record.row, id));
+
+        if (component)
+            mark_write<T>(arch, record.row / arch.get_chunk_capacity(), write_tick);
+
+        return component;
+    }
+
+    /// @brief If an entity has a component
+    /// @tparam T
+    /// @param e
+    /// @return bool
+    template <typename T>
+    bool has_component(entity e) const
+    {
+        return alive(e) && archetypes[records[entity_allocator::index_of(e)].archetype]->has(component_registry::id<T>());
+    }
+
+    // ======= QUERIES =======
+
+    /// @brief Run a function for every chunk holding all of Ts
+    /// @tparam ...Ts
+    /// @tparam Function: void(uint32_t count, entity *entities, Ts *...columns)
+    /// @param function
+    template <typename... Ts, typename Function>
+    void each_chunk(Function &&function)
+    {
+        visit_chunks<no_filter, Ts...>(0, get_tick(), function);
+    }
+
+    /// @brief Run a function for every chunk holding all of Ts that passes Filter
+    /// @tparam Filter: changed<...>, added<...> or no_filter
+    /// @tparam ...Ts
+    /// @tparam Function: void(uint32_t count, entity *entities, Ts *...columns)
+    /// @param since: Only chunks touched after this tick pass
+    /// @param function
+    template <typename Filter, typename... Ts, typename Function>
+    void each_chunk_filtered(uint32_t since, Function &&function)
+    {
+        visit_chunks<Filter, Ts...>(since, get_tick(), function);
+    }
+
+    /// @brief Run a function for every entity holding all of Ts, iterating contiguous columns
+    /// @tparam ...Ts
+    /// @tparam Function: void(Ts &...) or void(entity, Ts &...)
+    /// @param function
+    template <typename... Ts, typename Function>
+    void each(Function &&function)
+    {
+        each_filtered<no_filter, Ts...>(0, std::forward<Function>(function));
+    }
+
+    /// @brief Run a function for every entity holding all of Ts inside chunks that pass Filter
+    /// @tparam Filter: changed<...>, added<...> or no_filter
+    /// @tparam ...Ts
+    /// @tparam Function: void(Ts &...) or void(entity, Ts &...)
+    /// @param since: Only chunks touched after this tick pass
+    /// @param function
+    template <typename Filter, typename... Ts, typename Function>
+    void each_filtered(uint32_t since, Function &&function)
+    {
+        auto rows = [&function](uint32_t count, entity *owners, Ts *...columns)
+        {
+            std::tuple<Ts *...> cols(columns...);
+
+            for (uint32_t i = 0; i < count; ++i)
+                invoke_row(function, owners[i], cols, i, std::index_sequence_for<Ts...>{});
+        };
+
+        visit_chunks<Filter, Ts...>(since, get_tick(), rows);
+    }
+
+    /// @brief Run a function for every entity that lost T (or was destroyed with it) after a tick
+    /// @tparam T
+    /// @tparam Function: void(entity)
+    /// @param since
+    /// @param function
+    template <typename T, typename Function>
+    void each_removed(uint32_t since, Function &&function) const
+    {
+        component_id id = component_registry::id<T>();
+
+        if (id >= removed_log.size())
+            return;
+
+        for (const removed_entry &entry : removed_log[id])
+        {
+            if (entry.tick > since)
+                function(entry.owner);
+        }
+    }
+
+    /// @brief Forget removals stamped at or before a tick
+    /// @param before
+    void trim_removed(uint32_t before)
+    {
+        for (std::vector<removed_entry> &log : removed_log)
+        {
+            log.erase(std::remove_if(log.begin(), log.end(), [before](const removed_entry &entry)
+                                     { return entry.tick <= before; }),
+                      log.end());
+        }
+    }
+
+    /// @brief Collect every chunk holding all of Ts, so they can be split across threads
+    /// @tparam ...Ts
+    /// @param out: Cleared and refilled
+    template <typename... Ts>
+    void gather_chunks(std::vector<chunk_ref> &out) { gather_chunks_filtered<no_filter, Ts...>(out, 0); }
+
+    /// @brief Collect every chunk holding all of Ts that passes Filter
+    /// @tparam Filter: changed<...>, added<...> or no_filter
+    /// @tparam ...Ts
+    /// @param out: Cleared and refilled
+    /// @param since: Only chunks touched after this tick pass
+    template <typename Filter, typename... Ts>
+    void gather_chunks_filtered(std::vector<chunk_ref> &out, uint32_t since)
+    {
+        component_mask required = mask_of<Ts...>();
+        Filter::require(required);
+
+        out.clear();
+
+        for (uint32_t index : matching(required))
+        {
+            for (size_t c = 0; c < archetypes[index]->chunk_count(); ++c)
+            {
+                if (Filter::passes(*archetypes[index], c, since))
+                    out.push_back({index, static_cast<uint32_t>(c)});
+            }
+        }
+    }
+
+    /// @brief Run a function on one chunk collected by gather_chunks, stamping written (non-const) columns
+    /// @tparam ...Ts
+    /// @tparam Function: void(uint32_t count, entity *entities, Ts *...columns)
+    /// @param ref
+    /// @param write_tick
+    /// @param function
+    template <typename... Ts, typename Function>
+    void run_chunk(const chunk_ref &ref, uint32_t write_tick, Function &&function)
+    {
+        archetype &arch = *archetypes[ref.archetype];
+
+        (mark_write<Ts>(arch, ref.chunk, write_tick), ...);
+
+        function(arch.get_chunks()[ref.chunk].count,
+                 arch.entities(ref.chunk),
+                 static_cast<Ts *>(arch.column_data(ref.chunk, component_registry::id<std::remove_const_t<Ts>>()))...);
+    }
+
+    /// @brief Warm the query cache of a mask, after which matching() is read-only until a new archetype appears
+    /// @param required
+    void prepare_query(const component_mask &required) { matching(required); }
+
+    /// @brief Count the entities holding all of Ts
+    /// @tparam ...Ts
+    /// @return size_t
+    template <typename... Ts>
+    size_t count()
+    {
+        component_mask required;
+        (required.set(component_registry::id<std::remove_const_t<Ts>>()), ...);
+
+        size_t total = 0;
+
+        for (uint32_t index : matching(required))
+            total += archetypes[index]->size();
+
+        return total;
+    }
+
+    // ======= TICKS =======
+
+    /// @brief Current change tick; writes are stamped with it
+    /// @return uint32_t
+    uint32_t get_tick() const { return tick.load(std::memory_order_acquire); }
+
+    /// @brief Start a new tick (once per frame, or once per system when scheduled)
+    /// @return uint32_t: The new tick
+    uint32_t advance_tick() { return tick.fetch_add(1, std::memory_order_acq_rel) + 1; }
+
+    // ======= UTILITY API =======
+
+    /// @brief Component mask of a set of types
+    /// @tparam ...Ts
+    /// @return component_mask
+    template <typename... Ts>
+    static component_mask mask_of()
+    {
+        component_mask mask;
+        (mask.set(component_registry::id<std::remove_const_t<Ts>>()), ...);
+
+        return mask;
+    }
+
+    /// @brief Amount of live entities
+    /// @return size_t
+    size_t entity_count() const { return allocator.size(); }
+
+    /// @brief Amount of archetypes
+    /// @return size_t
+    size_t archetype_count() const { return archetypes.size(); }
+
+    /// @brief Find or create the archetype of a signature
+    /// @param types: Component IDs in any order
+    /// @return uint32_t: Archetype index
+    uint32_t get_or_create_archetype(std::vector<component_id> types)
+    {
+        std::sort(types.begin(), types.end());
+        return find_or_create(types);
+    }
+
+    /// @brief The entity allocator (read-only)
+    /// @return const entity_allocator&
+    const entity_allocator &get_allocator() const { return allocator; }
+
+    /// @brief Restore allocator state after rows were bulk-appended, then rebuild every entity record from the archetypes
+    /// @param generation_data
+    /// @param generation_count
+    /// @param free_data
+    /// @param free_count
+    void restore_entities(const uint8_t *generation_data, size_t generation_count, const uint32_t *free_data, size_t free_count)
+    {
+        allocator.restore(generation_data, generation_count, free_data, free_count);
+        records.assign(generation_count, {0, 0});
+
+        size_t rows = 0;
+
+        for (uint32_t a = 0; a < archetypes.size(); ++a)
+        {
+            archetype &arch = *archetypes[a];
+
+            for (uint32_t row = 0; row < arch.size(); ++row)
+            {
+                entity e = arch.entity_at(row);
+
+                if (!allocator.alive(e))
+                    throw std::runtime_error("archetype_world: Restored row references a dead entity");
+
+                records[entity_allocator::index_of(e)] = {a, row};
+            }
+
+            rows += arch.size();
+        }
+
+        if (rows != allocator.size())
+            throw std::runtime_error("archetype_world: Restored rows don't match the live entity count");
+    }
+
+    /// @brief Get an archetype by index
+    /// @param index
+    /// @return archetype&
+    archetype &get_archetype(size_t index) { return *archetypes[index]; }
+
+    /// @brief Destroy every entity and archetype
+    void clear()
+    {
+        archetypes.clear();
+        archetype_lookup.clear();
+        records.clear();
+        allocator.clear();
+        queries.clear();
+        removed_log.clear();
+
+        find_or_create({}); // tick keeps counting so systems' last-run ticks stay valid
+    }
+};
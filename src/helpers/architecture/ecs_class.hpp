@@ -7,12 +7,30 @@
 #include <memory>
 #include <functional>
 
+#include "./entity_allocator.hpp"
+
+#include "../memory/pool_allocator.hpp"
+
 // ====== STRUCTS ======
 
 struct IComponent
 {
     IComponent() = default;
     virtual ~IComponent() = default;
+
+    // ====== ALLOCATION ======
+
+    /// @brief Components come from size-class pools instead of the general heap
+    static void *operator new(size_t size) { return size_class_pool::components().allocate(size); }
+
+    /// @brief Sized delete; the virtual destructor passes the size of the most-derived component
+    static void operator delete(void *ptr, size_t size) { size_class_pool::components().deallocate(ptr, size); }
+
+    static void *operator new(size_t size, std::align_val_t align) { return ::operator new(size, align); }
+    static void operator delete(void *ptr, size_t, std::align_val_t align) { ::operator delete(ptr, align); }
+
+    static void *operator new(size_t, void *where) { return where; }
+    static void operator delete(void *, void *) {}
 };
 
 // ====== ECS_Instance ======
@@ -103,18 +121,18 @@ struct ECS_Instance
 class ecs_class
 {
 public:
-    static int current_id;
+    static entity_allocator allocator;
 
-    static std::unordered_map<int, ECS_Instance> ecs_storage;
+    static std::unordered_map<entity, ECS_Instance> ecs_storage;
 
 public:
     // ====== ENTITY ======
 
     /// @brief Creates a new entity
-    /// @return int: The entity ID
-    static int create_entity()
+    /// @return entity: 32-bit generational ID (destroyed IDs are recycled with a new generation)
+    static entity create_entity()
     {
-        int id = current_id++;
+        entity id = allocator.create();
         ecs_storage.emplace(id, ECS_Instance{});
         return id;
     }
@@ -122,16 +140,25 @@ public:
     /// @brief Return all data related to the entity
     /// @param id
     /// @return ECS_Instance
-    static ECS_Instance &get_entity(int id)
+    static ECS_Instance &get_entity(entity id)
     {
         return ecs_storage.at(id);
     }
 
+    /// @brief If an ID still refers to a live entity
+    /// @param id
+    /// @return bool
+    static bool is_alive(entity id)
+    {
+        return allocator.alive(id);
+    }
+
     /// @brief Removes a specific entity
     /// @param id
-    static void remove_entity(int id)
+    static void remove_entity(entity id)
     {
-        ecs_storage.erase(id);
+        if (allocator.destroy(id))
+            ecs_storage.erase(id);
     }
 
     // ====== SYSTEMS ======
@@ -159,5 +186,5 @@ public:
     }
 };
 
-int ecs_class::current_id = 0;
-std::unordered_map<int, ECS_Instance> ecs_class::ecs_storage;
\ No newline at end of file
+entity_allocator ecs_class::allocator;
+std::unordered_map<entity, ECS_Instance> ecs_class::ecs_storage;
\ No newline at end of file
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <stdexcept>
+#include <vector>
+
+// ======= TYPES =======
+
+/// @brief Entity handle: low 24 bits index, high 8 bits generation
+using entity = uint32_t;
+
+constexpr entity null_entity = 0xFFFFFFFFu;
+
+// ======= entity_allocator =======
+
+/// @brief Hands out 32-bit generational entity IDs and recycles destroyed indices
+class entity_allocator
+{
+public:
+    static constexpr uint32_t index_bits = 24;
+    static constexpr uint32_t index_mask = (1u << index_bits) - 1;
+    static constexpr uint32_t generation_mask = 0xFFu;
+
+    // ======= indices are only recycled once this many are free, so 8-bit generations wrap slowly =======
+
+    static constexpr size_t minimum_free_indices = 1024;
+
+private:
+    std::vector<uint8_t> generations;
+    std::deque<uint32_t> free_indices;
+
+    size_t alive_count = 0;
+
+public:
+    // ======= STATIC HELPERS =======
+
+    /// @brief Index part of a handle
+    /// @param e
+    /// @return uint32_t
+    static uint32_t index_of(entity e) { return e & index_mask; }
+
+    /// @brief Generation part of a handle
+    /// @param e
+    /// @return uint32_t
+    static uint32_t generation_of(entity e) { return e >> index_bits; }
+
+    /// @brief Build a handle
+    /// @param index
+    /// @param generation
+    /// @return entity
+    static entity make(uint32_t index, uint32_t generation) { return index | ((generation & generation_mask) << index_bits); }
+
+    // ======= MAIN API =======
+
+    /// @brief Allocate a new entity handle
+    /// @return entity
+    entity create()
+    {
+        uint32_t index;
+
+        if (free_indices.size() > minimum_free_indices)
+        {
+            index = free_indices.front();
+            free_indices.pop_front();
+        }
+        else
+        {
+            index = static_cast<uint32_t>(generations.size());
+
+            // ======= index_mask itself is reserved so null_entity never becomes a valid handle =======
+
+            if (index >= index_mask)
+                throw std::runtime_error("entity_allocator: Out of entity indices");
+
+            generations.push_back(0);
+        }
+
+        ++alive_count;
+
+        return make(index, generations[index]);
+    }
+
+    /// @brief Release a handle; every copy of it becomes stale
+    /// @param e
+    /// @return bool: false if the handle was already stale
+    bool destroy(entity e)
+    {
+        if (!alive(e))
+            return false;
+
+        uint32_t index = index_of(e);
+
+        generations[index] = static_cast<uint8_t>(generations[index] + 1);
+        free_indices.push_back(index);
+
+        --alive_count;
+
+        return true;
+    }
+
+    /// @brief If a handle still refers to a live entity
+    /// @param e
+    /// @return bool
+    bool alive(entity e) const
+    {
+        uint32_t index = index_of(e);
+
+        return e != null_entity && index < generations.size() && generations[index] == generation_of(e);
+    }
+
+    /// @brief Forget every entity
+    void clear()
+    {
+        generations.clear();
+        free_indices.clear();
+        alive_count = 0;
+    }
+
+    // ======= UTILITY API =======
+
+    /// @brief Amount of live entities
+    /// @return size_t
+    size_t size() const { return alive_count; }
+
+    /// @brief Amount of indices ever handed out
+    /// @return size_t
+    size_t capacity() const { return generations.size(); }
+
+    // ======= SERIALIZATION =======
+
+    /// @brief Current generation of every index
+    /// @return const std::vector<uint8_t>&
+    const std::vector<uint8_t> &get_generations() const { return generations; }
+
+    /// @brief Indices waiting to be recycled, oldest first
+    /// @return const std::deque<uint32_t>&
+    const std::deque<uint32_t> &get_free_indices() const { return free_indices; }
+
+    /// @brief Replace the whole allocator state (e.g. when loading a snapshot)
+    /// @param generation_data: One generation per index
+    /// @param generation_count
+    /// @param free_data: Free indices, oldest first
+    /// @param free_count
+    void restore(const uint8_t *generation_data, size_t generation_count, const uint32_t *free_data, size_t free_count)
+    {
+        if (free_count > generation_count || generation_count >= index_mask)
+            throw std::runtime_error("entity_allocator: Invalid allocator state");
+
+        generations.assign(generation_data, generation_data + generation_count);
+        free_indices.assign(free_data, free_data + free_count);
+
+        alive_count = generation_count - free_count;
+    }
+};
@@ -0,0 +1,377 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "./entity_allocator.hpp"
+
+// ======= MACROS =======
+
+#define SPARSE_PAGE_SIZE 4096
+
+// ======= pool_base =======
+
+/// @brief Type-erased part of a component_pool, lets the registry drop an entity from every pool
+class pool_base
+{
+public:
+    virtual ~pool_base() = default;
+
+    virtual bool contains(entity e) const = 0;
+    virtual void remove(entity e) = 0;
+    virtual void clear() = 0;
+    virtual size_t size() const = 0;
+};
+
+// ======= component_pool =======
+
+/// @brief Sparse set of one component type: dense components + dense entities + paged sparse index
+/// @tparam T
+template <typename T>
+class component_pool : public pool_base
+{
+private:
+    static constexpr uint32_t tombstone = 0xFFFFFFFFu;
+
+    std::vector<T> dense;
+    std::vector<entity> dense_entities;
+
+    std::vector<std::unique_ptr<uint32_t[]>> sparse_pages;
+
+private:
+    /// @brief Sparse slot of an entity, creating its page if needed
+    /// @param e
+    /// @return uint32_t&
+    uint32_t &sparse_slot(entity e)
+    {
+        uint32_t index = entity_allocator::index_of(e);
+        size_t page = index / SPARSE_PAGE_SIZE;
+
+        if (page >= sparse_pages.size())
+            sparse_pages.resize(page + 1);
+
+        if (!sparse_pages[page])
+        {
+            sparse_pages[page].reset(new uint32_t[SPARSE_PAGE_SIZE]);
+            std::fill_n(sparse_pages[page].get(), SPARSE_PAGE_SIZE, tombstone);
+        }
+
+        return sparse_pages[page][index % SPARSE_PAGE_SIZE];
+    }
+
+    /// @brief Dense position of an entity
+    /// @param e
+    /// @return uint32_t: tombstone if absent
+    uint32_t dense_index(entity e) const
+    {
+        uint32_t index = entity_allocator::index_of(e);
+        size_t page = index / SPARSE_PAGE_SIZE;
+
+        if (page >= sparse_pages.size() || !sparse_pages[page])
+            return tombstone;
+
+        uint32_t slot = sparse_pages[page][index % SPARSE_PAGE_SIZE];
+
+        // ======= full handle compare, so a recycled index with a new generation doesn't match =======
+
+        if (slot == tombstone || dense_entities[slot] != e)
+            return tombstone;
+
+        return slot;
+    }
+
+public:
+    // ======= MAIN API =======
+
+    /// @brief Add (or overwrite) the component of an entity, O(1)
+    /// @tparam ...Args
+    /// @param e
+    /// @param ...args
+    /// @return T&
+    template <typename... Args>
+    T &emplace(entity e, Args &&...args)
+    {
+        uint32_t slot = dense_index(e);
+
+        if (slot != tombstone)
+        {
+            dense[slot] = T{std::forward<Args>(args)...};
+            return dense[slot];
+        }
+
+        sparse_slot(e) = static_cast<uint32_t>(dense.size());
+
+        dense_entities.push_back(e);
+        dense.push_back(T{std::forward<Args>(args)...});
+
+        return dense.back();
+    }
+
+    /// @brief Remove the component of an entity by swapping the last element into its slot, O(1)
+    /// @param e
+    void remove(entity e) override
+    {
+        uint32_t slot = dense_index(e);
+
+        if (slot == tombstone)
+            return;
+
+        uint32_t last = static_cast<uint32_t>(dense.size() - 1);
+
+        if (slot != last)
+        {
+            dense[slot] = std::move(dense[last]);
+            dense_entities[slot] = dense_entities[last];
+
+            sparse_slot(dense_entities[slot]) = slot;
+        }
+
+        sparse_slot(e) = tombstone;
+
+        dense.pop_back();
+        dense_entities.pop_back();
+    }
+
+    /// @brief Get the component of an entity, O(1)
+    /// @param e
+    /// @return T* || nullptr
+    T *get(entity e)
+    {
+        uint32_t slot = dense_index(e);
+        return slot == tombstone ? nullptr : &dense[slot];
+    }
+
+    /// @brief If the entity has this component
+    /// @param e
+    /// @return bool
+    bool contains(entity e) const override { return dense_index(e) != tombstone; }
+
+    /// @brief Remove every component
+    void clear() override
+    {
+        dense.clear();
+        dense_entities.clear();
+        sparse_pages.clear();
+    }
+
+    // ======= UTILITY API =======
+
+    size_t size() const override { return dense.size(); }
+
+    /// @brief Dense component array
+    /// @return std::vector<T>&
+    std::vector<T> &components() { return dense; }
+
+    /// @brief Dense entity array (same order as components())
+    /// @return const std::vector<entity>&
+    const std::vector<entity> &entities() const { return dense_entities; }
+};
+
+// ======= sparse_view =======
+
+/// @brief Iterates every entity holding all of Ts: walks the smallest pool and probes the others
+/// @tparam ...Ts
+template <typename... Ts>
+class sparse_view
+{
+private:
+    std::tuple<component_pool<Ts> *...> pools;
+
+private:
+    /// @brief Smallest pool's entity list
+    /// @return const std::vector<entity>*
+    const std::vector<entity> *smallest() const
+    {
+        const std::vector<entity> *best = nullptr;
+
+        std::apply([&best](auto *...pool)
+                   { ((best = (!best || pool->size() < best->size()) ? &pool->entities() : best), ...); },
+                   pools);
+
+        return best;
+    }
+
+public:
+    // ======= CONSTRUCTOR =======
+
+    /// @brief Constructor for sparse_view
+    /// @param ...component_pools
+    explicit sparse_view(component_pool<Ts> *...component_pools) : pools(component_pools...) {}
+
+    // ======= MAIN API =======
+
+    /// @brief Run a function for every matching entity
+    /// @tparam Function: void(Ts &...) or void(entity, Ts &...)
+    /// @param function
+    template <typename Function>
+    void each(Function &&function)
+    {
+        const std::vector<entity> *candidates = smallest();
+
+        if (!candidates)
+            return;
+
+        // ======= iterate backwards so the callback may remove the current entity =======
+
+        for (size_t i = candidates->size(); i-- > 0;)
+        {
+            if (i >= candidates->size())
+                continue;
+
+            entity e = (*candidates)[i];
+
+            // ======= one sparse probe per pool: get() is nullptr when the entity lacks the component =======
+
+            std::tuple<Ts *...> components(std::get<component_pool<Ts> *>(pools)->get(e)...);
+
+            bool all = std::apply([](auto *...component)
+                                  { return ((component != nullptr) && ...); },
+                                  components);
+
+            if (!all)
+                continue;
+
+            std::apply([&function, e](Ts *...component)
+                       {
+                           if constexpr (std::is_invocable<Function &, entity, Ts &...>::value)
+                               function(e, *component...);
+                           else
+                               function(*component...);
+                       },
+                       components);
+        }
+    }
+};
+
+// ======= sparse_registry =======
+
+/// @brief Entity registry backed by one sparse-set pool per component type
+class sparse_registry
+{
+private:
+    entity_allocator allocator;
+
+    std::vector<std::unique_ptr<pool_base>> pools; // indexed by pool_type_id
+
+private:
+    /// @brief Next free pool type ID
+    /// @return size_t&
+    static size_t &type_counter()
+    {
+        static size_t counter = 0;
+        return counter;
+    }
+
+    /// @brief Registry-wide ID of a component type
+    /// @tparam T
+    /// @return size_t
+    template <typename T>
+    static size_t pool_type_id()
+    {
+        static const size_t id = type_counter()++;
+        return id;
+    }
+
+public:
+    // ======= ENTITY =======
+
+    /// @brief Create a new entity
+    /// @return entity
+    entity create() { return allocator.create(); }
+
+    /// @brief Destroy an entity and drop it from every pool
+    /// @param e
+    void destroy(entity e)
+    {
+        if (!allocator.alive(e))
+            return;
+
+        for (auto &pool : pools)
+            if (pool)
+                pool->remove(e);
+
+        allocator.destroy(e);
+    }
+
+    /// @brief If a handle still refers to a live entity
+    /// @param e
+    /// @return bool
+    bool alive(entity e) const { return allocator.alive(e); }
+
+    // ======= COMPONENTS =======
+
+    /// @brief Get (or create) the pool of a component type
+    /// @tparam T
+    /// @return component_pool<T>&
+    template <typename T>
+    component_pool<T> &pool()
+    {
+        size_t id = pool_type_id<T>();
+
+        if (id >= pools.size())
+            pools.resize(id + 1);
+
+        if (!pools[id])
+            pools[id] = std::make_unique<component_pool<T>>();
+
+        return *static_cast<component_pool<T> *>(pools[id].get());
+    }
+
+    /// @brief Add (or overwrite) a component
+    /// @tparam T
+    /// @tparam ...Args
+    /// @param e
+    /// @param ...args
+    /// @return T&
+    template <typename T, typename... Args>
+    T &emplace(entity e, Args &&...args) { return pool<T>().emplace(e, std::forward<Args>(args)...); }
+
+    /// @brief Remove a component
+    /// @tparam T
+    /// @param e
+    template <typename T>
+    void remove(entity e) { pool<T>().remove(e); }
+
+    /// @brief Get a component
+    /// @tparam T
+    /// @param e
+    /// @return T* || nullptr
+    template <typename T>
+    T *get(entity e) { return pool<T>().get(e); }
+
+    /// @brief If an entity has a component
+    /// @tparam T
+    /// @param e
+    /// @return bool
+    template <typename T>
+    bool has(entity e) { return pool<T>().contains(e); }
+
+    // ======= QUERIES =======
+
+    /// @brief View over every entity holding all of Ts
+    /// @tparam ...Ts
+    /// @return sparse_view<Ts...>
+    template <typename... Ts>
+    sparse_view<Ts...> view() { return sparse_view<Ts...>(&pool<Ts>()...); }
+
+    // ======= UTILITY API =======
+
+    /// @brief Amount of live entities
+    /// @return size_t
+    size_t size() const { return allocator.size(); }
+
+    /// @brief Destroy every entity and component
+    void clear()
+    {
+        for (auto &pool : pools)
+            if (pool)
+                pool->clear();
+
+        allocator.clear();
+    }
+};
@@ -0,0 +1,557 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "./archetype_ecs.hpp"
+#include "../threading/thread_pool.hpp"
+
+// ======= ACCESS DECLARATIONS =======
+
+/// @brief Component types a system only reads
+template <typename... Ts>
+struct reads
+{
+    static component_mask mask() { return archetype_world::mask_of<Ts...>(); }
+};
+
+/// @brief Component types a system reads and writes
+template <typename... Ts>
+struct writes
+{
+    static component_mask mask() { return archetype_world::mask_of<Ts...>(); }
+};
+
+// ======= STRUCTS =======
+
+struct system_timing
+{
+    std::string name;
+
+    double last_ms = 0.0;
+    double mean_ms = 0.0;
+    double max_ms = 0.0;
+
+    uint64_t runs = 0;
+};
+
+// ======= system_context =======
+
+/// @brief What a running system sees: access-checked queries, chunk-parallel iteration and deferred structural changes
+class system_context
+{
+private:
+    archetype_world &world;
+    thread_pool &pool;
+
+    const component_mask &readable;
+    const component_mask &writable;
+
+    std::mutex &query_mutex;
+    std::vector<archetype_world::chunk_ref> &scratch;
+
+    std::mutex &deferred_mutex;
+    std::vector<std::function<void(archetype_world &)>> &deferred;
+
+    uint32_t run_tick;
+    uint32_t last_run_tick;
+
+private:
+    /// @brief Throw if a query touches components the system didn't declare (const T needs read, T needs write)
+    template <typename... Ts>
+    void check_access() const
+    {
+        bool allowed = ((std::is_const<Ts>::value
+                             ? (readable.test(component_registry::id<std::remove_const_t<Ts>>()) || writable.test(component_registry::id<std::remove_const_t<Ts>>()))
+                             : writable.test(component_registry::id<std::remove_const_t<Ts>>())) &&
+                        ...);
+
+        if (!allowed)
+            throw std::logic_error("system_context: Query uses a component the system didn't declare (use const T for reads)");
+    }
+
+    /// @brief Filters read the change ticks of their components, so those need at least read access
+    void check_filter(const no_filter *) const {}
+
+    template <typename... Us>
+    void check_filter(const changed<Us...> *) const { check_access<const Us...>(); }
+
+    template <typename... Us>
+    void check_filter(const added<Us...> *) const { check_access<const Us...>(); }
+
+    /// @brief Collect matching chunks; locked because first use of a query fills the world's query cache
+    template <typename Filter, typename... Ts>
+    void gather(uint32_t since)
+    {
+        check_access<Ts...>();
+        check_filter(static_cast<const Filter *>(nullptr));
+
+        std::lock_guard<std::mutex> lock(query_mutex);
+        world.gather_chunks_filtered<Filter, Ts...>(scratch, since);
+    }
+
+    /// @brief Run a function on every gathered chunk, split across the pool if parallel
+    template <typename... Ts, typename Function>
+    void visit(Function &function, bool parallel, size_t grain)
+    {
+        auto rows = [&function](uint32_t count, entity *owners, Ts *...columns)
+        { each_row<Ts...>(function, count, owners, columns...); };
+
+        if (!parallel)
+        {
+            for (const archetype_world::chunk_ref &ref : scratch)
+                world.run_chunk<Ts...>(ref, run_tick, rows);
+
+            return;
+        }
+
+        pool.parallel_for(0, scratch.size(), grain, [this, &rows](size_t begin, size_t end)
+                          {
+                              for (size_t i = begin; i < end; ++i)
+                                  world.run_chunk<Ts...>(scratch[i], run_tick, rows);
+                          });
+    }
+
+    /// @brief Invoke a function on every row of one chunk
+    template <typename... Ts, typename Function>
+    static void each_row(Function &function, uint32_t count, entity *owners, Ts *...columns)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if constexpr (std::is_invocable<Function &, entity, Ts &...>::value)
+                function(owners[i], columns[i]...);
+            else
+                function(columns[i]...);
+        }
+    }
+
+public:
+    // ======= CONSTRUCTOR =======
+
+    /// @brief Constructor for system_context
+    system_context(archetype_world &world, thread_pool &pool,
+                   const component_mask &readable, const component_mask &writable,
+                   std::mutex &query_mutex, std::vector<archetype_world::chunk_ref> &scratch,
+                   std::mutex &deferred_mutex, std::vector<std::function<void(archetype_world &)>> &deferred,
+                   uint32_t run_tick, uint32_t last_run_tick)
+        : world(world), pool(pool), readable(readable), writable(writable),
+          query_mutex(query_mutex), scratch(scratch), deferred_mutex(deferred_mutex), deferred(deferred),
+          run_tick(run_tick), last_run_tick(last_run_tick) {}
+
+    // ======= QUERIES =======
+
+    /// @brief Run a function for every chunk holding all of Ts
+    /// @tparam ...Ts: const T for read access, T for write access
+    /// @tparam Function: void(uint32_t count, entity *entities, Ts *...columns)
+    /// @param function
+    template <typename... Ts, typename Function>
+    void each_chunk(Function &&function)
+    {
+        gather<no_filter, Ts...>(0);
+
+        for (const archetype_world::chunk_ref &ref : scratch)
+            world.run_chunk<Ts...>(ref, run_tick, function);
+    }
+
+    /// @brief Run a function for every entity holding all of Ts
+    /// @tparam ...Ts: const T for read access, T for write access
+    /// @tparam Function: void(Ts &...) or void(entity, Ts &...)
+    /// @param function
+    template <typename... Ts, typename Function>
+    void each(Function &&function)
+    {
+        gather<no_filter, Ts...>(0);
+        visit<Ts...>(function, false, 0);
+    }
+
+    /// @brief Like each, but only chunks that passed Filter since this system last ran
+    /// @tparam Filter: changed<...> or added<...> (its types must be declared too)
+    /// @tparam ...Ts: const T for read access, T for write access
+    /// @tparam Function: void(Ts &...) or void(entity, Ts &...)
+    /// @param function
+    template <typename Filter, typename... Ts, typename Function>
+    void each_filtered(Function &&function)
+    {
+        gather<Filter, Ts...>(last_run_tick);
+        visit<Ts...>(function, false, 0);
+    }
+
+    /// @brief Like each, but chunks are split across the thread pool; the function must be safe to call concurrently
+    /// @tparam ...Ts: const T for read access, T for write access
+    /// @tparam Function: void(Ts &...) or void(entity, Ts &...)
+    /// @param function
+    /// @param grain: Minimum chunks per task
+    template <typename... Ts, typename Function>
+    void par_each(Function &&function, size_t grain = 1)
+    {
+        gather<no_filter, Ts...>(0);
+        visit<Ts...>(function, true, grain);
+    }
+
+    /// @brief par_each over only the chunks that passed Filter since this system last ran
+    /// @tparam Filter: changed<...> or added<...> (its types must be declared too)
+    /// @tparam ...Ts: const T for read access, T for write access
+    /// @tparam Function: void(Ts &...) or void(entity, Ts &...)
+    /// @param function
+    /// @param grain: Minimum chunks per task
+    template <typename Filter, typename... Ts, typename Function>
+    void par_each_filtered(Function &&function, size_t grain = 1)
+    {
+        gather<Filter, Ts...>(last_run_tick);
+        visit<Ts...>(function, true, grain);
+    }
+
+    /// @brief Run a function for every entity that lost T since this system last ran
+    /// @tparam T
+    /// @tparam Function: void(entity)
+    /// @param function
+    template <typename T, typename Function>
+    void each_removed(Function &&function)
+    {
+        check_access<const T>();
+        world.each_removed<T>(last_run_tick, std::forward<Function>(function));
+    }
+
+    /// @brief Get a component of one entity
+    /// @tparam T: const T for read access, T for write access
+    /// @param e
+    /// @return T* || nullptr
+    template <typename T>
+    T *get(entity e)
+    {
+        check_access<T>();
+        return world.get_component<T>(e, run_tick);
+    }
+
+    // ======= STRUCTURAL CHANGES =======
+
+    /// @brief Queue a structural change (create/destroy/add/remove), applied after every system of the frame finished
+    /// @param command
+    void defer(std::function<void(archetype_world &)> command)
+    {
+        std::lock_guard<std::mutex> lock(deferred_mutex);
+        deferred.push_back(std::move(command));
+    }
+
+    // ======= UTILITY API =======
+
+    /// @brief Unchecked world access; only exclusive systems may change structure through it
+    /// @return archetype_world&
+    archetype_world &get_world() { return world; }
+
+    thread_pool &get_pool() { return pool; }
+
+    /// @brief Tick this run's writes are stamped with
+    uint32_t get_run_tick() const { return run_tick; }
+
+    /// @brief Tick of this system's previous run (0 before the first)
+    uint32_t get_last_run_tick() const { return last_run_tick; }
+};
+
+// ======= system_scheduler =======
+
+/// @brief Global systems with declared component access; non-conflicting systems run concurrently on a thread pool
+class system_scheduler
+{
+private:
+    struct system_entry
+    {
+        std::string name;
+
+        component_mask reads;
+        component_mask writes;
+
+        bool exclusive = false;
+
+        std::function<void(system_context &)> function;
+
+        std::vector<size_t> dependents;
+        size_t dependency_count = 0;
+
+        std::vector<archetype_world::chunk_ref> scratch;
+
+        uint32_t last_run_tick = 0;
+
+        double last_ms = 0.0;
+        double total_ms = 0.0;
+        double max_ms = 0.0;
+
+        uint64_t runs = 0;
+    };
+
+    std::vector<system_entry> systems;
+    std::unique_ptr<std::atomic<size_t>[]> pending;
+
+    std::mutex query_mutex;
+
+    std::mutex deferred_mutex;
+    std::vector<std::function<void(archetype_world &)>> deferred;
+
+    uint32_t trim_tick = 0;
+
+    bool dirty = true;
+
+private:
+    /// @brief If two systems can't run at the same time
+    static bool conflicts(const system_entry &a, const system_entry &b)
+    {
+        if (a.exclusive || b.exclusive)
+            return true;
+
+        return (a.writes & (b.reads | b.writes)).any() || (b.writes & a.reads).any();
+    }
+
+    /// @brief Build the DAG: a later system depends on every earlier system it conflicts with (registration order wins)
+    void build()
+    {
+        for (system_entry &system : systems)
+        {
+            system.dependents.clear();
+            system.dependency_count = 0;
+        }
+
+        for (size_t later = 0; later < systems.size(); ++later)
+        {
+            for (size_t earlier = 0; earlier < later; ++earlier)
+            {
+                if (!conflicts(systems[earlier], systems[later]))
+                    continue;
+
+                systems[earlier].dependents.push_back(later);
+                ++systems[later].dependency_count;
+            }
+        }
+
+        pending.reset(new std::atomic<size_t>[systems.size()]);
+
+        dirty = false;
+    }
+
+    /// @brief Run and time one system
+    void execute(size_t index, archetype_world &world, thread_pool &pool)
+    {
+        system_entry &system = systems[index];
+
+        // ======= every run gets its own tick, so a system sees writes made after its previous run started =======
+
+        uint32_t run_tick = world.advance_tick();
+
+        system_context context(world, pool, system.reads, system.writes, query_mutex, system.scratch, deferred_mutex, deferred,
+                               run_tick, system.last_run_tick);
+
+        auto start = std::chrono::steady_clock::now();
+
+        system.function(context);
+
+        system.last_run_tick = run_tick;
+
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        system.last_ms = ms;
+        system.total_ms += ms;
+        system.max_ms = std::max(system.max_ms, ms);
+        ++system.runs;
+    }
+
+    /// @brief Add a system entry
+    size_t add_entry(const std::string &name, const component_mask &read_mask, const component_mask &write_mask, bool exclusive, std::function<void(system_context &)> function)
+    {
+        system_entry system;
+        system.name = name;
+        system.reads = read_mask;
+        system.writes = write_mask;
+        system.exclusive = exclusive;
+        system.function = std::move(function);
+
+        systems.push_back(std::move(system));
+        dirty = true;
+
+        return systems.size() - 1;
+    }
+
+public:
+    // ======= SYSTEMS =======
+
+    /// @brief Register a system once; it runs every frame in registration order relative to systems it conflicts with
+    /// @tparam Reads: reads<...>
+    /// @tparam Writes: writes<...>
+    /// @tparam Function: void(system_context &)
+    /// @param name
+    /// @param function
+    /// @return size_t: System index
+    template <typename Reads, typename Writes, typename Function>
+    size_t add_system(const std::string &name, Function &&function)
+    {
+        return add_entry(name, Reads::mask(), Writes::mask(), false, std::forward<Function>(function));
+    }
+
+    /// @brief Register a system that runs alone and may change world structure directly
+    /// @tparam Function: void(system_context &)
+    /// @param name
+    /// @param function
+    /// @return size_t: System index
+    template <typename Function>
+    size_t add_exclusive_system(const std::string &name, Function &&function)
+    {
+        return add_entry(name, component_mask{}, component_mask{}, true, std::forward<Function>(function));
+    }
+
+    /// @brief Run every system once, then apply deferred structural changes in submission order
+    /// @note If a system throws, systems that haven't started yet are skipped, the frame's deferred changes are dropped
+    /// and the first exception is rethrown here once every task has finished
+    /// @param world
+    /// @param pool
+    void run(archetype_world &world, thread_pool &pool = thread_pool::shared())
+    {
+        if (systems.empty())
+            return;
+
+        if (dirty)
+            build();
+
+        // ======= removals older than the previous run were seen by every system =======
+
+        world.trim_removed(trim_tick);
+        trim_tick = world.get_tick();
+
+        std::atomic<size_t> remaining{systems.size()};
+
+        std::atomic<bool> failed{false};
+        std::exception_ptr error;
+        std::mutex error_mutex;
+
+        for (size_t i = 0; i < systems.size(); ++i)
+            pending[i].store(systems[i].dependency_count, std::memory_order_relaxed);
+
+        std::function<void(size_t)> launch = [&](size_t index)
+        {
+            pool.submit([&, index]
+                        {
+                            // ======= an exception can't leave the task: other tasks still reference this frame =======
+
+                            if (!failed.load(std::memory_order_acquire))
+                            {
+                                try
+                                {
+                                    execute(index, world, pool);
+                                }
+                                catch (...)
+                                {
+                                    std::lock_guard<std::mutex> lock(error_mutex);
+
+                                    if (!error)
+                                        error = std::current_exception();
+
+                                    failed.store(true, std::memory_order_release);
+                                }
+                            }
+
+                            for (size_t dependent : systems[index].dependents)
+                            {
+                                if (pending[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                                    launch(dependent);
+                            }
+
+                            remaining.fetch_sub(1, std::memory_order_release);
+                        });
+        };
+
+        for (size_t i = 0; i < systems.size(); ++i)
+        {
+            if (systems[i].dependency_count == 0)
+                launch(i);
+        }
+
+        // ======= the calling thread works too, so a pool without workers still makes progress =======
+
+        while (remaining.load(std::memory_order_acquire) > 0)
+        {
+            if (!pool.run_pending_task())
+                std::this_thread::yield();
+        }
+
+        world.advance_tick();
+
+        if (error)
+        {
+            deferred.clear();
+            std::rethrow_exception(error);
+        }
+
+        for (std::function<void(archetype_world &)> &command : deferred)
+            command(world);
+
+        deferred.clear();
+    }
+
+    /// @brief Remove every system
+    void clear()
+    {
+        systems.clear();
+        pending.reset();
+        dirty = true;
+    }
+
+    // ======= REPORTING =======
+
+    /// @brief Timing of every system
+    /// @return std::vector<system_timing>
+    std::vector<system_timing> get_timings() const
+    {
+        std::vector<system_timing> result;
+        result.reserve(systems.size());
+
+        for (const system_entry &system : systems)
+            result.push_back({system.name, system.last_ms, system.runs ? system.total_ms / system.runs : 0.0, system.max_ms, system.runs});
+
+        return result;
+    }
+
+    /// @brief Print a per-system timing table
+    /// @param out
+    void print_report(std::ostream &out) const
+    {
+        out << std::left << std::setw(32) << "system"
+            << std::right << std::setw(12) << "last ms"
+            << std::setw(12) << "mean ms"
+            << std::setw(12) << "max ms"
+            << std::setw(10) << "runs" << "\n";
+
+        for (const system_timing &timing : get_timings())
+        {
+            out << std::left << std::setw(32) << timing.name
+                << std::right << std::fixed << std::setprecision(3)
+                << std::setw(12) << timing.last_ms
+                << std::setw(12) << timing.mean_ms
+                << std::setw(12) << timing.max_ms
+                << std::setw(10) << timing.runs << "\n";
+        }
+    }
+
+    /// @brief Reset every system's timing
+    void reset_timings()
+    {
+        for (system_entry &system : systems)
+        {
+            system.last_ms = system.total_ms = system.max_ms = 0.0;
+            system.runs = 0;
+        }
+    }
+
+    // ======= UTILITY API =======
+
+    size_t size() const { return systems.size(); }
+};
@@ -0,0 +1,397 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "./archetype_ecs.hpp"
+#include "../io/mapped_file.hpp"
+
+// ======= MACROS =======
+
+#define WORLD_SNAPSHOT_VERSION 1
+#define WORLD_SNAPSHOT_ALIGN 16
+
+// ======= world_snapshot =======
+// Binary save/load of an archetype_world. Layout (every section padded to WORLD_SNAPSHOT_ALIGN):
+//   header | type table (schema hash, size, align, name) | generations | free indices
+//   | per archetype: type indices, entity column, one packed blob per component column
+// Loading maps the file and bulk-copies each blob into chunks; no per-entity create/add calls.
+// Component types are matched by name and must be registered (used once) in the loading process.
+
+class world_snapshot
+{
+private:
+    struct header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t endian;
+
+        uint32_t type_count;
+        uint32_t archetype_count;
+        uint32_t generation_count;
+        uint32_t free_count;
+    };
+
+    struct type_entry
+    {
+        uint64_t schema_hash;
+
+        uint32_t size;
+        uint32_t align;
+        uint32_t name_length;
+        uint32_t reserved;
+    };
+
+    struct archetype_entry
+    {
+        uint32_t type_count;
+        uint32_t row_count;
+    };
+
+    static constexpr char magic[8] = {'E', 'C', 'S', 'S', 'N', 'A', 'P', '\0'};
+    static constexpr uint32_t endian_marker = 0x01020304u;
+
+    // ======= WRITING =======
+
+    /// @brief Output that remembers how many bytes went through it, so sections can be padded
+    template <typename Sink>
+    struct writer
+    {
+        Sink &sink;
+        uint64_t written = 0;
+
+        void bytes(const void *data, size_t size)
+        {
+            if (size == 0)
+                return;
+
+            sink(data, size);
+            written += size;
+        }
+
+        template <typename T>
+        void value(const T &data) { bytes(&data, sizeof(T)); }
+
+        void pad()
+        {
+            static const unsigned char zeros[WORLD_SNAPSHOT_ALIGN] = {};
+            bytes(zeros, (WORLD_SNAPSHOT_ALIGN - written % WORLD_SNAPSHOT_ALIGN) % WORLD_SNAPSHOT_ALIGN);
+        }
+    };
+
+    /// @brief Bounds-checked cursor over a loaded snapshot
+    struct reader
+    {
+        const unsigned char *data;
+        size_t size;
+        size_t offset = 0;
+
+        const unsigned char *take(size_t count)
+        {
+            if (count > size - offset)
+                throw std::runtime_error("world_snapshot: Truncated snapshot");
+
+            const unsigned char *at = data + offset;
+            offset += count;
+
+            return at;
+        }
+
+        template <typename T>
+        T value()
+        {
+            T out;
+            std::memcpy(&out, take(sizeof(T)), sizeof(T));
+            return out;
+        }
+
+        void pad() { take((WORLD_SNAPSHOT_ALIGN - offset % WORLD_SNAPSHOT_ALIGN) % WORLD_SNAPSHOT_ALIGN); }
+    };
+
+    /// @brief Serialize a world into any void(const void *, size_t) sink
+    template <typename Sink>
+    static void write(archetype_world &world, Sink &sink)
+    {
+        writer<Sink> out{sink};
+
+        // ======= only types used by non-empty archetypes go in the table =======
+
+        std::vector<uint32_t> file_index(component_registry::types().size(), UINT32_MAX);
+        std::vector<component_id> used;
+
+        uint32_t archetype_count = 0;
+
+        for (size_t a = 0; a < world.archetype_count(); ++a)
+        {
+            archetype &arch = world.get_archetype(a);
+
+            if (arch.size() == 0)
+                continue;
+
+            ++archetype_count;
+
+            for (component_id id : arch.get_types())
+            {
+                if (file_index[id] == UINT32_MAX)
+                {
+                    file_index[id] = static_cast<uint32_t>(used.size());
+                    used.push_back(id);
+                }
+            }
+        }
+
+        const entity_allocator &allocator = world.get_allocator();
+
+        header head{};
+        std::memcpy(head.magic, magic, sizeof(magic));
+        head.version = WORLD_SNAPSHOT_VERSION;
+        head.endian = endian_marker;
+        head.type_count = static_cast<uint32_t>(used.size());
+        head.archetype_count = archetype_count;
+        head.generation_count = static_cast<uint32_t>(allocator.get_generations().size());
+        head.free_count = static_cast<uint32_t>(allocator.get_free_indices().size());
+
+        out.value(head);
+        out.pad();
+
+        // ======= type table =======
+
+        for (component_id id : used)
+        {
+            const component_type_info &info = component_registry::info(id);
+
+            out.value(type_entry{info.schema_hash, static_cast<uint32_t>(info.size), static_cast<uint32_t>(info.align),
+                                 static_cast<uint32_t>(info.name.size()), 0});
+            out.bytes(info.name.data(), info.name.size());
+            out.pad();
+        }
+
+        // ======= allocator =======
+
+        out.bytes(allocator.get_generations().data(), allocator.get_generations().size());
+        out.pad();
+
+        for (uint32_t index : allocator.get_free_indices())
+            out.value(index);
+
+        out.pad();
+
+        // ======= archetypes: entity column then one blob per component, written straight from the chunks =======
+
+        for (size_t a = 0; a < world.archetype_count(); ++a)
+        {
+            archetype &arch = world.get_archetype(a);
+
+            if (arch.size() == 0)
+                continue;
+
+            out.value(archetype_entry{static_cast<uint32_t>(arch.get_types().size()), arch.size()});
+
+            for (component_id id : arch.get_types())
+                out.value(file_index[id]);
+
+            out.pad();
+
+            for (size_t c = 0; c < arch.chunk_count(); ++c)
+                out.bytes(arch.entities(c), sizeof(entity) * arch.get_chunks()[c].count);
+
+            out.pad();
+
+            for (const archetype::column &col : arch.get_columns())
+            {
+                for (size_t c = 0; c < arch.chunk_count(); ++c)
+                    out.bytes(arch.column_data(c, col.id), col.size * arch.get_chunks()[c].count);
+
+                out.pad();
+            }
+        }
+    }
+
+public:
+    // ======= SAVE =======
+
+    /// @brief Save a world to a file
+    /// @param world
+    /// @param path
+    static void save(archetype_world &world, const std::string &path)
+    {
+        std::FILE *file = std::fopen(path.c_str(), "wb");
+
+        if (!file)
+            throw std::runtime_error("world_snapshot: Failed to open " + path + " for writing");
+
+        std::vector<char> buffer(1 << 20);
+        std::setvbuf(file, buffer.data(), _IOFBF, buffer.size());
+
+        bool failed = false;
+
+        auto sink = [file, &failed](const void *data, size_t size)
+        {
+            if (!failed && std::fwrite(data, 1, size, file) != size)
+                failed = true;
+        };
+
+        write(world, sink);
+
+        if (std::fclose(file) != 0 || failed)
+            throw std::runtime_error("world_snapshot: Failed to write " + path);
+    }
+
+    /// @brief Save a world into memory (cheap checkpoints during long runs)
+    /// @param world
+    /// @return std::vector<unsigned char>
+    static std::vector<unsigned char> save_to_memory(archetype_world &world)
+    {
+        std::vector<unsigned char> data;
+
+        auto sink = [&data](const void *bytes, size_t size)
+        {
+            const unsigned char *begin = static_cast<const unsigned char *>(bytes);
+            data.insert(data.end(), begin, begin + size);
+        };
+
+        write(world, sink);
+
+        return data;
+    }
+
+    // ======= LOAD =======
+
+    /// @brief Replace the contents of a world with a snapshot file (memory-mapped, bulk-copied)
+    /// @param world
+    /// @param path
+    static void load(archetype_world &world, const std::string &path)
+    {
+        mapped_file file(path);
+        load_from_memory(world, file.data(), file.size());
+    }
+
+    /// @brief Replace the contents of a world with a snapshot in memory
+    /// @param world
+    /// @param data
+    /// @param size
+    static void load_from_memory(archetype_world &world, const unsigned char *data, size_t size)
+    {
+        if (!data)
+            throw std::runtime_error("world_snapshot: Empty snapshot");
+
+        reader in{data, size};
+
+        header head = in.value<header>();
+        in.pad();
+
+        if (std::memcmp(head.magic, magic, sizeof(magic)) != 0)
+            throw std::runtime_error("world_snapshot: Not a world snapshot");
+
+        if (head.endian != endian_marker)
+            throw std::runtime_error("world_snapshot: Snapshot was written on a machine with different endianness");
+
+        if (head.version != WORLD_SNAPSHOT_VERSION)
+            throw std::runtime_error("world_snapshot: Unsupported snapshot version " + std::to_string(head.version));
+
+        // ======= map file types onto this process's component IDs, rejecting layout changes =======
+
+        std::vector<component_id> local_ids;
+        local_ids.reserve(head.type_count);
+
+        for (uint32_t t = 0; t < head.type_count; ++t)
+        {
+            type_entry entry = in.value<type_entry>();
+            std::string name(reinterpret_cast<const char *>(in.take(entry.name_length)), entry.name_length);
+            in.pad();
+
+            component_id id = component_registry::find(name);
+
+            if (id == UINT32_MAX)
+                throw std::runtime_error("world_snapshot: Component type " + name + " isn't registered");
+
+            const component_type_info &info = component_registry::info(id);
+
+            if (info.schema_hash != entry.schema_hash || info.size != entry.size || info.align != entry.align)
+                throw std::runtime_error("world_snapshot: Schema of component type " + name + " changed");
+
+            local_ids.push_back(id);
+        }
+
+        const uint8_t *generations = in.take(head.generation_count);
+        in.pad();
+
+        const uint32_t *free_indices = reinterpret_cast<const uint32_t *>(in.take(sizeof(uint32_t) * static_cast<size_t>(head.free_count)));
+        in.pad();
+
+        // ======= archetypes =======
+
+        // ======= on any error below the world is left empty rather than half loaded =======
+
+        world.clear();
+
+        try
+        {
+            load_archetypes(world, in, head, local_ids);
+            world.restore_entities(generations, head.generation_count, free_indices, head.free_count);
+        }
+        catch (...)
+        {
+            world.clear();
+            throw;
+        }
+    }
+
+private:
+    /// @brief Bulk-copy every archetype section into the world
+    static void load_archetypes(archetype_world &world, reader &in, const header &head, const std::vector<component_id> &local_ids)
+    {
+        uint32_t tick = world.get_tick();
+
+        std::vector<component_id> types;
+        std::vector<const unsigned char *> file_columns;
+        std::vector<const unsigned char *> sources;
+
+        for (uint32_t a = 0; a < head.archetype_count; ++a)
+        {
+            archetype_entry entry = in.value<archetype_entry>();
+
+            types.clear();
+
+            for (uint32_t t = 0; t < entry.type_count; ++t)
+            {
+                uint32_t index = in.value<uint32_t>();
+
+                if (index >= local_ids.size())
+                    throw std::runtime_error("world_snapshot: Corrupt type index");
+
+                types.push_back(local_ids[index]);
+            }
+
+            in.pad();
+
+            const entity *owners = reinterpret_cast<const entity *>(in.take(sizeof(entity) * static_cast<size_t>(entry.row_count)));
+            in.pad();
+
+            // ======= blobs are in the file's column order; local IDs may sort differently =======
+
+            file_columns.clear();
+
+            for (component_id id : types)
+            {
+                file_columns.push_back(in.take(component_registry::info(id).size * static_cast<size_t>(entry.row_count)));
+                in.pad();
+            }
+
+            archetype &arch = world.get_archetype(world.get_or_create_archetype(types));
+
+            sources.clear();
+
+            for (const archetype::column &col : arch.get_columns())
+                sources.push_back(file_columns[std::find(types.begin(), types.end(), col.id) - types.begin()]);
+
+            arch.append_rows(owners, sources, entry.row_count, tick);
+        }
+    }
+};
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// ======= mapped_file =======
+
+/// @brief Read-only memory mapping of a whole file (mmap on POSIX, file mapping on Windows)
+class mapped_file
+{
+private:
+    const unsigned char *bytes = nullptr;
+    size_t length = 0;
+
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+
+private:
+    /// @brief Unmap and close everything
+    void release()
+    {
+#ifdef _WIN32
+        if (bytes)
+            UnmapViewOfFile(bytes);
+
+        if (mapping)
+            CloseHandle(mapping);
+
+        if (file != INVALID_HANDLE_VALUE)
+            CloseHandle(file);
+
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (bytes)
+            munmap(const_cast<unsigned char *>(bytes), length);
+#endif
+        bytes = nullptr;
+        length = 0;
+    }
+
+public:
+    // ======= CONSTRUCTOR =======
+
+    /// @brief Constructor for mapped_file
+    /// @param path: File to map; throws std::runtime_error if it can't be opened or mapped
+    explicit mapped_file(const std::string &path)
+    {
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+        if (file == INVALID_HANDLE_VALUE)
+            throw std::runtime_error("mapped_file: Failed to open " + path);
+
+        LARGE_INTEGER file_size;
+
+        if (!GetFileSizeEx(file, &file_size))
+        {
+            release();
+            throw std::runtime_error("mapped_file: Failed to stat " + path);
+        }
+
+        length = static_cast<size_t>(file_size.QuadPart);
+
+        if (length == 0)
+            return;
+
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        bytes = mapping ? static_cast<const unsigned char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+
+        if (!bytes)
+        {
+            release();
+            throw std::runtime_error("mapped_file: Failed to map " + path);
+        }
+#else
+        int fd = open(path.c_str(), O_RDONLY);
+
+        if (fd < 0)
+            throw std::runtime_error("mapped_file: Failed to open " + path);
+
+        struct stat info;
+
+        if (fstat(fd, &info) != 0)
+        {
+            close(fd);
+            throw std::runtime_error("mapped_file: Failed to stat " + path);
+        }
+
+        length = static_cast<size_t>(info.st_size);
+
+        if (length == 0)
+        {
+            close(fd);
+            return;
+        }
+
+        void *view = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd); // the mapping keeps the file alive
+
+        if (view == MAP_FAILED)
+        {
+            length = 0;
+            throw std::runtime_error("mapped_file: Failed to map " + path);
+        }
+
+        madvise(view, length, MADV_SEQUENTIAL);
+
+        bytes = static_cast<const unsigned char *>(view);
+#endif
+    }
+
+    // ======= DESTRUCTOR =======
+
+    ~mapped_file() { release(); }
+
+    mapped_file(const mapped_file &) = delete;
+    mapped_file &operator=(const mapped_file &) = delete;
+
+    // ======= UTILITY API =======
+
+    const unsigned char *data() const { return bytes; }
+    size_t size() const { return length; }
+};
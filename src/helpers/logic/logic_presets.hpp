@@ -12,21 +12,32 @@ class object_interface;
 
 using preset_fn = std::function<void(object_interface &)>;
 
+// ======= PRESET FUNCTORS =======
+
+/// @brief Plain functor instead of a std::function, so applying a preset every frame never allocates
+struct gravity_preset
+{
+    float gravitational_force;
+    float delta_time;
+
+    void operator()(object_interface &obj) const
+    {
+        obj.velocity_add(0.0f, -gravitational_force / obj.get_mass() * delta_time, 0.0f);
+        obj.update_position(delta_time);
+    }
+};
+
 // ======= logic_presets =======
 
 class logic_presets
 {
 public:
-    /// @brief Gravity Preset
+    /// @brief Gravity Preset (per object; register it once with game_engine::presets.add_gravity instead of every frame)
     /// @param gravitational_force: How strong gravity is
     /// @param delta_time: Delta time
-    /// @return preset_fn: Preset function
-    static preset_fn gravity(float gravitational_force, float delta_time)
+    /// @return gravity_preset: Preset functor (converts to preset_fn if it needs to be stored)
+    static gravity_preset gravity(float gravitational_force, float delta_time)
     {
-        return [gravitational_force, delta_time](object_interface &obj)
-        {
-            obj.velocity_add(0.0f, -gravitational_force / obj.get_mass() * delta_time, 0.0f);
-            obj.update_position(delta_time);
-        };
+        return {gravitational_force, delta_time};
     }
 };
\ No newline at end of file
@@ -0,0 +1,513 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "../../rendering/objects/modifying/object_interface.hpp"
+
+// ======= STRUCTS =======
+
+/// @brief v.y -= strength / mass * dt, then x += v * dt (same as logic_presets::gravity)
+struct gravity_params
+{
+    float strength;
+};
+
+/// @brief v *= 1 / (1 + factor * dt)
+struct damping_params
+{
+    float factor;
+};
+
+/// @brief x = center + cos(angle) * u + sin(angle) * v, angle += speed * dt
+struct orbit_params
+{
+    glm::vec3 center;
+    glm::vec3 u; // radius long, perpendicular to the axis
+    glm::vec3 v;
+
+    float speed; // radians per second
+    float angle;
+};
+
+/// @brief x = origin + amplitude * sin(phase), phase += angular_frequency * dt
+struct oscillate_params
+{
+    glm::vec3 origin;
+    glm::vec3 amplitude;
+
+    float angular_frequency;
+    float phase;
+
+    bool anchored; // origin taken from the object on its first tick
+};
+
+/// @brief rotation += rate * dt
+struct spin_params
+{
+    glm::vec3 rate; // degrees per second
+};
+
+/// @brief Move along a registered polyline at a constant speed
+struct follow_path_params
+{
+    uint32_t path;
+    uint32_t segment;
+
+    float along; // distance into the current segment
+    float speed;
+};
+
+// ======= preset_table =======
+
+/// @brief Objects using one preset type and their parameters, packed densely
+/// @tparam Params
+template <typename Params>
+struct preset_table
+{
+    std::vector<uint32_t> objects;
+    std::vector<Params> params;
+
+    void add(size_t object_id, const Params &value)
+    {
+        objects.push_back(static_cast<uint32_t>(object_id));
+        params.push_back(value);
+    }
+
+    /// @brief Swap-remove every entry of an object
+    /// @return bool: If anything was removed
+    bool remove(size_t object_id)
+    {
+        bool removed = false;
+
+        for (size_t i = objects.size(); i-- > 0;)
+        {
+            if (objects[i] != object_id)
+                continue;
+
+            objects[i] = objects.back();
+            params[i] = params.back();
+
+            objects.pop_back();
+            params.pop_back();
+
+            removed = true;
+        }
+
+        return removed;
+    }
+
+    /// @brief Drop an object's entries and shift later IDs down, mirroring object_manager::delete_object
+    void erase_object(size_t object_id)
+    {
+        remove(object_id);
+
+        for (uint32_t &object : objects)
+        {
+            if (object > object_id)
+                --object;
+        }
+    }
+
+    void clear()
+    {
+        objects.clear();
+        params.clear();
+    }
+
+    size_t size() const { return objects.size(); }
+};
+
+// ======= preset_tables =======
+
+/// @brief Behaviour presets registered once per object (or group) and run as one tight loop per preset type each tick
+/// @note Replaces building a logic_presets closure per object per frame: parameters live in compact tables and
+/// game_engine runs them every tick. Order: damping, gravity, orbit, oscillate, spin, follow path
+class preset_tables
+{
+private:
+    preset_table<gravity_params> gravity_table;
+    preset_table<damping_params> damping_table;
+    preset_table<orbit_params> orbit_table;
+    preset_table<oscillate_params> oscillate_table;
+    preset_table<spin_params> spin_table;
+    preset_table<follow_path_params> path_table;
+
+    // ======= every path's points back to back; segment lengths stored with the segment start =======
+
+    std::vector<glm::vec3> path_points;
+    std::vector<float> segment_lengths;
+    std::vector<uint32_t> path_starts; // path count + 1
+    std::vector<uint8_t> path_loops;
+
+    static constexpr float two_pi = 6.28318530718f;
+
+private:
+    /// @brief Every table, for bulk removal
+    template <typename Function>
+    void for_each_table(Function &&function)
+    {
+        function(gravity_table);
+        function(damping_table);
+        function(orbit_table);
+        function(oscillate_table);
+        function(spin_table);
+        function(path_table);
+    }
+
+    uint32_t path_segments(uint32_t path) const
+    {
+        uint32_t points = path_starts[path + 1] - path_starts[path];
+        return path_loops[path] ? points : points - 1;
+    }
+
+    glm::vec3 path_point(uint32_t path, uint32_t index) const
+    {
+        uint32_t points = path_starts[path + 1] - path_starts[path];
+        return path_points[path_starts[path] + index % points];
+    }
+
+    // ======= PRESET LOOPS =======
+
+    template <typename Objects>
+    void run_damping(Objects &objects, float delta_time)
+    {
+        for (size_t i = 0; i < damping_table.size(); ++i)
+        {
+            size_t id = damping_table.objects[i];
+
+            if (id >= objects.size())
+                continue;
+
+            glm::vec3 velocity = objects[id].get_velocity() / (1.0f + damping_table.params[i].factor * delta_time);
+            objects[id].velocity_set(velocity.x, velocity.y, velocity.z);
+        }
+    }
+
+    template <typename Objects>
+    void run_gravity(Objects &objects, float delta_time)
+    {
+        for (size_t i = 0; i < gravity_table.size(); ++i)
+        {
+            size_t id = gravity_table.objects[i];
+
+            if (id >= objects.size())
+                continue;
+
+            object_interface &obj = objects[id];
+
+            obj.velocity_add(0.0f, -gravity_table.params[i].strength / obj.get_mass() * delta_time, 0.0f);
+            obj.update_position(delta_time);
+        }
+    }
+
+    template <typename Objects>
+    void run_orbit(Objects &objects, float delta_time)
+    {
+        for (size_t i = 0; i < orbit_table.size(); ++i)
+        {
+            size_t id = orbit_table.objects[i];
+            orbit_params &orbit = orbit_table.params[i];
+
+            orbit.angle = std::fmod(orbit.angle + orbit.speed * delta_time, two_pi);
+
+            if (id >= objects.size())
+                continue;
+
+            glm::vec3 position = orbit.center + std::cos(orbit.angle) * orbit.u + std::sin(orbit.angle) * orbit.v;
+            objects[id].move_set(position.x, position.y, position.z);
+        }
+    }
+
+    template <typename Objects>
+    void run_oscillate(Objects &objects, float delta_time)
+    {
+        for (size_t i = 0; i < oscillate_table.size(); ++i)
+        {
+            size_t id = oscillate_table.objects[i];
+            oscillate_params &oscillate = oscillate_table.params[i];
+
+            if (id >= objects.size())
+                continue;
+
+            if (!oscillate.anchored)
+            {
+                oscillate.origin = objects[id].get_offset() - oscillate.amplitude * std::sin(oscillate.phase);
+                oscillate.anchored = true;
+            }
+
+            oscillate.phase = std::fmod(oscillate.phase + oscillate.angular_frequency * delta_time, two_pi);
+
+            glm::vec3 position = oscillate.origin + oscillate.amplitude * std::sin(oscillate.phase);
+            objects[id].move_set(position.x, position.y, position.z);
+        }
+    }
+
+    template <typename Objects>
+    void run_spin(Objects &objects, float delta_time)
+    {
+        for (size_t i = 0; i < spin_table.size(); ++i)
+        {
+            size_t id = spin_table.objects[i];
+
+            if (id >= objects.size())
+                continue;
+
+            glm::vec3 turn = spin_table.params[i].rate * delta_time;
+            objects[id].rotate_add(turn.x, turn.y, turn.z);
+        }
+    }
+
+    template <typename Objects>
+    void run_follow_path(Objects &objects, float delta_time)
+    {
+        for (size_t i = 0; i < path_table.size(); ++i)
+        {
+            size_t id = path_table.objects[i];
+            follow_path_params &follow = path_table.params[i];
+
+            uint32_t segments = path_segments(follow.path);
+
+            follow.along += follow.speed * delta_time;
+
+            // ======= walk over finished segments; open paths stop at their last point =======
+
+            while (follow.segment < segments)
+            {
+                float length = segment_lengths[path_starts[follow.path] + follow.segment];
+
+                if (follow.along < length)
+                    break;
+
+                follow.along -= length;
+                ++follow.segment;
+
+                if (follow.segment == segments && path_loops[follow.path])
+                    follow.segment = 0;
+            }
+
+            if (id >= objects.size())
+                continue;
+
+            glm::vec3 position;
+
+            if (follow.segment >= segments)
+            {
+                position = path_point(follow.path, segments);
+            }
+            else
+            {
+                float length = segment_lengths[path_starts[follow.path] + follow.segment];
+                float t = length > 0.0f ? follow.along / length : 1.0f;
+
+                position = glm::mix(path_point(follow.path, follow.segment), path_point(follow.path, follow.segment + 1), t);
+            }
+
+            objects[id].move_set(position.x, position.y, position.z);
+        }
+    }
+
+public:
+    // ======= MAIN API =======
+
+    /// @brief Run every registered preset once
+    /// @tparam Objects: Indexable container of object_interface (e.g. object_manager::get_objects())
+    /// @param objects
+    /// @param delta_time
+    template <typename Objects>
+    void run(Objects &objects, float delta_time)
+    {
+        run_damping(objects, delta_time);
+        run_gravity(objects, delta_time);
+        run_orbit(objects, delta_time);
+        run_oscillate(objects, delta_time);
+        run_spin(objects, delta_time);
+        run_follow_path(objects, delta_time);
+    }
+
+    // ======= REGISTRATION =======
+
+    /// @brief Pull an object down and move it by its velocity every tick
+    /// @param object_id
+    /// @param strength: Same meaning as logic_presets::gravity
+    void add_gravity(size_t object_id, float strength)
+    {
+        gravity_table.add(object_id, {strength});
+    }
+
+    /// @brief Bleed off an object's velocity every tick
+    /// @param object_id
+    /// @param factor: Damping per second (0 = none)
+    void add_damping(size_t object_id, float factor)
+    {
+        damping_table.add(object_id, {std::max(factor, 0.0f)});
+    }
+
+    /// @brief Circle an object around a center
+    /// @param object_id
+    /// @param center
+    /// @param radius
+    /// @param speed: Radians per second
+    /// @param axis: Orbit axis (default: up)
+    /// @param start_angle: Radians (default: 0)
+    void add_orbit(size_t object_id, const glm::vec3 &center, float radius, float speed, const glm::vec3 &axis = {0.0f, 1.0f, 0.0f}, float start_angle = 0.0f)
+    {
+        glm::vec3 normal = glm::normalize(axis);
+        glm::vec3 side = std::abs(normal.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 0.0f, 1.0f);
+
+        glm::vec3 u = glm::normalize(side - normal * glm::dot(side, normal));
+        glm::vec3 v = glm::cross(u, normal);
+
+        orbit_table.add(object_id, {center, u * radius, v * radius, speed, start_angle});
+    }
+
+    /// @brief Swing an object back and forth around where it is on its first tick
+    /// @param object_id
+    /// @param amplitude: Peak offset per axis
+    /// @param frequency: Cycles per second
+    /// @param phase: Radians (default: 0)
+    void add_oscillate(size_t object_id, const glm::vec3 &amplitude, float frequency, float phase = 0.0f)
+    {
+        oscillate_table.add(object_id, {glm::vec3(0.0f), amplitude, frequency * two_pi, phase, false});
+    }
+
+    /// @brief Rotate an object at a constant rate
+    /// @param object_id
+    /// @param degrees_per_second
+    void add_spin(size_t object_id, const glm::vec3 &degrees_per_second)
+    {
+        spin_table.add(object_id, {degrees_per_second});
+    }
+
+    /// @brief Register a polyline objects can follow
+    /// @param points: At least 2
+    /// @param loop: Continue from the last point back to the first; the points can't all coincide
+    /// @return uint32_t: Path ID
+    uint32_t add_path(const std::vector<glm::vec3> &points, bool loop = false)
+    {
+        if (points.size() < 2)
+            throw std::invalid_argument("preset_tables: A path needs at least 2 points");
+
+        // ======= a loop without length would be walked forever =======
+
+        float total_length = 0.0f;
+
+        for (size_t i = 0; i < points.size(); ++i)
+            total_length += glm::length(points[(i + 1) % points.size()] - points[i]);
+
+        if (loop && !(total_length > 0.0f))
+            throw std::invalid_argument("preset_tables: A looping path needs a non-zero length");
+
+        if (path_starts.empty())
+            path_starts.push_back(0);
+
+        for (size_t i = 0; i < points.size(); ++i)
+        {
+            path_points.push_back(points[i]);
+            segment_lengths.push_back(glm::length(points[(i + 1) % points.size()] - points[i]));
+        }
+
+        path_starts.push_back(static_cast<uint32_t>(path_points.size()));
+        path_loops.push_back(loop);
+
+        return static_cast<uint32_t>(path_loops.size() - 1);
+    }
+
+    /// @brief Move an object along a registered path, starting at its first point
+    /// @param object_id
+    /// @param path: From add_path
+    /// @param speed: Units per second
+    void add_follow_path(size_t object_id, uint32_t path, float speed)
+    {
+        if (path >= path_loops.size())
+            throw std::out_of_range("preset_tables: Unknown path");
+
+        path_table.add(object_id, {path, 0, 0.0f, std::max(speed, 0.0f)});
+    }
+
+    // ======= GROUP REGISTRATION =======
+
+    /// @brief add_gravity for every object of a group
+    void add_gravity(const std::vector<size_t> &group, float strength)
+    {
+        for (size_t object_id : group)
+            add_gravity(object_id, strength);
+    }
+
+    /// @brief add_damping for every object of a group
+    void add_damping(const std::vector<size_t> &group, float factor)
+    {
+        for (size_t object_id : group)
+            add_damping(object_id, factor);
+    }
+
+    /// @brief Orbit a group, spread evenly around the circle
+    void add_orbit(const std::vector<size_t> &group, const glm::vec3 &center, float radius, float speed, const glm::vec3 &axis = {0.0f, 1.0f, 0.0f})
+    {
+        for (size_t i = 0; i < group.size(); ++i)
+            add_orbit(group[i], center, radius, speed, axis, two_pi * i / group.size());
+    }
+
+    /// @brief add_oscillate for every object of a group
+    void add_oscillate(const std::vector<size_t> &group, const glm::vec3 &amplitude, float frequency, float phase = 0.0f)
+    {
+        for (size_t object_id : group)
+            add_oscillate(object_id, amplitude, frequency, phase);
+    }
+
+    /// @brief add_spin for every object of a group
+    void add_spin(const std::vector<size_t> &group, const glm::vec3 &degrees_per_second)
+    {
+        for (size_t object_id : group)
+            add_spin(object_id, degrees_per_second);
+    }
+
+    /// @brief add_follow_path for every object of a group (all start at the first point)
+    void add_follow_path(const std::vector<size_t> &group, uint32_t path, float speed)
+    {
+        for (size_t object_id : group)
+            add_follow_path(object_id, path, speed);
+    }
+
+    // ======= REMOVAL =======
+
+    /// @brief Stop every preset on an object
+    /// @param object_id
+    void remove(size_t object_id)
+    {
+        for_each_table([object_id](auto &table)
+                       { table.remove(object_id); });
+    }
+
+    /// @brief Keep object IDs in sync after object_manager::delete_object (later IDs shift down by one)
+    /// @param object_id
+    void object_deleted(size_t object_id)
+    {
+        for_each_table([object_id](auto &table)
+                       { table.erase_object(object_id); });
+    }
+
+    /// @brief Drop every preset and path
+    void clear()
+    {
+        for_each_table([](auto &table)
+                       { table.clear(); });
+
+        path_points.clear();
+        segment_lengths.clear();
+        path_starts.clear();
+        path_loops.clear();
+    }
+
+    // ======= UTILITY API =======
+
+    /// @brief Amount of registered preset entries
+    /// @return size_t
+    size_t size() const
+    {
+        return gravity_table.size() + damping_table.size() + orbit_table.size() + oscillate_table.size() + spin_table.size() + path_table.size();
+    }
+};
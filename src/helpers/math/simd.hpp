@@ -0,0 +1,120 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+// ======= simd_float =======
+// Thin wrapper over the widest float vector the compiler targets: AVX (8 lanes), SSE2 (4) or scalar (1).
+// Build with -mavx / -march=native (or /arch:AVX) to get the AVX path; SSE2 is the x86-64 baseline.
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define ENGINE_SIMD_AVX 1
+#define ENGINE_SIMD_NAME "avx"
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ENGINE_SIMD_SSE 1
+#define ENGINE_SIMD_NAME "sse2"
+#else
+#define ENGINE_SIMD_SCALAR 1
+#define ENGINE_SIMD_NAME "scalar"
+#endif
+
+struct simd_float
+{
+#if ENGINE_SIMD_AVX
+    static constexpr int width = 8;
+    __m256 v;
+
+    static simd_float load(const float *p) { return {_mm256_loadu_ps(p)}; }
+    void store(float *p) const { _mm256_storeu_ps(p, v); }
+
+    static simd_float set1(float value) { return {_mm256_set1_ps(value)}; }
+    static simd_float zero() { return {_mm256_setzero_ps()}; }
+
+    friend simd_float operator+(simd_float a, simd_float b) { return {_mm256_add_ps(a.v, b.v)}; }
+    friend simd_float operator-(simd_float a, simd_float b) { return {_mm256_sub_ps(a.v, b.v)}; }
+    friend simd_float operator*(simd_float a, simd_float b) { return {_mm256_mul_ps(a.v, b.v)}; }
+    friend simd_float operator/(simd_float a, simd_float b) { return {_mm256_div_ps(a.v, b.v)}; }
+
+    static simd_float min(simd_float a, simd_float b) { return {_mm256_min_ps(a.v, b.v)}; }
+    static simd_float max(simd_float a, simd_float b) { return {_mm256_max_ps(a.v, b.v)}; }
+    static simd_float sqrt(simd_float a) { return {_mm256_sqrt_ps(a.v)}; }
+
+    /// @brief All-ones lanes where a > b
+    static simd_float greater(simd_float a, simd_float b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ)}; }
+    static simd_float less(simd_float a, simd_float b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)}; }
+
+    /// @brief mask ? a : b per lane
+    static simd_float select(simd_float mask, simd_float a, simd_float b) { return {_mm256_blendv_ps(b.v, a.v, mask.v)}; }
+
+    /// @brief a & mask (zero the lanes where mask is clear)
+    static simd_float keep(simd_float mask, simd_float a) { return {_mm256_and_ps(mask.v, a.v)}; }
+
+    /// @brief a | b (lanes set in either mask)
+    static simd_float either(simd_float a, simd_float b) { return {_mm256_or_ps(a.v, b.v)}; }
+
+    /// @brief One bit per lane, set where mask is set
+    static int movemask(simd_float mask) { return _mm256_movemask_ps(mask.v); }
+#elif ENGINE_SIMD_SSE
+    static constexpr int width = 4;
+    __m128 v;
+
+    static simd_float load(const float *p) { return {_mm_loadu_ps(p)}; }
+    void store(float *p) const { _mm_storeu_ps(p, v); }
+
+    static simd_float set1(float value) { return {_mm_set1_ps(value)}; }
+    static simd_float zero() { return {_mm_setzero_ps()}; }
+
+    friend simd_float operator+(simd_float a, simd_float b) { return {_mm_add_ps(a.v, b.v)}; }
+    friend simd_float operator-(simd_float a, simd_float b) { return {_mm_sub_ps(a.v, b.v)}; }
+    friend simd_float operator*(simd_float a, simd_float b) { return {_mm_mul_ps(a.v, b.v)}; }
+    friend simd_float operator/(simd_float a, simd_float b) { return {_mm_div_ps(a.v, b.v)}; }
+
+    static simd_float min(simd_float a, simd_float b) { return {_mm_min_ps(a.v, b.v)}; }
+    static simd_float max(simd_float a, simd_float b) { return {_mm_max_ps(a.v, b.v)}; }
+    static simd_float sqrt(simd_float a) { return {_mm_sqrt_ps(a.v)}; }
+
+    static simd_float greater(simd_float a, simd_float b) { return {_mm_cmpgt_ps(a.v, b.v)}; }
+    static simd_float less(simd_float a, simd_float b) { return {_mm_cmplt_ps(a.v, b.v)}; }
+
+    static simd_float select(simd_float mask, simd_float a, simd_float b) { return {_mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v))}; }
+    static simd_float keep(simd_float mask, simd_float a) { return {_mm_and_ps(mask.v, a.v)}; }
+    static simd_float either(simd_float a, simd_float b) { return {_mm_or_ps(a.v, b.v)}; }
+
+    static int movemask(simd_float mask) { return _mm_movemask_ps(mask.v); }
+#else
+    static constexpr int width = 1;
+    float v;
+
+    static simd_float load(const float *p) { return {*p}; }
+    void store(float *p) const { *p = v; }
+
+    static simd_float set1(float value) { return {value}; }
+    static simd_float zero() { return {0.0f}; }
+
+    friend simd_float operator+(simd_float a, simd_float b) { return {a.v + b.v}; }
+    friend simd_float operator-(simd_float a, simd_float b) { return {a.v - b.v}; }
+    friend simd_float operator*(simd_float a, simd_float b) { return {a.v * b.v}; }
+    friend simd_float operator/(simd_float a, simd_float b) { return {a.v / b.v}; }
+
+    static simd_float min(simd_float a, simd_float b) { return {std::min(a.v, b.v)}; }
+    static simd_float max(simd_float a, simd_float b) { return {std::max(a.v, b.v)}; }
+    static simd_float sqrt(simd_float a) { return {std::sqrt(a.v)}; }
+
+    // ======= scalar masks are 1.0f / 0.0f =======
+
+    static simd_float greater(simd_float a, simd_float b) { return {a.v > b.v ? 1.0f : 0.0f}; }
+    static simd_float less(simd_float a, simd_float b) { return {a.v < b.v ? 1.0f : 0.0f}; }
+
+    static simd_float select(simd_float mask, simd_float a, simd_float b) { return {mask.v != 0.0f ? a.v : b.v}; }
+    static simd_float keep(simd_float mask, simd_float a) { return {mask.v != 0.0f ? a.v : 0.0f}; }
+    static simd_float either(simd_float a, simd_float b) { return {(a.v != 0.0f || b.v != 0.0f) ? 1.0f : 0.0f}; }
+
+    static int movemask(simd_float mask) { return mask.v != 0.0f ? 1 : 0; }
+#endif
+
+    simd_float &operator+=(simd_float other) { return *this = *this + other; }
+    simd_float &operator-=(simd_float other) { return *this = *this - other; }
+    simd_float &operator*=(simd_float other) { return *this = *this * other; }
+};
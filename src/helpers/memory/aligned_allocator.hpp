@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+// ======= aligned_allocator =======
+
+/// @brief std::allocator replacement that aligns every allocation (SIMD loads, cache lines)
+/// @tparam T
+/// @tparam Align: Power of two (default: 64)
+template <typename T, size_t Align = 64>
+struct aligned_allocator
+{
+    using value_type = T;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = aligned_allocator<U, Align>;
+    };
+
+    aligned_allocator() noexcept = default;
+
+    template <typename U>
+    aligned_allocator(const aligned_allocator<U, Align> &) noexcept {}
+
+    T *allocate(size_t count) { return static_cast<T *>(::operator new(count * sizeof(T), std::align_val_t(Align))); }
+
+    void deallocate(T *ptr, size_t) noexcept { ::operator delete(ptr, std::align_val_t(Align)); }
+
+    template <typename U>
+    bool operator==(const aligned_allocator<U, Align> &) const noexcept { return true; }
+
+    template <typename U>
+    bool operator!=(const aligned_allocator<U, Align> &) const noexcept { return false; }
+};
+
+// ======= TYPES =======
+
+template <typename T>
+using aligned_vector = std::vector<T, aligned_allocator<T>>;
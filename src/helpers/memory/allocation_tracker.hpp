@@ -0,0 +1,322 @@
+#pragma once
+
+// ======= allocation_tracker =======
+// Counts global operator new/delete per thread and process-wide, and flags heap allocations inside guarded
+// (steady-state) scopes. Define ALLOCATION_TRACKER_IMPLEMENTATION in exactly one TU to install the hooks.
+//
+// ENGINE_ALLOCATION_GUARD: 0 = off, 1 = report guarded allocations to stderr, 2 = report then abort (default: 0)
+// ENGINE_ALLOCATION_WARMUP_FRAMES: frames a loop runs before it counts as steady state (default: 120)
+// ALLOCATION_TRACKER_BACKTRACE: 1 = print the call stack of guarded allocations (glibc only, default: 0)
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#ifndef ENGINE_ALLOCATION_GUARD
+#define ENGINE_ALLOCATION_GUARD 0
+#endif
+
+#ifndef ENGINE_ALLOCATION_WARMUP_FRAMES
+#define ENGINE_ALLOCATION_WARMUP_FRAMES 120
+#endif
+
+#ifndef ALLOCATION_TRACKER_BACKTRACE
+#define ALLOCATION_TRACKER_BACKTRACE 0
+#endif
+
+#if ALLOCATION_TRACKER_BACKTRACE && defined(__GLIBC__)
+#include <execinfo.h>
+#include <unistd.h>
+#define ALLOCATION_TRACKER_HAS_BACKTRACE 1
+#else
+#define ALLOCATION_TRACKER_HAS_BACKTRACE 0
+#endif
+
+#define ALLOCATION_TRACKER_MAX_REPORTS 16 // per outermost guard
+
+// ======= STRUCTS =======
+
+struct allocation_counters
+{
+    uint64_t allocations;
+    uint64_t deallocations;
+    uint64_t bytes;
+};
+
+// ======= allocation_tracker =======
+
+class allocation_tracker
+{
+private:
+    struct guard_state
+    {
+        int depth;
+        const char *label;
+
+        uint64_t violations;
+        uint64_t reported;
+
+        bool in_hook;
+    };
+
+private:
+    /// @brief Print one guarded allocation (never allocates itself)
+    static void report(size_t size, const char *label)
+    {
+        std::fprintf(stderr, "[allocation_tracker] %zu byte heap allocation inside steady-state scope '%s'\n", size, label ? label : "?");
+
+#if ALLOCATION_TRACKER_HAS_BACKTRACE
+        void *frames[32];
+        int depth = backtrace(frames, 32);
+        backtrace_symbols_fd(frames, depth, STDERR_FILENO);
+#endif
+    }
+
+public:
+    // ======= COUNTERS =======
+
+    /// @brief Counters of the calling thread (plain thread_local POD, safe to touch from operator new)
+    /// @return allocation_counters&
+    static allocation_counters &thread_counters()
+    {
+        static thread_local allocation_counters counters{0, 0, 0};
+        return counters;
+    }
+
+    static std::atomic<uint64_t> &total_allocations()
+    {
+        static std::atomic<uint64_t> value{0};
+        return value;
+    }
+
+    static std::atomic<uint64_t> &total_deallocations()
+    {
+        static std::atomic<uint64_t> value{0};
+        return value;
+    }
+
+    static std::atomic<uint64_t> &total_bytes()
+    {
+        static std::atomic<uint64_t> value{0};
+        return value;
+    }
+
+    /// @brief If the replacement operator new/delete are linked in
+    /// @return bool&
+    static bool &hooks_installed()
+    {
+        static bool installed = false;
+        return installed;
+    }
+
+    // ======= GUARD STATE =======
+
+    /// @brief Guard state of the calling thread
+    /// @return guard_state&
+    static guard_state &guard()
+    {
+        static thread_local guard_state state{0, nullptr, 0, 0, false};
+        return state;
+    }
+
+    // ======= HOOKS =======
+
+    /// @brief Called by the replacement operator new
+    /// @param size
+    static void on_allocate(size_t size)
+    {
+        allocation_counters &counters = thread_counters();
+        ++counters.allocations;
+        counters.bytes += size;
+
+        total_allocations().fetch_add(1, std::memory_order_relaxed);
+        total_bytes().fetch_add(size, std::memory_order_relaxed);
+
+        guard_state &state = guard();
+
+        if (state.depth == 0 || state.in_hook)
+            return;
+
+        state.in_hook = true;
+        ++state.violations;
+
+        if (ENGINE_ALLOCATION_GUARD >= 2 || state.reported < ALLOCATION_TRACKER_MAX_REPORTS)
+        {
+            ++state.reported;
+            report(size, state.label);
+        }
+
+        if (ENGINE_ALLOCATION_GUARD >= 2)
+            std::abort();
+
+        state.in_hook = false;
+    }
+
+    /// @brief Called by the replacement operator delete
+    static void on_deallocate()
+    {
+        ++thread_counters().deallocations;
+        total_deallocations().fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+// ======= allocation_guard =======
+
+/// @brief Marks a scope that must not touch the heap on this thread; allocations inside are reported (or abort)
+class allocation_guard
+{
+private:
+    bool active;
+
+    const char *previous_label = nullptr;
+    uint64_t violations_before = 0;
+
+public:
+    /// @brief Constructor for allocation_guard
+    /// @param label: Shown in reports
+    /// @param active: If false the guard does nothing, e.g. during warm-up frames (default: true)
+    explicit allocation_guard(const char *label, bool active = true) : active(active)
+    {
+        if (!active)
+            return;
+
+        auto &state = allocation_tracker::guard();
+
+        if (state.depth++ == 0)
+            state.reported = 0;
+
+        previous_label = state.label;
+        violations_before = state.violations;
+        state.label = label;
+    }
+
+    ~allocation_guard()
+    {
+        if (!active)
+            return;
+
+        auto &state = allocation_tracker::guard();
+
+        state.label = previous_label;
+        --state.depth;
+    }
+
+    allocation_guard(const allocation_guard &) = delete;
+    allocation_guard &operator=(const allocation_guard &) = delete;
+
+    /// @brief Heap allocations made inside this guard so far
+    /// @return uint64_t
+    uint64_t violations() const { return active ? allocation_tracker::guard().violations - violations_before : 0; }
+};
+
+// ======= MACROS =======
+
+#define ALLOCATION_GUARD_CONCAT_INNER(a, b) a##b
+#define ALLOCATION_GUARD_CONCAT(a, b) ALLOCATION_GUARD_CONCAT_INNER(a, b)
+
+#if ENGINE_ALLOCATION_GUARD
+#define ALLOCATION_GUARD(label) allocation_guard ALLOCATION_GUARD_CONCAT(allocation_guard_, __LINE__)(label)
+#define ALLOCATION_FRAME_GUARD(label)                                                   \
+    static thread_local uint64_t ALLOCATION_GUARD_CONCAT(allocation_frame_, __LINE__) = 0; \
+    allocation_guard ALLOCATION_GUARD_CONCAT(allocation_guard_, __LINE__)(label, ALLOCATION_GUARD_CONCAT(allocation_frame_, __LINE__)++ >= ENGINE_ALLOCATION_WARMUP_FRAMES)
+#else
+#define ALLOCATION_GUARD(label) ((void)0)
+#define ALLOCATION_FRAME_GUARD(label) ((void)0)
+#endif
+
+// ======= IMPLEMENTATION =======
+
+#ifdef ALLOCATION_TRACKER_IMPLEMENTATION
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete" // replaced new/delete both go through malloc/free
+#endif
+
+namespace
+{
+    struct allocation_tracker_installer
+    {
+        allocation_tracker_installer() { allocation_tracker::hooks_installed() = true; }
+    } allocation_tracker_install;
+
+    void *allocation_tracker_malloc(std::size_t size)
+    {
+        allocation_tracker::on_allocate(size);
+        return std::malloc(size ? size : 1);
+    }
+
+    void *allocation_tracker_aligned_malloc(std::size_t size, std::size_t align)
+    {
+        allocation_tracker::on_allocate(size);
+
+#ifdef _WIN32
+        return _aligned_malloc(size ? size : 1, align);
+#else
+        void *ptr = nullptr;
+        return posix_memalign(&ptr, align < sizeof(void *) ? sizeof(void *) : align, size ? size : 1) == 0 ? ptr : nullptr;
+#endif
+    }
+
+    void allocation_tracker_free(void *ptr)
+    {
+        if (!ptr)
+            return;
+
+        allocation_tracker::on_deallocate();
+        std::free(ptr);
+    }
+
+    void allocation_tracker_aligned_free(void *ptr)
+    {
+        if (!ptr)
+            return;
+
+        allocation_tracker::on_deallocate();
+
+#ifdef _WIN32
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+}
+
+void *operator new(std::size_t size)
+{
+    if (void *ptr = allocation_tracker_malloc(size))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) { return operator new(size); }
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept { return allocation_tracker_malloc(size); }
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept { return allocation_tracker_malloc(size); }
+
+void *operator new(std::size_t size, std::align_val_t align)
+{
+    if (void *ptr = allocation_tracker_aligned_malloc(size, static_cast<std::size_t>(align)))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size, std::align_val_t align) { return operator new(size, align); }
+
+void operator delete(void *ptr) noexcept { allocation_tracker_free(ptr); }
+void operator delete[](void *ptr) noexcept { allocation_tracker_free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { allocation_tracker_free(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { allocation_tracker_free(ptr); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept { allocation_tracker_free(ptr); }
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept { allocation_tracker_free(ptr); }
+
+void operator delete(void *ptr, std::align_val_t) noexcept { allocation_tracker_aligned_free(ptr); }
+void operator delete[](void *ptr, std::align_val_t) noexcept { allocation_tracker_aligned_free(ptr); }
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept { allocation_tracker_aligned_free(ptr); }
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept { allocation_tracker_aligned_free(ptr); }
+
+#endif
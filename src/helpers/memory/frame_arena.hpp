@@ -0,0 +1,171 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "./memory_stats.hpp"
+
+// ======= frame_arena =======
+
+/// @brief Linear (bump) allocator for transient data; everything is released at once by reset() (not thread-safe)
+class frame_arena
+{
+private:
+    struct block
+    {
+        unsigned char *data;
+        size_t size;
+    };
+
+    std::vector<block> blocks;
+
+    size_t current = 0; // block being bumped
+    size_t offset = 0;  // bytes used inside the current block
+
+    size_t used_bytes = 0;
+    size_t high_water = 0;
+
+    allocation_stats *stats;
+
+private:
+    /// @brief Allocate a block
+    static block make_block(size_t size)
+    {
+        return {static_cast<unsigned char *>(::operator new(size, std::align_val_t(alignof(std::max_align_t)))), size};
+    }
+
+    /// @brief Free every block
+    void release()
+    {
+        for (block &b : blocks)
+            ::operator delete(b.data, std::align_val_t(alignof(std::max_align_t)));
+
+        blocks.clear();
+    }
+
+public:
+    // ======= CONSTRUCTOR =======
+
+    /// @brief Constructor for frame_arena
+    /// @param capacity: Bytes reserved up front (default: 1 MiB)
+    /// @param name: Subsystem name used for allocation stats (default: "frame_arena")
+    explicit frame_arena(size_t capacity = 1 << 20, const std::string &name = "frame_arena")
+        : stats(&memory_stats::category(name))
+    {
+        blocks.push_back(make_block(std::max<size_t>(capacity, 64)));
+    }
+
+    // ======= DESTRUCTOR =======
+
+    ~frame_arena() { release(); }
+
+    frame_arena(const frame_arena &) = delete;
+    frame_arena &operator=(const frame_arena &) = delete;
+
+    // ======= MAIN API =======
+
+    /// @brief Bump-allocate memory, valid until the next reset()
+    /// @param bytes
+    /// @param align: Power of two (default: alignof(std::max_align_t))
+    /// @return void*
+    void *allocate(size_t bytes, size_t align = alignof(std::max_align_t))
+    {
+        while (true)
+        {
+            block &b = blocks[current];
+
+            uintptr_t base = reinterpret_cast<uintptr_t>(b.data);
+            uintptr_t aligned = (base + offset + align - 1) & ~(uintptr_t(align) - 1);
+
+            if (aligned + bytes <= base + b.size)
+            {
+                size_t consumed = aligned + bytes - (base + offset);
+
+                offset = aligned + bytes - base;
+                used_bytes += consumed;
+                high_water = std::max(high_water, used_bytes);
+
+                stats->on_allocate(consumed);
+
+                return reinterpret_cast<void *>(aligned);
+            }
+
+            // ======= overflow: chain a bigger block; reset() folds the chain back into one =======
+
+            if (current + 1 == blocks.size())
+                blocks.push_back(make_block(std::max(b.size * 2, bytes + align)));
+
+            ++current;
+            offset = 0;
+        }
+    }
+
+    /// @brief Allocate an uninitialised array
+    /// @tparam T: Trivially destructible (the arena never runs destructors)
+    /// @param count
+    /// @return T*
+    template <typename T>
+    T *allocate_array(size_t count)
+    {
+        static_assert(std::is_trivially_destructible<T>::value, "frame_arena: types must be trivially destructible");
+        return static_cast<T *>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    /// @brief Construct an object in the arena
+    /// @tparam T: Trivially destructible (the arena never runs destructors)
+    /// @tparam ...Args
+    /// @param ...args
+    /// @return T*
+    template <typename T, typename... Args>
+    T *create(Args &&...args)
+    {
+        static_assert(std::is_trivially_destructible<T>::value, "frame_arena: types must be trivially destructible");
+        return ::new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    /// @brief Release every allocation; if the frame overflowed, the blocks are merged so the next frame fits in one
+    void reset()
+    {
+        stats->on_deallocate(used_bytes);
+
+        if (blocks.size() > 1)
+        {
+            size_t total = 0;
+
+            for (const block &b : blocks)
+                total += b.size;
+
+            release();
+            blocks.push_back(make_block(total));
+        }
+
+        current = 0;
+        offset = 0;
+        used_bytes = 0;
+    }
+
+    // ======= UTILITY API =======
+
+    /// @brief Bytes used since the last reset
+    size_t used() const { return used_bytes; }
+
+    /// @brief Bytes reserved across every block
+    size_t capacity() const
+    {
+        size_t total = 0;
+
+        for (const block &b : blocks)
+            total += b.size;
+
+        return total;
+    }
+
+    /// @brief Most bytes ever used in one frame
+    size_t high_water_mark() const { return high_water; }
+};
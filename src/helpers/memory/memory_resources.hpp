@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+#include "./frame_arena.hpp"
+#include "./pool_allocator.hpp"
+
+// ======= arena_resource =======
+
+/// @brief std::pmr adapter over a frame_arena: deallocate is a no-op, memory comes back on reset()
+class arena_resource : public std::pmr::memory_resource
+{
+private:
+    frame_arena &arena;
+
+private:
+    void *do_allocate(size_t bytes, size_t align) override { return arena.allocate(bytes, align); }
+
+    void do_deallocate(void *, size_t, size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+
+public:
+    // ======= CONSTRUCTOR =======
+
+    /// @brief Constructor for arena_resource
+    /// @param arena
+    explicit arena_resource(frame_arena &arena) : arena(arena) {}
+};
+
+// ======= pool_resource =======
+
+/// @brief std::pmr adapter over a size_class_pool; large or over-aligned requests go to the upstream resource
+class pool_resource : public std::pmr::memory_resource
+{
+private:
+    size_class_pool &pools;
+    std::pmr::memory_resource *upstream;
+
+private:
+    void *do_allocate(size_t bytes, size_t align) override
+    {
+        if (bytes > size_class_pool::max_pooled_size() || align > POOL_BLOCK_ALIGN)
+            return upstream->allocate(bytes, align);
+
+        return pools.allocate(bytes);
+    }
+
+    void do_deallocate(void *ptr, size_t bytes, size_t align) override
+    {
+        if (bytes > size_class_pool::max_pooled_size() || align > POOL_BLOCK_ALIGN)
+            upstream->deallocate(ptr, bytes, align);
+        else
+            pools.deallocate(ptr, bytes);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+
+public:
+    // ======= CONSTRUCTOR =======
+
+    /// @brief Constructor for pool_resource
+    /// @param pools
+    /// @param upstream: Used for requests the pools can't serve (default: std::pmr::new_delete_resource())
+    explicit pool_resource(size_class_pool &pools, std::pmr::memory_resource *upstream = std::pmr::new_delete_resource())
+        : pools(pools), upstream(upstream) {}
+};
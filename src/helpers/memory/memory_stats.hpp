@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+// ======= allocation_stats =======
+
+/// @brief Allocation counters of one subsystem; safe to update from any thread
+struct allocation_stats
+{
+    std::string name;
+
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> deallocations{0};
+
+    std::atomic<uint64_t> bytes_allocated{0}; // lifetime total
+    std::atomic<uint64_t> bytes_in_use{0};
+    std::atomic<uint64_t> peak_bytes{0};
+
+    explicit allocation_stats(const std::string &name) : name(name) {}
+
+    /// @brief Record an allocation
+    /// @param bytes
+    void on_allocate(size_t bytes)
+    {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        bytes_allocated.fetch_add(bytes, std::memory_order_relaxed);
+
+        uint64_t in_use = bytes_in_use.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        uint64_t peak = peak_bytes.load(std::memory_order_relaxed);
+
+        while (in_use > peak && !peak_bytes.compare_exchange_weak(peak, in_use, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    /// @brief Record a deallocation
+    /// @param bytes
+    void on_deallocate(size_t bytes)
+    {
+        deallocations.fetch_add(1, std::memory_order_relaxed);
+        bytes_in_use.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+};
+
+// ======= memory_stats =======
+
+/// @brief Registry of per-subsystem allocation_stats
+class memory_stats
+{
+private:
+    static std::mutex &registry_mutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    /// @brief Every category; leaked on purpose so allocators torn down during static destruction can still report
+    static std::deque<allocation_stats> &categories()
+    {
+        static std::deque<allocation_stats> *list = new std::deque<allocation_stats>();
+        return *list;
+    }
+
+public:
+    /// @brief Get (or create) the stats of a subsystem; the reference stays valid for the program's lifetime
+    /// @param name
+    /// @return allocation_stats&
+    static allocation_stats &category(const std::string &name)
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+
+        for (allocation_stats &stats : categories())
+        {
+            if (stats.name == name)
+                return stats;
+        }
+
+        return categories().emplace_back(name);
+    }
+
+    /// @brief Print a table of every subsystem
+    /// @param out
+    static void print_report(std::ostream &out)
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+
+        out << std::left << std::setw(24) << "subsystem"
+            << std::right << std::setw(14) << "allocs"
+            << std::setw(14) << "frees"
+            << std::setw(16) << "in use (B)"
+            << std::setw(16) << "peak (B)"
+            << std::setw(18) << "total (B)" << "\n";
+
+        for (const allocation_stats &stats : categories())
+        {
+            out << std::left << std::setw(24) << stats.name
+                << std::right << std::setw(14) << stats.allocations.load()
+                << std::setw(14) << stats.deallocations.load()
+                << std::setw(16) << stats.bytes_in_use.load()
+                << std::setw(16) << stats.peak_bytes.load()
+                << std::setw(18) << stats.bytes_allocated.load() << "\n";
+        }
+    }
+};
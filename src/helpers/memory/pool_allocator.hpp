@@ -0,0 +1,263 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "./memory_stats.hpp"
+
+// ======= MACROS =======
+
+#define POOL_BLOCK_ALIGN alignof(std::max_align_t)
+#define POOL_SIZE_CLASS_STEP 16
+#define POOL_SIZE_CLASS_COUNT 16 // size classes up to 256 bytes
+
+// ======= pool_allocator =======
+
+/// @brief Fixed-size block allocator: pages carved into blocks, freed blocks go on an intrusive free list (not thread-safe)
+class pool_allocator
+{
+private:
+    struct free_block
+    {
+        free_block *next;
+    };
+
+    size_t block_size;
+    size_t blocks_per_page;
+
+    std::vector<unsigned char *> pages;
+    free_block *free_list = nullptr;
+
+    size_t blocks_in_use = 0;
+
+    allocation_stats *stats;
+
+private:
+    /// @brief Allocate a page and thread its blocks onto the free list
+    void grow()
+    {
+        unsigned char *page = static_cast<unsigned char *>(::operator new(block_size * blocks_per_page, std::align_val_t(POOL_BLOCK_ALIGN)));
+        pages.push_back(page);
+
+        for (size_t i = blocks_per_page; i-- > 0;)
+        {
+            free_block *block = reinterpret_cast<free_block *>(page + i * block_size);
+            block->next = free_list;
+            free_list = block;
+        }
+    }
+
+public:
+    // ======= CONSTRUCTOR =======
+
+    /// @brief Constructor for pool_allocator
+    /// @param block_size: Bytes per block (rounded up to POOL_BLOCK_ALIGN)
+    /// @param blocks_per_page: Blocks allocated at once when the pool runs dry (default: 256)
+    /// @param stats: Subsystem to report to (default: "pool")
+    explicit pool_allocator(size_t block_size, size_t blocks_per_page = 256, allocation_stats *stats = nullptr)
+        : block_size((std::max(block_size, sizeof(free_block)) + POOL_BLOCK_ALIGN - 1) & ~(POOL_BLOCK_ALIGN - 1)),
+          blocks_per_page(blocks_per_page ? blocks_per_page : 1),
+          stats(stats ? stats : &memory_stats::category("pool")) {}
+
+    // ======= DESTRUCTOR =======
+
+    ~pool_allocator()
+    {
+        for (unsigned char *page : pages)
+            ::operator delete(page, std::align_val_t(POOL_BLOCK_ALIGN));
+    }
+
+    pool_allocator(const pool_allocator &) = delete;
+    pool_allocator &operator=(const pool_allocator &) = delete;
+
+    // ======= MAIN API =======
+
+    /// @brief Take one block, O(1)
+    /// @return void*
+    void *allocate()
+    {
+        if (!free_list)
+            grow();
+
+        free_block *block = free_list;
+        free_list = block->next;
+
+        ++blocks_in_use;
+        stats->on_allocate(block_size);
+
+        return block;
+    }
+
+    /// @brief Return a block, O(1)
+    /// @param ptr: A block from this pool (nullptr is ignored)
+    void deallocate(void *ptr)
+    {
+        if (!ptr)
+            return;
+
+        free_block *block = static_cast<free_block *>(ptr);
+        block->next = free_list;
+        free_list = block;
+
+        --blocks_in_use;
+        stats->on_deallocate(block_size);
+    }
+
+    // ======= UTILITY API =======
+
+    size_t get_block_size() const { return block_size; }
+    size_t in_use() const { return blocks_in_use; }
+    size_t capacity() const { return pages.size() * blocks_per_page; }
+};
+
+// ======= typed_pool =======
+
+/// @brief pool_allocator that constructs and destroys objects of one type
+/// @tparam T
+template <typename T>
+class typed_pool
+{
+    static_assert(alignof(T) <= POOL_BLOCK_ALIGN, "typed_pool: over-aligned types are not supported");
+
+private:
+    pool_allocator pool;
+
+public:
+    // ======= CONSTRUCTOR =======
+
+    /// @brief Constructor for typed_pool
+    /// @param blocks_per_page: Objects allocated at once when the pool runs dry (default: 256)
+    /// @param stats: Subsystem to report to (default: "pool")
+    explicit typed_pool(size_t blocks_per_page = 256, allocation_stats *stats = nullptr)
+        : pool(sizeof(T), blocks_per_page, stats) {}
+
+    // ======= MAIN API =======
+
+    /// @brief Construct an object inside the pool
+    /// @tparam ...Args
+    /// @param ...args
+    /// @return T*
+    template <typename... Args>
+    T *create(Args &&...args)
+    {
+        void *memory = pool.allocate();
+
+        try
+        {
+            return ::new (memory) T(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            pool.deallocate(memory);
+            throw;
+        }
+    }
+
+    /// @brief Destroy an object created by this pool
+    /// @param object
+    void destroy(T *object)
+    {
+        if (!object)
+            return;
+
+        object->~T();
+        pool.deallocate(object);
+    }
+
+    // ======= UTILITY API =======
+
+    size_t in_use() const { return pool.in_use(); }
+    size_t capacity() const { return pool.capacity(); }
+};
+
+// ======= size_class_pool =======
+
+/// @brief Thread-safe pools for every size class up to POOL_SIZE_CLASS_STEP * POOL_SIZE_CLASS_COUNT bytes; larger requests use the heap
+class size_class_pool
+{
+private:
+    std::vector<pool_allocator *> classes;
+    std::mutex mutex;
+
+    allocation_stats *stats;
+
+private:
+    /// @brief Size class of a request
+    static size_t class_of(size_t size) { return (size + POOL_SIZE_CLASS_STEP - 1) / POOL_SIZE_CLASS_STEP - (size ? 1 : 0); }
+
+public:
+    // ======= CONSTRUCTOR =======
+
+    /// @brief Constructor for size_class_pool
+    /// @param name: Subsystem name used for allocation stats
+    /// @param blocks_per_page: Blocks allocated at once per size class (default: 256)
+    explicit size_class_pool(const std::string &name, size_t blocks_per_page = 256)
+        : stats(&memory_stats::category(name))
+    {
+        for (size_t i = 0; i < POOL_SIZE_CLASS_COUNT; ++i)
+            classes.push_back(new pool_allocator((i + 1) * POOL_SIZE_CLASS_STEP, blocks_per_page, stats));
+    }
+
+    // ======= DESTRUCTOR =======
+
+    ~size_class_pool()
+    {
+        for (pool_allocator *pool : classes)
+            delete pool;
+    }
+
+    size_class_pool(const size_class_pool &) = delete;
+    size_class_pool &operator=(const size_class_pool &) = delete;
+
+    // ======= MAIN API =======
+
+    /// @brief Pools backing IComponent allocations; leaked on purpose so components freed during static destruction stay valid
+    /// @return size_class_pool&
+    static size_class_pool &components()
+    {
+        static size_class_pool *pool = new size_class_pool("components");
+        return *pool;
+    }
+
+    /// @brief Largest request served from a pool
+    static constexpr size_t max_pooled_size() { return POOL_SIZE_CLASS_STEP * POOL_SIZE_CLASS_COUNT; }
+
+    /// @brief Allocate size bytes
+    /// @param size
+    /// @return void*
+    void *allocate(size_t size)
+    {
+        if (size > max_pooled_size())
+        {
+            stats->on_allocate(size);
+            return ::operator new(size);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        return classes[class_of(size)]->allocate();
+    }
+
+    /// @brief Free memory from allocate; size must match the request
+    /// @param ptr
+    /// @param size
+    void deallocate(void *ptr, size_t size)
+    {
+        if (!ptr)
+            return;
+
+        if (size > max_pooled_size())
+        {
+            stats->on_deallocate(size);
+            ::operator delete(ptr);
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        classes[class_of(size)]->deallocate(ptr);
+    }
+};
@@ -0,0 +1,533 @@
+#pragma once
+
+// ======= BUILD FLAGS =======
+// ENGINE_PROFILING defaults to on in debug builds and off when NDEBUG is defined.
+// Define ENGINE_PROFILING=0 / 1 to force it; when off every macro below compiles to nothing.
+
+#ifndef ENGINE_PROFILING
+#ifdef NDEBUG
+#define ENGINE_PROFILING 0
+#else
+#define ENGINE_PROFILING 1
+#endif
+#endif
+
+#if ENGINE_PROFILING
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <glad/glad.h>
+
+// ======= STRUCTS =======
+
+struct profile_event
+{
+    const char *name;
+
+    uint64_t start_ns;
+    uint64_t end_ns;
+};
+
+struct trace_event
+{
+    const char *name;
+
+    uint64_t start_ns;
+    uint64_t duration_ns;
+
+    uint32_t thread_id;
+};
+
+struct scope_stats
+{
+    double mean_ms = 0.0;
+    double p95_ms = 0.0;
+    double p99_ms = 0.0;
+    double max_ms = 0.0;
+
+    size_t samples = 0;
+};
+
+// ======= profile_thread_buffer =======
+
+/// @brief Single-producer ring of events; only the owning thread writes, the collector reads behind it
+class profile_thread_buffer
+{
+public:
+    static constexpr size_t capacity = 1 << 14;
+
+private:
+    profile_event events[capacity];
+
+    std::atomic<uint64_t> head{0};
+    uint64_t tail = 0;
+
+public:
+    uint32_t thread_id;
+
+    std::atomic<bool> retired{false};
+
+    // ======= CONSTRUCTOR =======
+
+    /// @brief Constructor for profile_thread_buffer
+    /// @param id: Trace thread ID
+    explicit profile_thread_buffer(uint32_t id) : thread_id(id) {}
+
+    // ======= MAIN API =======
+
+    /// @brief Record an event (owning thread only, wait-free)
+    /// @param event
+    void push(const profile_event &event)
+    {
+        uint64_t h = head.load(std::memory_order_relaxed);
+        events[h & (capacity - 1)] = event;
+        head.store(h + 1, std::memory_order_release);
+    }
+
+    /// @brief Move every event recorded since the last drain into out (collector only)
+    /// @tparam Function: void(const profile_event &)
+    /// @param out
+    template <typename Function>
+    void drain(Function &&out)
+    {
+        uint64_t h = head.load(std::memory_order_acquire);
+
+        if (h - tail > capacity)
+            tail = h - capacity; // ring overflowed, the oldest events are gone
+
+        for (; tail < h; ++tail)
+        {
+            profile_event event = events[tail & (capacity - 1)];
+
+            // ======= the producer lapped us while copying, drop the torn entry =======
+
+            if (head.load(std::memory_order_acquire) - tail >= capacity)
+                continue;
+
+            out(event);
+        }
+    }
+
+    /// @brief If every recorded event has been drained (collector only)
+    /// @return bool
+    bool drained() const { return tail == head.load(std::memory_order_acquire); }
+};
+
+// ======= frame_profiler =======
+
+class frame_profiler
+{
+public:
+    static constexpr size_t stats_window = 240;
+    static constexpr size_t trace_capacity = 1 << 18;
+    static constexpr int gpu_frames_in_flight = 4;
+
+    static constexpr uint32_t gpu_thread_id = 0xFFFF;
+
+private:
+    struct scope_window
+    {
+        float samples_ms[stats_window] = {};
+
+        size_t next = 0;
+        size_t count = 0;
+    };
+
+    struct gpu_query
+    {
+        const char *name;
+
+        unsigned int query;
+        uint64_t cpu_start_ns;
+    };
+
+    std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+    std::mutex mutex;
+
+    std::vector<std::unique_ptr<profile_thread_buffer>> thread_buffers;
+    std::atomic<uint32_t> next_thread_id{1};
+
+    std::unordered_map<const char *, scope_window> windows;
+
+    std::vector<trace_event> trace;
+    size_t trace_next = 0;
+
+    // ======= GPU (GL thread only) =======
+
+    std::vector<gpu_query> gpu_frames[gpu_frames_in_flight];
+    std::vector<unsigned int> free_queries;
+
+    int gpu_frame = 0;
+    bool gpu_query_open = false;
+
+private:
+    /// @brief Store a finished sample (mutex held)
+    void record(const char *name, uint64_t start_ns, uint64_t duration_ns, uint32_t thread_id)
+    {
+        scope_window &window = windows[name];
+
+        window.samples_ms[window.next] = static_cast<float>(duration_ns / 1e6);
+        window.next = (window.next + 1) % stats_window;
+        window.count = std::min(window.count + 1, stats_window);
+
+        trace_event event{name, start_ns, duration_ns, thread_id};
+
+        if (trace.size() < trace_capacity)
+            trace.push_back(event);
+        else
+            trace[trace_next] = event;
+
+        trace_next = (trace_next + 1) % trace_capacity;
+    }
+
+    /// @brief Get (or register) the calling thread's buffer; buffers of exited threads are reused once drained
+    /// @return profile_thread_buffer&
+    profile_thread_buffer &thread_buffer()
+    {
+        struct buffer_handle
+        {
+            profile_thread_buffer *buffer = nullptr;
+
+            ~buffer_handle()
+            {
+                if (buffer)
+                    buffer->retired.store(true, std::memory_order_release);
+            }
+        };
+
+        thread_local buffer_handle handle;
+
+        if (!handle.buffer)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            for (auto &buffer : thread_buffers)
+            {
+                if (buffer->retired.load(std::memory_order_acquire) && buffer->drained())
+                {
+                    buffer->thread_id = next_thread_id++;
+                    buffer->retired.store(false, std::memory_order_relaxed);
+
+                    handle.buffer = buffer.get();
+                    break;
+                }
+            }
+
+            if (!handle.buffer)
+            {
+                thread_buffers.push_back(std::make_unique<profile_thread_buffer>(next_thread_id++));
+                handle.buffer = thread_buffers.back().get();
+            }
+        }
+
+        return *handle.buffer;
+    }
+
+public:
+    // ======= CONSTRUCTOR =======
+
+    /// @brief Constructor for frame_profiler, reserves the whole trace history so end_frame() doesn't allocate once warm
+    frame_profiler()
+    {
+        trace.reserve(trace_capacity);
+    }
+
+    // ======= SINGLETON =======
+
+    /// @brief Get the global profiler
+    /// @return frame_profiler&
+    static frame_profiler &get()
+    {
+        static frame_profiler instance;
+        return instance;
+    }
+
+    // ======= CPU API =======
+
+    /// @brief Nanoseconds since the profiler started
+    /// @return uint64_t
+    uint64_t now_ns() const
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now() - epoch)
+                                         .count());
+    }
+
+    /// @brief Record a finished CPU scope on the calling thread (lock-free)
+    /// @param name: Scope name, must have static storage (string literal)
+    /// @param start_ns
+    /// @param end_ns
+    void submit(const char *name, uint64_t start_ns, uint64_t end_ns)
+    {
+        thread_buffer().push({name, start_ns, end_ns});
+    }
+
+    /// @brief Drain every thread buffer into the rolling statistics and trace history (call once per frame)
+    void end_frame()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        for (auto &buffer : thread_buffers)
+        {
+            uint32_t thread_id = buffer->thread_id;
+
+            buffer->drain([this, thread_id](const profile_event &event)
+                          { record(event.name, event.start_ns, event.end_ns - event.start_ns, thread_id); });
+        }
+    }
+
+    // ======= GPU API (GL thread only) =======
+
+    /// @brief Start a GL_TIME_ELAPSED query; GPU scopes can not nest
+    /// @param name: Scope name, must have static storage (string literal)
+    void begin_gpu(const char *name)
+    {
+        if (gpu_query_open)
+            return;
+
+        unsigned int query;
+
+        if (free_queries.empty())
+            glGenQueries(1, &query);
+        else
+        {
+            query = free_queries.back();
+            free_queries.pop_back();
+        }
+
+        glBeginQuery(GL_TIME_ELAPSED, query);
+
+        gpu_frames[gpu_frame].push_back({name, query, now_ns()});
+        gpu_query_open = true;
+    }
+
+    /// @brief End the open GL_TIME_ELAPSED query
+    void end_gpu()
+    {
+        if (!gpu_query_open)
+            return;
+
+        glEndQuery(GL_TIME_ELAPSED);
+        gpu_query_open = false;
+    }
+
+    /// @brief Advance the GPU frame ring and read back queries issued gpu_frames_in_flight frames ago without stalling
+    void end_gpu_frame()
+    {
+        gpu_frame = (gpu_frame + 1) % gpu_frames_in_flight;
+
+        std::vector<gpu_query> &oldest = gpu_frames[gpu_frame];
+
+        if (oldest.empty())
+            return;
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        for (const gpu_query &q : oldest)
+        {
+            int available = 0;
+            glGetQueryObjectiv(q.query, GL_QUERY_RESULT_AVAILABLE, &available);
+
+            if (available)
+            {
+                GLuint64 elapsed = 0;
+                glGetQueryObjectui64v(q.query, GL_QUERY_RESULT, &elapsed);
+
+                record(q.name, q.cpu_start_ns, elapsed, gpu_thread_id);
+            }
+
+            // ======= results that still aren't ready are dropped rather than waited on =======
+
+            free_queries.push_back(q.query);
+        }
+
+        oldest.clear();
+    }
+
+    // ======= REPORTING API =======
+
+    /// @brief Get rolling statistics (last stats_window samples) for a scope
+    /// @param name: The scope name
+    /// @return scope_stats
+    scope_stats get_stats(const char *name)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto it = windows.find(name);
+
+        if (it == windows.end())
+        {
+            // ======= names are keyed by pointer; fall back to a string compare =======
+
+            it = std::find_if(windows.begin(), windows.end(), [name](const auto &entry)
+                              { return std::string(entry.first) == name; });
+
+            if (it == windows.end())
+                return {};
+        }
+
+        const scope_window &window = it->second;
+
+        std::vector<float> sorted(window.samples_ms, window.samples_ms + window.count);
+        std::sort(sorted.begin(), sorted.end());
+
+        scope_stats stats;
+        stats.samples = sorted.size();
+
+        if (sorted.empty())
+            return stats;
+
+        double total = 0.0;
+
+        for (float sample : sorted)
+            total += sample;
+
+        auto percentile = [&sorted](double p)
+        {
+            size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+            return static_cast<double>(sorted[index]);
+        };
+
+        stats.mean_ms = total / sorted.size();
+        stats.p95_ms = percentile(0.95);
+        stats.p99_ms = percentile(0.99);
+        stats.max_ms = sorted.back();
+
+        return stats;
+    }
+
+    /// @brief Print every scope's rolling statistics
+    /// @param out: Output stream (default: std::cout)
+    void print_report(std::ostream &out = std::cout)
+    {
+        std::vector<const char *> names;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            for (const auto &entry : windows)
+                names.push_back(entry.first);
+        }
+
+        out << std::left << std::setw(32) << "scope"
+            << std::right << std::setw(12) << "mean(ms)" << std::setw(12) << "p95(ms)" << std::setw(12) << "p99(ms)" << "\n";
+
+        for (const char *name : names)
+        {
+            scope_stats stats = get_stats(name);
+
+            out << std::left << std::setw(32) << name << std::right << std::fixed << std::setprecision(3)
+                << std::setw(12) << stats.mean_ms << std::setw(12) << stats.p95_ms << std::setw(12) << stats.p99_ms << "\n";
+        }
+    }
+
+    /// @brief Write the retained trace history as Chrome trace-event JSON (chrome://tracing, Perfetto)
+    /// @param path: Output file path
+    /// @return bool: false if the file could not be opened
+    bool export_chrome_trace(const std::string &path)
+    {
+        std::ofstream file(path);
+
+        if (!file.is_open())
+        {
+            std::cerr << "export_chrome_trace(): Failed to open " << path << std::endl;
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        file << "{\"traceEvents\":[\n";
+
+        bool first = true;
+
+        for (const trace_event &event : trace)
+        {
+            if (!first)
+                file << ",\n";
+
+            first = false;
+
+            file << "{\"name\":\"" << event.name
+                 << "\",\"cat\":\"" << (event.thread_id == gpu_thread_id ? "gpu" : "cpu")
+                 << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread_id
+                 << ",\"ts\":" << event.start_ns / 1000.0
+                 << ",\"dur\":" << event.duration_ns / 1000.0 << "}";
+        }
+
+        file << "\n]}\n";
+
+        return true;
+    }
+};
+
+// ======= profile_scope =======
+
+/// @brief RAII CPU scope marker
+class profile_scope
+{
+private:
+    const char *name;
+    uint64_t start_ns;
+
+public:
+    explicit profile_scope(const char *scope_name)
+        : name(scope_name), start_ns(frame_profiler::get().now_ns()) {}
+
+    ~profile_scope()
+    {
+        frame_profiler &profiler = frame_profiler::get();
+        profiler.submit(name, start_ns, profiler.now_ns());
+    }
+
+    profile_scope(const profile_scope &) = delete;
+    profile_scope &operator=(const profile_scope &) = delete;
+};
+
+// ======= gpu_profile_scope =======
+
+/// @brief RAII GPU scope marker (GL thread only, can not nest)
+class gpu_profile_scope
+{
+public:
+    explicit gpu_profile_scope(const char *scope_name) { frame_profiler::get().begin_gpu(scope_name); }
+
+    ~gpu_profile_scope() { frame_profiler::get().end_gpu(); }
+
+    gpu_profile_scope(const gpu_profile_scope &) = delete;
+    gpu_profile_scope &operator=(const gpu_profile_scope &) = delete;
+};
+
+// ======= MACROS =======
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#define PROFILE_SCOPE(name) profile_scope PROFILE_CONCAT(profile_scope_, __LINE__)(name)
+#define PROFILE_GPU_SCOPE(name) gpu_profile_scope PROFILE_CONCAT(gpu_profile_scope_, __LINE__)(name)
+#define PROFILE_FRAME_END() frame_profiler::get().end_frame()
+#define PROFILE_GPU_FRAME_END() frame_profiler::get().end_gpu_frame()
+#define PROFILE_EXPORT_TRACE(path) frame_profiler::get().export_chrome_trace(path)
+#define PROFILE_PRINT_REPORT() frame_profiler::get().print_report()
+
+#else
+
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_GPU_SCOPE(name) ((void)0)
+#define PROFILE_FRAME_END() ((void)0)
+#define PROFILE_GPU_FRAME_END() ((void)0)
+#define PROFILE_EXPORT_TRACE(path) ((void)0)
+#define PROFILE_PRINT_REPORT() ((void)0)
+
+#endif
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// ======= spsc_queue =======
+
+/// @brief Fixed-capacity lock-free queue for exactly one producer thread and one consumer thread
+/// @note Never allocates; a full queue rejects new items instead of overwriting unread ones
+/// @tparam T: Trivially copyable item
+/// @tparam Capacity: Power of two
+template <typename T, size_t Capacity>
+class spsc_queue
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "spsc_queue: Capacity must be a power of two");
+
+private:
+    T items[Capacity];
+
+    // ======= head / tail on their own cache lines so producer and consumer don't false share =======
+
+    alignas(64) std::atomic<uint64_t> head{0}; // next slot to write (producer)
+    alignas(64) std::atomic<uint64_t> tail{0}; // next slot to read (consumer)
+
+    std::atomic<uint64_t> dropped{0};
+
+public:
+    // ======= PRODUCER =======
+
+    /// @brief Append an item (producer only, wait-free)
+    /// @param item
+    /// @return bool: false if the queue was full and the item was dropped
+    bool push(const T &item)
+    {
+        uint64_t h = head.load(std::memory_order_relaxed);
+
+        if (h - tail.load(std::memory_order_acquire) >= Capacity)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        items[h & (Capacity - 1)] = item;
+        head.store(h + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // ======= CONSUMER =======
+
+    /// @brief Take the oldest item (consumer only)
+    /// @param out
+    /// @return bool: false if the queue was empty
+    bool pop(T &out)
+    {
+        uint64_t t = tail.load(std::memory_order_relaxed);
+
+        if (t == head.load(std::memory_order_acquire))
+            return false;
+
+        out = items[t & (Capacity - 1)];
+        tail.store(t + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /// @brief Hand every queued item to out in order, oldest first (consumer only)
+    /// @tparam Function: void(const T &)
+    /// @param out
+    /// @return size_t: Amount of items drained
+    template <typename Function>
+    size_t drain(Function &&out)
+    {
+        uint64_t t = tail.load(std::memory_order_relaxed);
+        uint64_t h = head.load(std::memory_order_acquire);
+
+        for (uint64_t i = t; i < h; ++i)
+            out(items[i & (Capacity - 1)]);
+
+        tail.store(h, std::memory_order_release);
+
+        return static_cast<size_t>(h - t);
+    }
+
+    // ======= UTILITY API =======
+
+    /// @brief Items currently queued (approximate while the other side is running)
+    /// @return size_t
+    size_t size() const { return static_cast<size_t>(head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire)); }
+
+    /// @brief Items rejected because the queue was full
+    /// @return uint64_t
+    uint64_t dropped_count() const { return dropped.load(std::memory_order_relaxed); }
+
+    /// @brief Max amount of queued items
+    /// @return size_t
+    static constexpr size_t capacity() { return Capacity; }
+};
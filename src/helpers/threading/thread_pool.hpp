@@ -0,0 +1,286 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// ======= thread_pool =======
+
+/// @brief Fixed set of worker threads pulling from one task queue; waiting threads help run tasks
+class thread_pool
+{
+private:
+    /// @brief One parallel_for call; lives on the caller's stack, so queuing its ranges doesn't allocate
+    struct parallel_job
+    {
+        void (*run)(void *function, size_t begin, size_t end) = nullptr;
+        void *function = nullptr;
+
+        size_t begin = 0;
+        size_t end = 0;
+        size_t step = 0;
+
+        size_t ranges = 0;
+        size_t claimed = 0; // guarded by the pool mutex
+
+        std::atomic<size_t> remaining{0}; // ranges not finished yet
+        std::atomic<bool> failed{false};
+        std::exception_ptr error; // first exception of a range, guarded by the pool mutex
+
+        parallel_job *next = nullptr;
+    };
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+
+    parallel_job *jobs = nullptr; // jobs with unclaimed ranges, newest first
+
+    std::mutex mutex;
+    std::condition_variable cv;
+
+    bool stopping = false;
+
+private:
+    /// @brief Claim the next range of the newest job, unlinking the job once every range is claimed; mutex must be held
+    /// @param job
+    /// @param range
+    /// @return bool: false if no job has ranges left
+    bool claim_range(parallel_job *&job, size_t &range)
+    {
+        if (!jobs)
+            return false;
+
+        job = jobs;
+        range = job->claimed++;
+
+        if (job->claimed == job->ranges)
+            jobs = job->next;
+
+        return true;
+    }
+
+    /// @brief Run one range of a job; an exception is kept for the caller, and later ranges are skipped
+    /// @param job
+    /// @param range
+    void run_range(parallel_job &job, size_t range)
+    {
+        size_t start = job.begin + range * job.step;
+        size_t stop = start + job.step < job.end ? start + job.step : job.end;
+
+        if (!job.failed.load(std::memory_order_acquire))
+        {
+            try
+            {
+                job.run(job.function, start, stop);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+
+                if (!job.error)
+                    job.error = std::current_exception();
+
+                job.failed.store(true, std::memory_order_release);
+            }
+        }
+
+        // ======= last access: the caller may return as soon as this reaches 0 =======
+
+        job.remaining.fetch_sub(1, std::memory_order_release);
+    }
+
+    /// @brief Worker loop
+    void worker_loop()
+    {
+        while (true)
+        {
+            std::function<void()> task;
+            parallel_job *job = nullptr;
+            size_t range = 0;
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+
+                cv.wait(lock, [this]
+                        { return stopping || jobs || !tasks.empty(); });
+
+                if (!claim_range(job, range))
+                {
+                    if (tasks.empty())
+                        return;
+
+                    task = std::move(tasks.front());
+                    tasks.pop_front();
+                }
+            }
+
+            if (job)
+                run_range(*job, range);
+            else
+                task();
+        }
+    }
+
+public:
+    // ======= CONSTRUCTOR =======
+
+    /// @brief Constructor for thread_pool
+    /// @param thread_count: Amount of workers; the calling thread also helps while waiting (default: cores - 1)
+    explicit thread_pool(size_t thread_count = std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 0)
+    {
+        workers.reserve(thread_count);
+
+        for (size_t i = 0; i < thread_count; ++i)
+            workers.emplace_back([this]
+                                 { worker_loop(); });
+    }
+
+    // ======= DESTRUCTOR =======
+
+    /// @brief Destructor, finishes queued tasks then joins every worker
+    ~thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+
+        cv.notify_all();
+
+        for (std::thread &worker : workers)
+            worker.join();
+    }
+
+    thread_pool(const thread_pool &) = delete;
+    thread_pool &operator=(const thread_pool &) = delete;
+
+    // ======= MAIN API =======
+
+    /// @brief Get the engine-wide shared pool
+    /// @return thread_pool&
+    static thread_pool &shared()
+    {
+        static thread_pool pool;
+        return pool;
+    }
+
+    /// @brief Queue a task
+    /// @param task
+    void submit(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.push_back(std::move(task));
+        }
+
+        cv.notify_one();
+    }
+
+    /// @brief Run one parallel_for range or queued task on the calling thread
+    /// @return bool: false if there was nothing to run
+    bool run_pending_task()
+    {
+        std::function<void()> task;
+        parallel_job *job = nullptr;
+        size_t range = 0;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            if (!claim_range(job, range))
+            {
+                if (tasks.empty())
+                    return false;
+
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+        }
+
+        if (job)
+            run_range(*job, range);
+        else
+            task();
+
+        return true;
+    }
+
+    /// @brief Split [begin, end) into ranges of at least grain and run them in parallel; blocks until done
+    /// @note Doesn't allocate: workers claim ranges from a job record on the caller's stack. If a range throws, the
+    /// ranges not started yet are skipped and the first exception is rethrown once every range has finished
+    /// @tparam Function: void(size_t range_begin, size_t range_end)
+    /// @param begin
+    /// @param end
+    /// @param grain: Minimum range size
+    /// @param function
+    template <typename Function>
+    void parallel_for(size_t begin, size_t end, size_t grain, Function &&function)
+    {
+        using function_type = std::remove_reference_t<Function>;
+
+        if (end <= begin)
+            return;
+
+        size_t total = end - begin;
+        size_t max_ranges = (workers.size() + 1) * 4;
+
+        if (grain == 0)
+            grain = 1;
+
+        size_t ranges = (total + grain - 1) / grain;
+
+        if (ranges > max_ranges)
+            ranges = max_ranges;
+
+        if (ranges <= 1 || workers.empty())
+        {
+            function(begin, end);
+            return;
+        }
+
+        parallel_job job;
+
+        job.run = [](void *context, size_t range_begin, size_t range_end)
+        { (*static_cast<function_type *>(context))(range_begin, range_end); };
+        job.function = const_cast<void *>(static_cast<const void *>(std::addressof(function)));
+
+        job.begin = begin;
+        job.end = end;
+        job.step = (total + ranges - 1) / ranges;
+        job.ranges = (total + job.step - 1) / job.step;
+        job.remaining.store(job.ranges, std::memory_order_relaxed);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            job.next = jobs;
+            jobs = &job;
+        }
+
+        cv.notify_all();
+
+        // ======= help instead of sleeping, so nested parallel_for calls can't deadlock =======
+
+        while (job.remaining.load(std::memory_order_acquire) > 0)
+        {
+            if (!run_pending_task())
+                std::this_thread::yield();
+        }
+
+        if (job.error)
+            std::rethrow_exception(job.error);
+    }
+
+    // ======= UTILITY API =======
+
+    /// @brief Amount of worker threads (excluding callers that help)
+    /// @return size_t
+    size_t size() const { return workers.size(); }
+};
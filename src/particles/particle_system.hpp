@@ -0,0 +1,467 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "../helpers/architecture/entity_allocator.hpp"
+#include "../helpers/memory/aligned_allocator.hpp"
+#include "../helpers/math/simd.hpp"
+#include "../helpers/threading/thread_pool.hpp"
+#include "../rendering/particles/particle_frame.hpp"
+
+// ======= MACROS =======
+
+#define PARTICLE_LANE_PADDING 8        // pools are padded to this many lanes (widest SIMD path)
+#define PARTICLE_UPDATE_GRAIN 16384    // particles per update task
+
+// ======= TYPES =======
+
+/// @brief Generational emitter handle (same layout as entity)
+using emitter_handle = uint32_t;
+
+constexpr emitter_handle null_emitter = null_entity;
+
+// ======= STRUCTS =======
+
+/// @brief How an emitter spawns and moves its particles
+struct emitter_params
+{
+    glm::vec3 position{0.0f};
+    glm::vec3 spawn_extent{0.0f}; // half size of the spawn box around position
+
+    float rate = 100.0f; // particles per second
+    size_t max_particles = 100000;
+
+    glm::vec3 velocity{0.0f, 1.0f, 0.0f};
+    float velocity_spread = 0.5f; // random velocity added per axis, +- this
+
+    float lifetime_min = 1.0f;
+    float lifetime_max = 2.0f;
+
+    glm::vec3 acceleration{0.0f, -9.81f, 0.0f};
+    float drag = 0.0f; // velocity damping per second
+
+    glm::vec4 color_start{1.0f};
+    glm::vec4 color_end{1.0f, 1.0f, 1.0f, 0.0f};
+
+    float size_start = 0.1f;
+    float size_end = 0.05f;
+};
+
+/// @brief What the last update did
+struct particle_stats
+{
+    size_t live = 0;
+    size_t spawned = 0;
+    size_t died = 0;
+    size_t emitters = 0;
+};
+
+// ======= particle_system =======
+
+/// @brief CPU particles: one SoA pool per emitter, advanced by a vectorised pass split across the thread pool
+/// @note Dead particles are compacted by moving live ones from the end into the holes, so pools stay dense and
+/// packing a frame is a copy of the position and age arrays
+class particle_system
+{
+private:
+    /// @brief An emitter and its particles; age is normalized (0 = born, 1 = dead)
+    struct emitter
+    {
+        emitter_params params;
+
+        bool emitting = true;
+        float spawn_debt = 0.0f; // fractional particles carried to the next update
+        uint32_t seed = 0;
+
+        size_t count = 0;
+
+        aligned_vector<float> pos_x, pos_y, pos_z;
+        aligned_vector<float> vel_x, vel_y, vel_z;
+        aligned_vector<float> age, inv_lifetime;
+
+        /// @brief Every SoA array, for bulk resizes
+        template <typename Function>
+        void for_each_array(Function &&function)
+        {
+            for (aligned_vector<float> *array : {&pos_x, &pos_y, &pos_z, &vel_x, &vel_y, &vel_z, &age, &inv_lifetime})
+                function(*array);
+        }
+
+        /// @brief Copy particle from into slot to
+        void move_particle(size_t from, size_t to)
+        {
+            for_each_array([from, to](aligned_vector<float> &array)
+                           { array[to] = array[from]; });
+        }
+    };
+
+    /// @brief Lane range of one emitter handled by one task
+    struct update_task
+    {
+        uint32_t emitter;
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    entity_allocator handles;
+    std::vector<std::unique_ptr<emitter>> emitters; // by handle index, null once removed
+
+    std::vector<update_task> tasks;
+    std::vector<std::vector<uint32_t>> dead; // one per task, ascending indices
+
+    particle_stats stats;
+
+private:
+    // ======= HELPERS =======
+
+    static float random01(uint32_t &seed)
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+
+        return (seed >> 8) * (1.0f / 16777216.0f);
+    }
+
+    static float random_signed(uint32_t &seed) { return random01(seed) * 2.0f - 1.0f; }
+
+    emitter &get(emitter_handle handle)
+    {
+        if (!handles.alive(handle))
+            throw std::out_of_range("particle_system: Stale emitter handle");
+
+        return *emitters[entity_allocator::index_of(handle)];
+    }
+
+    /// @brief Grow the pool so count particles plus padding fit; padding lanes stay zero
+    static void reserve_lanes(emitter &e, size_t particles)
+    {
+        size_t padded = (particles + PARTICLE_LANE_PADDING - 1) / PARTICLE_LANE_PADDING * PARTICLE_LANE_PADDING;
+
+        if (padded <= e.pos_x.size())
+            return;
+
+        size_t grown = std::max(padded, e.pos_x.size() * 2);
+
+        e.for_each_array([grown](aligned_vector<float> &array)
+                         { array.resize(grown, 0.0f); });
+    }
+
+    /// @brief Append up to amount new particles (capped by max_particles)
+    static size_t spawn(emitter &e, size_t amount)
+    {
+        const emitter_params &p = e.params;
+
+        amount = std::min(amount, p.max_particles > e.count ? p.max_particles - e.count : size_t(0));
+
+        if (amount == 0)
+            return 0;
+
+        reserve_lanes(e, e.count + amount);
+
+        float life_range = std::max(p.lifetime_max - p.lifetime_min, 0.0f);
+
+        for (size_t k = 0; k < amount; ++k)
+        {
+            size_t i = e.count + k;
+
+            e.pos_x[i] = p.position.x + random_signed(e.seed) * p.spawn_extent.x;
+            e.pos_y[i] = p.position.y + random_signed(e.seed) * p.spawn_extent.y;
+            e.pos_z[i] = p.position.z + random_signed(e.seed) * p.spawn_extent.z;
+
+            e.vel_x[i] = p.velocity.x + random_signed(e.seed) * p.velocity_spread;
+            e.vel_y[i] = p.velocity.y + random_signed(e.seed) * p.velocity_spread;
+            e.vel_z[i] = p.velocity.z + random_signed(e.seed) * p.velocity_spread;
+
+            e.age[i] = 0.0f;
+            e.inv_lifetime[i] = 1.0f / std::max(p.lifetime_min + random01(e.seed) * life_range, 1e-4f);
+        }
+
+        e.count += amount;
+
+        return amount;
+    }
+
+    /// @brief Advance lanes [begin, end) of an emitter and record the particles that died, ascending
+    static void update_range(emitter &e, size_t begin, size_t end, float dt, std::vector<uint32_t> &out_dead)
+    {
+        const simd_float step = simd_float::set1(dt);
+        const simd_float damping = simd_float::set1(1.0f / (1.0f + dt * e.params.drag));
+        const simd_float one = simd_float::set1(1.0f);
+
+        const simd_float ax = simd_float::set1(e.params.acceleration.x * dt);
+        const simd_float ay = simd_float::set1(e.params.acceleration.y * dt);
+        const simd_float az = simd_float::set1(e.params.acceleration.z * dt);
+
+        const int lanes_mask = (1 << simd_float::width) - 1;
+
+        for (size_t i = begin; i < end; i += simd_float::width)
+        {
+            simd_float vx = (simd_float::load(&e.vel_x[i]) + ax) * damping;
+            simd_float vy = (simd_float::load(&e.vel_y[i]) + ay) * damping;
+            simd_float vz = (simd_float::load(&e.vel_z[i]) + az) * damping;
+
+            vx.store(&e.vel_x[i]);
+            vy.store(&e.vel_y[i]);
+            vz.store(&e.vel_z[i]);
+
+            (simd_float::load(&e.pos_x[i]) + vx * step).store(&e.pos_x[i]);
+            (simd_float::load(&e.pos_y[i]) + vy * step).store(&e.pos_y[i]);
+            (simd_float::load(&e.pos_z[i]) + vz * step).store(&e.pos_z[i]);
+
+            simd_float age = simd_float::load(&e.age[i]) + simd_float::load(&e.inv_lifetime[i]) * step;
+            age.store(&e.age[i]);
+
+            // ======= dead = age >= 1; padding lanes past the live count are ignored =======
+
+            int died = ~simd_float::movemask(simd_float::less(age, one)) & lanes_mask;
+
+            for (; died; died &= died - 1)
+            {
+                size_t k = i + __builtin_ctz(died);
+
+                if (k < e.count)
+                    out_dead.push_back(static_cast<uint32_t>(k));
+            }
+        }
+    }
+
+    /// @brief Fill holes left by dead particles with live ones from the end of the pool
+    /// @param e
+    /// @param holes: Ascending dead indices
+    /// @param hole_count
+    static void compact(emitter &e, const uint32_t *holes, size_t hole_count)
+    {
+        size_t low = 0, high = hole_count;
+        size_t last = e.count;
+
+        while (low < high)
+        {
+            --last;
+
+            // ======= a dead tail particle just shrinks the pool, a live one moves into the lowest hole =======
+
+            if (holes[high - 1] == last)
+            {
+                --high;
+                continue;
+            }
+
+            e.move_particle(last, holes[low++]);
+        }
+
+        e.count = last;
+
+        // ======= zero the vacated lanes so padding never reports deaths or draws =======
+
+        size_t padded = (e.count + hole_count + PARTICLE_LANE_PADDING - 1) / PARTICLE_LANE_PADDING * PARTICLE_LANE_PADDING;
+
+        e.for_each_array([&e, padded](aligned_vector<float> &array)
+                         { std::fill(array.begin() + e.count, array.begin() + padded, 0.0f); });
+    }
+
+public:
+    // ======= EMITTERS =======
+
+    /// @brief Add an emitter
+    /// @param params
+    /// @return emitter_handle
+    emitter_handle add_emitter(const emitter_params &params)
+    {
+        emitter_handle handle = handles.create();
+        uint32_t index = entity_allocator::index_of(handle);
+
+        if (index >= emitters.size())
+            emitters.resize(index + 1);
+
+        emitters[index] = std::make_unique<emitter>();
+        emitters[index]->params = params;
+        emitters[index]->seed = 0x9E3779B9u ^ (index * 2654435761u) ^ 1u;
+
+        return handle;
+    }
+
+    /// @brief Remove an emitter and all its particles; the handle becomes stale
+    /// @param handle
+    void remove_emitter(emitter_handle handle)
+    {
+        if (!handles.alive(handle))
+            return;
+
+        emitters[entity_allocator::index_of(handle)].reset();
+        handles.destroy(handle);
+    }
+
+    /// @brief If a handle still refers to an emitter
+    /// @param handle
+    /// @return bool
+    bool alive(emitter_handle handle) const { return handles.alive(handle); }
+
+    /// @brief Live-editable spawn and motion parameters (e.g. to move the emitter)
+    /// @param handle
+    /// @return emitter_params&
+    emitter_params &get_params(emitter_handle handle) { return get(handle).params; }
+
+    /// @brief Start or stop continuous spawning; live particles keep simulating
+    /// @param handle
+    /// @param emitting
+    void set_emitting(emitter_handle handle, bool emitting) { get(handle).emitting = emitting; }
+
+    /// @brief Spawn particles right away
+    /// @param handle
+    /// @param amount
+    /// @return size_t: Particles actually spawned (max_particles caps it)
+    size_t burst(emitter_handle handle, size_t amount) { return spawn(get(handle), amount); }
+
+    /// @brief Live particles of an emitter
+    /// @param handle
+    /// @return size_t
+    size_t particle_count(emitter_handle handle) { return get(handle).count; }
+
+    // ======= SIMULATION =======
+
+    /// @brief Spawn, advance and compact every emitter
+    /// @param dt
+    /// @param pool: Update tasks are split across it (default: thread_pool::shared())
+    void update(float dt, thread_pool &pool = thread_pool::shared())
+    {
+        stats = particle_stats{};
+
+        // ======= spawn (serial, cheap next to the update) and cut every pool into tasks =======
+
+        tasks.clear();
+
+        for (size_t index = 0; index < emitters.size(); ++index)
+        {
+            if (!emitters[index])
+                continue;
+
+            emitter &e = *emitters[index];
+            ++stats.emitters;
+
+            if (e.emitting && dt > 0.0f)
+            {
+                e.spawn_debt += e.params.rate * dt;
+
+                size_t amount = static_cast<size_t>(e.spawn_debt);
+                e.spawn_debt -= static_cast<float>(amount);
+
+                stats.spawned += spawn(e, amount);
+            }
+
+            size_t lanes = (e.count + PARTICLE_LANE_PADDING - 1) / PARTICLE_LANE_PADDING * PARTICLE_LANE_PADDING;
+
+            for (size_t begin = 0; begin < lanes; begin += PARTICLE_UPDATE_GRAIN)
+                tasks.push_back({static_cast<uint32_t>(index), static_cast<uint32_t>(begin), static_cast<uint32_t>(std::min(begin + PARTICLE_UPDATE_GRAIN, lanes))});
+        }
+
+        if (dead.size() < tasks.size())
+            dead.resize(tasks.size());
+
+        pool.parallel_for(0, tasks.size(), 1, [this, dt](size_t begin, size_t end)
+                          {
+                              for (size_t t = begin; t < end; ++t)
+                              {
+                                  dead[t].clear();
+                                  update_range(*emitters[tasks[t].emitter], tasks[t].begin, tasks[t].end, dt, dead[t]);
+                              }
+                          });
+
+        // ======= compact each emitter; its tasks are consecutive and ascending, so their holes are merged in order =======
+
+        for (size_t t = 0; t < tasks.size();)
+        {
+            emitter &e = *emitters[tasks[t].emitter];
+
+            size_t first = t;
+
+            while (t < tasks.size() && tasks[t].emitter == tasks[first].emitter)
+                ++t;
+
+            size_t holes = 0;
+
+            for (size_t k = first; k < t; ++k)
+                holes += dead[k].size();
+
+            if (holes == 0)
+                continue;
+
+            // ======= gather into the first task's bucket (reused capacity) when split across tasks =======
+
+            for (size_t k = first + 1; k < t; ++k)
+                dead[first].insert(dead[first].end(), dead[k].begin(), dead[k].end());
+
+            compact(e, dead[first].data(), holes);
+            stats.died += holes;
+        }
+
+        for (const auto &e : emitters)
+            stats.live += e ? e->count : 0;
+    }
+
+    /// @brief Copy every live particle into a frame for particle_renderer (one batch per non-empty emitter)
+    /// @param frame: Overwritten; capacity is reused
+    void pack(particle_frame &frame) const
+    {
+        frame.batches.clear();
+
+        // ======= resized in place rather than cleared, so a steady particle count never zero-fills the streams =======
+
+        frame.data.resize(size() * 4);
+
+        size_t offset = 0;
+
+        for (const auto &e : emitters)
+        {
+            if (!e || e->count == 0)
+                continue;
+
+            const emitter_params &p = e->params;
+            frame.batches.push_back({offset, static_cast<uint32_t>(e->count), p.color_start, p.color_end, p.size_start, p.size_end});
+
+            for (const aligned_vector<float> *array : {&e->pos_x, &e->pos_y, &e->pos_z, &e->age})
+            {
+                std::memcpy(frame.data.data() + offset, array->data(), e->count * sizeof(float));
+                offset += e->count;
+            }
+        }
+    }
+
+    /// @brief Remove every emitter and particle
+    void clear()
+    {
+        emitters.clear();
+        handles.clear();
+        tasks.clear();
+    }
+
+    // ======= UTILITY API =======
+
+    /// @brief Live particles over all emitters
+    /// @return size_t
+    size_t size() const
+    {
+        size_t total = 0;
+
+        for (const auto &e : emitters)
+            total += e ? e->count : 0;
+
+        return total;
+    }
+
+    /// @brief Amount of emitters
+    /// @return size_t
+    size_t emitter_count() const { return handles.size(); }
+
+    /// @brief Statistics of the last update
+    /// @return const particle_stats&
+    const particle_stats &get_stats() const { return stats; }
+};
@@ -0,0 +1,685 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "./physics_world.hpp"
+
+// ======= MACROS =======
+
+#define BROADPHASE_SWEEP_GRAIN 4096          // bodies per pair-generation task
+#define BROADPHASE_CELL_SCALE 1.5f           // automatic cell size = this * average body size
+#define BROADPHASE_MAX_LARGE_BODIES 16       // automatic cell size grows so at most this many bodies skip the grid
+#define BROADPHASE_DENSE_CELLS_PER_BODY 8    // dense grid while it needs at most this many cells per body, hash beyond
+
+// ======= STRUCTS =======
+
+/// @brief Candidate pair of dense body indices, a < b (valid until bodies are added or removed)
+struct broadphase_pair
+{
+    uint32_t a;
+    uint32_t b;
+};
+
+/// @brief What the last update did
+struct broadphase_stats
+{
+    size_t bodies = 0;
+    size_t active_bodies = 0; // dynamic and awake, re-binned every update
+    size_t pairs = 0;
+    size_t large_bodies = 0; // bigger than a cell, tested against every body
+
+    float cell_size = 0.0f;
+
+    bool resting_rebuilt = false; // static / sleeping grid had to be rebuilt
+};
+
+// ======= broadphase_grid =======
+
+/// @brief Uniform grid of AABBs binned by their min corner with a counting sort
+/// @note No binned box may be larger than a cell, so partners sit in the 27 surrounding cells.
+/// Compact sets use a dense grid over the occupied cell range, sparse ones hash cells into a table sized by the body count
+class broadphase_grid
+{
+public:
+    /// @brief One binned body; half a cache line, so a neighbour test touches a single line
+    struct alignas(32) entry
+    {
+        float min[3];
+        float max[3];
+
+        uint32_t body;
+        uint32_t active; // pairs need at least one active side
+    };
+
+private:
+    // ======= binned bodies in bucket order, so every cell is one contiguous run =======
+
+    std::vector<uint32_t> bucket_start; // table size + 1
+    std::vector<uint32_t> bucket_fill;
+
+    std::vector<uint64_t> body_keys; // input order
+    std::vector<uint32_t> body_buckets;
+
+    std::vector<entry, aligned_allocator<entry>> entries;
+    std::vector<uint64_t> entry_key; // cell of every entry (hashed buckets mix cells)
+
+    uint32_t table_bits = 0;
+
+    bool dense = false;
+    int32_t origin[3] = {0, 0, 0};
+    int32_t dims[3] = {0, 0, 0};
+
+    float inv_cell = 1.0f;
+
+private:
+    // ======= CELL HELPERS =======
+
+    static constexpr uint64_t cell_bits = 21;
+    static constexpr uint64_t cell_mask = (1ull << cell_bits) - 1;
+
+    /// @brief Pack cell coordinates (wrapping every 2^21 cells, far beyond any overlap distance)
+    static uint64_t pack(int32_t x, int32_t y, int32_t z)
+    {
+        return ((static_cast<uint64_t>(x) & cell_mask) << (2 * cell_bits)) | ((static_cast<uint64_t>(y) & cell_mask) << cell_bits) | (static_cast<uint64_t>(z) & cell_mask);
+    }
+
+    uint32_t bucket_of(uint64_t key) const
+    {
+        return static_cast<uint32_t>((key * 0x9E3779B97F4A7C15ull) >> (64 - table_bits));
+    }
+
+    int32_t cell_of(float value) const { return static_cast<int32_t>(std::floor(value * inv_cell)); }
+
+    size_t grid_index(int32_t x, int32_t y, int32_t z) const { return (static_cast<size_t>(x) * dims[1] + y) * dims[2] + z; }
+
+    /// @brief Test a box against entries [begin, end); hashed buckets also hold other cells, so those filter by key
+    /// @tparam Hashed
+    template <bool Hashed>
+    void test_run(const entry &self, uint64_t key, size_t begin, size_t end, std::vector<broadphase_pair> &out) const
+    {
+        for (size_t q = begin; q < end; ++q)
+        {
+            const entry &other = entries[q];
+
+            // ======= non-short-circuit: one well-predicted branch instead of up to seven random ones =======
+
+            bool overlap = (other.min[0] <= self.max[0]) & (other.max[0] >= self.min[0]) &
+                           (other.min[1] <= self.max[1]) & (other.max[1] >= self.min[1]) &
+                           (other.min[2] <= self.max[2]) & (other.max[2] >= self.min[2]) &
+                           ((self.active | other.active) != 0);
+
+            if (Hashed)
+                overlap &= entry_key[q] == key;
+
+            if (!overlap)
+                continue;
+
+            uint32_t a = self.body, b = other.body;
+            out.push_back(a < b ? broadphase_pair{a, b} : broadphase_pair{b, a});
+        }
+    }
+
+public:
+    // ======= MAIN API =======
+
+    /// @brief Bin a set of bodies
+    /// @param bodies: Dense body indices
+    /// @param count
+    /// @param bounds_min: Per-axis min arrays indexed by dense body index
+    /// @param bounds_max: Per-axis max arrays indexed by dense body index
+    /// @param active: Stored in every entry
+    /// @param cell_size
+    void build(const uint32_t *bodies, size_t count, const float *const bounds_min[3], const float *const bounds_max[3], bool active, float cell_size)
+    {
+        inv_cell = 1.0f / cell_size;
+
+        body_keys.resize(count);
+        body_buckets.resize(count);
+
+        // ======= cell range of every min corner decides dense grid vs hash table =======
+
+        int32_t low[3] = {INT32_MAX, INT32_MAX, INT32_MAX};
+        int32_t high[3] = {INT32_MIN, INT32_MIN, INT32_MIN};
+
+        for (size_t k = 0; k < count; ++k)
+        {
+            for (int a = 0; a < 3; ++a)
+            {
+                int32_t c = cell_of(bounds_min[a][bodies[k]]);
+
+                low[a] = std::min(low[a], c);
+                high[a] = std::max(high[a], c);
+            }
+        }
+
+        dense = false;
+
+        if (count > 0)
+        {
+            double cells = 1.0;
+
+            for (int a = 0; a < 3; ++a)
+            {
+                origin[a] = low[a];
+                dims[a] = high[a] - low[a] + 1;
+                cells *= dims[a];
+            }
+
+            dense = cells <= static_cast<double>(std::max<size_t>(count, 64)) * BROADPHASE_DENSE_CELLS_PER_BODY;
+        }
+
+        size_t table;
+
+        if (dense)
+        {
+            table = static_cast<size_t>(dims[0]) * dims[1] * dims[2];
+        }
+        else
+        {
+            // ======= table at least twice the body count, so most cells get their own bucket =======
+
+            table_bits = 4;
+
+            while ((size_t(1) << table_bits) < count * 2)
+                ++table_bits;
+
+            table = size_t(1) << table_bits;
+        }
+
+        bucket_start.assign(table + 1, 0);
+
+        for (size_t k = 0; k < count; ++k)
+        {
+            uint32_t i = bodies[k];
+            int32_t cx = cell_of(bounds_min[0][i]), cy = cell_of(bounds_min[1][i]), cz = cell_of(bounds_min[2][i]);
+
+            body_keys[k] = pack(cx, cy, cz);
+            body_buckets[k] = dense ? static_cast<uint32_t>(grid_index(cx - origin[0], cy - origin[1], cz - origin[2])) : bucket_of(body_keys[k]);
+
+            ++bucket_start[body_buckets[k] + 1];
+        }
+
+        for (size_t b = 0; b < table; ++b)
+            bucket_start[b + 1] += bucket_start[b];
+
+        bucket_fill.assign(bucket_start.begin(), bucket_start.end() - 1);
+
+        entries.resize(count);
+        entry_key.resize(count);
+
+        // ======= scatter, gathering bounds alongside so a cell's bodies are contiguous in memory =======
+
+        for (size_t k = 0; k < count; ++k)
+        {
+            uint32_t slot = bucket_fill[body_buckets[k]]++;
+            entry &e = entries[slot];
+
+            e.body = bodies[k];
+            e.active = active;
+
+            for (int a = 0; a < 3; ++a)
+            {
+                e.min[a] = bounds_min[a][bodies[k]];
+                e.max[a] = bounds_max[a][bodies[k]];
+            }
+
+            entry_key[slot] = body_keys[k];
+        }
+    }
+
+    /// @brief Pairs inside the grid for entries [begin, end): own cell plus the 13 forward neighbours, each pair once
+    /// @param begin
+    /// @param end
+    /// @param out
+    void self_pairs(size_t begin, size_t end, std::vector<broadphase_pair> &out) const
+    {
+        for (size_t p = begin; p < end; ++p)
+        {
+            const entry &self = entries[p];
+
+            int32_t cx = cell_of(self.min[0]);
+            int32_t cy = cell_of(self.min[1]);
+            int32_t cz = cell_of(self.min[2]);
+
+            if (dense)
+            {
+                // ======= z-neighbours are adjacent cells, so the 13 forward cells collapse into 5 contiguous runs =======
+
+                int32_t x = cx - origin[0], y = cy - origin[1], z = cz - origin[2];
+
+                size_t own_end = grid_index(x, y, std::min(z + 1, dims[2] - 1)) + 1;
+                test_run<false>(self, 0, p + 1, bucket_start[own_end], out);
+
+                static constexpr int32_t rows[4][2] = {{0, 1}, {1, -1}, {1, 0}, {1, 1}};
+
+                for (const auto &row : rows)
+                {
+                    int32_t nx = x + row[0], ny = y + row[1];
+
+                    if (nx >= dims[0] || ny < 0 || ny >= dims[1])
+                        continue;
+
+                    size_t first = grid_index(nx, ny, std::max(z - 1, 0));
+                    size_t last = grid_index(nx, ny, std::min(z + 1, dims[2] - 1));
+
+                    test_run<false>(self, 0, bucket_start[first], bucket_start[last + 1], out);
+                }
+
+                continue;
+            }
+
+            // ======= own cell: only later entries, so each pair is seen once =======
+
+            uint64_t key = entry_key[p];
+
+            test_run<true>(self, key, p + 1, bucket_start[bucket_of(key) + 1], out);
+
+            for (int dx = 0; dx <= 1; ++dx)
+            {
+                for (int dy = dx ? -1 : 0; dy <= 1; ++dy)
+                {
+                    for (int dz = (dx || dy) ? -1 : 1; dz <= 1; ++dz)
+                    {
+                        uint64_t neighbour = pack(cx + dx, cy + dy, cz + dz);
+                        uint32_t other = bucket_of(neighbour);
+
+                        if (bucket_start[other] != bucket_start[other + 1])
+                            test_run<true>(self, neighbour, bucket_start[other], bucket_start[other + 1], out);
+                    }
+                }
+            }
+        }
+    }
+
+    /// @brief Pairs between a box binned elsewhere (no larger than a cell) and every entry of this grid
+    /// @param probe
+    /// @param out
+    void query(const entry &probe, std::vector<broadphase_pair> &out) const
+    {
+        if (entries.empty())
+            return;
+
+        int32_t cx = cell_of(probe.min[0]);
+        int32_t cy = cell_of(probe.min[1]);
+        int32_t cz = cell_of(probe.min[2]);
+
+        if (dense)
+        {
+            // ======= 9 z-runs clamped to the grid; a probe outside it simply finds nothing =======
+
+            int32_t x = cx - origin[0], y = cy - origin[1], z = cz - origin[2];
+            int32_t z_low = std::max(z - 1, 0), z_high = std::min(z + 1, dims[2] - 1);
+
+            if (z_low > z_high)
+                return;
+
+            for (int32_t nx = std::max(x - 1, 0); nx <= std::min(x + 1, dims[0] - 1); ++nx)
+            {
+                for (int32_t ny = std::max(y - 1, 0); ny <= std::min(y + 1, dims[1] - 1); ++ny)
+                    test_run<false>(probe, 0, bucket_start[grid_index(nx, ny, z_low)], bucket_start[grid_index(nx, ny, z_high) + 1], out);
+            }
+
+            return;
+        }
+
+        for (int dx = -1; dx <= 1; ++dx)
+        {
+            for (int dy = -1; dy <= 1; ++dy)
+            {
+                for (int dz = -1; dz <= 1; ++dz)
+                {
+                    uint64_t neighbour = pack(cx + dx, cy + dy, cz + dz);
+                    uint32_t other = bucket_of(neighbour);
+
+                    if (bucket_start[other] != bucket_start[other + 1])
+                        test_run<true>(probe, neighbour, bucket_start[other], bucket_start[other + 1], out);
+                }
+            }
+        }
+    }
+
+    /// @brief Forget every entry
+    void clear()
+    {
+        entries.clear();
+        entry_key.clear();
+    }
+
+    // ======= UTILITY API =======
+
+    /// @brief Amount of binned bodies
+    /// @return size_t
+    size_t size() const { return entries.size(); }
+
+    /// @brief Binned body in bucket order
+    /// @param index
+    /// @return const entry&
+    const entry &operator[](size_t index) const { return entries[index]; }
+};
+
+// ======= broadphase =======
+
+/// @brief Candidate pairs over physics_world AABBs from two uniform grids
+/// @note Static and sleeping bodies live in a resting grid that is only rebuilt when one of them changes;
+/// awake dynamic bodies are re-binned every update and queried against it, so settled piles cost almost nothing.
+/// Bodies larger than a cell skip both grids and are tested against every body with SIMD
+class broadphase
+{
+private:
+    // ======= per-body bounds, dense order (SIMD friendly) =======
+
+    aligned_vector<float> bounds_min[3];
+    aligned_vector<float> bounds_max[3];
+
+    std::vector<uint8_t> large;
+    std::vector<uint8_t> active;
+
+    std::vector<uint32_t> large_bodies;
+    std::vector<uint32_t> active_bodies;
+    std::vector<uint32_t> resting_bodies;
+
+    std::vector<float> extents; // scratch for the automatic cell size
+
+    broadphase_grid active_grid;
+    broadphase_grid resting_grid;
+
+    float cell_size = 0.0f; // 0 = automatic
+    float current_cell = 1.0f;
+
+    uint64_t seen_structure = UINT64_MAX;
+    uint64_t seen_resting = UINT64_MAX;
+
+    std::vector<std::vector<broadphase_pair>> buckets; // one per pair-generation task, reused every update
+    std::vector<broadphase_pair> pairs;
+
+    broadphase_stats stats;
+
+private:
+    /// @brief AABB = position +- half extents, vectorised over every lane
+    /// @param world
+    void compute_bounds(physics_world &world)
+    {
+        size_t lanes = world.padded_size();
+
+        const float *position[3] = {world.positions_x(), world.positions_y(), world.positions_z()};
+        const float *half[3] = {world.half_extents_x(), world.half_extents_y(), world.half_extents_z()};
+
+        for (int a = 0; a < 3; ++a)
+        {
+            bounds_min[a].resize(lanes);
+            bounds_max[a].resize(lanes);
+
+            for (size_t i = 0; i < lanes; i += simd_float::width)
+            {
+                simd_float p = simd_float::load(position[a] + i);
+                simd_float h = simd_float::load(half[a] + i);
+
+                (p - h).store(&bounds_min[a][i]);
+                (p + h).store(&bounds_max[a][i]);
+            }
+        }
+    }
+
+    /// @brief Configured cell size, or BROADPHASE_CELL_SCALE times the average body size, grown so at most
+    /// BROADPHASE_MAX_LARGE_BODIES bodies are too big to bin
+    /// @param world
+    /// @return float
+    float choose_cell_size(physics_world &world)
+    {
+        size_t count = world.size();
+
+        if (cell_size > 0.0f || count == 0)
+            return cell_size > 0.0f ? cell_size : 1.0f;
+
+        const float *half[3] = {world.half_extents_x(), world.half_extents_y(), world.half_extents_z()};
+
+        extents.resize(count);
+
+        double total = 0.0;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            extents[i] = 2.0f * std::max(half[0][i], std::max(half[1][i], half[2][i]));
+            total += extents[i];
+        }
+
+        float size = static_cast<float>(total / count) * BROADPHASE_CELL_SCALE;
+
+        if (count > BROADPHASE_MAX_LARGE_BODIES)
+        {
+            auto limit = extents.begin() + (count - 1 - BROADPHASE_MAX_LARGE_BODIES);
+
+            std::nth_element(extents.begin(), limit, extents.end());
+            size = std::max(size, *limit);
+        }
+
+        return size > 1e-4f ? size : 1.0f;
+    }
+
+    /// @brief Sort every body into large / active / resting
+    /// @param world
+    /// @param collect_resting: Also rebuild the resting list
+    void classify(physics_world &world, bool collect_resting)
+    {
+        size_t count = world.size();
+
+        const float *inv_mass = world.inverse_masses();
+        const float *awake = world.awake_lanes();
+
+        large.resize(count);
+        active.resize(count);
+
+        large_bodies.clear();
+        active_bodies.clear();
+
+        if (collect_resting)
+            resting_bodies.clear();
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            float extent = std::max(bounds_max[0][i] - bounds_min[0][i], std::max(bounds_max[1][i] - bounds_min[1][i], bounds_max[2][i] - bounds_min[2][i]));
+
+            large[i] = extent > current_cell;
+            active[i] = inv_mass[i] > 0.0f && awake[i] > 0.0f;
+
+            if (large[i])
+                large_bodies.push_back(static_cast<uint32_t>(i));
+            else if (active[i])
+                active_bodies.push_back(static_cast<uint32_t>(i));
+            else if (collect_resting)
+                resting_bodies.push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+    /// @brief Pairs of large bodies [begin, end) against every body, vectorised over the dense bounds
+    void sweep_large(size_t begin, size_t end, size_t count, std::vector<broadphase_pair> &out) const
+    {
+        for (size_t l = begin; l < end; ++l)
+        {
+            uint32_t body = large_bodies[l];
+
+            simd_float lo[3], hi[3];
+
+            for (int a = 0; a < 3; ++a)
+            {
+                lo[a] = simd_float::set1(bounds_min[a][body]);
+                hi[a] = simd_float::set1(bounds_max[a][body]);
+            }
+
+            for (size_t i = 0; i < count; i += simd_float::width)
+            {
+                simd_float apart = simd_float::zero();
+
+                for (int a = 0; a < 3; ++a)
+                {
+                    apart = simd_float::either(apart, simd_float::greater(simd_float::load(&bounds_min[a][i]), hi[a]));
+                    apart = simd_float::either(apart, simd_float::less(simd_float::load(&bounds_max[a][i]), lo[a]));
+                }
+
+                int touching = ~simd_float::movemask(apart) & ((1 << simd_float::width) - 1);
+
+                for (; touching; touching &= touching - 1)
+                {
+                    size_t k = i + __builtin_ctz(touching);
+
+                    // ======= padding lanes, self, large-large pairs already reported by the lower index, resting-resting =======
+
+                    if (k >= count || k == body || (large[k] && k < body) || !(active[body] | active[k]))
+                        continue;
+
+                    uint32_t other = static_cast<uint32_t>(k);
+                    out.push_back(body < other ? broadphase_pair{body, other} : broadphase_pair{other, body});
+                }
+            }
+        }
+    }
+
+public:
+    // ======= MAIN API =======
+
+    /// @brief Refresh the AABBs and regenerate the candidate pair list (every pair has an awake dynamic body)
+    /// @param world
+    /// @param pool: Pair generation is split across it (default: thread_pool::shared())
+    void update(physics_world &world, thread_pool &pool = thread_pool::shared())
+    {
+        size_t count = world.size();
+
+        stats = broadphase_stats{};
+        stats.bodies = count;
+
+        // ======= body sizes only change with the structure, so the cell size is cached =======
+
+        if (world.get_structure_version() != seen_structure)
+        {
+            current_cell = choose_cell_size(world);
+            seen_structure = world.get_structure_version();
+            seen_resting = UINT64_MAX;
+        }
+
+        bool rebuild_resting = world.get_resting_version() != seen_resting;
+
+        compute_bounds(world);
+        classify(world, rebuild_resting);
+
+        const float *mins[3] = {bounds_min[0].data(), bounds_min[1].data(), bounds_min[2].data()};
+        const float *maxs[3] = {bounds_max[0].data(), bounds_max[1].data(), bounds_max[2].data()};
+
+        if (rebuild_resting)
+        {
+            resting_grid.build(resting_bodies.data(), resting_bodies.size(), mins, maxs, false, current_cell);
+            seen_resting = world.get_resting_version();
+        }
+
+        active_grid.build(active_bodies.data(), active_bodies.size(), mins, maxs, true, current_cell);
+
+        stats.active_bodies = active_bodies.size();
+        stats.large_bodies = large_bodies.size();
+        stats.cell_size = current_cell;
+        stats.resting_rebuilt = rebuild_resting;
+
+        pairs.clear();
+
+        bool large_active = std::any_of(large_bodies.begin(), large_bodies.end(), [this](uint32_t body)
+                                        { return active[body] != 0; });
+
+        if (active_bodies.empty() && !large_active)
+            return;
+
+        // ======= active tasks first, then large-body tasks; buckets concatenated in task order (deterministic) =======
+
+        size_t binned = active_grid.size();
+        size_t max_tasks = (pool.size() + 1) * 4;
+
+        size_t binned_tasks = std::min((binned + BROADPHASE_SWEEP_GRAIN - 1) / BROADPHASE_SWEEP_GRAIN, max_tasks);
+        size_t large_tasks = std::min(large_bodies.size(), max_tasks);
+        size_t tasks = binned_tasks + large_tasks;
+
+        if (buckets.size() < tasks)
+            buckets.resize(tasks);
+
+        pool.parallel_for(0, tasks, 1, [&](size_t begin, size_t end)
+                          {
+                              for (size_t task = begin; task < end; ++task)
+                              {
+                                  buckets[task].clear();
+
+                                  if (task < binned_tasks)
+                                  {
+                                      size_t first = binned * task / binned_tasks, last = binned * (task + 1) / binned_tasks;
+
+                                      active_grid.self_pairs(first, last, buckets[task]);
+
+                                      for (size_t p = first; p < last; ++p)
+                                          resting_grid.query(active_grid[p], buckets[task]);
+                                  }
+                                  else
+                                  {
+                                      size_t l = task - binned_tasks;
+                                      sweep_large(large_bodies.size() * l / large_tasks, large_bodies.size() * (l + 1) / large_tasks, count, buckets[task]);
+                                  }
+                              }
+                          });
+
+        size_t total = 0;
+
+        for (size_t task = 0; task < tasks; ++task)
+            total += buckets[task].size();
+
+        pairs.reserve(total);
+
+        for (size_t task = 0; task < tasks; ++task)
+            pairs.insert(pairs.end(), buckets[task].begin(), buckets[task].end());
+
+        stats.pairs = pairs.size();
+    }
+
+    /// @brief Fix the cell size instead of deriving it from the body sizes
+    /// @param size: 0 = automatic; bodies larger than a cell are tested against every body
+    void set_cell_size(float size)
+    {
+        cell_size = std::max(size, 0.0f);
+        seen_structure = UINT64_MAX;
+    }
+
+    /// @brief Drop the last pair list and both cached grids
+    void clear()
+    {
+        pairs.clear();
+        active_grid.clear();
+        resting_grid.clear();
+
+        seen_structure = UINT64_MAX;
+        seen_resting = UINT64_MAX;
+    }
+
+    // ======= UTILITY API =======
+
+    /// @brief Candidate pairs from the last update
+    /// @return const std::vector<broadphase_pair>&
+    const std::vector<broadphase_pair> &get_pairs() const { return pairs; }
+
+    /// @brief Statistics of the last update
+    /// @return const broadphase_stats&
+    const broadphase_stats &get_stats() const { return stats; }
+
+    /// @brief Awake dynamic bodies (dense indices) of the last update, large ones excluded
+    /// @return const std::vector<uint32_t>&
+    const std::vector<uint32_t> &get_active_bodies() const { return active_bodies; }
+
+    /// @brief Bodies bigger than a cell (dense indices) of the last update
+    /// @return const std::vector<uint32_t>&
+    const std::vector<uint32_t> &get_large_bodies() const { return large_bodies; }
+
+    /// @brief AABB of a dense body index from the last update
+    /// @param index
+    /// @param out_min
+    /// @param out_max
+    void get_bounds(size_t index, glm::vec3 &out_min, glm::vec3 &out_max) const
+    {
+        out_min = {bounds_min[0][index], bounds_min[1][index], bounds_min[2][index]};
+        out_max = {bounds_max[0][index], bounds_max[1][index], bounds_max[2][index]};
+    }
+};
@@ -0,0 +1,656 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "./narrowphase.hpp"
+
+// ======= MACROS =======
+
+#define CONTACT_SOLVER_ITERATIONS 8              // default velocity iterations per step
+#define CONTACT_RESTITUTION_THRESHOLD 1.0f       // closing speeds below this never bounce (stops resting jitter)
+#define CONTACT_WARM_START_ALIGNMENT 0.9f        // cached impulses are reused while the normal stays this aligned
+
+// ======= STRUCTS =======
+
+/// @brief What the last solve did
+struct contact_stats
+{
+    size_t manifolds = 0;
+    size_t awake_bodies = 0;
+    size_t woken_bodies = 0;
+    size_t slept_bodies = 0;
+    size_t warm_started = 0;
+    size_t islands = 0; // sleeping islands currently recorded
+};
+
+// ======= contact_solver =======
+
+/// @brief Sequential impulse solver over narrowphase manifolds, with warm starting and sleeping islands
+/// @note Bodies carry no rotation, so every manifold is one point-free constraint: a normal impulse and two
+/// friction impulses through the centres of mass. Islands of bodies that stay slow for time_to_sleep seconds
+/// are put to sleep together and woken together as soon as an awake body touches one of them
+class contact_solver
+{
+private:
+    /// @brief One manifold prepared for the iterations
+    struct constraint
+    {
+        uint32_t a;
+        uint32_t b;
+
+        glm::vec3 normal;
+        glm::vec3 tangent[2];
+
+        float inv_mass_a;
+        float inv_mass_b;
+        float inv_k; // 1 / (inverse mass a + inverse mass b)
+
+        float target; // normal separation speed to reach (position correction or bounce)
+
+        float normal_impulse;
+        float tangent_impulse[2];
+
+        uint64_t key;
+        bool flipped; // a has the larger handle
+    };
+
+    /// @brief Accumulated impulse of a pair, oriented from the smaller handle to the larger one
+    struct cached_impulse
+    {
+        uint64_t key;
+
+        glm::vec3 normal;
+        glm::vec3 impulse;
+    };
+
+    /// @brief Sleeping island a body was put to sleep with
+    struct island_link
+    {
+        body_handle handle = null_body;
+        uint32_t island = UINT32_MAX;
+    };
+
+    narrowphase detection;
+
+    std::vector<constraint> constraints;
+
+    std::vector<cached_impulse> cache; // sorted by key, pairs of the last step
+    std::vector<cached_impulse> next_cache;
+    std::vector<cached_impulse> sleeping_cache; // sorted by key, pairs inside sleeping islands
+    std::vector<cached_impulse> merge_scratch;
+
+    // ======= sleep state by handle index (stable across swap-removes) =======
+
+    std::vector<float> sleep_timers;
+    std::vector<island_link> island_links;
+
+    std::vector<std::vector<body_handle>> islands;
+    std::vector<uint32_t> free_islands;
+    size_t island_count = 0;
+
+    uint64_t seen_structure = 0;
+
+    // ======= per-step scratch by dense index, only touched for awake bodies =======
+
+    std::vector<uint32_t> awake_list;
+    std::vector<uint32_t> parents;
+    std::vector<float> island_timers;
+    std::vector<uint32_t> root_islands;
+
+    int iterations = CONTACT_SOLVER_ITERATIONS;
+
+    float restitution = 0.0f;
+    float friction = 0.5f;
+    float baumgarte = 0.2f; // fraction of the penetration removed per step
+    float slop = 0.01f;     // penetration left alone so resting contacts persist
+
+    bool sleeping = true;
+    float sleep_velocity = 0.05f;
+    float time_to_sleep = 0.5f;
+
+    contact_stats stats;
+
+private:
+    // ======= HELPERS =======
+
+    static glm::vec3 velocity_of(physics_world &world, uint32_t index)
+    {
+        return {world.velocities_x()[index], world.velocities_y()[index], world.velocities_z()[index]};
+    }
+
+    static void add_velocity(physics_world &world, uint32_t index, const glm::vec3 &delta)
+    {
+        world.velocities_x()[index] += delta.x;
+        world.velocities_y()[index] += delta.y;
+        world.velocities_z()[index] += delta.z;
+    }
+
+    static bool is_dynamic(physics_world &world, uint32_t index) { return world.inverse_masses()[index] > 0.0f; }
+
+    static bool is_active(physics_world &world, uint32_t index) { return is_dynamic(world, index) && world.awake_lanes()[index] > 0.0f; }
+
+    /// @brief Two unit vectors completing an orthonormal basis with the normal
+    static void tangents_of(const glm::vec3 &normal, glm::vec3 (&out)[2])
+    {
+        if (std::abs(normal.x) >= 0.57735f)
+            out[0] = glm::normalize(glm::vec3(normal.y, -normal.x, 0.0f));
+        else
+            out[0] = glm::normalize(glm::vec3(0.0f, normal.z, -normal.y));
+
+        out[1] = glm::cross(normal, out[0]);
+    }
+
+    /// @brief Binary search a sorted cache
+    static const cached_impulse *find(const std::vector<cached_impulse> &entries, uint64_t key)
+    {
+        auto it = std::lower_bound(entries.begin(), entries.end(), key, [](const cached_impulse &entry, uint64_t value)
+                                   { return entry.key < value; });
+
+        return it != entries.end() && it->key == key ? &*it : nullptr;
+    }
+
+    /// @brief Merge sorted fresh entries into a sorted cache, fresh ones replacing equal keys
+    void merge_into(std::vector<cached_impulse> &base, const std::vector<cached_impulse> &fresh)
+    {
+        merge_scratch.clear();
+        merge_scratch.reserve(base.size() + fresh.size());
+
+        size_t i = 0, j = 0;
+
+        while (i < base.size() || j < fresh.size())
+        {
+            if (j == fresh.size() || (i < base.size() && base[i].key < fresh[j].key))
+            {
+                merge_scratch.push_back(base[i++]);
+                continue;
+            }
+
+            if (i < base.size() && base[i].key == fresh[j].key)
+                ++i;
+
+            merge_scratch.push_back(fresh[j++]);
+        }
+
+        base.swap(merge_scratch);
+    }
+
+    // ======= SLEEPING ISLANDS =======
+
+    island_link &link_of(body_handle handle)
+    {
+        uint32_t index = entity_allocator::index_of(handle);
+
+        if (index >= island_links.size())
+        {
+            island_links.resize(index + 1);
+            sleep_timers.resize(index + 1, 0.0f);
+        }
+
+        return island_links[index];
+    }
+
+    /// @brief Wake every body of a sleeping island and release it
+    /// @return size_t: Bodies woken
+    size_t wake_island(physics_world &world, uint32_t island)
+    {
+        size_t woken = 0;
+
+        for (body_handle member : islands[island])
+        {
+            island_link &member_link = link_of(member);
+
+            if (member_link.handle == member && member_link.island == island)
+                member_link = island_link{};
+
+            if (!world.alive(member))
+                continue;
+
+            size_t member_index = world.index_of(member);
+
+            // ======= static bodies the island rested on are listed too; they never sleep =======
+
+            if (world.awake_lanes()[member_index] <= 0.0f)
+            {
+                sleep_timers[entity_allocator::index_of(member)] = 0.0f;
+                world.set_awake(member_index, true);
+                ++woken;
+            }
+        }
+
+        islands[island].clear();
+        free_islands.push_back(island);
+        --island_count;
+
+        return woken;
+    }
+
+    /// @brief Wake a sleeping body together with the island it fell asleep with
+    /// @return size_t: Bodies woken
+    size_t wake_body(physics_world &world, uint32_t index)
+    {
+        body_handle handle = world.get_handles()[index];
+        island_link &link = link_of(handle);
+
+        if (link.handle == handle && link.island != UINT32_MAX)
+            return wake_island(world, link.island);
+
+        world.set_awake(index, true);
+        return 1;
+    }
+
+    /// @brief Wake islands that lost a body (including a static one they rested on)
+    void wake_broken_islands(physics_world &world)
+    {
+        for (uint32_t island = 0; island < islands.size(); ++island)
+        {
+            bool broken = std::any_of(islands[island].begin(), islands[island].end(), [&world](body_handle member)
+                                      { return !world.alive(member); });
+
+            if (broken)
+                stats.woken_bodies += wake_island(world, island);
+        }
+    }
+
+    /// @brief Wake every sleeping body an awake body touches
+    /// @return bool: If anything woke (pairs among the woken bodies are still missing)
+    bool wake_touched(physics_world &world)
+    {
+        size_t woken = 0;
+
+        for (const contact_manifold &manifold : detection.get_manifolds())
+        {
+            bool active_a = is_active(world, manifold.a), active_b = is_active(world, manifold.b);
+
+            if (active_a && is_dynamic(world, manifold.b) && !active_b)
+                woken += wake_body(world, manifold.b);
+            else if (active_b && is_dynamic(world, manifold.a) && !active_a)
+                woken += wake_body(world, manifold.a);
+        }
+
+        stats.woken_bodies += woken;
+
+        return woken > 0;
+    }
+
+    uint32_t find_root(uint32_t index)
+    {
+        while (parents[index] != index)
+        {
+            parents[index] = parents[parents[index]];
+            index = parents[index];
+        }
+
+        return index;
+    }
+
+    /// @brief Advance sleep timers, group touching awake bodies into islands and put slow islands to sleep
+    void update_sleep(physics_world &world, const broadphase &collisions, float dt)
+    {
+        awake_list.assign(collisions.get_active_bodies().begin(), collisions.get_active_bodies().end());
+
+        for (uint32_t index : collisions.get_large_bodies())
+        {
+            if (is_active(world, index))
+                awake_list.push_back(index);
+        }
+
+        stats.awake_bodies = awake_list.size();
+
+        if (!sleeping || awake_list.empty())
+            return;
+
+        if (parents.size() < world.size())
+        {
+            parents.resize(world.size());
+            island_timers.resize(world.size());
+            root_islands.resize(world.size());
+        }
+
+        float threshold = sleep_velocity * sleep_velocity;
+
+        for (uint32_t index : awake_list)
+        {
+            glm::vec3 velocity = velocity_of(world, index);
+            body_handle handle = world.get_handles()[index];
+
+            link_of(handle);
+
+            float &timer = sleep_timers[entity_allocator::index_of(handle)];
+            timer = glm::dot(velocity, velocity) < threshold ? timer + dt : 0.0f;
+
+            parents[index] = index;
+            island_timers[index] = std::numeric_limits<float>::max();
+            root_islands[index] = UINT32_MAX;
+        }
+
+        // ======= static bodies never join islands, so a pile on the floor splits into independent stacks =======
+
+        for (const constraint &c : constraints)
+        {
+            if (!is_active(world, c.a) || !is_active(world, c.b))
+                continue;
+
+            uint32_t root_a = find_root(c.a), root_b = find_root(c.b);
+
+            if (root_a != root_b)
+                parents[std::max(root_a, root_b)] = std::min(root_a, root_b);
+        }
+
+        for (uint32_t index : awake_list)
+        {
+            uint32_t root = find_root(index);
+            island_timers[root] = std::min(island_timers[root], sleep_timers[entity_allocator::index_of(world.get_handles()[index])]);
+        }
+
+        size_t slept = 0;
+
+        for (uint32_t index : awake_list)
+        {
+            uint32_t root = find_root(index);
+
+            if (island_timers[root] < time_to_sleep)
+                continue;
+
+            if (root_islands[root] == UINT32_MAX)
+            {
+                if (free_islands.empty())
+                {
+                    root_islands[root] = static_cast<uint32_t>(islands.size());
+                    islands.emplace_back();
+                }
+                else
+                {
+                    root_islands[root] = free_islands.back();
+                    free_islands.pop_back();
+                }
+
+                ++island_count;
+            }
+
+            body_handle handle = world.get_handles()[index];
+
+            islands[root_islands[root]].push_back(handle);
+            link_of(handle) = island_link{handle, root_islands[root]};
+
+            world.set_awake(index, false);
+            ++slept;
+        }
+
+        stats.slept_bodies = slept;
+
+        if (slept == 0)
+            return;
+
+        // ======= keep the impulses of pairs that just fell asleep, so waking them warm starts; islands also
+        // list the static bodies they rest on, so removing one wakes them =======
+
+        const body_handle *handles = world.get_handles().data();
+
+        next_cache.clear();
+
+        for (const constraint &c : constraints)
+        {
+            bool asleep_a = is_dynamic(world, c.a) && world.awake_lanes()[c.a] <= 0.0f;
+            bool asleep_b = is_dynamic(world, c.b) && world.awake_lanes()[c.b] <= 0.0f;
+
+            if (!asleep_a && !asleep_b)
+                continue;
+
+            next_cache.push_back(*find(cache, c.key));
+
+            if (asleep_a && !is_dynamic(world, c.b))
+                islands[link_of(handles[c.a]).island].push_back(handles[c.b]);
+            else if (asleep_b && !is_dynamic(world, c.a))
+                islands[link_of(handles[c.b]).island].push_back(handles[c.a]);
+        }
+
+        std::sort(next_cache.begin(), next_cache.end(), [](const cached_impulse &x, const cached_impulse &y)
+                  { return x.key < y.key; });
+
+        merge_into(sleeping_cache, next_cache);
+    }
+
+public:
+    // ======= MAIN API =======
+
+    /// @brief Resolve every contact of the last broadphase update by adjusting velocities
+    /// @note Call between physics_world::integrate_velocities and physics_world::integrate_positions;
+    /// if an awake body touches a sleeping island it is woken and the broadphase is updated again
+    /// @param world
+    /// @param collisions: Updated this step
+    /// @param dt
+    /// @param pool: Narrowphase and broadphase work is split across it (default: thread_pool::shared())
+    void solve(physics_world &world, broadphase &collisions, float dt, thread_pool &pool = thread_pool::shared())
+    {
+        stats = contact_stats{};
+
+        if (dt <= 0.0f)
+            return;
+
+        // ======= removed bodies may have been holding up a sleeping island =======
+
+        if (world.get_structure_version() != seen_structure)
+        {
+            wake_broken_islands(world);
+            seen_structure = world.get_structure_version();
+
+            sleeping_cache.erase(std::remove_if(sleeping_cache.begin(), sleeping_cache.end(), [&world](const cached_impulse &entry)
+                                                { return !world.alive(static_cast<body_handle>(entry.key >> 32)) || !world.alive(static_cast<body_handle>(entry.key)); }),
+                                 sleeping_cache.end());
+
+            if (stats.woken_bodies > 0)
+                collisions.update(world, pool);
+        }
+
+        detection.update(world, collisions, pool);
+
+        bool woke = stats.woken_bodies > 0;
+
+        while (wake_touched(world))
+        {
+            collisions.update(world, pool);
+            detection.update(world, collisions, pool);
+
+            woke = true;
+        }
+
+        const std::vector<contact_manifold> &manifolds = detection.get_manifolds();
+        const body_handle *handles = world.get_handles().data();
+
+        stats.manifolds = manifolds.size();
+
+        // ======= prepare: effective masses, velocity targets and warm starting =======
+
+        constraints.clear();
+
+        for (const contact_manifold &manifold : manifolds)
+        {
+            constraint c;
+
+            c.a = manifold.a;
+            c.b = manifold.b;
+            c.normal = manifold.normal;
+
+            c.inv_mass_a = is_active(world, c.a) ? world.inverse_masses()[c.a] : 0.0f;
+            c.inv_mass_b = is_active(world, c.b) ? world.inverse_masses()[c.b] : 0.0f;
+
+            float k = c.inv_mass_a + c.inv_mass_b;
+
+            if (k <= 0.0f)
+                continue;
+
+            c.inv_k = 1.0f / k;
+            tangents_of(c.normal, c.tangent);
+
+            float closing = glm::dot(velocity_of(world, c.b) - velocity_of(world, c.a), c.normal);
+            float correction = baumgarte / dt * std::max(manifold.penetration - slop, 0.0f);
+            float bounce = closing < -CONTACT_RESTITUTION_THRESHOLD ? -restitution * closing : 0.0f;
+
+            c.target = std::max(correction, bounce);
+
+            body_handle ha = handles[c.a], hb = handles[c.b];
+
+            c.flipped = ha > hb;
+            c.key = c.flipped ? (static_cast<uint64_t>(hb) << 32 | ha) : (static_cast<uint64_t>(ha) << 32 | hb);
+
+            c.normal_impulse = c.tangent_impulse[0] = c.tangent_impulse[1] = 0.0f;
+
+            const cached_impulse *cached = find(cache, c.key);
+
+            if (!cached)
+                cached = find(sleeping_cache, c.key);
+
+            float orientation = c.flipped ? -1.0f : 1.0f;
+
+            if (cached && glm::dot(cached->normal * orientation, c.normal) > CONTACT_WARM_START_ALIGNMENT)
+            {
+                glm::vec3 impulse = cached->impulse * orientation;
+
+                c.normal_impulse = std::max(glm::dot(impulse, c.normal), 0.0f);
+
+                for (int t = 0; t < 2; ++t)
+                    c.tangent_impulse[t] = std::clamp(glm::dot(impulse, c.tangent[t]), -friction * c.normal_impulse, friction * c.normal_impulse);
+
+                glm::vec3 applied = c.normal * c.normal_impulse + c.tangent[0] * c.tangent_impulse[0] + c.tangent[1] * c.tangent_impulse[1];
+
+                add_velocity(world, c.a, -applied * c.inv_mass_a);
+                add_velocity(world, c.b, applied * c.inv_mass_b);
+
+                ++stats.warm_started;
+            }
+
+            constraints.push_back(c);
+        }
+
+        // ======= iterate: friction first, then the normal impulse it is bounded by =======
+
+        for (int iteration = 0; iteration < iterations; ++iteration)
+        {
+            for (constraint &c : constraints)
+            {
+                glm::vec3 relative = velocity_of(world, c.b) - velocity_of(world, c.a);
+
+                for (int t = 0; t < 2; ++t)
+                {
+                    float limit = friction * c.normal_impulse;
+                    float previous = c.tangent_impulse[t];
+
+                    c.tangent_impulse[t] = std::clamp(previous - glm::dot(relative, c.tangent[t]) * c.inv_k, -limit, limit);
+
+                    glm::vec3 applied = c.tangent[t] * (c.tangent_impulse[t] - previous);
+
+                    add_velocity(world, c.a, -applied * c.inv_mass_a);
+                    add_velocity(world, c.b, applied * c.inv_mass_b);
+
+                    relative += applied * (c.inv_mass_a + c.inv_mass_b);
+                }
+
+                float previous = c.normal_impulse;
+
+                c.normal_impulse = std::max(previous + (c.target - glm::dot(relative, c.normal)) * c.inv_k, 0.0f);
+
+                glm::vec3 applied = c.normal * (c.normal_impulse - previous);
+
+                add_velocity(world, c.a, -applied * c.inv_mass_a);
+                add_velocity(world, c.b, applied * c.inv_mass_b);
+            }
+        }
+
+        // ======= store accumulated impulses for the next step, oriented by handle order =======
+
+        next_cache.clear();
+
+        for (const constraint &c : constraints)
+        {
+            float orientation = c.flipped ? -1.0f : 1.0f;
+            glm::vec3 impulse = c.normal * c.normal_impulse + c.tangent[0] * c.tangent_impulse[0] + c.tangent[1] * c.tangent_impulse[1];
+
+            next_cache.push_back(cached_impulse{c.key, c.normal * orientation, impulse * orientation});
+        }
+
+        std::sort(next_cache.begin(), next_cache.end(), [](const cached_impulse &x, const cached_impulse &y)
+                  { return x.key < y.key; });
+
+        cache.swap(next_cache);
+
+        // ======= pairs of woken islands are live again; drop their sleeping copies =======
+
+        if (woke && !sleeping_cache.empty())
+        {
+            sleeping_cache.erase(std::remove_if(sleeping_cache.begin(), sleeping_cache.end(), [this](const cached_impulse &entry)
+                                                { return find(cache, entry.key) != nullptr; }),
+                                 sleeping_cache.end());
+        }
+
+        update_sleep(world, collisions, dt);
+
+        stats.islands = island_count;
+    }
+
+    /// @brief Forget cached impulses, timers and sleeping islands (bodies keep their sleep state)
+    void clear()
+    {
+        detection.clear();
+        constraints.clear();
+
+        cache.clear();
+        sleeping_cache.clear();
+
+        sleep_timers.clear();
+        island_links.clear();
+
+        islands.clear();
+        free_islands.clear();
+        island_count = 0;
+
+        seen_structure = 0;
+    }
+
+    // ======= SETTINGS =======
+
+    /// @brief Velocity iterations per step (more = stiffer stacks)
+    /// @param count
+    void set_iterations(int count) { iterations = std::max(count, 1); }
+
+    /// @brief Bounciness of impacts faster than CONTACT_RESTITUTION_THRESHOLD
+    /// @param value: 0 = none, 1 = elastic
+    void set_restitution(float value) { restitution = std::clamp(value, 0.0f, 1.0f); }
+
+    /// @brief Coulomb friction coefficient
+    /// @param value
+    void set_friction(float value) { friction = std::max(value, 0.0f); }
+
+    /// @brief Position correction: fraction of the penetration beyond slop removed per step
+    /// @param factor
+    /// @param allowed_penetration
+    void set_correction(float factor, float allowed_penetration)
+    {
+        baumgarte = std::clamp(factor, 0.0f, 1.0f);
+        slop = std::max(allowed_penetration, 0.0f);
+    }
+
+    /// @brief Put islands to sleep once all their bodies stay below a speed for a while
+    /// @param enabled
+    /// @param velocity: Speed threshold
+    /// @param seconds: Time every body of an island must stay below it
+    void set_sleeping(bool enabled, float velocity = 0.05f, float seconds = 0.5f)
+    {
+        sleeping = enabled;
+        sleep_velocity = std::max(velocity, 0.0f);
+        time_to_sleep = std::max(seconds, 0.0f);
+    }
+
+    // ======= UTILITY API =======
+
+    /// @brief Manifolds of the last solve (dense indices)
+    /// @return const std::vector<contact_manifold>&
+    const std::vector<contact_manifold> &get_manifolds() const { return detection.get_manifolds(); }
+
+    /// @brief Statistics of the last solve
+    /// @return const contact_stats&
+    const contact_stats &get_stats() const { return stats; }
+};
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cmath>
+
+#include <glm/glm.hpp>
+
+#include "./physics_world.hpp"
+
+// ======= gravity_force =======
+
+/// @brief Constant acceleration on every dynamic body (mass independent)
+class gravity_force : public force_generator
+{
+public:
+    glm::vec3 acceleration;
+
+    /// @brief Constructor for gravity_force
+    /// @param acceleration (default: -9.81 on Y)
+    explicit gravity_force(const glm::vec3 &acceleration = glm::vec3(0.0f, -9.81f, 0.0f)) : acceleration(acceleration) {}
+
+    void apply(physics_world &world, float) override { world.add_uniform_acceleration(acceleration); }
+};
+
+// ======= drag_force =======
+
+/// @brief Linear drag F = -k * v on every body, vectorised over the SoA arrays
+class drag_force : public force_generator
+{
+public:
+    float coefficient;
+
+    /// @brief Constructor for drag_force
+    /// @param coefficient: k
+    explicit drag_force(float coefficient) : coefficient(coefficient) {}
+
+    void apply(physics_world &world, float) override
+    {
+        const simd_float k = simd_float::set1(-coefficient);
+
+        float *v[3] = {world.velocities_x(), world.velocities_y(), world.velocities_z()};
+        float *f[3] = {world.forces_x(), world.forces_y(), world.forces_z()};
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            for (size_t i = 0; i < world.padded_size(); i += simd_float::width)
+                (simd_float::load(f[axis] + i) + simd_float::load(v[axis] + i) * k).store(f[axis] + i);
+        }
+    }
+};
+
+// ======= spring_force =======
+
+/// @brief Damped springs between two bodies, or between a body and a fixed anchor
+class spring_force : public force_generator
+{
+public:
+    struct spring
+    {
+        body_handle a;
+        body_handle b; // null_body: anchored at `anchor`
+
+        glm::vec3 anchor;
+
+        float rest_length;
+        float stiffness;
+        float damping;
+    };
+
+private:
+    std::vector<spring> springs;
+
+public:
+    /// @brief Connect two bodies
+    /// @return size_t: Spring index
+    size_t connect(body_handle a, body_handle b, float rest_length, float stiffness, float damping = 0.0f)
+    {
+        springs.push_back({a, b, glm::vec3(0.0f), rest_length, stiffness, damping});
+        return springs.size() - 1;
+    }
+
+    /// @brief Tie a body to a fixed point
+    /// @return size_t: Spring index
+    size_t anchor(body_handle a, const glm::vec3 &point, float rest_length, float stiffness, float damping = 0.0f)
+    {
+        springs.push_back({a, null_body, point, rest_length, stiffness, damping});
+        return springs.size() - 1;
+    }
+
+    /// @brief Remove every spring
+    void clear() { springs.clear(); }
+
+    void apply(physics_world &world, float) override
+    {
+        float *px = world.positions_x(), *py = world.positions_y(), *pz = world.positions_z();
+        float *vx = world.velocities_x(), *vy = world.velocities_y(), *vz = world.velocities_z();
+        float *fx = world.forces_x(), *fy = world.forces_y(), *fz = world.forces_z();
+
+        for (const spring &s : springs)
+        {
+            // ======= springs on removed bodies go quiet instead of throwing =======
+
+            if (!world.alive(s.a) || (s.b != null_body && !world.alive(s.b)))
+                continue;
+
+            size_t i = world.index_of(s.a);
+            bool anchored = s.b == null_body;
+            size_t j = anchored ? 0 : world.index_of(s.b);
+
+            glm::vec3 other = anchored ? s.anchor : glm::vec3(px[j], py[j], pz[j]);
+            glm::vec3 other_velocity = anchored ? glm::vec3(0.0f) : glm::vec3(vx[j], vy[j], vz[j]);
+
+            glm::vec3 delta = other - glm::vec3(px[i], py[i], pz[i]);
+            float length = std::sqrt(glm::dot(delta, delta));
+
+            if (length <= 1e-6f)
+                continue;
+
+            glm::vec3 direction = delta / length;
+            float closing = glm::dot(other_velocity - glm::vec3(vx[i], vy[i], vz[i]), direction);
+            glm::vec3 force = direction * (s.stiffness * (length - s.rest_length) + s.damping * closing);
+
+            fx[i] += force.x;
+            fy[i] += force.y;
+            fz[i] += force.z;
+
+            if (!anchored)
+            {
+                fx[j] -= force.x;
+                fy[j] -= force.y;
+                fz[j] -= force.z;
+            }
+        }
+    }
+};
@@ -0,0 +1,264 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "./broadphase.hpp"
+
+// ======= MACROS =======
+
+#define NARROWPHASE_MAX_POINTS 4       // an overlap rectangle has at most 4 corners
+#define NARROWPHASE_GRAIN 2048         // candidate pairs per narrowphase task
+
+// ======= STRUCTS =======
+
+/// @brief Touching pair of dense body indices, a < b
+struct contact_manifold
+{
+    uint32_t a;
+    uint32_t b;
+
+    glm::vec3 normal; // unit, pointing from a to b
+    float penetration;
+
+    int point_count;
+    glm::vec3 points[NARROWPHASE_MAX_POINTS]; // world space, halfway through the overlap
+};
+
+// ======= narrowphase =======
+
+/// @brief Exact tests for broadphase pairs: sphere-sphere, sphere-box and box-box manifolds
+/// @note Bodies carry no rotation, so boxes are axis aligned and box-box reduces to the axis of least overlap
+class narrowphase
+{
+private:
+    std::vector<std::vector<contact_manifold>> buckets; // one per task, reused every update
+    std::vector<contact_manifold> manifolds;
+
+public:
+    // ======= SHAPE TESTS =======
+
+    /// @brief Sphere against sphere
+    /// @param ca: Center of a
+    /// @param ra: Radius of a
+    /// @param cb: Center of b
+    /// @param rb: Radius of b
+    /// @param out: Normal, penetration and points (bodies are left untouched)
+    /// @return bool: If they touch
+    static bool sphere_sphere(const glm::vec3 &ca, float ra, const glm::vec3 &cb, float rb, contact_manifold &out)
+    {
+        glm::vec3 delta = cb - ca;
+        float reach = ra + rb;
+        float distance_sq = glm::dot(delta, delta);
+
+        if (distance_sq > reach * reach)
+            return false;
+
+        float distance = std::sqrt(distance_sq);
+
+        // ======= concentric spheres have no separating direction, so pick up =======
+
+        out.normal = distance > 1e-6f ? delta / distance : glm::vec3(0.0f, 1.0f, 0.0f);
+        out.penetration = reach - distance;
+        out.point_count = 1;
+        out.points[0] = ca + out.normal * (ra - out.penetration * 0.5f);
+
+        return true;
+    }
+
+    /// @brief Sphere against axis-aligned box, normal from the sphere to the box
+    /// @param center: Sphere center
+    /// @param radius
+    /// @param box_center
+    /// @param half: Box half extents
+    /// @param out
+    /// @return bool
+    static bool sphere_box(const glm::vec3 &center, float radius, const glm::vec3 &box_center, const glm::vec3 &half, contact_manifold &out)
+    {
+        glm::vec3 local = center - box_center;
+        glm::vec3 closest = glm::clamp(local, -half, half);
+        glm::vec3 delta = closest - local;
+
+        float distance_sq = glm::dot(delta, delta);
+
+        if (distance_sq > radius * radius)
+            return false;
+
+        out.point_count = 1;
+
+        if (distance_sq > 1e-12f)
+        {
+            float distance = std::sqrt(distance_sq);
+
+            out.normal = delta / distance;
+            out.penetration = radius - distance;
+            out.points[0] = box_center + closest;
+
+            return true;
+        }
+
+        // ======= center inside the box: push out through the nearest face =======
+
+        glm::vec3 depth = half - glm::abs(local);
+        int axis = depth.x < depth.y ? (depth.x < depth.z ? 0 : 2) : (depth.y < depth.z ? 1 : 2);
+
+        out.normal = glm::vec3(0.0f);
+        out.normal[axis] = local[axis] < 0.0f ? 1.0f : -1.0f;
+        out.penetration = radius + depth[axis];
+        out.points[0] = center;
+
+        return true;
+    }
+
+    /// @brief Axis-aligned box against axis-aligned box
+    /// @param ca: Center of a
+    /// @param ha: Half extents of a
+    /// @param cb: Center of b
+    /// @param hb: Half extents of b
+    /// @param out: Normal along the axis of least overlap, corners of the overlap rectangle as points
+    /// @return bool
+    static bool box_box(const glm::vec3 &ca, const glm::vec3 &ha, const glm::vec3 &cb, const glm::vec3 &hb, contact_manifold &out)
+    {
+        glm::vec3 delta = cb - ca;
+        glm::vec3 overlap = ha + hb - glm::abs(delta);
+
+        if (overlap.x < 0.0f || overlap.y < 0.0f || overlap.z < 0.0f)
+            return false;
+
+        int axis = overlap.x < overlap.y ? (overlap.x < overlap.z ? 0 : 2) : (overlap.y < overlap.z ? 1 : 2);
+
+        out.normal = glm::vec3(0.0f);
+        out.normal[axis] = delta[axis] < 0.0f ? -1.0f : 1.0f;
+        out.penetration = overlap[axis];
+
+        // ======= overlap region; its face across the normal gives up to 4 distinct corners =======
+
+        glm::vec3 low = glm::max(ca - ha, cb - hb);
+        glm::vec3 high = glm::min(ca + ha, cb + hb);
+
+        int u = (axis + 1) % 3, v = (axis + 2) % 3;
+
+        out.point_count = 0;
+
+        for (int corner = 0; corner < NARROWPHASE_MAX_POINTS; ++corner)
+        {
+            glm::vec3 &point = out.points[out.point_count];
+
+            point[axis] = (low[axis] + high[axis]) * 0.5f;
+            point[u] = (corner & 1) ? high[u] : low[u];
+            point[v] = (corner & 2) ? high[v] : low[v];
+
+            // ======= degenerate (edge or corner) overlaps repeat corners; keep them once =======
+
+            bool repeated = ((corner & 1) && high[u] <= low[u]) || ((corner & 2) && high[v] <= low[v]);
+
+            if (!repeated)
+                ++out.point_count;
+        }
+
+        return true;
+    }
+
+    /// @brief Dispatch a pair on its shapes
+    /// @param world
+    /// @param a: Dense index
+    /// @param b: Dense index
+    /// @param out: Filled with a, b and the contact if touching
+    /// @return bool
+    static bool collide(physics_world &world, uint32_t a, uint32_t b, contact_manifold &out)
+    {
+        const body_shape *shapes = world.get_shapes();
+
+        glm::vec3 ca(world.positions_x()[a], world.positions_y()[a], world.positions_z()[a]);
+        glm::vec3 cb(world.positions_x()[b], world.positions_y()[b], world.positions_z()[b]);
+
+        glm::vec3 ha(world.half_extents_x()[a], world.half_extents_y()[a], world.half_extents_z()[a]);
+        glm::vec3 hb(world.half_extents_x()[b], world.half_extents_y()[b], world.half_extents_z()[b]);
+
+        out.a = a;
+        out.b = b;
+
+        bool sphere_a = shapes[a] == body_shape::sphere;
+        bool sphere_b = shapes[b] == body_shape::sphere;
+
+        if (sphere_a && sphere_b)
+            return sphere_sphere(ca, ha.x, cb, hb.x, out);
+
+        if (sphere_a)
+            return sphere_box(ca, ha.x, cb, hb, out);
+
+        if (sphere_b)
+        {
+            if (!sphere_box(cb, hb.x, ca, ha, out))
+                return false;
+
+            out.normal = -out.normal;
+            return true;
+        }
+
+        return box_box(ca, ha, cb, hb, out);
+    }
+
+    // ======= MAIN API =======
+
+    /// @brief Test every candidate pair of the last broadphase update
+    /// @param world
+    /// @param collisions
+    /// @param pool: Pairs are split across it (default: thread_pool::shared())
+    void update(physics_world &world, const broadphase &collisions, thread_pool &pool = thread_pool::shared())
+    {
+        const std::vector<broadphase_pair> &pairs = collisions.get_pairs();
+
+        manifolds.clear();
+
+        if (pairs.empty())
+            return;
+
+        // ======= tasks write their own bucket; concatenating in task order keeps the output deterministic =======
+
+        size_t tasks = std::min((pairs.size() + NARROWPHASE_GRAIN - 1) / NARROWPHASE_GRAIN, (pool.size() + 1) * 4);
+
+        if (buckets.size() < tasks)
+            buckets.resize(tasks);
+
+        pool.parallel_for(0, tasks, 1, [&](size_t begin, size_t end)
+                          {
+                              for (size_t task = begin; task < end; ++task)
+                              {
+                                  std::vector<contact_manifold> &out = buckets[task];
+                                  out.clear();
+
+                                  size_t first = pairs.size() * task / tasks, last = pairs.size() * (task + 1) / tasks;
+
+                                  for (size_t p = first; p < last; ++p)
+                                  {
+                                      contact_manifold manifold;
+
+                                      if (collide(world, pairs[p].a, pairs[p].b, manifold))
+                                          out.push_back(manifold);
+                                  }
+                              }
+                          });
+
+        size_t total = 0;
+
+        for (size_t task = 0; task < tasks; ++task)
+            total += buckets[task].size();
+
+        manifolds.reserve(total);
+
+        for (size_t task = 0; task < tasks; ++task)
+            manifolds.insert(manifolds.end(), buckets[task].begin(), buckets[task].end());
+    }
+
+    /// @brief Drop the last manifolds
+    void clear() { manifolds.clear(); }
+
+    // ======= UTILITY API =======
+
+    /// @brief Manifolds from the last update
+    /// @return const std::vector<contact_manifold>&
+    const std::vector<contact_manifold> &get_manifolds() const { return manifolds; }
+};
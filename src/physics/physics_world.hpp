@@ -0,0 +1,611 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "../helpers/architecture/entity_allocator.hpp"
+#include "../helpers/memory/aligned_allocator.hpp"
+#include "../helpers/math/simd.hpp"
+#include "../helpers/threading/thread_pool.hpp"
+
+// ======= MACROS =======
+
+#define PHYSICS_LANE_PADDING 8             // SoA arrays are padded to this many lanes (widest SIMD path)
+#define PHYSICS_PARALLEL_THRESHOLD (1 << 16) // bodies before integration is split across the thread pool
+
+// ======= TYPES =======
+
+/// @brief Generational body handle (same layout as entity)
+using body_handle = uint32_t;
+
+constexpr body_handle null_body = null_entity;
+
+/// @brief Collision shape; boxes stay axis aligned (bodies carry no rotation)
+enum class body_shape : uint8_t
+{
+    box,
+    sphere // radius = half_extents.x
+};
+
+class physics_world;
+
+// ======= force_generator =======
+
+/// @brief Registered once; applied to the whole world every step
+class force_generator
+{
+public:
+    virtual ~force_generator() = default;
+
+    /// @brief Accumulate forces (or uniform accelerations) for this step
+    /// @param world
+    /// @param dt
+    virtual void apply(physics_world &world, float dt) = 0;
+};
+
+// ======= physics_world =======
+
+/// @brief Point-mass bodies in SoA arrays, integrated with one vectorised semi-implicit Euler pass
+/// @note Bodies can be put to sleep; sleeping and static bodies are skipped by the integrator and the broadphase
+class physics_world
+{
+private:
+    entity_allocator handles;
+
+    std::vector<uint32_t> sparse;             // handle index -> dense index
+    std::vector<body_handle> dense_handles;   // dense index -> handle
+    std::vector<size_t> object_ids;           // dense index -> linked object (SIZE_MAX if none)
+
+    aligned_vector<float> pos_x, pos_y, pos_z;
+    aligned_vector<float> vel_x, vel_y, vel_z;
+    aligned_vector<float> force_x, force_y, force_z;
+    aligned_vector<float> inv_mass;
+    aligned_vector<float> half_x, half_y, half_z;
+    aligned_vector<float> awake; // 1 = simulated, 0 = asleep (skipped until woken)
+
+    std::vector<body_shape> shapes;
+
+    size_t count = 0;
+    size_t linked_count = 0;
+
+    uint64_t structure_version = 0; // bumped whenever dense indices or body sizes change
+    uint64_t resting_version = 0;   // bumped whenever a static or sleeping body changes (broadphase caches those)
+
+    glm::vec3 uniform_acceleration{0.0f};
+    float linear_damping = 0.0f;
+
+    std::vector<std::unique_ptr<force_generator>> generators;
+
+private:
+    /// @brief Every SoA array, for bulk resizes and swaps
+    template <typename Function>
+    void for_each_array(Function &&function)
+    {
+        for (aligned_vector<float> *array : {&pos_x, &pos_y, &pos_z, &vel_x, &vel_y, &vel_z, &force_x, &force_y, &force_z, &inv_mass, &half_x, &half_y, &half_z, &awake})
+            function(*array);
+    }
+
+    /// @brief Grow the arrays so count bodies plus padding fit; padding lanes stay zero (static, at rest)
+    void reserve_lanes(size_t bodies)
+    {
+        size_t padded = (bodies + PHYSICS_LANE_PADDING - 1) / PHYSICS_LANE_PADDING * PHYSICS_LANE_PADDING;
+
+        if (padded <= pos_x.size())
+            return;
+
+        size_t grown = std::max(padded, pos_x.size() * 2);
+
+        for_each_array([grown](aligned_vector<float> &array)
+                       { array.resize(grown, 0.0f); });
+    }
+
+    /// @brief Integrate dense lanes [begin, end); both multiples of simd_float::width
+    /// @tparam Velocities: v += (F / m + g) * dt, then clear forces
+    /// @tparam Positions: x += v * dt
+    template <bool Velocities, bool Positions>
+    void integrate_range(size_t begin, size_t end, float dt)
+    {
+        const simd_float step = simd_float::set1(dt);
+        const simd_float damping = simd_float::set1(1.0f / (1.0f + dt * linear_damping));
+        const simd_float zero = simd_float::zero();
+
+        const simd_float gx = simd_float::set1(uniform_acceleration.x);
+        const simd_float gy = simd_float::set1(uniform_acceleration.y);
+        const simd_float gz = simd_float::set1(uniform_acceleration.z);
+
+        for (size_t i = begin; i < end; i += simd_float::width)
+        {
+            simd_float im = simd_float::load(&inv_mass[i]);
+
+            // ======= static and sleeping lanes neither accelerate nor move =======
+
+            simd_float moving = simd_float::keep(simd_float::greater(im, zero), simd_float::greater(simd_float::load(&awake[i]), zero));
+
+            simd_float vx = simd_float::load(&vel_x[i]);
+            simd_float vy = simd_float::load(&vel_y[i]);
+            simd_float vz = simd_float::load(&vel_z[i]);
+
+            if (Velocities)
+            {
+                vx = (vx + simd_float::keep(moving, simd_float::load(&force_x[i]) * im + gx) * step) * damping;
+                vy = (vy + simd_float::keep(moving, simd_float::load(&force_y[i]) * im + gy) * step) * damping;
+                vz = (vz + simd_float::keep(moving, simd_float::load(&force_z[i]) * im + gz) * step) * damping;
+
+                vx.store(&vel_x[i]);
+                vy.store(&vel_y[i]);
+                vz.store(&vel_z[i]);
+
+                zero.store(&force_x[i]);
+                zero.store(&force_y[i]);
+                zero.store(&force_z[i]);
+            }
+
+            if (Positions)
+            {
+                (simd_float::load(&pos_x[i]) + simd_float::keep(moving, vx) * step).store(&pos_x[i]);
+                (simd_float::load(&pos_y[i]) + simd_float::keep(moving, vy) * step).store(&pos_y[i]);
+                (simd_float::load(&pos_z[i]) + simd_float::keep(moving, vz) * step).store(&pos_z[i]);
+            }
+        }
+    }
+
+    /// @brief A body was edited from outside: wake it if dynamic, otherwise invalidate cached resting state
+    void touch(size_t index)
+    {
+        if (inv_mass[index] > 0.0f && awake[index] > 0.0f)
+            return;
+
+        if (inv_mass[index] > 0.0f)
+            set_awake(index, true);
+        else
+            ++resting_version;
+    }
+
+    /// @brief Run integrate_range over every lane, split across the pool for large worlds
+    template <bool Velocities, bool Positions>
+    void integrate(float dt, thread_pool &pool)
+    {
+        size_t lanes = padded_size();
+
+        if (lanes < PHYSICS_PARALLEL_THRESHOLD)
+        {
+            integrate_range<Velocities, Positions>(0, lanes, dt);
+            return;
+        }
+
+        // ======= parallel_for over blocks of PHYSICS_LANE_PADDING lanes, so every range stays SIMD aligned =======
+
+        pool.parallel_for(0, lanes / PHYSICS_LANE_PADDING, PHYSICS_PARALLEL_THRESHOLD / (4 * PHYSICS_LANE_PADDING), [this, dt](size_t begin, size_t end)
+                          { integrate_range<Velocities, Positions>(begin * PHYSICS_LANE_PADDING, end * PHYSICS_LANE_PADDING, dt); });
+    }
+
+    /// @brief Reset the uniform acceleration and let every generator accumulate forces
+    void apply_generators(float dt)
+    {
+        uniform_acceleration = glm::vec3(0.0f);
+
+        for (auto &generator : generators)
+            generator->apply(*this, dt);
+    }
+
+public:
+    // ======= BODIES =======
+
+    /// @brief Add a body
+    /// @param position
+    /// @param velocity (default: at rest)
+    /// @param mass: <= 0 makes the body static (default: 1)
+    /// @param object_id: Object kept in sync by sync_to (default: none)
+    /// @param half_extents: Collision box half size (default: unit cube, matching object_lib shapes)
+    /// @return body_handle
+    body_handle add_body(const glm::vec3 &position, const glm::vec3 &velocity = glm::vec3(0.0f), float mass = 1.0f, size_t object_id = SIZE_MAX, const glm::vec3 &half_extents = glm::vec3(0.5f))
+    {
+        body_handle handle = handles.create();
+        uint32_t index = entity_allocator::index_of(handle);
+
+        if (index >= sparse.size())
+            sparse.resize(index + 1, UINT32_MAX);
+
+        reserve_lanes(count + 1);
+
+        sparse[index] = static_cast<uint32_t>(count);
+        dense_handles.push_back(handle);
+        object_ids.push_back(object_id);
+
+        pos_x[count] = position.x;
+        pos_y[count] = position.y;
+        pos_z[count] = position.z;
+
+        vel_x[count] = velocity.x;
+        vel_y[count] = velocity.y;
+        vel_z[count] = velocity.z;
+
+        force_x[count] = force_y[count] = force_z[count] = 0.0f;
+        inv_mass[count] = mass > 0.0f ? 1.0f / mass : 0.0f;
+
+        half_x[count] = half_extents.x;
+        half_y[count] = half_extents.y;
+        half_z[count] = half_extents.z;
+
+        awake[count] = 1.0f;
+        shapes.push_back(body_shape::box);
+
+        if (object_id != SIZE_MAX)
+            ++linked_count;
+
+        ++count;
+        ++structure_version;
+        ++resting_version;
+
+        return handle;
+    }
+
+    /// @brief Add a sphere body
+    /// @param position
+    /// @param radius
+    /// @param velocity (default: at rest)
+    /// @param mass: <= 0 makes the body static (default: 1)
+    /// @param object_id: Object kept in sync by sync_to (default: none)
+    /// @return body_handle
+    body_handle add_sphere(const glm::vec3 &position, float radius, const glm::vec3 &velocity = glm::vec3(0.0f), float mass = 1.0f, size_t object_id = SIZE_MAX)
+    {
+        body_handle handle = add_body(position, velocity, mass, object_id, glm::vec3(radius));
+        shapes[index_of(handle)] = body_shape::sphere;
+
+        return handle;
+    }
+
+    /// @brief Remove a body; the last body is moved into its slot
+    /// @param handle
+    void remove_body(body_handle handle)
+    {
+        if (!handles.alive(handle))
+            return;
+
+        size_t slot = sparse[entity_allocator::index_of(handle)];
+        size_t last = count - 1;
+
+        if (object_ids[slot] != SIZE_MAX)
+            --linked_count;
+
+        if (slot != last)
+        {
+            for_each_array([slot, last](aligned_vector<float> &array)
+                           { array[slot] = array[last]; });
+
+            dense_handles[slot] = dense_handles[last];
+            object_ids[slot] = object_ids[last];
+            shapes[slot] = shapes[last];
+            sparse[entity_allocator::index_of(dense_handles[slot])] = static_cast<uint32_t>(slot);
+        }
+
+        // ======= the vacated lane becomes padding again =======
+
+        for_each_array([last](aligned_vector<float> &array)
+                       { array[last] = 0.0f; });
+
+        dense_handles.pop_back();
+        object_ids.pop_back();
+        shapes.pop_back();
+        sparse[entity_allocator::index_of(handle)] = UINT32_MAX;
+
+        handles.destroy(handle);
+        --count;
+        ++structure_version;
+        ++resting_version;
+    }
+
+    /// @brief Keep linked object IDs in sync after object_manager::delete_object: bodies linked to the deleted object are
+    /// removed (their handles die) and later IDs shift down by one
+    /// @param object_id
+    void object_deleted(size_t object_id)
+    {
+        if (linked_count == 0)
+            return;
+
+        // ======= backwards, so the body remove_body() swaps into a slot has already been visited =======
+
+        for (size_t i = count; i-- > 0;)
+            if (object_ids[i] == object_id)
+                remove_body(dense_handles[i]);
+
+        for (size_t &id : object_ids)
+            if (id != SIZE_MAX && id > object_id)
+                --id;
+    }
+
+    /// @brief If a handle refers to a live body
+    /// @param handle
+    /// @return bool
+    bool alive(body_handle handle) const { return handles.alive(handle); }
+
+    /// @brief Remove every body (force generators stay registered)
+    void clear()
+    {
+        handles.clear();
+        sparse.clear();
+        dense_handles.clear();
+        object_ids.clear();
+        shapes.clear();
+
+        for_each_array([](aligned_vector<float> &array)
+                       { std::fill(array.begin(), array.end(), 0.0f); });
+
+        count = 0;
+        linked_count = 0;
+        ++structure_version;
+        ++resting_version;
+    }
+
+    // ======= BODY STATE =======
+
+    /// @brief Dense index of a body (changes when other bodies are removed)
+    /// @param handle
+    /// @return size_t
+    size_t index_of(body_handle handle) const
+    {
+        if (!handles.alive(handle))
+            throw std::out_of_range("physics_world: Invalid body handle");
+
+        return sparse[entity_allocator::index_of(handle)];
+    }
+
+    glm::vec3 get_position(body_handle handle) const
+    {
+        size_t i = index_of(handle);
+        return {pos_x[i], pos_y[i], pos_z[i]};
+    }
+
+    /// @brief Teleport a body (wakes dynamic bodies)
+    void set_position(body_handle handle, const glm::vec3 &position)
+    {
+        size_t i = index_of(handle);
+
+        pos_x[i] = position.x;
+        pos_y[i] = position.y;
+        pos_z[i] = position.z;
+
+        touch(i);
+    }
+
+    glm::vec3 get_velocity(body_handle handle) const
+    {
+        size_t i = index_of(handle);
+        return {vel_x[i], vel_y[i], vel_z[i]};
+    }
+
+    /// @brief Set a body's velocity (wakes dynamic bodies; static bodies only move through set_position)
+    void set_velocity(body_handle handle, const glm::vec3 &velocity)
+    {
+        size_t i = index_of(handle);
+
+        vel_x[i] = velocity.x;
+        vel_y[i] = velocity.y;
+        vel_z[i] = velocity.z;
+
+        touch(i);
+    }
+
+    /// @brief Mass of a body
+    /// @param handle
+    /// @return float: 0 for static bodies
+    float get_mass(body_handle handle) const
+    {
+        float im = inv_mass[index_of(handle)];
+        return im > 0.0f ? 1.0f / im : 0.0f;
+    }
+
+    glm::vec3 get_half_extents(body_handle handle) const
+    {
+        size_t i = index_of(handle);
+        return {half_x[i], half_y[i], half_z[i]};
+    }
+
+    void set_half_extents(body_handle handle, const glm::vec3 &half_extents)
+    {
+        size_t i = index_of(handle);
+
+        half_x[i] = half_extents.x;
+        half_y[i] = half_extents.y;
+        half_z[i] = half_extents.z;
+
+        touch(i);
+        ++structure_version;
+    }
+
+    /// @brief Collision shape of a body
+    /// @param handle
+    /// @return body_shape
+    body_shape get_shape(body_handle handle) const { return shapes[index_of(handle)]; }
+
+    /// @brief Add a force for the next step only (wakes the body)
+    /// @param handle
+    /// @param force
+    void apply_force(body_handle handle, const glm::vec3 &force)
+    {
+        size_t i = index_of(handle);
+
+        force_x[i] += force.x;
+        force_y[i] += force.y;
+        force_z[i] += force.z;
+
+        touch(i);
+    }
+
+    /// @brief Change velocity immediately by impulse / mass
+    /// @param handle
+    /// @param impulse
+    void apply_impulse(body_handle handle, const glm::vec3 &impulse)
+    {
+        size_t i = index_of(handle);
+
+        vel_x[i] += impulse.x * inv_mass[i];
+        vel_y[i] += impulse.y * inv_mass[i];
+        vel_z[i] += impulse.z * inv_mass[i];
+
+        touch(i);
+    }
+
+    // ======= SLEEPING =======
+
+    /// @brief If a body is simulated (static bodies always report awake)
+    /// @param handle
+    /// @return bool
+    bool is_awake(body_handle handle) const { return awake[index_of(handle)] > 0.0f; }
+
+    /// @brief Resume simulating a sleeping body
+    /// @param handle
+    void wake(body_handle handle) { set_awake(index_of(handle), true); }
+
+    /// @brief Stop simulating a body until it is woken; its velocity is zeroed
+    /// @param handle
+    void sleep(body_handle handle) { set_awake(index_of(handle), false); }
+
+    /// @brief Sleep state by dense index (used by the contact solver)
+    /// @param index
+    /// @param state
+    void set_awake(size_t index, bool state)
+    {
+        if ((awake[index] > 0.0f) == state || (!state && inv_mass[index] <= 0.0f))
+            return;
+
+        awake[index] = state ? 1.0f : 0.0f;
+
+        if (!state)
+            vel_x[index] = vel_y[index] = vel_z[index] = 0.0f;
+
+        ++resting_version;
+    }
+
+    // ======= FORCE GENERATORS =======
+
+    /// @brief Register a force generator; it applies every step until removed
+    /// @tparam T: force_generator subclass
+    /// @tparam ...Args
+    /// @param ...args
+    /// @return T&
+    template <typename T, typename... Args>
+    T &add_force_generator(Args &&...args)
+    {
+        generators.push_back(std::make_unique<T>(std::forward<Args>(args)...));
+        return static_cast<T &>(*generators.back());
+    }
+
+    /// @brief Unregister a force generator
+    /// @param generator
+    void remove_force_generator(const force_generator *generator)
+    {
+        generators.erase(std::remove_if(generators.begin(), generators.end(), [generator](const std::unique_ptr<force_generator> &entry)
+                                        { return entry.get() == generator; }),
+                         generators.end());
+    }
+
+    /// @brief Acceleration applied to every dynamic body this step (used by gravity-like generators)
+    /// @param acceleration
+    void add_uniform_acceleration(const glm::vec3 &acceleration) { uniform_acceleration += acceleration; }
+
+    /// @brief Gravity-like acceleration accumulated by the generators this step
+    /// @return const glm::vec3&
+    const glm::vec3 &get_uniform_acceleration() const { return uniform_acceleration; }
+
+    /// @brief Velocity damping per second (0 = none)
+    /// @param damping
+    void set_linear_damping(float damping) { linear_damping = std::max(damping, 0.0f); }
+
+    // ======= SIMULATION =======
+
+    /// @brief Apply every force generator, then integrate all bodies in one vectorised pass
+    /// @param dt
+    /// @param pool: Splits large worlds across threads (default: thread_pool::shared())
+    void step(float dt, thread_pool &pool = thread_pool::shared())
+    {
+        apply_generators(dt);
+        integrate<true, true>(dt, pool);
+    }
+
+    /// @brief First half of a step with contacts: apply every force generator and update velocities only
+    /// @param dt
+    /// @param pool (default: thread_pool::shared())
+    void integrate_velocities(float dt, thread_pool &pool = thread_pool::shared())
+    {
+        apply_generators(dt);
+        integrate<true, false>(dt, pool);
+    }
+
+    /// @brief Second half of a step with contacts: move bodies by their (solved) velocities
+    /// @param dt
+    /// @param pool (default: thread_pool::shared())
+    void integrate_positions(float dt, thread_pool &pool = thread_pool::shared())
+    {
+        integrate<false, true>(dt, pool);
+    }
+
+    /// @brief Copy positions and velocities of linked bodies onto their objects
+    /// @tparam Objects: Indexable container of object_interface (e.g. object_manager::get_objects())
+    /// @param objects
+    template <typename Objects>
+    void sync_to(Objects &objects) const
+    {
+        if (linked_count == 0)
+            return;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            size_t id = object_ids[i];
+
+            // ======= sleeping bodies haven't moved since they were last synced =======
+
+            if (id >= objects.size() || awake[i] <= 0.0f)
+                continue;
+
+            objects[id].move_set(pos_x[i], pos_y[i], pos_z[i]);
+            objects[id].velocity_set(vel_x[i], vel_y[i], vel_z[i]);
+        }
+    }
+
+    // ======= SOA ACCESS (force generators, broadphase) =======
+
+    size_t size() const { return count; }
+
+    /// @brief Lane count including zeroed padding, a multiple of PHYSICS_LANE_PADDING
+    size_t padded_size() const { return (count + PHYSICS_LANE_PADDING - 1) / PHYSICS_LANE_PADDING * PHYSICS_LANE_PADDING; }
+
+    float *positions_x() { return pos_x.data(); }
+    float *positions_y() { return pos_y.data(); }
+    float *positions_z() { return pos_z.data(); }
+
+    float *velocities_x() { return vel_x.data(); }
+    float *velocities_y() { return vel_y.data(); }
+    float *velocities_z() { return vel_z.data(); }
+
+    float *forces_x() { return force_x.data(); }
+    float *forces_y() { return force_y.data(); }
+    float *forces_z() { return force_z.data(); }
+
+    const float *inverse_masses() const { return inv_mass.data(); }
+
+    const float *half_extents_x() const { return half_x.data(); }
+    const float *half_extents_y() const { return half_y.data(); }
+    const float *half_extents_z() const { return half_z.data(); }
+
+    /// @brief 1 for simulated lanes, 0 for sleeping ones
+    const float *awake_lanes() const { return awake.data(); }
+
+    const body_shape *get_shapes() const { return shapes.data(); }
+
+    /// @brief Changes whenever bodies are added or removed (dense indices are only stable between changes)
+    /// @return uint64_t
+    uint64_t get_structure_version() const { return structure_version; }
+
+    /// @brief Changes whenever a static or sleeping body may have changed (or the body set changed)
+    /// @return uint64_t
+    uint64_t get_resting_version() const { return resting_version; }
+
+    const std::vector<body_handle> &get_handles() const { return dense_handles; }
+};
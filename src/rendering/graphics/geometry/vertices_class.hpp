@@ -4,6 +4,8 @@
 
 #include <glad/glad.h>
 
+#include "../../software/software_assets.hpp"
+
 // ======= vertices_class =======
 
 class vertices_class
@@ -15,16 +17,15 @@ public:
     /// @param vertices
     /// @param colors
     /// @param texcoords
+    /// @param normals: Without them lit shading treats every surface as facing the camera
     /// @return unsigned int: VAO
-    static unsigned int create_object(const std::vector<float> &vertices, const std::vector<float> &colors, const std::vector<float> &texcoords = {})
+    static unsigned int create_object(const std::vector<float> &vertices, const std::vector<float> &colors, const std::vector<float> &texcoords = {}, const std::vector<float> &normals = {})
     {
-        unsigned int VAO, VBO[3] = {0, 0, 0};
+        unsigned int VAO, VBO[4] = {0, 0, 0, 0};
         glGenVertexArrays(1, &VAO);
 
-        int bufferCount = 2;
-
-        if (!texcoords.empty())
-            bufferCount = 3;
+        int bufferCount = 2 + !texcoords.empty() + !normals.empty();
+        int nextBuffer = 2;
 
         glGenBuffers(bufferCount, VBO);
 
@@ -42,15 +43,28 @@ public:
 
         if (!texcoords.empty())
         {
-            glBindBuffer(GL_ARRAY_BUFFER, VBO[2]);
+            glBindBuffer(GL_ARRAY_BUFFER, VBO[nextBuffer++]);
             glBufferData(GL_ARRAY_BUFFER, texcoords.size() * sizeof(float), texcoords.data(), GL_STATIC_DRAW);
             glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void *)0);
             glEnableVertexAttribArray(2);
         }
 
+        if (!normals.empty())
+        {
+            glBindBuffer(GL_ARRAY_BUFFER, VBO[nextBuffer++]);
+            glBufferData(GL_ARRAY_BUFFER, normals.size() * sizeof(float), normals.data(), GL_STATIC_DRAW);
+            glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void *)0);
+            glEnableVertexAttribArray(3);
+        }
+
         glBindBuffer(GL_ARRAY_BUFFER, 0);
         glBindVertexArray(0);
 
+        // ======= keep a CPU copy for the software backend =======
+
+        if (software_assets::get().capturing())
+            software_assets::get().add_mesh(VAO, vertices, colors, texcoords);
+
         return VAO;
     }
 };
\ No newline at end of file
@@ -2,15 +2,117 @@
 
 in vec2 textureCoords;
 in vec3 vertexColor;
+in vec3 worldPosition;
+in vec3 worldNormal;
+in vec3 toCamera;
+in float viewDepth;
 out vec4 fragColor;
 
 uniform sampler2D texture_diffuse;
 uniform bool use_texture;
 
+uniform bool use_lighting;
+uniform vec3 ambient_light;
+uniform samplerBuffer light_data;      // 2 texels per light: position + radius, color
+uniform usamplerBuffer light_clusters; // offset, count per cluster
+uniform usamplerBuffer light_indices;
+uniform ivec3 cluster_grid;
+uniform vec2 cluster_depth;            // slice = log(view depth) * x + y
+uniform vec4 cluster_viewport;
+
+uniform bool use_sun;
+uniform bool use_shadows;
+uniform vec3 sun_direction;                // from the light into the scene
+uniform vec3 sun_color;
+uniform sampler2DArrayShadow shadow_maps;  // one layer per cascade
+uniform mat4 shadow_matrices[4];           // world -> cascade clip space
+uniform vec4 shadow_splits;                // farthest view depth of each cascade
+uniform vec4 shadow_texels;                // world size of a texel of each cascade
+
+vec3 surface_normal()
+{
+    vec3 normal = dot(worldNormal, worldNormal) > 0.0 ? normalize(worldNormal) : normalize(toCamera);
+
+    // light whichever side faces the camera (nothing is face culled)
+    if (dot(normal, toCamera) < 0.0)
+        normal = -normal;
+
+    return normal;
+}
+
+vec3 clustered_light(vec3 normal)
+{
+    ivec2 tile = clamp(ivec2((gl_FragCoord.xy - cluster_viewport.xy) / cluster_viewport.zw * vec2(cluster_grid.xy)), ivec2(0), cluster_grid.xy - 1);
+    int slice = clamp(int(floor(log(max(viewDepth, 1e-6)) * cluster_depth.x + cluster_depth.y)), 0, cluster_grid.z - 1);
+
+    uvec2 range = texelFetch(light_clusters, (slice * cluster_grid.y + tile.y) * cluster_grid.x + tile.x).xy;
+
+    vec3 total = vec3(0.0);
+
+    for (uint i = 0u; i < range.y; ++i)
+    {
+        int light = int(texelFetch(light_indices, int(range.x + i)).x);
+
+        vec4 sphere = texelFetch(light_data, light * 2);
+        vec3 offset = sphere.xyz - worldPosition;
+
+        float distance_squared = dot(offset, offset);
+        float radius_squared = sphere.w * sphere.w;
+
+        if (distance_squared >= radius_squared)
+            continue;
+
+        float falloff = 1.0 - distance_squared / radius_squared;
+        float facing = max(dot(normal, offset * inversesqrt(max(distance_squared, 1e-8))), 0.0);
+
+        total += texelFetch(light_data, light * 2 + 1).rgb * (falloff * falloff * facing);
+    }
+
+    return total;
+}
+
+float sun_shadow(vec3 normal)
+{
+    if (!use_shadows || viewDepth >= shadow_splits.w)
+        return 1.0;
+
+    int cascade = viewDepth < shadow_splits.x ? 0 : viewDepth < shadow_splits.y ? 1 : viewDepth < shadow_splits.z ? 2 : 3;
+
+    // pushed off the surface by a texel and a half against acne on slopes
+    vec3 position = worldPosition + normal * (shadow_texels[cascade] * 1.5);
+    vec3 coords = (shadow_matrices[cascade] * vec4(position, 1.0)).xyz * 0.5 + 0.5;
+
+    return texture(shadow_maps, vec4(coords.xy, float(cascade), min(coords.z, 1.0)));
+}
+
+vec3 sun_light(vec3 normal)
+{
+    float facing = max(dot(normal, -sun_direction), 0.0);
+
+    if (facing <= 0.0)
+        return vec3(0.0);
+
+    return sun_color * (facing * sun_shadow(normal));
+}
+
 void main()
 {
     vec4 vertexCol = vec4(vertexColor, 1.0);
     vec4 textureCol = texture(texture_diffuse, textureCoords);
 
     fragColor = use_texture ? vertexCol * textureCol : vertexCol;
+
+    if (use_lighting || use_sun)
+    {
+        vec3 normal = surface_normal();
+        vec3 light = ambient_light;
+
+        if (use_lighting)
+            light += clustered_light(normal);
+
+        if (use_sun)
+            light += sun_light(normal);
+
+        fragColor.rgb *= light;
+    }
 }
\ No newline at end of file
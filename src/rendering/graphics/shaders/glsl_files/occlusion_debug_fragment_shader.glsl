@@ -0,0 +1,13 @@
+#version 330 core
+
+in vec2 textureCoords;
+out vec4 fragColor;
+
+uniform sampler2D occlusion_buffer;
+
+void main()
+{
+    float nearness = texture(occlusion_buffer, textureCoords).r;
+
+    fragColor = vec4(nearness, nearness, nearness, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+#version 330 core
+
+in vec2 corner;
+in vec4 particleColor;
+out vec4 fragColor;
+
+void main()
+{
+    float falloff = 1.0 - smoothstep(0.25, 0.5, length(corner));
+
+    if (falloff <= 0.0)
+        discard;
+
+    fragColor = vec4(particleColor.rgb, particleColor.a * falloff);
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#version 330 core
+
+layout(location = 0) in vec2 aCorner;
+layout(location = 1) in float aPosX;
+layout(location = 2) in float aPosY;
+layout(location = 3) in float aPosZ;
+layout(location = 4) in float aAge;
+
+out vec2 corner;
+out vec4 particleColor;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+uniform vec4 color_start;
+uniform vec4 color_end;
+uniform float size_start;
+uniform float size_end;
+
+void main()
+{
+    vec3 right = vec3(view[0][0], view[1][0], view[2][0]);
+    vec3 up = vec3(view[0][1], view[1][1], view[2][1]);
+
+    float size = mix(size_start, size_end, aAge);
+    vec3 worldPos = vec3(aPosX, aPosY, aPosZ) + (right * aCorner.x + up * aCorner.y) * size;
+
+    gl_Position = projection * view * vec4(worldPos, 1.0);
+    corner = aCorner;
+    particleColor = mix(color_start, color_end, aAge);
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+#version 330 core
+
+in vec2 textureCoords;
+out vec4 fragColor;
+
+uniform sampler2D frame;
+
+void main()
+{
+    fragColor = texture(frame, textureCoords);
+}
\ No newline at end of file
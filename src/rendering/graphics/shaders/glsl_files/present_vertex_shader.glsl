@@ -0,0 +1,11 @@
+#version 330 core
+
+layout(location = 0) in vec2 aCorner;
+
+out vec2 textureCoords;
+
+void main()
+{
+    gl_Position = vec4(aCorner, 0.0, 1.0);
+    textureCoords = aCorner * 0.5 + 0.5;
+}
\ No newline at end of file
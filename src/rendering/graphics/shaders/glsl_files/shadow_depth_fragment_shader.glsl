@@ -0,0 +1,6 @@
+#version 330 core
+
+// depth only: the rasterizer writes the depth, no color target is bound
+void main()
+{
+}
\ No newline at end of file
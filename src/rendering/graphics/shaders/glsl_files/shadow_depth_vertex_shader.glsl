@@ -0,0 +1,11 @@
+#version 330 core
+
+layout(location = 0) in vec3 aPos;
+
+uniform mat4 model;
+uniform mat4 light_view_projection;
+
+void main()
+{
+    gl_Position = light_view_projection * model * vec4(aPos, 1.0);
+}
\ No newline at end of file
@@ -3,9 +3,14 @@
 layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec3 aColor;
 layout(location = 2) in vec2 aTexCoords;
+layout(location = 3) in vec3 aNormal;
 
 out vec2 textureCoords;
 out vec3 vertexColor;
+out vec3 worldPosition;
+out vec3 worldNormal;
+out vec3 toCamera;
+out float viewDepth;
 
 uniform mat4 model;
 uniform mat4 view;
@@ -13,7 +18,18 @@ uniform mat4 projection;
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    vec4 world = model * vec4(aPos, 1.0);
+    vec4 eye = view * world;
+
+    gl_Position = projection * eye;
     textureCoords = aTexCoords;
     vertexColor = aColor;
+
+    // cofactor of the model matrix: transforms normals like the inverse transpose, up to scale
+    mat3 linear = mat3(model);
+    worldNormal = mat3(cross(linear[1], linear[2]), cross(linear[2], linear[0]), cross(linear[0], linear[1])) * aNormal;
+
+    worldPosition = world.xyz;
+    toCamera = -(transpose(mat3(view)) * view[3].xyz) - world.xyz;
+    viewDepth = -eye.z;
 }
\ No newline at end of file
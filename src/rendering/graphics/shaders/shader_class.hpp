@@ -5,6 +5,8 @@
 #include <sstream>
 #include <string>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -18,6 +20,8 @@ class shader_class
 private:
     unsigned int ID;
 
+    mutable std::vector<std::pair<std::string, int>> uniform_locations; // name -> location, filled on first use
+
 public:
     // ======= CONSTRUCTOR =======
 
@@ -107,22 +111,57 @@ public:
 
     // ======= UTILITY API =======
 
+    /// @brief Get the location of a uniform; cached after the first lookup, no allocation afterwards
+    /// @param name: Name of the uniform
+    /// @return int: -1 if the uniform doesn't exist
+    int get_uniform_location(const char *name) const
+    {
+        for (const auto &entry : uniform_locations)
+            if (entry.first == name)
+                return entry.second;
+
+        int loc = glGetUniformLocation(ID, name);
+        uniform_locations.emplace_back(name, loc);
+
+        return loc;
+    }
+
     /// @brief Set a matrix
     /// @param name: Name of the matrix
     /// @param mat: The matrix
-    void setMat4(const std::string &name, const glm::mat4 &mat) const
+    void setMat4(const char *name, const glm::mat4 &mat) const
     {
-        int loc = glGetUniformLocation(ID, name.c_str());
-        glUniformMatrix4fv(loc, 1, GL_FALSE, &mat[0][0]);
+        glUniformMatrix4fv(get_uniform_location(name), 1, GL_FALSE, &mat[0][0]);
+    }
+
+    void setMat4(const std::string &name, const glm::mat4 &mat) const { setMat4(name.c_str(), mat); }
+
+    /// @brief Set a mat4 array uniform
+    /// @param name: Name of the array
+    /// @param mats: First matrix
+    /// @param count: Amount of matrices
+    void set_uniform_mat4v(const char *name, const glm::mat4 *mats, int count) const
+    {
+        glUniformMatrix4fv(get_uniform_location(name), count, GL_FALSE, &mats[0][0][0]);
     }
 
     /// @brief Set a vec3 uniform using glm::vec3
     /// @param name: Name of the uniform
     /// @param value: The value to set
-    void setVec3(const std::string &name, const glm::vec3 &value) const
+    void setVec3(const char *name, const glm::vec3 &value) const
     {
-        int loc = glGetUniformLocation(ID, name.c_str());
-        glUniform3f(loc, value.x, value.y, value.z);
+        glUniform3f(get_uniform_location(name), value.x, value.y, value.z);
+    }
+
+    void setVec3(const std::string &name, const glm::vec3 &value) const { setVec3(name.c_str(), value); }
+
+    /// @brief Set a vec2 uniform
+    /// @param name: Name of the uniform
+    /// @param x
+    /// @param y
+    void set_uniform2f(const char *name, float x, float y) const
+    {
+        glUniform2f(get_uniform_location(name), x, y);
     }
 
     /// @brief Set a vec3 uniform
@@ -130,18 +169,46 @@ public:
     /// @param x
     /// @param y
     /// @param z
-    void set_uniform3f(const std::string &name, float x, float y, float z) const
+    void set_uniform3f(const char *name, float x, float y, float z) const
     {
-        int loc = glGetUniformLocation(ID, name.c_str());
-        glUniform3f(loc, x, y, z);
+        glUniform3f(get_uniform_location(name), x, y, z);
+    }
+
+    void set_uniform3f(const std::string &name, float x, float y, float z) const { set_uniform3f(name.c_str(), x, y, z); }
+
+    /// @brief Set a vec4 uniform
+    /// @param name: Name of the uniform
+    /// @param value: The value to set
+    void set_uniform4f(const char *name, const glm::vec4 &value) const
+    {
+        glUniform4f(get_uniform_location(name), value.x, value.y, value.z, value.w);
+    }
+
+    /// @brief Set a uniform1f
+    /// @param name: Name of the uniform
+    /// @param value: The value to set
+    void set_uniform1f(const char *name, float value) const
+    {
+        glUniform1f(get_uniform_location(name), value);
     }
 
     /// @brief Set a uniform1i
     /// @param name: Name of the uniform
     /// @param value: The value to set
-    void set_uniform1i(const std::string &name, int value) const
+    void set_uniform1i(const char *name, int value) const
+    {
+        glUniform1i(get_uniform_location(name), value);
+    }
+
+    void set_uniform1i(const std::string &name, int value) const { set_uniform1i(name.c_str(), value); }
+
+    /// @brief Set an ivec3 uniform
+    /// @param name: Name of the uniform
+    /// @param x
+    /// @param y
+    /// @param z
+    void set_uniform3i(const char *name, int x, int y, int z) const
     {
-        int loc = glGetUniformLocation(ID, name.c_str());
-        glUniform1i(loc, value);
+        glUniform3i(get_uniform_location(name), x, y, z);
     }
 };
\ No newline at end of file
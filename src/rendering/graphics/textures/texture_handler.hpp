@@ -6,26 +6,20 @@
 #include <glad/glad.h>
 #include <stb_image.h>
 
+#include "../../software/software_assets.hpp"
+
 // ======= texture_handler =======
 
 class texture_handler
 {
 private:
-    unsigned int ID;
+    unsigned int ID = 0;
 
 public:
     /// @brief Loads an image as a texture
     /// @param image_path: Path to the texture
     void load_image(const std::string &image_path)
     {
-        glGenTextures(1, &ID);
-        glBindTexture(GL_TEXTURE_2D, ID);
-
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
         int width, height, nrChannels;
 
         stbi_set_flip_vertically_on_load(true);
@@ -34,17 +28,7 @@ public:
 
         if (data)
         {
-            GLenum format;
-
-            if (nrChannels == 1)
-                format = GL_RED;
-            else if (nrChannels == 3)
-                format = GL_RGB;
-            else if (nrChannels == 4)
-                format = GL_RGBA;
-
-            glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-            glGenerateMipmap(GL_TEXTURE_2D);
+            load_pixels(data, width, height, nrChannels);
         }
         else
         {
@@ -54,6 +38,46 @@ public:
         stbi_image_free(data);
     }
 
+    /// @brief Loads raw 8-bit pixels as a texture
+    /// @param data: Pixel data (rows bottom to top)
+    /// @param width
+    /// @param height
+    /// @param channels: 1, 3 or 4
+    void load_pixels(const unsigned char *data, int width, int height, int channels)
+    {
+        GLenum format;
+
+        if (channels == 1)
+            format = GL_RED;
+        else if (channels == 3)
+            format = GL_RGB;
+        else if (channels == 4)
+            format = GL_RGBA;
+        else
+        {
+            std::cerr << "load_pixels(): Unsupported channel count: " << channels << std::endl;
+            return;
+        }
+
+        if (ID == 0)
+            glGenTextures(1, &ID);
+
+        glBindTexture(GL_TEXTURE_2D, ID);
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+        glGenerateMipmap(GL_TEXTURE_2D);
+
+        if (software_assets::get().capturing())
+            software_assets::get().add_texture(ID, data, width, height, channels);
+    }
+
     /// @brief Bind the texture to a slot
     /// @param slot: What slot to bind the texture to (glActiveTexture)
     void bind(unsigned int slot = 0) const
@@ -61,4 +85,8 @@ public:
         glActiveTexture(GL_TEXTURE0 + slot);
         glBindTexture(GL_TEXTURE_2D, ID);
     }
+
+    /// @brief Get the GL texture ID
+    /// @return unsigned int
+    unsigned int get_id() const { return ID; }
 };
\ No newline at end of file
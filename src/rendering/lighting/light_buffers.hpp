@@ -0,0 +1,109 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include "./light_clusters.hpp"
+#include "../graphics/shaders/shader_class.hpp"
+
+// ======= MACROS =======
+
+#define LIGHT_BUFFER_FIRST_UNIT 1 // texture units 1..3 (0 is texture_diffuse)
+
+// ======= light_buffers =======
+
+/// @brief Uploads a light_cluster_data into three texture buffers (light data, cluster ranges, light indices) for fragment_shader.glsl
+class light_buffers
+{
+private:
+    unsigned int buffers[3] = {0, 0, 0};
+    unsigned int textures[3] = {0, 0, 0};
+
+    /// @brief Replace a buffer's contents (orphaning the old storage, so the driver doesn't wait on frames still reading it)
+    static void upload(unsigned int buffer, const void *data, size_t bytes)
+    {
+        glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+        glBufferData(GL_TEXTURE_BUFFER, bytes > 0 ? bytes : 16, bytes > 0 ? data : nullptr, GL_STREAM_DRAW);
+    }
+
+public:
+    // ======= CONSTRUCTOR =======
+
+    /// @brief Constructor for light_buffers (needs the GL context)
+    light_buffers()
+    {
+        const GLenum formats[3] = {GL_RGBA32F, GL_RG32UI, GL_R32UI};
+
+        glGenBuffers(3, buffers);
+        glGenTextures(3, textures);
+
+        for (int i = 0; i < 3; ++i)
+        {
+            upload(buffers[i], nullptr, 0);
+
+            glBindTexture(GL_TEXTURE_BUFFER, textures[i]);
+            glTexBuffer(GL_TEXTURE_BUFFER, formats[i], buffers[i]);
+        }
+
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    }
+
+    // ======= MAIN API =======
+
+    /// @brief Point a shader's light samplers at their texture units; needed once even if nothing is ever lit, since
+    /// samplers of different types left on unit 0 next to texture_diffuse make every draw fail
+    /// @param shader: Bound shader using fragment_shader.glsl
+    void attach(const shader_class &shader) const
+    {
+        shader.set_uniform1i("light_data", LIGHT_BUFFER_FIRST_UNIT);
+        shader.set_uniform1i("light_clusters", LIGHT_BUFFER_FIRST_UNIT + 1);
+        shader.set_uniform1i("light_indices", LIGHT_BUFFER_FIRST_UNIT + 2);
+    }
+
+    /// @brief Upload a frame's lights and clusters
+    /// @param data
+    void upload(const light_cluster_data &data)
+    {
+        if (!data.valid)
+            return;
+
+        upload(buffers[0], data.lights.data(), data.lights.size() * sizeof(float));
+        upload(buffers[1], data.clusters.data(), data.clusters.size() * sizeof(uint32_t));
+        upload(buffers[2], data.indices.data(), data.indices.size() * sizeof(uint32_t));
+
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    }
+
+    /// @brief Turn clustered lighting on or off for the following draws of a shader using fragment_shader.glsl
+    /// @param shader: Bound and attached
+    /// @param data: The data last uploaded (lighting stays off if it's invalid)
+    /// @param rect: Viewport the clusters span, x, y, width, height in pixels
+    void bind(const shader_class &shader, const light_cluster_data &data, const int rect[4]) const
+    {
+        shader.set_uniform1i("use_lighting", data.valid);
+
+        if (!data.valid)
+            return;
+
+        for (int i = 0; i < 3; ++i)
+        {
+            glActiveTexture(GL_TEXTURE0 + LIGHT_BUFFER_FIRST_UNIT + i);
+            glBindTexture(GL_TEXTURE_BUFFER, textures[i]);
+        }
+
+        glActiveTexture(GL_TEXTURE0);
+
+        shader.set_uniform3i("cluster_grid", LIGHT_CLUSTERS_X, LIGHT_CLUSTERS_Y, LIGHT_CLUSTERS_Z);
+        shader.set_uniform2f("cluster_depth", data.depth_scale, data.depth_bias);
+        shader.set_uniform4f("cluster_viewport", glm::vec4(rect[0], rect[1], rect[2], rect[3]));
+    }
+
+    /// @brief Destroy the GL objects
+    void destroy()
+    {
+        glDeleteTextures(3, textures);
+        glDeleteBuffers(3, buffers);
+    }
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// ======= MACROS =======
+
+#define LIGHT_CLUSTERS_X 16 // screen columns (multiple of 8, tested as whole SIMD blocks)
+#define LIGHT_CLUSTERS_Y 9  // screen rows
+#define LIGHT_CLUSTERS_Z 24 // depth slices, exponentially spaced between the near and far plane
+
+// ======= STRUCTS =======
+
+/// @brief Cluster grid of one frame in the layout the shaders read (light_buffers uploads it as is)
+struct light_cluster_data
+{
+    std::vector<float> lights;      // 8 floats per light: world x, y, z, radius, r, g, b, 0
+    std::vector<uint32_t> clusters; // offset into indices, count; x fastest, then y, then slice
+    std::vector<uint32_t> indices;  // the lights of every cluster, back to back
+
+    float depth_scale = 0.0f; // slice = log(view depth) * depth_scale + depth_bias
+    float depth_bias = 0.0f;
+
+    bool valid = false; // false: nothing to light (no lights, or not a perspective projection)
+};
@@ -0,0 +1,379 @@
+#pragma once
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "./light_cluster_data.hpp"
+#include "./point_lights.hpp"
+#include "../../helpers/math/simd.hpp"
+#include "../../helpers/memory/aligned_allocator.hpp"
+#include "../../helpers/threading/thread_pool.hpp"
+
+// ======= MACROS =======
+
+#define LIGHT_CLUSTER_GRAIN 1024 // lights per view-space transform task
+
+// ======= STRUCTS =======
+
+/// @brief What the last build did
+struct light_cluster_stats
+{
+    size_t lights = 0;
+    size_t in_view = 0;         // lights overlapping the view's depth range
+    size_t references = 0;      // light indices written over all clusters
+    size_t max_per_cluster = 0;
+};
+
+// ======= light_clusters =======
+
+/// @brief Assigns point lights to a 3D grid of view-space clusters so each fragment only loops over the lights of its cluster
+/// @note Cluster bounds are AABBs of the frustum cells, rebuilt when the projection changes. A cell's x range only depends
+/// on its column and slice and its y range on its row and slice, so a light is tested against a (slice, row) strip of
+/// clusters by one SIMD sphere-AABB test per 8 columns. Strips are assigned in parallel, each task owns its clusters
+class light_clusters
+{
+private:
+    static constexpr int cluster_count = LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y * LIGHT_CLUSTERS_Z;
+
+    glm::mat4 cached_projection = glm::mat4(0.0f);
+
+    float slice_depth[LIGHT_CLUSTERS_Z + 1];
+    aligned_vector<float> column_min, column_max; // per (slice, column)
+    std::vector<float> row_min, row_max;          // per (slice, row)
+
+    aligned_vector<float> view_x, view_y, depth;
+    std::vector<int> slice_first, slice_last; // slice range per light, first > last if it's out of view
+
+    // ======= lights bucketed by slice as SoA copies, each slice padded to LIGHT_LANE_PADDING with lights that never hit =======
+
+    std::vector<uint32_t> slice_offsets; // lights of slice k: [slice_offsets[k], slice_offsets[k + 1])
+    std::vector<uint32_t> slice_cursor;
+    std::vector<uint32_t> slice_lights;
+    aligned_vector<float> slice_x, slice_y, slice_z, slice_radius_squared; // view x, view y, view depth, radius^2
+
+    std::vector<std::vector<uint32_t>> cluster_lights;
+
+    light_cluster_data data;
+    light_cluster_stats stats;
+
+private:
+    /// @brief Slice containing a view depth, clamped to the grid
+    int slice_of(float view_depth) const
+    {
+        int slice = static_cast<int>(std::floor(std::log(view_depth) * data.depth_scale + data.depth_bias));
+        slice = std::min(std::max(slice, 0), LIGHT_CLUSTERS_Z - 1);
+
+        // ======= the log can round across a boundary; the exact slice depths decide =======
+
+        while (slice > 0 && view_depth < slice_depth[slice])
+            --slice;
+
+        while (slice < LIGHT_CLUSTERS_Z - 1 && view_depth >= slice_depth[slice + 1])
+            ++slice;
+
+        return slice;
+    }
+
+    /// @brief Rebuild the slice depths and cluster extents of a perspective projection
+    void rebuild_extents(const glm::mat4 &projection)
+    {
+        cached_projection = projection;
+
+        float near_plane = projection[3][2] / (projection[2][2] - 1.0f);
+        float far_plane = projection[3][2] / (projection[2][2] + 1.0f);
+
+        if (!std::isfinite(far_plane) || far_plane <= near_plane)
+            far_plane = near_plane * 10000.0f;
+
+        float log_ratio = std::log(far_plane / near_plane);
+
+        data.depth_scale = LIGHT_CLUSTERS_Z / log_ratio;
+        data.depth_bias = -LIGHT_CLUSTERS_Z * std::log(near_plane) / log_ratio;
+
+        for (int k = 0; k <= LIGHT_CLUSTERS_Z; ++k)
+            slice_depth[k] = near_plane * std::pow(far_plane / near_plane, static_cast<float>(k) / LIGHT_CLUSTERS_Z);
+
+        column_min.resize(LIGHT_CLUSTERS_Z * LIGHT_CLUSTERS_X);
+        column_max.resize(LIGHT_CLUSTERS_Z * LIGHT_CLUSTERS_X);
+        row_min.resize(LIGHT_CLUSTERS_Z * LIGHT_CLUSTERS_Y);
+        row_max.resize(LIGHT_CLUSTERS_Z * LIGHT_CLUSTERS_Y);
+
+        // ======= view x at depth d and NDC x is d * (ndc + P[2][0]) / P[0][0] (y likewise), so the extremes are at the corners =======
+
+        auto extent = [&](int slice, int cell, int cells, float scale, float offset, float &low, float &high)
+        {
+            low = FLT_MAX;
+            high = -FLT_MAX;
+
+            for (float d : {slice_depth[slice], slice_depth[slice + 1]})
+            {
+                for (int side = 0; side < 2; ++side)
+                {
+                    float ndc = -1.0f + 2.0f * (cell + side) / cells;
+                    float value = d * (ndc + offset) / scale;
+
+                    low = std::min(low, value);
+                    high = std::max(high, value);
+                }
+            }
+        };
+
+        for (int k = 0; k < LIGHT_CLUSTERS_Z; ++k)
+        {
+            for (int column = 0; column < LIGHT_CLUSTERS_X; ++column)
+                extent(k, column, LIGHT_CLUSTERS_X, projection[0][0], projection[2][0],
+                       column_min[k * LIGHT_CLUSTERS_X + column], column_max[k * LIGHT_CLUSTERS_X + column]);
+
+            for (int row = 0; row < LIGHT_CLUSTERS_Y; ++row)
+                extent(k, row, LIGHT_CLUSTERS_Y, projection[1][1], projection[2][1],
+                       row_min[k * LIGHT_CLUSTERS_Y + row], row_max[k * LIGHT_CLUSTERS_Y + row]);
+        }
+    }
+
+    /// @brief Move lights [first_block, last_block) into view space, find their slice ranges and pack them for upload
+    void transform_blocks(const point_lights &lights, const glm::mat4 &view, size_t first_block, size_t last_block)
+    {
+        const size_t width = simd_float::width;
+        const size_t count = lights.size();
+
+        simd_float row[3][4];
+
+        for (int k = 0; k < 3; ++k)
+            for (int c = 0; c < 4; ++c)
+                row[k][c] = simd_float::set1(view[c][k]);
+
+        for (size_t block = first_block; block < last_block; ++block)
+        {
+            size_t begin = block * width;
+
+            simd_float x = simd_float::load(lights.x() + begin);
+            simd_float y = simd_float::load(lights.y() + begin);
+            simd_float z = simd_float::load(lights.z() + begin);
+
+            (row[0][0] * x + row[0][1] * y + row[0][2] * z + row[0][3]).store(&view_x[begin]);
+            (row[1][0] * x + row[1][1] * y + row[1][2] * z + row[1][3]).store(&view_y[begin]);
+            (simd_float::zero() - (row[2][0] * x + row[2][1] * y + row[2][2] * z + row[2][3])).store(&depth[begin]);
+
+            for (size_t i = begin; i < std::min(begin + width, count); ++i)
+            {
+                float r = lights.radii()[i];
+                float *packed = &data.lights[i * 8];
+
+                packed[0] = lights.x()[i];
+                packed[1] = lights.y()[i];
+                packed[2] = lights.z()[i];
+                packed[3] = r;
+                packed[4] = lights.red()[i];
+                packed[5] = lights.green()[i];
+                packed[6] = lights.blue()[i];
+                packed[7] = 0.0f;
+
+                if (r <= 0.0f || depth[i] + r < slice_depth[0] || depth[i] - r >= slice_depth[LIGHT_CLUSTERS_Z])
+                {
+                    slice_first[i] = 1;
+                    slice_last[i] = 0;
+                    continue;
+                }
+
+                slice_first[i] = slice_of(std::max(depth[i] - r, slice_depth[0]));
+                slice_last[i] = slice_of(depth[i] + r);
+            }
+        }
+    }
+
+    /// @brief Test every light of a slice against one row of its clusters, 8 lights per SIMD test, then 8 columns per SIMD test
+    void assign_strip(int slice, int row)
+    {
+        const int width = simd_float::width;
+        const int first_cluster = (slice * LIGHT_CLUSTERS_Y + row) * LIGHT_CLUSTERS_X;
+
+        for (int column = 0; column < LIGHT_CLUSTERS_X; ++column)
+            cluster_lights[first_cluster + column].clear();
+
+        const simd_float zero = simd_float::zero();
+        const simd_float near_depth = simd_float::set1(slice_depth[slice]);
+        const simd_float far_depth = simd_float::set1(slice_depth[slice + 1]);
+        const simd_float low_y = simd_float::set1(row_min[slice * LIGHT_CLUSTERS_Y + row]);
+        const simd_float high_y = simd_float::set1(row_max[slice * LIGHT_CLUSTERS_Y + row]);
+
+        const float *low_x = &column_min[slice * LIGHT_CLUSTERS_X];
+        const float *high_x = &column_max[slice * LIGHT_CLUSTERS_X];
+
+        alignas(32) float remaining[simd_float::width];
+
+        for (uint32_t j = slice_offsets[slice]; j < slice_offsets[slice + 1]; j += width)
+        {
+            simd_float z = simd_float::load(&slice_z[j]);
+            simd_float y = simd_float::load(&slice_y[j]);
+
+            simd_float dz = simd_float::max(simd_float::max(near_depth - z, z - far_depth), zero);
+            simd_float dy = simd_float::max(simd_float::max(low_y - y, y - high_y), zero);
+            simd_float budget = simd_float::load(&slice_radius_squared[j]) - dz * dz - dy * dy;
+
+            int candidates = ~simd_float::movemask(simd_float::less(budget, zero)) & ((1 << width) - 1);
+
+            if (!candidates)
+                continue;
+
+            budget.store(remaining);
+
+            for (; candidates; candidates &= candidates - 1)
+            {
+                int lane = __builtin_ctz(candidates);
+
+                simd_float x = simd_float::set1(slice_x[j + lane]);
+                simd_float lane_budget = simd_float::set1(remaining[lane]);
+
+                for (int column = 0; column < LIGHT_CLUSTERS_X; column += width)
+                {
+                    simd_float dx = simd_float::max(simd_float::max(simd_float::load(low_x + column) - x, x - simd_float::load(high_x + column)), zero);
+
+                    for (int hits = ~simd_float::movemask(simd_float::greater(dx * dx, lane_budget)) & ((1 << width) - 1); hits; hits &= hits - 1)
+                        cluster_lights[first_cluster + column + __builtin_ctz(hits)].push_back(slice_lights[j + lane]);
+                }
+            }
+        }
+    }
+
+public:
+    // ======= MAIN API =======
+
+    /// @brief Assign lights to the clusters of a view
+    /// @param lights
+    /// @param view: View matrix
+    /// @param projection: Perspective projection matrix (anything else leaves the data invalid)
+    /// @param pool: Transforms and strips are split across it (default: thread_pool::shared())
+    void build(const point_lights &lights, const glm::mat4 &view, const glm::mat4 &projection, thread_pool &pool = thread_pool::shared())
+    {
+        size_t count = lights.size();
+
+        stats = {};
+        stats.lights = count;
+
+        data.valid = false;
+
+        if (count == 0 || projection[2][3] != -1.0f || projection[3][3] != 0.0f)
+            return;
+
+        if (projection != cached_projection)
+            rebuild_extents(projection);
+
+        size_t blocks = (count + simd_float::width - 1) / simd_float::width;
+        size_t padded = blocks * simd_float::width;
+
+        if (view_x.size() < padded)
+        {
+            view_x.resize(padded);
+            view_y.resize(padded);
+            depth.resize(padded);
+        }
+
+        slice_first.resize(count);
+        slice_last.resize(count);
+        data.lights.resize(count * 8);
+
+        pool.parallel_for(0, blocks, LIGHT_CLUSTER_GRAIN / simd_float::width, [&](size_t first, size_t last)
+                          { transform_blocks(lights, view, first, last); });
+
+        // ======= bucket the lights by slice (counting sort, a light goes into every slice it spans) =======
+
+        slice_offsets.assign(LIGHT_CLUSTERS_Z + 1, 0);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            for (int k = slice_first[i]; k <= slice_last[i]; ++k)
+                ++slice_offsets[k + 1];
+
+            stats.in_view += slice_first[i] <= slice_last[i];
+        }
+
+        for (int k = 0; k < LIGHT_CLUSTERS_Z; ++k)
+            slice_offsets[k + 1] = slice_offsets[k] + (slice_offsets[k + 1] + LIGHT_LANE_PADDING - 1) / LIGHT_LANE_PADDING * LIGHT_LANE_PADDING;
+
+        size_t entries = slice_offsets[LIGHT_CLUSTERS_Z];
+
+        slice_lights.assign(entries, 0);
+        slice_x.assign(entries, 0.0f);
+        slice_y.assign(entries, 0.0f);
+        slice_z.assign(entries, 0.0f);
+        slice_radius_squared.assign(entries, -1.0f);
+
+        slice_cursor.assign(slice_offsets.begin(), slice_offsets.end() - 1);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            float r = data.lights[i * 8 + 3];
+
+            for (int k = slice_first[i]; k <= slice_last[i]; ++k)
+            {
+                uint32_t j = slice_cursor[k]++;
+
+                slice_lights[j] = static_cast<uint32_t>(i);
+                slice_x[j] = view_x[i];
+                slice_y[j] = view_y[i];
+                slice_z[j] = depth[i];
+                slice_radius_squared[j] = r * r;
+            }
+        }
+
+        // ======= every strip owns LIGHT_CLUSTERS_X clusters, so strips run in parallel =======
+
+        cluster_lights.resize(cluster_count);
+
+        pool.parallel_for(0, LIGHT_CLUSTERS_Z * LIGHT_CLUSTERS_Y, 1, [this](size_t first, size_t last)
+                          {
+                              for (size_t strip = first; strip < last; ++strip)
+                                  assign_strip(static_cast<int>(strip / LIGHT_CLUSTERS_Y), static_cast<int>(strip % LIGHT_CLUSTERS_Y));
+                          });
+
+        // ======= compact the per-cluster lists =======
+
+        data.clusters.resize(cluster_count * 2);
+
+        uint32_t offset = 0;
+
+        for (int c = 0; c < cluster_count; ++c)
+        {
+            uint32_t size = static_cast<uint32_t>(cluster_lights[c].size());
+
+            data.clusters[c * 2] = offset;
+            data.clusters[c * 2 + 1] = size;
+
+            offset += size;
+            stats.max_per_cluster = std::max<size_t>(stats.max_per_cluster, size);
+        }
+
+        data.indices.resize(offset);
+        stats.references = offset;
+
+        pool.parallel_for(0, cluster_count, LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y, [this](size_t first, size_t last)
+                          {
+                              for (size_t c = first; c < last; ++c)
+                                  std::copy(cluster_lights[c].begin(), cluster_lights[c].end(), data.indices.begin() + data.clusters[c * 2]);
+                          });
+
+        data.valid = true;
+    }
+
+    // ======= UTILITY API =======
+
+    /// @brief Cluster grid of the last build
+    /// @return const light_cluster_data&
+    const light_cluster_data &get_data() const { return data; }
+
+    /// @brief Lights assigned to one cluster in the last build
+    /// @param x: Column
+    /// @param y: Row
+    /// @param slice
+    /// @return const std::vector<uint32_t>&
+    const std::vector<uint32_t> &cluster(int x, int y, int slice) const { return cluster_lights[(slice * LIGHT_CLUSTERS_Y + y) * LIGHT_CLUSTERS_X + x]; }
+
+    /// @brief Statistics of the last build
+    /// @return const light_cluster_stats&
+    const light_cluster_stats &get_stats() const { return stats; }
+};
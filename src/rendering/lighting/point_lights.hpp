@@ -0,0 +1,196 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "../../helpers/architecture/entity_allocator.hpp"
+#include "../../helpers/memory/aligned_allocator.hpp"
+
+// ======= MACROS =======
+
+#define LIGHT_LANE_PADDING 8 // SoA arrays are padded to this many lanes (widest SIMD path)
+
+// ======= TYPES =======
+
+/// @brief Generational light handle (same layout as entity)
+using light_handle = uint32_t;
+
+constexpr light_handle null_light = null_entity;
+
+// ======= point_lights =======
+
+/// @brief Point lights in SoA arrays (dense, padded with zero-radius lanes), addressed through generational handles
+class point_lights
+{
+private:
+    entity_allocator handles;
+
+    std::vector<uint32_t> sparse; // handle index -> dense slot
+    std::vector<light_handle> dense_handles;
+
+    aligned_vector<float> pos_x, pos_y, pos_z, radius;
+    aligned_vector<float> color_r, color_g, color_b; // premultiplied by intensity
+
+    size_t count = 0;
+
+    /// @brief Call a function on every SoA array
+    template <typename Function>
+    void for_each_array(Function &&function)
+    {
+        for (aligned_vector<float> *array : {&pos_x, &pos_y, &pos_z, &radius, &color_r, &color_g, &color_b})
+            function(*array);
+    }
+
+    /// @brief Dense slot of a live handle
+    size_t slot_of(light_handle handle) const
+    {
+        if (!handles.alive(handle))
+            throw std::out_of_range("point_lights: Invalid light handle");
+
+        return sparse[entity_allocator::index_of(handle)];
+    }
+
+public:
+    // ======= MAIN API =======
+
+    /// @brief Add a light
+    /// @param position: World position
+    /// @param light_radius: No light reaches past this distance
+    /// @param color (default: white)
+    /// @param intensity: Multiplies color (default: 1)
+    /// @return light_handle
+    light_handle add_light(const glm::vec3 &position, float light_radius, const glm::vec3 &color = glm::vec3(1.0f), float intensity = 1.0f)
+    {
+        light_handle handle = handles.create();
+        uint32_t index = entity_allocator::index_of(handle);
+
+        if (index >= sparse.size())
+            sparse.resize(index + 1, UINT32_MAX);
+
+        size_t padded = (count + 1 + LIGHT_LANE_PADDING - 1) / LIGHT_LANE_PADDING * LIGHT_LANE_PADDING;
+
+        if (pos_x.size() < padded)
+            for_each_array([padded](aligned_vector<float> &array)
+                           { array.resize(padded, 0.0f); });
+
+        sparse[index] = static_cast<uint32_t>(count);
+        dense_handles.push_back(handle);
+
+        ++count;
+
+        set_position(handle, position);
+        set_radius(handle, light_radius);
+        set_color(handle, color, intensity);
+
+        return handle;
+    }
+
+    /// @brief Remove a light; the last light is moved into its slot
+    /// @param handle
+    void remove_light(light_handle handle)
+    {
+        if (!handles.alive(handle))
+            return;
+
+        size_t slot = slot_of(handle);
+        size_t last = count - 1;
+
+        if (slot != last)
+        {
+            for_each_array([slot, last](aligned_vector<float> &array)
+                           { array[slot] = array[last]; });
+
+            dense_handles[slot] = dense_handles[last];
+            sparse[entity_allocator::index_of(dense_handles[slot])] = static_cast<uint32_t>(slot);
+        }
+
+        // ======= the vacated lane becomes padding again =======
+
+        for_each_array([last](aligned_vector<float> &array)
+                       { array[last] = 0.0f; });
+
+        dense_handles.pop_back();
+        sparse[entity_allocator::index_of(handle)] = UINT32_MAX;
+
+        handles.destroy(handle);
+        --count;
+    }
+
+    /// @brief Remove every light
+    void clear()
+    {
+        handles.clear();
+        sparse.clear();
+        dense_handles.clear();
+
+        for_each_array([](aligned_vector<float> &array)
+                       { std::fill(array.begin(), array.end(), 0.0f); });
+
+        count = 0;
+    }
+
+    // ======= SETTERS =======
+
+    /// @brief Move a light
+    /// @param handle
+    /// @param position
+    void set_position(light_handle handle, const glm::vec3 &position)
+    {
+        size_t slot = slot_of(handle);
+
+        pos_x[slot] = position.x;
+        pos_y[slot] = position.y;
+        pos_z[slot] = position.z;
+    }
+
+    /// @brief Change how far a light reaches
+    /// @param handle
+    /// @param light_radius
+    void set_radius(light_handle handle, float light_radius) { radius[slot_of(handle)] = light_radius > 0.0f ? light_radius : 0.0f; }
+
+    /// @brief Change a light's color
+    /// @param handle
+    /// @param color
+    /// @param intensity: Multiplies color (default: 1)
+    void set_color(light_handle handle, const glm::vec3 &color, float intensity = 1.0f)
+    {
+        size_t slot = slot_of(handle);
+
+        color_r[slot] = color.x * intensity;
+        color_g[slot] = color.y * intensity;
+        color_b[slot] = color.z * intensity;
+    }
+
+    // ======= GETTERS =======
+
+    /// @brief If a handle still refers to a light
+    /// @param handle
+    /// @return bool
+    bool alive(light_handle handle) const { return handles.alive(handle); }
+
+    /// @brief World position of a light
+    /// @param handle
+    /// @return glm::vec3
+    glm::vec3 get_position(light_handle handle) const
+    {
+        size_t slot = slot_of(handle);
+        return {pos_x[slot], pos_y[slot], pos_z[slot]};
+    }
+
+    /// @brief Amount of lights
+    /// @return size_t
+    size_t size() const { return count; }
+
+    /// @brief Dense SoA arrays, valid up to size() and padded to LIGHT_LANE_PADDING
+    const float *x() const { return pos_x.data(); }
+    const float *y() const { return pos_y.data(); }
+    const float *z() const { return pos_z.data(); }
+    const float *radii() const { return radius.data(); }
+    const float *red() const { return color_r.data(); }
+    const float *green() const { return color_g.data(); }
+    const float *blue() const { return color_b.data(); }
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+// ======= MACROS =======
+
+#define SHADOW_CASCADES 4                       // cascades of the directional light, nearest first
+#define SHADOW_MAP_SIZE 1024                    // texels per side of a cascade
+#define SHADOW_MAX_PASSES (SHADOW_CASCADES * 3) // static redraws per frame: two scrolled-in strips + one invalidated region per cascade
+
+// ======= STRUCTS =======
+
+/// @brief A rectangle of a cascade's static cache to clear and redraw with the static casters overlapping it
+struct shadow_pass
+{
+    int cascade = 0;
+    int rect[4] = {0, 0, 0, 0}; // x, y, width, height in texels
+};
+
+/// @brief Placement of one cascade and how its cached static depth changes this frame
+struct shadow_cascade
+{
+    glm::mat4 light_view_projection{1.0f}; // world -> clip of the cascade's orthographic box
+
+    float split = 0.0f; // farthest view depth the cascade is used for
+    float texel = 0.0f; // world size of a texel
+
+    int scroll[2] = {0, 0}; // texels the cached depth moves by before the passes (old texel t lands on t - scroll)
+    bool rebuild = false;   // the whole cache is redrawn (scroll is 0 and the passes cover it)
+
+    uint64_t base = 0;     // cache revision the scroll and passes apply on top of
+    uint64_t revision = 0; // cache revision after them
+
+    uint32_t dynamic_casters = 0; // dynamic casters drawn over the cache this frame
+};
+
+/// @brief Everything the GL side needs to update and sample the cascaded shadow maps of a frame
+struct shadow_cascade_data
+{
+    shadow_cascade cascades[SHADOW_CASCADES];
+
+    shadow_pass passes[SHADOW_MAX_PASSES];
+    int pass_count = 0;
+
+    glm::vec3 direction{0.0f, -1.0f, 0.0f}; // normalized, from the light into the scene
+    glm::vec3 color{1.0f};
+
+    bool shadows = true; // false: the light is unshadowed and no map is drawn
+    bool valid = false;
+
+    /// @brief Bit of a caster mask meaning "dynamic caster of a cascade"
+    /// @param cascade
+    /// @return uint32_t
+    static uint32_t cascade_bit(int cascade) { return 1u << cascade; }
+
+    /// @brief Bit of a caster mask meaning "static caster of a pass"
+    /// @param pass
+    /// @return uint32_t
+    static uint32_t pass_bit(int pass) { return 1u << (SHADOW_CASCADES + pass); }
+};
@@ -0,0 +1,605 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "./shadow_cascade_data.hpp"
+#include "../views/view_culler.hpp"
+#include "../../helpers/math/simd.hpp"
+#include "../../helpers/threading/thread_pool.hpp"
+
+// ======= MACROS =======
+
+#define SHADOW_CASTER_GRAIN 2048   // objects per caster classification task
+#define SHADOW_SPLIT_LAMBDA 0.75f  // cascade splits: 0 = uniform, 1 = logarithmic
+#define SHADOW_CACHE_SLACK 0.25f   // extra cascade width, in cascade radii, the camera can move in before the cache scrolls
+#define SHADOW_DEPTH_SLACK 2.0f    // extra depth range, in cascade radii, the camera can move in along the light before the cache is redrawn
+
+// ======= TYPES =======
+
+/// @brief How an object casts shadows
+enum class shadow_caster : uint8_t
+{
+    dynamic,    // drawn into every cascade it overlaps, every frame (default)
+    stationary, // drawn once into the cached static depth; only redrawn where the cache scrolls or is invalidated
+    none        // casts no shadow
+};
+
+// ======= STRUCTS =======
+
+/// @brief What the last update did
+struct shadow_stats
+{
+    size_t dynamic_draws = 0; // dynamic caster draws over all cascades
+    size_t static_draws = 0;  // stationary caster draws over all passes
+    int passes = 0;           // static cache rectangles redrawn
+    int rebuilt = 0;          // cascades whose whole cache was redrawn
+    int scrolled = 0;         // cascades whose cache scrolled
+};
+
+// ======= shadow_cascades =======
+
+/// @brief Fits the cascades of a directional light's shadow map to a camera and decides which casters each cascade draws
+/// @note Cascades are boxes around the bounding sphere of their slice of the view frustum, so they keep their size while the
+/// camera turns, with texel-snapped origins so they don't shimmer while it moves. Each box is wider than its sphere: it stays
+/// put until the sphere leaves it, then recenters and scrolls its cached static depth by whole texels, so only the strips
+/// that scrolled in are redrawn with stationary casters. Dynamic casters are drawn over a copy of the cache every frame.
+/// Casters of every cascade and pass are classified in one SIMD pass over the culler's bounding spheres
+class shadow_cascades
+{
+private:
+    struct cache_state
+    {
+        bool placed = false;
+
+        int64_t origin_x = 0; // box center in texels along the light's x / y axes
+        int64_t origin_y = 0;
+        float origin_z = 0.0f; // box center along the light
+
+        uint64_t revision = 0;
+    };
+
+    struct box_test
+    {
+        float min_x, max_x, min_y, max_y, max_z; // light space
+        uint32_t bit;
+    };
+
+    glm::vec3 axis_x{1.0f, 0.0f, 0.0f};
+    glm::vec3 axis_y{0.0f, 0.0f, 1.0f};
+
+    bool enabled = false;
+    float max_distance = 0.0f; // 0: the camera's far plane
+
+    glm::mat4 cached_projection = glm::mat4(0.0f);
+    float cached_distance = -1.0f;
+
+    float center_depth[SHADOW_CASCADES]; // view depth of each slice's bounding sphere center
+    float radius[SHADOW_CASCADES];
+
+    cache_state caches[SHADOW_CASCADES];
+
+    std::vector<shadow_caster> modes; // per object ID, missing entries are dynamic
+    size_t stationary_count = 0;
+    size_t none_count = 0;
+
+    std::vector<glm::vec4> dirty_regions; // world spheres whose stationary casters changed
+    bool dirty_all = true;
+
+    std::atomic<uint32_t> lost{0}; // cascades whose cache the render thread couldn't update
+
+    box_test tests[SHADOW_CASCADES + SHADOW_MAX_PASSES];
+    int test_count = 0;
+
+    std::vector<uint32_t> masks;
+
+    shadow_cascade_data data;
+    shadow_stats stats;
+
+private:
+    /// @brief Rebuild the split depths and bounding spheres of a perspective projection
+    void rebuild_splits(const glm::mat4 &projection)
+    {
+        cached_projection = projection;
+        cached_distance = max_distance;
+
+        float near_plane = projection[3][2] / (projection[2][2] - 1.0f);
+        float far_plane = projection[3][2] / (projection[2][2] + 1.0f);
+
+        if (!std::isfinite(far_plane) || far_plane <= near_plane)
+            far_plane = near_plane * 10000.0f;
+
+        if (max_distance > near_plane)
+            far_plane = std::min(far_plane, max_distance);
+
+        // ======= a slice's far corners are at depth * k from the view axis =======
+
+        float k_squared = 1.0f / (projection[0][0] * projection[0][0]) + 1.0f / (projection[1][1] * projection[1][1]);
+
+        float split[SHADOW_CASCADES + 1];
+
+        for (int c = 0; c <= SHADOW_CASCADES; ++c)
+        {
+            float t = static_cast<float>(c) / SHADOW_CASCADES;
+
+            split[c] = SHADOW_SPLIT_LAMBDA * near_plane * std::pow(far_plane / near_plane, t) +
+                       (1.0f - SHADOW_SPLIT_LAMBDA) * (near_plane + (far_plane - near_plane) * t);
+        }
+
+        split[0] = near_plane;
+        split[SHADOW_CASCADES] = far_plane;
+
+        // ======= smallest sphere around a slice: equidistant to its near and far corners, or centered on the far face =======
+
+        for (int c = 0; c < SHADOW_CASCADES; ++c)
+        {
+            float a = split[c];
+            float b = split[c + 1];
+
+            float center = std::min((a + b) * 0.5f * (1.0f + k_squared), b);
+
+            float to_far = (b - center) * (b - center) + b * b * k_squared;
+            float to_near = (center - a) * (center - a) + a * a * k_squared;
+
+            center_depth[c] = center;
+            radius[c] = std::sqrt(std::max(to_far, to_near)) * 1.001f;
+
+            data.cascades[c].split = b;
+            data.cascades[c].texel = 2.0f * radius[c] * (1.0f + SHADOW_CACHE_SLACK) / SHADOW_MAP_SIZE;
+        }
+
+        for (cache_state &cache : caches)
+            cache.placed = false;
+    }
+
+    /// @brief Rectangle of a cascade covering a light space sphere, in texels, clamped to the map
+    /// @return bool: If it's not empty
+    bool texel_rect(int c, float x, float y, float r, int out[4]) const
+    {
+        const float texel = data.cascades[c].texel;
+        const float half = SHADOW_MAP_SIZE * 0.5f;
+
+        float low_x = (x - r) / texel - caches[c].origin_x + half;
+        float high_x = (x + r) / texel - caches[c].origin_x + half;
+        float low_y = (y - r) / texel - caches[c].origin_y + half;
+        float high_y = (y + r) / texel - caches[c].origin_y + half;
+
+        int x0 = static_cast<int>(std::max(std::floor(low_x), 0.0f));
+        int x1 = static_cast<int>(std::min(std::ceil(high_x), static_cast<float>(SHADOW_MAP_SIZE)));
+        int y0 = static_cast<int>(std::max(std::floor(low_y), 0.0f));
+        int y1 = static_cast<int>(std::min(std::ceil(high_y), static_cast<float>(SHADOW_MAP_SIZE)));
+
+        if (x1 <= x0 || y1 <= y0)
+            return false;
+
+        out[0] = x0;
+        out[1] = y0;
+        out[2] = x1 - x0;
+        out[3] = y1 - y0;
+
+        return true;
+    }
+
+    /// @brief Queue a static redraw of a cascade rectangle and the caster test that goes with it
+    void add_pass(int c, int x, int y, int w, int h)
+    {
+        if (w <= 0 || h <= 0)
+            return;
+
+        shadow_pass &pass = data.passes[data.pass_count];
+
+        pass.cascade = c;
+        pass.rect[0] = x;
+        pass.rect[1] = y;
+        pass.rect[2] = w;
+        pass.rect[3] = h;
+
+        add_test(c, pass.rect, shadow_cascade_data::pass_bit(data.pass_count));
+        ++data.pass_count;
+    }
+
+    /// @brief Light space box of a cascade rectangle (texels) as a caster test
+    void add_test(int c, const int rect[4], uint32_t bit)
+    {
+        const float texel = data.cascades[c].texel;
+        const float half = SHADOW_MAP_SIZE * 0.5f;
+
+        box_test &test = tests[test_count++];
+
+        test.min_x = (caches[c].origin_x - half + rect[0]) * texel;
+        test.max_x = (caches[c].origin_x - half + rect[0] + rect[2]) * texel;
+        test.min_y = (caches[c].origin_y - half + rect[1]) * texel;
+        test.max_y = (caches[c].origin_y - half + rect[1] + rect[3]) * texel;
+        test.max_z = caches[c].origin_z + radius[c] * (1.0f + SHADOW_DEPTH_SLACK);
+        test.bit = bit;
+    }
+
+    /// @brief Move a cascade's box to follow its slice and queue the static redraws that takes
+    void place_cascade(int c, const glm::vec3 &center, bool invalid)
+    {
+        shadow_cascade &cascade = data.cascades[c];
+        cache_state &cache = caches[c];
+
+        const float texel = cascade.texel;
+        const float r = radius[c];
+        const float half = r * (1.0f + SHADOW_CACHE_SLACK);
+        const float depth_half = r * (1.0f + SHADOW_DEPTH_SLACK);
+
+        float x = glm::dot(axis_x, center);
+        float y = glm::dot(axis_y, center);
+        float z = glm::dot(data.direction, center);
+
+        int first_pass = data.pass_count;
+
+        cascade.scroll[0] = cascade.scroll[1] = 0;
+        cascade.rebuild = false;
+
+        // ======= the cache stays valid while the slice stays inside the box; it only moves by whole texels =======
+
+        bool outside_x = std::fabs(x - cache.origin_x * texel) + r > half;
+        bool outside_y = std::fabs(y - cache.origin_y * texel) + r > half;
+        bool outside_z = std::fabs(z - cache.origin_z) + r > depth_half;
+
+        int64_t new_x = outside_x ? static_cast<int64_t>(std::llround(x / texel)) : cache.origin_x;
+        int64_t new_y = outside_y ? static_cast<int64_t>(std::llround(y / texel)) : cache.origin_y;
+
+        int64_t scroll_x = new_x - cache.origin_x;
+        int64_t scroll_y = new_y - cache.origin_y;
+
+        // ======= depth is relative to the box, so moving along the light invalidates every stored value =======
+
+        if (invalid || !cache.placed || outside_z || std::llabs(scroll_x) >= SHADOW_MAP_SIZE || std::llabs(scroll_y) >= SHADOW_MAP_SIZE)
+        {
+            cache.placed = true;
+            cache.origin_x = static_cast<int64_t>(std::llround(x / texel));
+            cache.origin_y = static_cast<int64_t>(std::llround(y / texel));
+            cache.origin_z = z;
+
+            cascade.rebuild = true;
+            add_pass(c, 0, 0, SHADOW_MAP_SIZE, SHADOW_MAP_SIZE);
+        }
+        else
+        {
+            cache.origin_x = new_x;
+            cache.origin_y = new_y;
+
+            cascade.scroll[0] = static_cast<int>(scroll_x);
+            cascade.scroll[1] = static_cast<int>(scroll_y);
+
+            // ======= strips that scrolled in: a full-height column, then the rest of the scrolled-in rows =======
+
+            int sx = cascade.scroll[0];
+            int sy = cascade.scroll[1];
+
+            int column_x = sx > 0 ? SHADOW_MAP_SIZE - sx : 0;
+            int rows_y = sy > 0 ? SHADOW_MAP_SIZE - sy : 0;
+            int rest_x = sx > 0 ? 0 : -sx;
+
+            add_pass(c, column_x, 0, std::abs(sx), SHADOW_MAP_SIZE);
+            add_pass(c, rest_x, rows_y, SHADOW_MAP_SIZE - std::abs(sx), std::abs(sy));
+
+            // ======= everything stationary casters changed under goes into one rectangle =======
+
+            int region[4] = {SHADOW_MAP_SIZE, SHADOW_MAP_SIZE, 0, 0}; // x0, y0, x1, y1
+
+            for (const glm::vec4 &sphere : dirty_regions)
+            {
+                int rect[4];
+
+                if (!texel_rect(c, glm::dot(axis_x, glm::vec3(sphere)), glm::dot(axis_y, glm::vec3(sphere)), sphere.w, rect))
+                    continue;
+
+                region[0] = std::min(region[0], rect[0]);
+                region[1] = std::min(region[1], rect[1]);
+                region[2] = std::max(region[2], rect[0] + rect[2]);
+                region[3] = std::max(region[3], rect[1] + rect[3]);
+            }
+
+            add_pass(c, region[0], region[1], region[2] - region[0], region[3] - region[1]);
+        }
+
+        if (data.pass_count != first_pass)
+        {
+            cascade.base = cache.revision;
+            cascade.revision = ++cache.revision;
+        }
+        else
+        {
+            cascade.base = cascade.revision = cache.revision;
+        }
+
+        // ======= world -> light space -> the box's [-1, 1] cube =======
+
+        float box_x = cache.origin_x * texel;
+        float box_y = cache.origin_y * texel;
+
+        glm::mat4 &m = cascade.light_view_projection;
+        m = glm::mat4(0.0f);
+
+        for (int i = 0; i < 3; ++i)
+        {
+            m[i][0] = axis_x[i] / half;
+            m[i][1] = axis_y[i] / half;
+            m[i][2] = data.direction[i] / depth_half;
+        }
+
+        m[3][0] = -box_x / half;
+        m[3][1] = -box_y / half;
+        m[3][2] = -cache.origin_z / depth_half;
+        m[3][3] = 1.0f;
+
+        // ======= dynamic casters: anywhere over the box or between it and the light (depth is clamped, not clipped) =======
+
+        int whole[4] = {0, 0, SHADOW_MAP_SIZE, SHADOW_MAP_SIZE};
+        add_test(c, whole, shadow_cascade_data::cascade_bit(c));
+    }
+
+    /// @brief Project spheres [first_block, last_block) into light space and set the bits of every box they overlap
+    void classify_blocks(const view_cull_spheres &spheres, size_t first_block, size_t last_block)
+    {
+        const size_t width = simd_float::width;
+
+        const uint32_t cascade_bits = (1u << SHADOW_CASCADES) - 1;
+        const size_t mode_count = modes.size();
+
+        for (size_t block = first_block; block < last_block; ++block)
+        {
+            size_t begin = block * width;
+            size_t end = std::min(begin + width, spheres.count);
+
+            simd_float cx = simd_float::load(spheres.x + begin);
+            simd_float cy = simd_float::load(spheres.y + begin);
+            simd_float cz = simd_float::load(spheres.z + begin);
+            simd_float r = simd_float::load(spheres.radius + begin);
+
+            simd_float lx = simd_float::set1(axis_x.x) * cx + simd_float::set1(axis_x.y) * cy + simd_float::set1(axis_x.z) * cz;
+            simd_float ly = simd_float::set1(axis_y.x) * cx + simd_float::set1(axis_y.y) * cy + simd_float::set1(axis_y.z) * cz;
+            simd_float lz = simd_float::set1(data.direction.x) * cx + simd_float::set1(data.direction.y) * cy + simd_float::set1(data.direction.z) * cz;
+
+            simd_float low_x = lx - r, high_x = lx + r;
+            simd_float low_y = ly - r, high_y = ly + r;
+            simd_float low_z = lz - r;
+
+            uint32_t lane_masks[simd_float::width] = {};
+
+            for (int t = 0; t < test_count; ++t)
+            {
+                const box_test &test = tests[t];
+
+                simd_float outside = simd_float::either(simd_float::less(high_x, simd_float::set1(test.min_x)), simd_float::greater(low_x, simd_float::set1(test.max_x)));
+                outside = simd_float::either(outside, simd_float::either(simd_float::less(high_y, simd_float::set1(test.min_y)), simd_float::greater(low_y, simd_float::set1(test.max_y))));
+                outside = simd_float::either(outside, simd_float::greater(low_z, simd_float::set1(test.max_z)));
+
+                for (int hits = ~simd_float::movemask(outside) & ((1 << width) - 1); hits; hits &= hits - 1)
+                    lane_masks[__builtin_ctz(hits)] |= test.bit;
+            }
+
+            for (size_t i = begin; i < end; ++i)
+            {
+                shadow_caster mode = i < mode_count ? modes[i] : shadow_caster::dynamic;
+                uint32_t mask = lane_masks[i - begin];
+
+                masks[i] = mode == shadow_caster::dynamic ? mask & cascade_bits : mode == shadow_caster::stationary ? mask & ~cascade_bits : 0;
+            }
+        }
+    }
+
+public:
+    // ======= LIGHT =======
+
+    /// @brief Turn the directional light on or change it; a new direction redraws every cached cascade
+    /// @param direction: From the light into the scene
+    /// @param color: Premultiplied by intensity
+    /// @param shadows: Draw a shadow map for it
+    void set_light(const glm::vec3 &direction, const glm::vec3 &color, bool shadows)
+    {
+        glm::vec3 normalized = glm::normalize(direction);
+
+        if (!enabled || normalized != data.direction)
+        {
+            data.direction = normalized;
+
+            glm::vec3 helper = std::fabs(normalized.y) < 0.99f ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+
+            axis_x = glm::normalize(glm::cross(helper, normalized));
+            axis_y = glm::cross(normalized, axis_x);
+
+            dirty_all = true;
+        }
+
+        data.color = color;
+        data.shadows = shadows;
+        enabled = true;
+    }
+
+    /// @brief Turn the directional light off
+    void remove_light() { enabled = false; }
+
+    /// @brief Limit how far from the camera shadows are drawn (default: 0, the camera's far plane)
+    /// @param distance
+    void set_distance(float distance) { max_distance = std::max(distance, 0.0f); }
+
+    // ======= CASTERS =======
+
+    /// @brief Change how an object casts shadows
+    /// @param object_id
+    /// @param mode
+    /// @param sphere: The object's bounding sphere, where the static cache is redrawn if it gains or loses a stationary caster
+    void set_caster(size_t object_id, shadow_caster mode, const glm::vec4 &sphere)
+    {
+        if (object_id >= modes.size())
+        {
+            if (mode == shadow_caster::dynamic)
+                return;
+
+            modes.resize(object_id + 1, shadow_caster::dynamic);
+        }
+
+        shadow_caster old = modes[object_id];
+
+        if (old == mode)
+            return;
+
+        stationary_count += (mode == shadow_caster::stationary) - (old == shadow_caster::stationary);
+        none_count += (mode == shadow_caster::none) - (old == shadow_caster::none);
+
+        modes[object_id] = mode;
+
+        if (old == shadow_caster::stationary || mode == shadow_caster::stationary)
+            invalidate_region(sphere);
+    }
+
+    /// @brief How an object casts shadows
+    /// @param object_id
+    /// @return shadow_caster
+    shadow_caster get_caster(size_t object_id) const { return object_id < modes.size() ? modes[object_id] : shadow_caster::dynamic; }
+
+    /// @brief Shift the IDs after a deleted object
+    /// @param object_id
+    /// @param sphere: The deleted object's bounding sphere
+    void object_deleted(size_t object_id, const glm::vec4 &sphere)
+    {
+        if (object_id >= modes.size())
+            return;
+
+        set_caster(object_id, shadow_caster::dynamic, sphere);
+        modes.erase(modes.begin() + object_id);
+    }
+
+    /// @brief Redraw the static cache wherever it overlaps a sphere (call after moving a stationary caster, with its old and new bounds)
+    /// @param sphere: World center and radius (radius < 0: everywhere)
+    void invalidate_region(const glm::vec4 &sphere)
+    {
+        if (sphere.w < 0.0f)
+            dirty_all = true;
+        else
+            dirty_regions.push_back(sphere);
+    }
+
+    /// @brief Redraw the whole static cache of every cascade
+    void invalidate_static() { dirty_all = true; }
+
+    /// @brief Redraw the whole static cache of some cascades; safe to call from the render thread, e.g. when it skipped an update
+    /// @param cascade_mask: Bit per cascade
+    void invalidate(uint32_t cascade_mask) { lost.fetch_or(cascade_mask); }
+
+    /// @brief Forget every caster setting
+    void clear()
+    {
+        modes.clear();
+        stationary_count = 0;
+        none_count = 0;
+
+        dirty_regions.clear();
+        dirty_all = true;
+    }
+
+    // ======= MAIN API =======
+
+    /// @brief Fit the cascades to a camera and classify every object as a caster of the cascades and static redraws it overlaps
+    /// @param view: Camera view matrix (rigid)
+    /// @param projection: Camera perspective projection (anything else leaves the data invalid)
+    /// @param spheres: Bounding spheres of this frame's cull (view_culler::get_spheres), indexed by object ID
+    /// @param pool: Classification is split across it (default: thread_pool::shared())
+    void update(const glm::mat4 &view, const glm::mat4 &projection, const view_cull_spheres &spheres, thread_pool &pool = thread_pool::shared())
+    {
+        stats = {};
+
+        data.valid = false;
+        data.pass_count = 0;
+
+        masks.assign(spheres.count, 0);
+
+        data.valid = enabled && projection[2][3] == -1.0f && projection[3][3] == 0.0f;
+
+        if (!data.valid || !data.shadows)
+        {
+            // ======= nothing tracks the casters meanwhile =======
+
+            dirty_regions.clear();
+            dirty_all = true;
+
+            return;
+        }
+
+        if (projection != cached_projection || max_distance != cached_distance)
+            rebuild_splits(projection);
+
+        // ======= camera position and forward axis of a rigid view matrix =======
+
+        glm::vec3 right(view[0][0], view[1][0], view[2][0]);
+        glm::vec3 up(view[0][1], view[1][1], view[2][1]);
+        glm::vec3 back(view[0][2], view[1][2], view[2][2]);
+
+        glm::vec3 position = -(right * view[3][0] + up * view[3][1] + back * view[3][2]);
+
+        uint32_t lost_cascades = lost.exchange(0);
+        test_count = 0;
+
+        for (int c = 0; c < SHADOW_CASCADES; ++c)
+            place_cascade(c, position - back * center_depth[c], dirty_all || (lost_cascades & (1u << c)));
+
+        dirty_all = false;
+        dirty_regions.clear();
+
+        for (const shadow_cascade &cascade : data.cascades)
+        {
+            stats.rebuilt += cascade.rebuild;
+            stats.scrolled += cascade.scroll[0] != 0 || cascade.scroll[1] != 0;
+        }
+
+        stats.passes = data.pass_count;
+
+        // ======= nothing to draw: every object is stationary (or casts nothing) and no cache changed =======
+
+        if (data.pass_count == 0 && modes.size() == spheres.count && stationary_count + none_count == spheres.count)
+        {
+            for (shadow_cascade &cascade : data.cascades)
+                cascade.dynamic_casters = 0;
+
+            return;
+        }
+
+        size_t blocks = (spheres.count + simd_float::width - 1) / simd_float::width;
+
+        pool.parallel_for(0, blocks, SHADOW_CASTER_GRAIN / simd_float::width, [this, &spheres](size_t first, size_t last)
+                          { classify_blocks(spheres, first, last); });
+
+        // ======= counts =======
+
+        uint32_t per_bit[SHADOW_CASCADES + SHADOW_MAX_PASSES] = {};
+
+        for (uint32_t mask : masks)
+            for (; mask; mask &= mask - 1)
+                ++per_bit[__builtin_ctz(mask)];
+
+        for (int c = 0; c < SHADOW_CASCADES; ++c)
+        {
+            data.cascades[c].dynamic_casters = per_bit[c];
+            stats.dynamic_draws += per_bit[c];
+        }
+
+        for (int p = 0; p < data.pass_count; ++p)
+            stats.static_draws += per_bit[SHADOW_CASCADES + p];
+    }
+
+    // ======= UTILITY API =======
+
+    /// @brief Cascades, passes and light of the last update
+    /// @return const shadow_cascade_data&
+    const shadow_cascade_data &get_data() const { return data; }
+
+    /// @brief Caster bits per object from the last update (shadow_cascade_data::cascade_bit / pass_bit)
+    /// @return const std::vector<uint32_t>&
+    const std::vector<uint32_t> &get_masks() const { return masks; }
+
+    /// @brief Statistics of the last update
+    /// @return const shadow_stats&
+    const shadow_stats &get_stats() const { return stats; }
+};
@@ -0,0 +1,333 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include "./shadow_cascade_data.hpp"
+#include "./light_buffers.hpp"
+#include "../graphics/shaders/shader_class.hpp"
+
+// ======= MACROS =======
+
+#define SHADOW_MAP_UNIT (LIGHT_BUFFER_FIRST_UNIT + 3) // texture unit of the cascade array
+#define SHADOW_SLOPE_BIAS 2.0f                        // glPolygonOffset factor of caster depth
+#define SHADOW_CONSTANT_BIAS 4.0f                     // glPolygonOffset units of caster depth
+
+static_assert(SHADOW_CASCADES == 4, "fragment_shader.glsl selects between four cascades");
+
+// ======= shadow_maps =======
+
+/// @brief Depth textures of the cascaded shadow maps: a cache of stationary casters per cascade and the sampled maps
+/// (cache + dynamic casters), drawn with a depth-only shader from shadow_cascade_data
+/// @note A sampled layer is only recomposed when its cache changed or it has dynamic casters (now or last time), so a
+/// static scene under a still camera draws nothing. Caches are scrolled with two depth blits through a scratch texture
+class shadow_maps
+{
+private:
+    shader_class depth_shader;
+
+    unsigned int maps = 0;    // GL_TEXTURE_2D_ARRAY, compared when sampled
+    unsigned int cache = 0;   // GL_TEXTURE_2D_ARRAY, stationary casters only
+    unsigned int scratch = 0; // GL_TEXTURE_2D, a scroll's intermediate copy
+
+    unsigned int draw_target = 0;
+    unsigned int read_target = 0;
+
+    bool cache_valid[SHADOW_CASCADES] = {};
+    uint64_t cache_revision[SHADOW_CASCADES] = {};
+
+    bool map_valid[SHADOW_CASCADES] = {};
+    bool map_dynamic[SHADOW_CASCADES] = {}; // the layer holds dynamic casters drawn last time
+    uint64_t map_revision[SHADOW_CASCADES] = {};
+
+    bool drawing = false;
+
+    /// @brief Allocate a depth texture array with one layer per cascade
+    static unsigned int create_array(bool compare)
+    {
+        unsigned int texture;
+
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT32F, SHADOW_MAP_SIZE, SHADOW_MAP_SIZE, SHADOW_CASCADES, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, compare ? GL_LINEAR : GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, compare ? GL_LINEAR : GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        if (compare)
+        {
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+        }
+
+        return texture;
+    }
+
+    /// @brief Attach a depth layer to a framebuffer target
+    static void attach_layer(GLenum target, unsigned int framebuffer, unsigned int texture, int layer)
+    {
+        glBindFramebuffer(target, framebuffer);
+        glFramebufferTextureLayer(target, GL_DEPTH_ATTACHMENT, texture, 0, layer);
+    }
+
+    /// @brief Depth-only state for the caster draws (depth clamped, so casters between the light and a box still cast)
+    void begin()
+    {
+        if (drawing)
+            return;
+
+        drawing = true;
+
+        depth_shader.use();
+
+        glViewport(0, 0, SHADOW_MAP_SIZE, SHADOW_MAP_SIZE);
+        glEnable(GL_DEPTH_CLAMP);
+        glEnable(GL_POLYGON_OFFSET_FILL);
+        glPolygonOffset(SHADOW_SLOPE_BIAS, SHADOW_CONSTANT_BIAS);
+    }
+
+    /// @brief Move a cascade's cached depth by whole texels (old texel t lands on t - scroll)
+    void scroll_cache(int cascade, const int scroll[2])
+    {
+        int source[4], target[4]; // x0, y0, x1, y1
+
+        for (int axis = 0; axis < 2; ++axis)
+        {
+            int shift = scroll[axis];
+
+            source[axis] = shift > 0 ? shift : 0;
+            source[axis + 2] = shift > 0 ? SHADOW_MAP_SIZE : SHADOW_MAP_SIZE + shift;
+            target[axis] = source[axis] - shift;
+            target[axis + 2] = source[axis + 2] - shift;
+        }
+
+        // ======= a layer can't be blitted onto itself where the rectangles overlap =======
+
+        attach_layer(GL_READ_FRAMEBUFFER, read_target, cache, cascade);
+
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, draw_target);
+        glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, scratch, 0);
+
+        glBlitFramebuffer(source[0], source[1], source[2], source[3], target[0], target[1], target[2], target[3], GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, read_target);
+        glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, scratch, 0);
+
+        attach_layer(GL_DRAW_FRAMEBUFFER, draw_target, cache, cascade);
+
+        glBlitFramebuffer(target[0], target[1], target[2], target[3], target[0], target[1], target[2], target[3], GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+    }
+
+public:
+    // ======= CONSTRUCTOR =======
+
+    /// @brief Constructor for shadow_maps (needs the GL context)
+    /// @param vertexPath: File path for the depth-only vertex code (.glsl)
+    /// @param fragmentPath: File path for the depth-only fragment code (.glsl)
+    shadow_maps(const char *vertexPath, const char *fragmentPath)
+        : depth_shader(vertexPath, fragmentPath)
+    {
+        maps = create_array(true);
+        cache = create_array(false);
+
+        glGenTextures(1, &scratch);
+        glBindTexture(GL_TEXTURE_2D, scratch);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT32F, SHADOW_MAP_SIZE, SHADOW_MAP_SIZE, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        // ======= depth-only targets =======
+
+        glGenFramebuffers(1, &draw_target);
+        glGenFramebuffers(1, &read_target);
+
+        for (unsigned int framebuffer : {draw_target, read_target})
+        {
+            glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+            glDrawBuffer(GL_NONE);
+            glReadBuffer(GL_NONE);
+        }
+
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
+    // ======= MAIN API =======
+
+    /// @brief Point a shader's shadow sampler at its texture unit; needed once, like light_buffers::attach
+    /// @param shader: Bound shader using fragment_shader.glsl
+    void attach(const shader_class &shader) const { shader.set_uniform1i("shadow_maps", SHADOW_MAP_UNIT); }
+
+    /// @brief Update the caches and sampled maps of a frame; if drew(), the depth shader, the map's viewport and a shadow
+    /// framebuffer are left bound
+    /// @tparam SubmitCasters: void(uint32_t bit), calls draw() for every caster whose mask has the bit
+    /// @param data
+    /// @param submit_casters
+    /// @return uint32_t: Cascades that couldn't be updated because an earlier update never arrived (shadow_cascades::invalidate them)
+    template <typename SubmitCasters>
+    uint32_t render(const shadow_cascade_data &data, SubmitCasters &&submit_casters)
+    {
+        drawing = false;
+
+        if (!data.valid || !data.shadows)
+            return 0;
+
+        uint32_t lost = 0;
+
+        for (int c = 0; c < SHADOW_CASCADES; ++c)
+        {
+            const shadow_cascade &cascade = data.cascades[c];
+
+            // ======= static cache: scroll, then clear and redraw the passes' rectangles =======
+
+            if (cascade.base != cascade.revision)
+            {
+                if (!cascade.rebuild && (!cache_valid[c] || cache_revision[c] != cascade.base))
+                {
+                    cache_valid[c] = false;
+                    lost |= 1u << c;
+                    continue;
+                }
+
+                begin();
+
+                if (cascade.scroll[0] != 0 || cascade.scroll[1] != 0)
+                    scroll_cache(c, cascade.scroll);
+
+                attach_layer(GL_FRAMEBUFFER, draw_target, cache, c);
+                depth_shader.setMat4("light_view_projection", cascade.light_view_projection);
+
+                glEnable(GL_SCISSOR_TEST);
+
+                for (int p = 0; p < data.pass_count; ++p)
+                {
+                    const shadow_pass &pass = data.passes[p];
+
+                    if (pass.cascade != c)
+                        continue;
+
+                    glScissor(pass.rect[0], pass.rect[1], pass.rect[2], pass.rect[3]);
+                    glClear(GL_DEPTH_BUFFER_BIT);
+
+                    submit_casters(shadow_cascade_data::pass_bit(p));
+                }
+
+                glDisable(GL_SCISSOR_TEST);
+
+                cache_valid[c] = true;
+                cache_revision[c] = cascade.revision;
+            }
+            else if (!cache_valid[c] || cache_revision[c] != cascade.revision)
+            {
+                cache_valid[c] = false;
+                lost |= 1u << c;
+                continue;
+            }
+
+            // ======= sampled layer: a copy of the cache with the dynamic casters on top =======
+
+            bool dynamic = cascade.dynamic_casters > 0;
+
+            if (map_valid[c] && map_revision[c] == cache_revision[c] && !dynamic && !map_dynamic[c])
+                continue;
+
+            begin();
+
+            attach_layer(GL_READ_FRAMEBUFFER, read_target, cache, c);
+            attach_layer(GL_DRAW_FRAMEBUFFER, draw_target, maps, c);
+
+            glBlitFramebuffer(0, 0, SHADOW_MAP_SIZE, SHADOW_MAP_SIZE, 0, 0, SHADOW_MAP_SIZE, SHADOW_MAP_SIZE, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+
+            if (dynamic)
+            {
+                glBindFramebuffer(GL_FRAMEBUFFER, draw_target);
+                depth_shader.setMat4("light_view_projection", cascade.light_view_projection);
+
+                submit_casters(shadow_cascade_data::cascade_bit(c));
+            }
+
+            map_valid[c] = true;
+            map_dynamic[c] = dynamic;
+            map_revision[c] = cache_revision[c];
+        }
+
+        if (drawing)
+        {
+            glDisable(GL_POLYGON_OFFSET_FILL);
+            glDisable(GL_DEPTH_CLAMP);
+        }
+
+        return lost;
+    }
+
+    /// @brief Draw one caster into the current cascade (only from render()'s SubmitCasters)
+    /// @param model
+    /// @param VAO
+    /// @param vertexCount
+    void draw(const glm::mat4 &model, unsigned int VAO, int vertexCount) const
+    {
+        depth_shader.setMat4("model", model);
+
+        glBindVertexArray(VAO);
+        glDrawArrays(GL_TRIANGLES, 0, vertexCount);
+    }
+
+    /// @brief If the last render() drew or copied anything (the caller must restore its framebuffer, viewport and shader)
+    /// @return bool
+    bool drew() const { return drawing; }
+
+    /// @brief Turn the directional light on or off for the following draws of a shader using fragment_shader.glsl
+    /// @param shader: Bound and attached
+    /// @param data: The data last rendered (the light stays off if it's invalid)
+    void bind(const shader_class &shader, const shadow_cascade_data &data) const
+    {
+        shader.set_uniform1i("use_sun", data.valid);
+
+        if (!data.valid)
+            return;
+
+        shader.setVec3("sun_direction", data.direction);
+        shader.setVec3("sun_color", data.color);
+        shader.set_uniform1i("use_shadows", data.shadows);
+
+        if (!data.shadows)
+            return;
+
+        glActiveTexture(GL_TEXTURE0 + SHADOW_MAP_UNIT);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, maps);
+        glActiveTexture(GL_TEXTURE0);
+
+        glm::mat4 matrices[SHADOW_CASCADES];
+        glm::vec4 splits, texels;
+
+        for (int c = 0; c < SHADOW_CASCADES; ++c)
+        {
+            matrices[c] = data.cascades[c].light_view_projection;
+            splits[c] = data.cascades[c].split;
+            texels[c] = data.cascades[c].texel;
+        }
+
+        shader.set_uniform_mat4v("shadow_matrices", matrices, SHADOW_CASCADES);
+        shader.set_uniform4f("shadow_splits", splits);
+        shader.set_uniform4f("shadow_texels", texels);
+    }
+
+    /// @brief Destroy the GL objects
+    void destroy()
+    {
+        unsigned int textures[3] = {maps, cache, scratch};
+        unsigned int framebuffers[2] = {draw_target, read_target};
+
+        glDeleteTextures(3, textures);
+        glDeleteFramebuffers(2, framebuffers);
+
+        depth_shader.destroy();
+    }
+};
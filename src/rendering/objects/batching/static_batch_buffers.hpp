@@ -0,0 +1,231 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include "./static_batches.hpp"
+#include "../modifying/object_interface.hpp"
+#include "../../graphics/shaders/shader_class.hpp"
+
+// ======= static_batch_buffers =======
+
+/// @brief GL copies of the static_batches: one VAO with an interleaved vertex buffer and an index buffer per batch
+/// @note Buffers keep the capacity of the CPU arrays, so appending or removing a member only re-uploads the ranges
+/// the batch marked; they're reallocated when the CPU array outgrew them
+class static_batch_buffers
+{
+private:
+    struct gpu_batch
+    {
+        unsigned int VAO = 0;
+        unsigned int VBO = 0;
+        unsigned int EBO = 0;
+
+        size_t vertex_capacity = 0; // bytes
+        size_t index_capacity = 0;  // bytes
+
+        GLsizei count = 0; // indices
+        unsigned int texture = 0;
+    };
+
+    std::vector<gpu_batch> batches; // same slots as static_batches
+
+    /// @brief Copy the changed elements of a CPU array into its buffer (all of it if the buffer is too small)
+    /// @param target: GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER
+    /// @param buffer
+    /// @param data
+    /// @param element: Values per element the range counts in
+    /// @param range: Dirty [begin, end) in elements
+    /// @param capacity: Bytes allocated for the buffer
+    template <typename Value>
+    static void write(GLenum target, unsigned int buffer, const std::vector<Value> &data, size_t element, const size_t range[2], size_t &capacity)
+    {
+        size_t bytes = data.size() * sizeof(Value);
+
+        if (bytes == 0)
+            return;
+
+        glBindBuffer(target, buffer);
+
+        if (bytes > capacity)
+        {
+            capacity = data.capacity() * sizeof(Value);
+
+            glBufferData(target, capacity, nullptr, GL_DYNAMIC_DRAW);
+            glBufferSubData(target, 0, bytes, data.data());
+            return;
+        }
+
+        // ======= later removals may have shrunk the array below a range marked earlier =======
+
+        size_t end = std::min(range[1], data.size() / element);
+
+        if (range[0] < end)
+            glBufferSubData(target, range[0] * element * sizeof(Value), (end - range[0]) * element * sizeof(Value), data.data() + range[0] * element);
+    }
+
+    /// @brief Create the GL objects of a batch slot
+    static void create(gpu_batch &batch)
+    {
+        const GLint sizes[4] = {3, 3, 2, 3}; // position, color, texcoords, normal
+
+        glGenVertexArrays(1, &batch.VAO);
+        glGenBuffers(1, &batch.VBO);
+        glGenBuffers(1, &batch.EBO);
+
+        glBindVertexArray(batch.VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, batch.VBO);
+
+        size_t offset = 0;
+
+        for (GLuint location = 0; location < 4; ++location)
+        {
+            glVertexAttribPointer(location, sizes[location], GL_FLOAT, GL_FALSE, STATIC_BATCH_STRIDE * sizeof(float), (void *)(offset * sizeof(float)));
+            glEnableVertexAttribArray(location);
+
+            offset += sizes[location];
+        }
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch.EBO);
+    }
+
+public:
+    // ======= STATIC HELPERS =======
+
+    /// @brief Read the geometry of a mesh made by vertices_class::create_object back from its buffers
+    /// @param mesh
+    /// @param out: Streams the VAO doesn't have are left empty
+    /// @return bool: false if the mesh has no positions
+    static bool read_mesh(const Mesh &mesh, static_mesh_data &out)
+    {
+        std::vector<float> *streams[4] = {&out.vertices, &out.colors, &out.texcoords, &out.normals};
+        const size_t sizes[4] = {3, 3, 2, 3};
+
+        out.vertex_count = mesh.vertexCount > 0 ? static_cast<size_t>(mesh.vertexCount) : 0;
+
+        glBindVertexArray(mesh.VAO);
+
+        for (GLuint location = 0; location < 4; ++location)
+        {
+            GLint enabled = 0, buffer = 0, buffer_size = 0;
+
+            glGetVertexAttribiv(location, GL_VERTEX_ATTRIB_ARRAY_ENABLED, &enabled);
+            glGetVertexAttribiv(location, GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING, &buffer);
+
+            streams[location]->clear();
+
+            if (!enabled || buffer == 0)
+                continue;
+
+            glBindBuffer(GL_ARRAY_BUFFER, static_cast<GLuint>(buffer));
+            glGetBufferParameteriv(GL_ARRAY_BUFFER, GL_BUFFER_SIZE, &buffer_size);
+
+            streams[location]->assign(out.vertex_count * sizes[location], 0.0f);
+
+            size_t bytes = std::min(streams[location]->size() * sizeof(float), static_cast<size_t>(std::max(buffer_size, 0)));
+
+            if (bytes > 0)
+                glGetBufferSubData(GL_ARRAY_BUFFER, 0, bytes, streams[location]->data());
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindVertexArray(0);
+
+        return out.vertex_count > 0 && !out.vertices.empty();
+    }
+
+    // ======= MAIN API =======
+
+    /// @brief Upload what changed in the batches since the last upload and mark it clean
+    /// @param source
+    void upload(static_batches &source)
+    {
+        if (source.get_dirty().empty())
+            return;
+
+        for (uint32_t slot : source.get_dirty())
+        {
+            const static_batch &batch = source.get_batch(slot);
+
+            if (batches.size() <= slot)
+                batches.resize(slot + 1);
+
+            gpu_batch &target = batches[slot];
+
+            if (target.VAO == 0)
+                create(target);
+            else
+                glBindVertexArray(target.VAO);
+
+            write(GL_ARRAY_BUFFER, target.VBO, batch.vertices, STATIC_BATCH_STRIDE, batch.dirty_vertices, target.vertex_capacity);
+            write(GL_ELEMENT_ARRAY_BUFFER, target.EBO, batch.indices, 1, batch.dirty_indices, target.index_capacity);
+
+            target.count = static_cast<GLsizei>(batch.indices.size());
+            target.texture = batch.texture;
+        }
+
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        source.clear_dirty();
+    }
+
+    /// @brief Draw the batches visible in a view with one call each
+    /// @param shader: Bound shader using vertex_shader.glsl, with the view's matrices set
+    /// @param masks: Visibility bitmask per batch (static_batches::get_masks())
+    /// @param view_bit: Bit of the view being drawn
+    void draw(const shader_class &shader, const std::vector<uint32_t> &masks, uint32_t view_bit) const
+    {
+        size_t count = std::min(batches.size(), masks.size());
+        bool first = true;
+
+        for (size_t slot = 0; slot < count; ++slot)
+        {
+            const gpu_batch &batch = batches[slot];
+
+            if (batch.count == 0 || !(masks[slot] & view_bit))
+                continue;
+
+            // ======= the vertices are already in world space =======
+
+            if (first)
+            {
+                shader.setMat4("model", glm::mat4(1.0f));
+                first = false;
+            }
+
+            shader.set_uniform1i("use_texture", batch.texture != 0);
+
+            if (batch.texture != 0)
+            {
+                glActiveTexture(GL_TEXTURE0);
+                glBindTexture(GL_TEXTURE_2D, batch.texture);
+                shader.set_uniform1i("texture_diffuse", 0);
+            }
+
+            glBindVertexArray(batch.VAO);
+            glDrawElements(GL_TRIANGLES, batch.count, GL_UNSIGNED_INT, nullptr);
+        }
+    }
+
+    /// @brief Destroy the GL objects of every batch
+    void destroy()
+    {
+        for (gpu_batch &batch : batches)
+        {
+            if (batch.VAO == 0)
+                continue;
+
+            glDeleteBuffers(1, &batch.VBO);
+            glDeleteBuffers(1, &batch.EBO);
+            glDeleteVertexArrays(1, &batch.VAO);
+        }
+
+        batches.clear();
+    }
+};
@@ -0,0 +1,564 @@
+#pragma once
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "../../views/view_culler.hpp"
+
+// ======= MACROS =======
+
+#define STATIC_BATCH_CELL_SIZE 32.0f // world units per side of a batching cell; objects are binned by their origin
+#define STATIC_BATCH_STRIDE 11       // floats per merged vertex: position, color, texcoords, normal (vertex_shader.glsl locations 0..3)
+#define STATIC_BATCH_NONE UINT32_MAX // member slot of an object that isn't static
+
+// ======= STRUCTS =======
+
+/// @brief Object space triangle list of a mesh, laid out like the inputs of vertices_class::create_object (missing streams are empty)
+struct static_mesh_data
+{
+    std::vector<float> vertices;  // x, y, z per vertex
+    std::vector<float> colors;    // r, g, b per vertex
+    std::vector<float> texcoords; // u, v per vertex
+    std::vector<float> normals;   // x, y, z per vertex
+
+    size_t vertex_count = 0;
+};
+
+/// @brief Every static object of one texture in one cell, pre-transformed into world space and drawn with one indexed call
+struct static_batch
+{
+    unsigned int texture = 0; // GL texture ID, 0 = untextured
+    int cell[3] = {0, 0, 0};
+
+    std::vector<float> vertices; // STATIC_BATCH_STRIDE floats per vertex
+    std::vector<uint32_t> indices;
+    std::vector<uint32_t> members; // member slots in index order
+
+    size_t dead_vertices = 0; // left behind by removed members until the batch is compacted
+
+    glm::vec3 bounds_min{FLT_MAX}; // world AABB of the vertices (min > max while empty)
+    glm::vec3 bounds_max{-FLT_MAX};
+
+    size_t dirty_vertices[2] = {0, 0}; // vertex range changed since the last upload (begin >= end: clean)
+    size_t dirty_indices[2] = {0, 0};  // index range changed since the last upload
+};
+
+/// @brief What the batches hold and what the last cull did
+struct static_batch_stats
+{
+    size_t objects = 0;  // static objects merged
+    size_t batches = 0;  // batches with at least one member
+    size_t visible = 0;  // batches inside at least one view frustum in the last cull
+    size_t vertices = 0; // merged vertices, dead ones included
+    size_t indices = 0;
+    size_t dead_vertices = 0;
+};
+
+// ======= static_batches =======
+
+/// @brief Merges objects that never move into large pre-transformed vertex / index arrays, one batch per texture and
+/// world cell, and culls those batches per view by their bounds
+/// @note Adding an object appends its welded vertices to its batch; removing one cuts its indices out and leaves its
+/// vertices behind until they're the majority, then only that batch is compacted. Each batch records the ranges it
+/// changed, so the GL side (static_batch_buffers) re-uploads just those. Object IDs shift on deletion like object_manager's
+class static_batches
+{
+private:
+    struct member
+    {
+        uint32_t batch = STATIC_BATCH_NONE; // STATIC_BATCH_NONE: free slot
+        uint32_t first_vertex = 0;
+        uint32_t vertex_count = 0;
+        uint32_t first_index = 0;
+        uint32_t index_count = 0;
+    };
+
+    struct batch_key
+    {
+        unsigned int texture;
+        int cell[3];
+
+        bool operator==(const batch_key &other) const
+        {
+            return texture == other.texture && cell[0] == other.cell[0] && cell[1] == other.cell[1] && cell[2] == other.cell[2];
+        }
+    };
+
+    struct batch_key_hash
+    {
+        size_t operator()(const batch_key &key) const
+        {
+            uint64_t hash = key.texture;
+
+            for (int axis = 0; axis < 3; ++axis)
+                hash = hash * 0x9E3779B97F4A7C15ull + static_cast<uint32_t>(key.cell[axis]);
+
+            return static_cast<size_t>(hash ^ (hash >> 29));
+        }
+    };
+
+    std::vector<static_batch> batches; // slots are never reused before clear(), so stale masks only ever point at the same batch
+    std::unordered_map<batch_key, uint32_t, batch_key_hash> batch_slots;
+
+    std::vector<member> members;
+    std::vector<uint32_t> free_members;
+    std::vector<uint32_t> member_of; // member slot per object ID
+
+    std::vector<uint32_t> masks; // visibility bitmask per batch from the last cull
+    std::vector<uint32_t> dirty; // batches with ranges to upload
+
+    std::vector<uint32_t> weld_table; // open addressing scratch of append(): local vertex + 1, 0 = empty
+
+    static_batch_stats stats;
+
+private:
+    /// @brief Grow a dirty range to cover [begin, end)
+    static void mark(size_t range[2], size_t begin, size_t end)
+    {
+        if (begin >= end)
+            return;
+
+        if (range[0] >= range[1])
+        {
+            range[0] = begin;
+            range[1] = end;
+            return;
+        }
+
+        range[0] = std::min(range[0], begin);
+        range[1] = std::max(range[1], end);
+    }
+
+    /// @brief Queue a batch for upload once
+    void touch(uint32_t slot)
+    {
+        static_batch &batch = batches[slot];
+
+        if (batch.dirty_vertices[0] >= batch.dirty_vertices[1] && batch.dirty_indices[0] >= batch.dirty_indices[1])
+            dirty.push_back(slot);
+    }
+
+    /// @brief FNV-1a over one merged vertex
+    static uint32_t hash_vertex(const float *vertex)
+    {
+        uint32_t bits[STATIC_BATCH_STRIDE];
+        std::memcpy(bits, vertex, sizeof(bits));
+
+        uint32_t hash = 2166136261u;
+
+        for (uint32_t word : bits)
+            hash = (hash ^ word) * 16777619u;
+
+        return hash;
+    }
+
+    /// @brief Find or create the batch of a texture and cell
+    uint32_t batch_for(unsigned int texture, const glm::vec3 &origin)
+    {
+        batch_key key{texture, {static_cast<int>(std::floor(origin.x / STATIC_BATCH_CELL_SIZE)),
+                                static_cast<int>(std::floor(origin.y / STATIC_BATCH_CELL_SIZE)),
+                                static_cast<int>(std::floor(origin.z / STATIC_BATCH_CELL_SIZE))}};
+
+        auto found = batch_slots.find(key);
+
+        if (found != batch_slots.end())
+            return found->second;
+
+        uint32_t slot = static_cast<uint32_t>(batches.size());
+
+        batches.emplace_back();
+        batches.back().texture = texture;
+        std::copy(key.cell, key.cell + 3, batches.back().cell);
+
+        batch_slots.emplace(key, slot);
+
+        return slot;
+    }
+
+    /// @brief Transform a mesh into world space, weld identical corners and append it to the end of a batch
+    void append(static_batch &batch, const static_mesh_data &mesh, const glm::mat4 &model, member &entry)
+    {
+        // ======= normals go through the cofactor of the model matrix, like vertex_shader.glsl =======
+
+        glm::vec3 axis[3] = {glm::vec3(model[0]), glm::vec3(model[1]), glm::vec3(model[2])};
+        glm::vec3 cofactor[3] = {glm::cross(axis[1], axis[2]), glm::cross(axis[2], axis[0]), glm::cross(axis[0], axis[1])};
+
+        size_t count = mesh.vertex_count;
+        size_t base = batch.vertices.size() / STATIC_BATCH_STRIDE;
+        size_t table_size = 16;
+
+        while (table_size < count * 2)
+            table_size *= 2;
+
+        weld_table.assign(table_size, 0);
+
+        entry.first_vertex = static_cast<uint32_t>(base);
+        entry.first_index = static_cast<uint32_t>(batch.indices.size());
+        entry.index_count = static_cast<uint32_t>(count);
+
+        uint32_t added = 0;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            float vertex[STATIC_BATCH_STRIDE] = {};
+
+            glm::vec3 position = glm::vec3(model * glm::vec4(mesh.vertices[i * 3], mesh.vertices[i * 3 + 1], mesh.vertices[i * 3 + 2], 1.0f));
+
+            vertex[0] = position.x;
+            vertex[1] = position.y;
+            vertex[2] = position.z;
+
+            for (size_t c = 0; c < 3 && i * 3 + c < mesh.colors.size(); ++c)
+                vertex[3 + c] = mesh.colors[i * 3 + c];
+
+            for (size_t c = 0; c < 2 && i * 2 + c < mesh.texcoords.size(); ++c)
+                vertex[6 + c] = mesh.texcoords[i * 2 + c];
+
+            if (i * 3 + 2 < mesh.normals.size())
+            {
+                glm::vec3 normal = cofactor[0] * mesh.normals[i * 3] + cofactor[1] * mesh.normals[i * 3 + 1] + cofactor[2] * mesh.normals[i * 3 + 2];
+                float length = glm::length(normal);
+
+                if (length > 0.0f)
+                    normal = normal / length;
+
+                vertex[8] = normal.x;
+                vertex[9] = normal.y;
+                vertex[10] = normal.z;
+            }
+
+            // ======= weld against the corners this mesh already added =======
+
+            size_t probe = hash_vertex(vertex) & (table_size - 1);
+            uint32_t local = 0;
+
+            for (; weld_table[probe] != 0; probe = (probe + 1) & (table_size - 1))
+            {
+                const float *existing = &batch.vertices[(base + weld_table[probe] - 1) * STATIC_BATCH_STRIDE];
+
+                if (std::memcmp(existing, vertex, sizeof(vertex)) == 0)
+                {
+                    local = weld_table[probe];
+                    break;
+                }
+            }
+
+            if (local == 0)
+            {
+                local = weld_table[probe] = ++added;
+
+                batch.vertices.insert(batch.vertices.end(), vertex, vertex + STATIC_BATCH_STRIDE);
+
+                batch.bounds_min = glm::min(batch.bounds_min, position);
+                batch.bounds_max = glm::max(batch.bounds_max, position);
+            }
+
+            batch.indices.push_back(static_cast<uint32_t>(base + local - 1));
+        }
+
+        entry.vertex_count = added;
+
+        mark(batch.dirty_vertices, base, base + added);
+        mark(batch.dirty_indices, entry.first_index, batch.indices.size());
+    }
+
+    /// @brief Move the live vertices of a batch together, rewrite its indices and recompute its bounds
+    void compact(static_batch &batch)
+    {
+        size_t write = 0;
+
+        batch.bounds_min = glm::vec3(FLT_MAX);
+        batch.bounds_max = glm::vec3(-FLT_MAX);
+
+        for (uint32_t slot : batch.members)
+        {
+            member &entry = members[slot];
+
+            uint32_t shift = entry.first_vertex - static_cast<uint32_t>(write);
+
+            if (shift > 0)
+            {
+                std::copy(batch.vertices.begin() + entry.first_vertex * STATIC_BATCH_STRIDE,
+                          batch.vertices.begin() + (entry.first_vertex + entry.vertex_count) * STATIC_BATCH_STRIDE,
+                          batch.vertices.begin() + write * STATIC_BATCH_STRIDE);
+
+                for (uint32_t i = entry.first_index; i < entry.first_index + entry.index_count; ++i)
+                    batch.indices[i] -= shift;
+
+                entry.first_vertex = static_cast<uint32_t>(write);
+            }
+
+            for (size_t v = write; v < write + entry.vertex_count; ++v)
+            {
+                const float *position = &batch.vertices[v * STATIC_BATCH_STRIDE];
+
+                batch.bounds_min = glm::min(batch.bounds_min, glm::vec3(position[0], position[1], position[2]));
+                batch.bounds_max = glm::max(batch.bounds_max, glm::vec3(position[0], position[1], position[2]));
+            }
+
+            write += entry.vertex_count;
+        }
+
+        batch.vertices.resize(write * STATIC_BATCH_STRIDE);
+        batch.dead_vertices = 0;
+
+        mark(batch.dirty_vertices, 0, write);
+        mark(batch.dirty_indices, 0, batch.indices.size());
+    }
+
+public:
+    // ======= MAIN API =======
+
+    /// @brief Merge an object into the batch of its texture and cell; an object that already is static is re-merged
+    /// (the way to pick up a new transform)
+    /// @param object_id
+    /// @param mesh: Object space geometry
+    /// @param model: Model matrix baked into the merged copy
+    /// @param texture: GL texture ID, 0 if untextured
+    /// @return bool: false if the mesh has no vertices
+    bool add(size_t object_id, const static_mesh_data &mesh, const glm::mat4 &model, unsigned int texture)
+    {
+        remove(object_id);
+
+        if (mesh.vertex_count == 0 || mesh.vertices.size() < mesh.vertex_count * 3)
+            return false;
+
+        uint32_t slot;
+
+        if (!free_members.empty())
+        {
+            slot = free_members.back();
+            free_members.pop_back();
+        }
+        else
+        {
+            slot = static_cast<uint32_t>(members.size());
+            members.emplace_back();
+        }
+
+        uint32_t batch_slot = batch_for(texture, glm::vec3(model[3]));
+        static_batch &batch = batches[batch_slot];
+
+        touch(batch_slot);
+
+        member &entry = members[slot];
+        entry.batch = batch_slot;
+
+        append(batch, mesh, model, entry);
+        batch.members.push_back(slot);
+
+        if (member_of.size() <= object_id)
+            member_of.resize(object_id + 1, STATIC_BATCH_NONE);
+
+        member_of[object_id] = slot;
+        ++stats.objects;
+
+        return true;
+    }
+
+    /// @brief Take an object out of its batch
+    /// @param object_id
+    /// @return bool: false if it wasn't static
+    bool remove(size_t object_id)
+    {
+        if (object_id >= member_of.size() || member_of[object_id] == STATIC_BATCH_NONE)
+            return false;
+
+        uint32_t slot = member_of[object_id];
+        member entry = members[slot];
+        static_batch &batch = batches[entry.batch];
+
+        touch(entry.batch);
+
+        // ======= members are in index order, so the ones after it just slide down =======
+
+        auto position = std::lower_bound(batch.members.begin(), batch.members.end(), entry.first_index, [this](uint32_t other, uint32_t first)
+                                         { return members[other].first_index < first; });
+
+        for (auto it = position + 1; it != batch.members.end(); ++it)
+            members[*it].first_index -= entry.index_count;
+
+        batch.members.erase(position);
+        batch.indices.erase(batch.indices.begin() + entry.first_index, batch.indices.begin() + entry.first_index + entry.index_count);
+        batch.dead_vertices += entry.vertex_count;
+
+        mark(batch.dirty_indices, entry.first_index, batch.indices.size());
+
+        if (batch.members.empty())
+        {
+            batch.vertices.clear();
+            batch.indices.clear();
+            batch.dead_vertices = 0;
+
+            batch.bounds_min = glm::vec3(FLT_MAX);
+            batch.bounds_max = glm::vec3(-FLT_MAX);
+        }
+        else if (batch.dead_vertices * 2 * STATIC_BATCH_STRIDE > batch.vertices.size())
+            compact(batch);
+
+        members[slot] = member{};
+        free_members.push_back(slot);
+        member_of[object_id] = STATIC_BATCH_NONE;
+        --stats.objects;
+
+        return true;
+    }
+
+    /// @brief Take a deleted object out of its batch and shift the IDs after it down like object_manager does
+    /// @param object_id
+    void object_deleted(size_t object_id)
+    {
+        remove(object_id);
+
+        if (object_id < member_of.size())
+            member_of.erase(member_of.begin() + object_id);
+    }
+
+    /// @brief Drop every batch
+    void clear()
+    {
+        batches.clear();
+        batch_slots.clear();
+        members.clear();
+        free_members.clear();
+        member_of.clear();
+        masks.clear();
+        dirty.clear();
+
+        stats = static_batch_stats{};
+    }
+
+    /// @brief Frustum-cull every batch against every view in view_mask by its bounds
+    /// @param views: view_set::data()
+    /// @param view_mask: Views to cull for (view_set::active_mask())
+    void cull(const render_view *views, uint32_t view_mask)
+    {
+        float planes[RENDER_VIEW_MAX][6][4];
+        uint32_t view_ids[RENDER_VIEW_MAX];
+        uint32_t view_count = 0;
+
+        for (uint32_t id = 0; id < RENDER_VIEW_MAX; ++id)
+        {
+            if (!(view_mask & (1u << id)))
+                continue;
+
+            view_culler::extract_planes(views[id].projection * views[id].view, planes[view_count]);
+            view_ids[view_count++] = id;
+        }
+
+        masks.assign(batches.size(), 0);
+
+        stats.batches = stats.visible = stats.vertices = stats.indices = stats.dead_vertices = 0;
+
+        for (size_t b = 0; b < batches.size(); ++b)
+        {
+            const static_batch &batch = batches[b];
+
+            if (batch.indices.empty())
+                continue;
+
+            ++stats.batches;
+            stats.vertices += batch.vertices.size() / STATIC_BATCH_STRIDE;
+            stats.indices += batch.indices.size();
+            stats.dead_vertices += batch.dead_vertices;
+
+            const glm::vec3 &low = batch.bounds_min;
+            const glm::vec3 &high = batch.bounds_max;
+
+            // ======= outside a plane if even the box corner farthest along its normal is behind it =======
+
+            for (uint32_t v = 0; v < view_count; ++v)
+            {
+                bool outside = false;
+
+                for (const float *plane : planes[v])
+                {
+                    float x = plane[0] >= 0.0f ? high.x : low.x;
+                    float y = plane[1] >= 0.0f ? high.y : low.y;
+                    float z = plane[2] >= 0.0f ? high.z : low.z;
+
+                    if (plane[0] * x + plane[1] * y + plane[2] * z + plane[3] < 0.0f)
+                    {
+                        outside = true;
+                        break;
+                    }
+                }
+
+                if (!outside)
+                    masks[b] |= 1u << view_ids[v];
+            }
+
+            stats.visible += masks[b] != 0;
+        }
+    }
+
+    /// @brief Stop the culler from drawing static objects one by one (their batches draw them); call after occlusion
+    /// culling, since occluders are picked by the same masks
+    /// @param culler
+    void hide_members(view_culler &culler) const
+    {
+        if (stats.objects == 0)
+            return;
+
+        size_t count = std::min(member_of.size(), culler.get_masks().size());
+
+        for (size_t i = 0; i < count; ++i)
+            if (member_of[i] != STATIC_BATCH_NONE)
+                culler.hide(i);
+    }
+
+    // ======= UPLOAD API =======
+
+    /// @brief Batches with changed ranges since clear_dirty()
+    /// @return const std::vector<uint32_t>&
+    const std::vector<uint32_t> &get_dirty() const { return dirty; }
+
+    /// @brief Mark every changed range as uploaded
+    void clear_dirty()
+    {
+        for (uint32_t slot : dirty)
+        {
+            static_batch &batch = batches[slot];
+
+            batch.dirty_vertices[0] = batch.dirty_vertices[1] = 0;
+            batch.dirty_indices[0] = batch.dirty_indices[1] = 0;
+        }
+
+        dirty.clear();
+    }
+
+    // ======= UTILITY API =======
+
+    /// @brief If an object is merged into a batch
+    /// @param object_id
+    /// @return bool
+    bool is_static(size_t object_id) const { return object_id < member_of.size() && member_of[object_id] != STATIC_BATCH_NONE; }
+
+    /// @brief Get a batch by slot
+    /// @param slot
+    /// @return const static_batch&
+    const static_batch &get_batch(size_t slot) const { return batches[slot]; }
+
+    /// @brief Batch slots ever created since the last clear(), empty ones included
+    /// @return size_t
+    size_t batch_count() const { return batches.size(); }
+
+    /// @brief Static objects merged
+    /// @return size_t
+    size_t object_count() const { return stats.objects; }
+
+    /// @brief Visibility bitmask per batch from the last cull
+    /// @return const std::vector<uint32_t>&
+    const std::vector<uint32_t> &get_masks() const { return masks; }
+
+    /// @brief Sizes of the batches and statistics of the last cull
+    /// @return const static_batch_stats&
+    const static_batch_stats &get_stats() const { return stats; }
+};
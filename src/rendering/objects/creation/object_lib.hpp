@@ -1,5 +1,9 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
 #include <vector>
 #include <unordered_map>
 #include <variant>
@@ -12,11 +16,69 @@
 
 class object_lib
 {
+private:
+    /// @brief Build the shape map by moving the vectors in (an initializer list would copy every vector)
+    /// @param vertices
+    /// @param colors
+    /// @param texture_coords
+    /// @param count
+    /// @param normals: x, y, z per vertex (default: flat_normals(vertices))
+    /// @return {{"vertices", vertices}, {"colors", colors}, {"texture_coords", texture_coords}, {"normals", normals}, {"count", count}};
+    static std::unordered_map<std::string, std::variant<int, std::vector<float>>> make_shape(std::vector<float> &&vertices, std::vector<float> &&colors, std::vector<float> &&texture_coords, int count,
+                                                                                             std::vector<float> &&normals = {})
+    {
+        if (normals.empty())
+            normals = flat_normals(vertices);
+
+        std::unordered_map<std::string, std::variant<int, std::vector<float>>> shape;
+        shape.reserve(5);
+
+        shape.emplace("vertices", std::move(vertices));
+        shape.emplace("colors", std::move(colors));
+        shape.emplace("texture_coords", std::move(texture_coords));
+        shape.emplace("normals", std::move(normals));
+        shape.emplace("count", count);
+
+        return shape;
+    }
+
 public:
+    // ======= NORMALS =======
+
+    /// @brief One normal per triangle corner, perpendicular to its triangle (counter-clockwise winding faces it)
+    /// @param vertices: x, y, z per vertex, three vertices per triangle
+    /// @return std::vector<float>: x, y, z per vertex
+    static std::vector<float> flat_normals(const std::vector<float> &vertices)
+    {
+        std::vector<float> normals(vertices.size(), 0.0f);
+
+        for (size_t i = 0; i + 9 <= vertices.size(); i += 9)
+        {
+            const float *a = &vertices[i];
+            const float *b = &vertices[i + 3];
+            const float *c = &vertices[i + 6];
+
+            float u[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+            float v[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+            float n[3] = {u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0]};
+
+            float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+            if (length > 0.0f)
+                for (float &component : n)
+                    component /= length;
+
+            for (int corner = 0; corner < 3; ++corner)
+                std::copy(n, n + 3, &normals[i + corner * 3]);
+        }
+
+        return normals;
+    }
+
     // ======= 2D SHAPES =======
 
     /// @brief Triangle object
-    /// @return {{"vertices", vertices}, {"colors", colors}, {"texture_coords", texture_coords}, {"count", 3}};
+    /// @return {{"vertices", vertices}, {"colors", colors}, {"texture_coords", texture_coords}, {"normals", normals}, {"count", 3}};
     static std::unordered_map<std::string, std::variant<int, std::vector<float>>> triangle()
     {
         std::vector<float> vertices = {
@@ -34,11 +96,11 @@ public:
             0.0f, 0.0f,
             1.0f, 0.0f};
 
-        return {{"vertices", vertices}, {"colors", colors}, {"texture_coords", texture_coords}, {"count", 3}};
+        return make_shape(std::move(vertices), std::move(colors), std::move(texture_coords), 3);
     }
 
     /// @brief Square object
-    /// @return {{"vertices", vertices}, {"colors", colors}, {"texture_coords", texture_coords}, {"count", 6}};
+    /// @return {{"vertices", vertices}, {"colors", colors}, {"texture_coords", texture_coords}, {"normals", normals}, {"count", 6}};
     static std::unordered_map<std::string, std::variant<int, std::vector<float>>> square()
     {
         std::vector<float> vertices = {
@@ -67,13 +129,13 @@ public:
             0.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f,
             0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f};
 
-        return {{"vertices", vertices}, {"colors", colors}, {"texture_coords", texture_coords}, {"count", 6}};
+        return make_shape(std::move(vertices), std::move(colors), std::move(texture_coords), 6);
     }
 
     // ======= 3D SHAPES =======
 
     /// @brief Cube object
-    /// @return {{"vertices", vertices}, {"colors", colors}, {"texture_coords", texture_coords}, {"count", 36}};
+    /// @return {{"vertices", vertices}, {"colors", colors}, {"texture_coords", texture_coords}, {"normals", normals}, {"count", 36}};
     static std::unordered_map<std::string, std::variant<int, std::vector<float>>> cube()
     {
         std::vector<float> vertices = {
@@ -193,7 +255,7 @@ public:
             0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f,
             1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f};
 
-        return {{"vertices", vertices}, {"colors", colors}, {"texture_coords", texture_coords}, {"count", 36}};
+        return make_shape(std::move(vertices), std::move(colors), std::move(texture_coords), 36);
     }
 
     static std::unordered_map<std::string, std::variant<int, std::vector<float>>> sphere(int lat_segments = 16, int lon_segments = 16)
@@ -202,6 +264,15 @@ public:
         std::vector<float> colors;
         std::vector<float> texture_coords;
 
+        // ======= reserve up front: no regrowth while pushing =======
+
+        size_t grid_points = static_cast<size_t>(lat_segments + 1) * (lon_segments + 1);
+        size_t triangle_points = static_cast<size_t>(lat_segments) * lon_segments * 6;
+
+        vertices.reserve(grid_points * 3);
+        colors.reserve(grid_points * 3);
+        texture_coords.reserve(grid_points * 2);
+
         for (int i = 0; i <= lat_segments; ++i)
         {
             float theta = i * PI / lat_segments;
@@ -235,6 +306,10 @@ public:
         std::vector<float> sphere_colors;
         std::vector<float> sphere_texcoords;
 
+        sphere_vertices.reserve(triangle_points * 3);
+        sphere_colors.reserve(triangle_points * 3);
+        sphere_texcoords.reserve(triangle_points * 2);
+
         int count = 0;
 
         for (int i = 0; i < lat_segments; ++i)
@@ -268,6 +343,13 @@ public:
             }
         }
 
-        return {{"vertices", sphere_vertices}, {"colors", sphere_colors}, {"texture_coords", sphere_texcoords}, {"count", count}};
+        // ======= smooth normals: a unit sphere's normal is its position =======
+
+        std::vector<float> sphere_normals(sphere_vertices.size());
+
+        for (size_t i = 0; i < sphere_vertices.size(); ++i)
+            sphere_normals[i] = sphere_vertices[i] * 2.0f;
+
+        return make_shape(std::move(sphere_vertices), std::move(sphere_colors), std::move(sphere_texcoords), count, std::move(sphere_normals));
     }
 };
\ No newline at end of file
@@ -1,9 +1,14 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <vector>
 #include <variant>
 
 #include "../modifying/object_interface.hpp"
+#include "../creation/object_lib.hpp"
+#include "../../graphics/geometry/vertices_class.hpp"
 
 // ======= object_manager =======
 
@@ -31,10 +36,31 @@ public:
     }
 
     /// @brief Render all objects
-    void render_all()
+    /// @param alpha: Interpolation factor between the previous and current simulation state (default: 1)
+    void render_all(float alpha = 1.0f)
     {
         for (auto &obj : objects)
-            obj.render();
+            obj.render(alpha);
+    }
+
+    /// @brief Render the objects a view_culler marked visible in a view
+    /// @param masks: One visibility bitmask per object (view_culler::get_masks())
+    /// @param view_bit: Bit of the view being drawn
+    /// @param alpha: Interpolation factor between the previous and current simulation state (default: 1)
+    void render_visible(const std::vector<uint32_t> &masks, uint32_t view_bit, float alpha = 1.0f)
+    {
+        size_t count = std::min(objects.size(), masks.size());
+
+        for (size_t i = 0; i < count; ++i)
+            if (masks[i] & view_bit)
+                objects[i].render(alpha);
+    }
+
+    /// @brief Store the current transform of every object as its previous simulation state
+    void store_previous_states()
+    {
+        for (auto &obj : objects)
+            obj.store_previous_state();
     }
 
     // ======= OBJECT API =======
@@ -78,9 +104,17 @@ public:
 
         int count = std::get<int>(shapeData.at("count"));
 
-        unsigned int vao = vertices_class::create_object(vertices, colors, texture_coords);
+        auto normals_entry = shapeData.find("normals");
+        std::vector<float> normals = normals_entry != shapeData.end() ? std::get<std::vector<float>>(normals_entry->second) : object_lib::flat_normals(vertices);
+
+        unsigned int vao = vertices_class::create_object(vertices, colors, texture_coords, normals);
 
-        size_t index = create_new_object(shader, Mesh{vao, count});
+        float radius_squared = 0.0f;
+
+        for (size_t i = 0; i + 2 < vertices.size(); i += 3)
+            radius_squared = std::max(radius_squared, vertices[i] * vertices[i] + vertices[i + 1] * vertices[i + 1] + vertices[i + 2] * vertices[i + 2]);
+
+        size_t index = create_new_object(shader, Mesh{vao, count, std::sqrt(radius_squared)});
 
         objects[index].scale_set(scale.x, scale.y, scale.z);
 
@@ -88,6 +122,8 @@ public:
 
         objects[index].rotate_set(rotation.x, rotation.y, rotation.z);
 
+        objects[index].store_previous_state();
+
         return index;
     }
 
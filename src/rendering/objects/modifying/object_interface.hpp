@@ -4,6 +4,8 @@
 
 #include "../../graphics/shaders/shader_class.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <functional>
 
 #include <glm/glm.hpp>
@@ -15,6 +17,8 @@ struct Mesh
 {
     unsigned int VAO;
     int vertexCount;
+
+    float radius = -1.0f; // bounding sphere around the mesh origin; < 0 = unknown, never culled
 };
 
 // ======= object_interface =======
@@ -35,6 +39,10 @@ private:
     glm::vec3 rotation{0.0f};
     glm::vec3 velocity{0.0f};
 
+    glm::vec3 prevScale{1.0f};
+    glm::vec3 prevOffset{0.0f};
+    glm::vec3 prevRotation{0.0f};
+
     glm::mat4 modelMatrix{1.0f};
 
     shader_class *shader;
@@ -46,15 +54,33 @@ private:
     bool hasTexture;
 
 private:
+    /// @brief Build a model matrix from a transform
+    /// @param pos: Offset
+    /// @param rot: Rotation (degrees)
+    /// @param scl: Scale
+    /// @return glm::mat4
+    static glm::mat4 buildModelMatrix(const glm::vec3 &pos, const glm::vec3 &rot, const glm::vec3 &scl)
+    {
+        glm::mat4 matrix = glm::mat4(1.0f);
+        matrix = glm::translate(matrix, pos);
+        matrix = glm::rotate(matrix, glm::radians(rot.x), glm::vec3{1, 0, 0});
+        matrix = glm::rotate(matrix, glm::radians(rot.y), glm::vec3{0, 1, 0});
+        matrix = glm::rotate(matrix, glm::radians(rot.z), glm::vec3{0, 0, 1});
+        matrix = glm::scale(matrix, scl);
+
+        return matrix;
+    }
+
     /// @brief Update the model matrix based on current transformations
     void updateModelMatrix()
     {
-        modelMatrix = glm::mat4(1.0f);
-        modelMatrix = glm::translate(modelMatrix, offset);
-        modelMatrix = glm::rotate(modelMatrix, glm::radians(rotation.x), glm::vec3{1, 0, 0});
-        modelMatrix = glm::rotate(modelMatrix, glm::radians(rotation.y), glm::vec3{0, 1, 0});
-        modelMatrix = glm::rotate(modelMatrix, glm::radians(rotation.z), glm::vec3{0, 0, 1});
-        modelMatrix = glm::scale(modelMatrix, scale);
+        modelMatrix = buildModelMatrix(offset, rotation, scale);
+    }
+
+    /// @brief Update only the translation column (the matrix is T * R * S, so moving never needs the trig rebuild)
+    void updateTranslation()
+    {
+        modelMatrix[3] = glm::vec4(offset, 1.0f);
     }
 
 public:
@@ -78,7 +104,7 @@ public:
     void move_add(float dx, float dy, float dz)
     {
         offset += glm::vec3(dx, dy, dz);
-        updateModelMatrix();
+        updateTranslation();
     }
 
     /// @brief Set the shader offset a certain direction
@@ -88,7 +114,7 @@ public:
     void move_set(float dx, float dy, float dz)
     {
         offset = glm::vec3(dx, dy, dz);
-        updateModelMatrix();
+        updateTranslation();
     }
 
     /// @brief Add to a shaders rotation
@@ -159,12 +185,37 @@ public:
     /// @param vz: Z Velocity
     void velocity_set(float vx, float vy, float vz) { velocity = glm::vec3(vx, vy, vz); }
 
+    // ======= INTERPOLATION =======
+
+    /// @brief Store the current transform as the previous simulation state (call before each fixed tick)
+    void store_previous_state()
+    {
+        prevScale = scale;
+        prevOffset = offset;
+        prevRotation = rotation;
+    }
+
+    /// @brief Get the model matrix interpolated between the previous and current simulation state
+    /// @param alpha: Interpolation factor [0, 1]; 1 returns the current model matrix
+    /// @return glm::mat4
+    glm::mat4 get_interpolated_matrix(float alpha) const
+    {
+        if (alpha >= 1.0f || (prevOffset == offset && prevRotation == rotation && prevScale == scale))
+            return modelMatrix;
+
+        return buildModelMatrix(
+            glm::mix(prevOffset, offset, alpha),
+            glm::mix(prevRotation, rotation, alpha),
+            glm::mix(prevScale, scale, alpha));
+    }
+
     // ======= RENDERING =======
 
     /// @brief Render the object
-    void render() const
+    /// @param alpha: Interpolation factor between the previous and current simulation state (default: 1)
+    void render(float alpha = 1.0f) const
     {
-        shader->setMat4("model", modelMatrix);
+        shader->setMat4("model", get_interpolated_matrix(alpha));
 
         shader->set_uniform1i("use_texture", hasTexture);
 
@@ -192,11 +243,24 @@ public:
         hasTexture = true;
     }
 
+    /// @brief Applies raw 8-bit pixels as a texture to the current object
+    /// @param data: Pixel data (rows bottom to top)
+    /// @param width
+    /// @param height
+    /// @param channels: 1, 3 or 4
+    void apply_texture_pixels(const unsigned char *data, int width, int height, int channels)
+    {
+        texture.load_pixels(data, width, height, channels);
+        hasTexture = true;
+    }
+
     // ======= OBJECT CONTROL API =======
 
     /// @brief Apply a preset from logic_presets.hpp
+    /// @tparam Preset: Any void(object_interface &) callable (functor, lambda or preset_fn)
     /// @param preset: The preset to add
-    void apply_preset(const preset_fn &preset)
+    template <typename Preset>
+    void apply_preset(const Preset &preset)
     {
         preset(*this);
     }
@@ -206,11 +270,15 @@ public:
     void update_position(float delta_time)
     {
         offset += velocity * delta_time;
-        updateModelMatrix();
+        updateTranslation();
     }
 
     // ======= UTILITY API =======
 
+    /// @brief Get the current model matrix
+    /// @return const glm::mat4&
+    const glm::mat4 &get_model_matrix() const { return modelMatrix; }
+
     /// @brief Return scale of the current shader
     /// @return const glm::vec3&
     const glm::vec3 &get_scale() const { return scale; }
@@ -234,6 +302,23 @@ public:
     /// @return shader_class*
     shader_class *get_shader() const { return shader; }
 
+    /// @brief Get the GL ID of the applied texture (0 if none)
+    /// @return unsigned int
+    unsigned int get_texture_id() const { return texture.get_id(); }
+
+    /// @brief World-space bounding sphere used for culling; grown by the last tick's movement so interpolated frames stay inside
+    /// @return glm::vec4: Center (xyz) and radius (w), radius < 0 if the mesh has no bounds
+    glm::vec4 get_bounding_sphere() const
+    {
+        if (mesh.radius < 0.0f)
+            return glm::vec4(offset, -1.0f);
+
+        float largest = std::max({std::abs(scale.x), std::abs(scale.y), std::abs(scale.z),
+                                  std::abs(prevScale.x), std::abs(prevScale.y), std::abs(prevScale.z)});
+
+        return glm::vec4(offset, mesh.radius * largest + glm::length(offset - prevOffset));
+    }
+
     /// @brief Get the current mesh
     /// @return const Mesh&
     const Mesh &get_mesh() const { return mesh; }
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// ======= STRUCTS =======
+
+/// @brief One emitter's particles inside a particle_frame; colour and size over life are evaluated on the GPU
+struct particle_batch
+{
+    size_t offset; // first float of the batch in particle_frame::data
+    uint32_t count;
+
+    glm::vec4 color_start;
+    glm::vec4 color_end;
+
+    float size_start;
+    float size_end;
+};
+
+// ======= particle_frame =======
+
+/// @brief Instance streams of every live particle for one frame
+/// @note Each batch stores count x, then count y, count z and count normalized ages back to back,
+/// so packing is a plain copy of the simulation arrays
+struct particle_frame
+{
+    std::vector<float> data;
+    std::vector<particle_batch> batches;
+
+    /// @brief Reset the frame while keeping its capacity
+    void clear()
+    {
+        data.clear();
+        batches.clear();
+    }
+
+    /// @brief Amount of particles in the frame
+    /// @return size_t
+    size_t size() const
+    {
+        size_t total = 0;
+
+        for (const particle_batch &batch : batches)
+            total += batch.count;
+
+        return total;
+    }
+};
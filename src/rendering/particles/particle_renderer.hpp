@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include <glad/glad.h>
+
+#include "./particle_frame.hpp"
+#include "../graphics/shaders/shader_class.hpp"
+
+// ======= particle_renderer =======
+
+/// @brief Draws a particle_frame as camera-facing quads, one instanced draw call per batch
+/// @note The instance buffer is orphaned and refilled every frame; each particle is 16 bytes (x, y, z, age)
+class particle_renderer
+{
+private:
+    shader_class shader;
+
+    unsigned int VAO = 0;
+    unsigned int quad_VBO = 0;
+    unsigned int instance_VBO = 0;
+
+    size_t instance_capacity = 0; // bytes
+
+public:
+    // ======= CONSTRUCTOR =======
+
+    /// @brief Constructor for particle_renderer (needs the GL context)
+    /// @param vertexPath: File path for the particle vertex code (.glsl)
+    /// @param fragmentPath: File path for the particle fragment code (.glsl)
+    particle_renderer(const char *vertexPath, const char *fragmentPath)
+        : shader(vertexPath, fragmentPath)
+    {
+        // ======= two triangles spanning [-0.5, 0.5]; the vertex shader turns them towards the camera =======
+
+        const float corners[] = {
+            -0.5f, -0.5f, 0.5f, -0.5f, 0.5f, 0.5f,
+            -0.5f, -0.5f, 0.5f, 0.5f, -0.5f, 0.5f};
+
+        glGenVertexArrays(1, &VAO);
+        glGenBuffers(1, &quad_VBO);
+        glGenBuffers(1, &instance_VBO);
+
+        glBindVertexArray(VAO);
+
+        glBindBuffer(GL_ARRAY_BUFFER, quad_VBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void *)0);
+        glEnableVertexAttribArray(0);
+
+        // ======= x, y, z and age are separate streams, so every attribute is a single float =======
+
+        glBindBuffer(GL_ARRAY_BUFFER, instance_VBO);
+
+        for (GLuint location = 1; location <= 4; ++location)
+        {
+            glEnableVertexAttribArray(location);
+            glVertexAttribDivisor(location, 1);
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindVertexArray(0);
+    }
+
+    // ======= MAIN API =======
+
+    /// @brief Draw every batch of a frame; leaves the particle shader bound and restores blending and depth writes
+    /// @param frame
+    /// @param view
+    /// @param projection
+    void render(const particle_frame &frame, const glm::mat4 &view, const glm::mat4 &projection)
+    {
+        if (frame.batches.empty())
+            return;
+
+        shader.use();
+        shader.setMat4("view", view);
+        shader.setMat4("projection", projection);
+
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, instance_VBO);
+
+        // ======= orphan the old storage so the driver never waits on last frame's draws =======
+
+        size_t bytes = frame.data.size() * sizeof(float);
+
+        if (bytes > instance_capacity)
+            instance_capacity = bytes + bytes / 2;
+
+        glBufferData(GL_ARRAY_BUFFER, instance_capacity, nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, frame.data.data());
+
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glDepthMask(GL_FALSE);
+
+        for (const particle_batch &batch : frame.batches)
+        {
+            for (GLuint stream = 0; stream < 4; ++stream)
+            {
+                size_t offset = (batch.offset + stream * static_cast<size_t>(batch.count)) * sizeof(float);
+                glVertexAttribPointer(1 + stream, 1, GL_FLOAT, GL_FALSE, sizeof(float), (void *)offset);
+            }
+
+            shader.set_uniform4f("color_start", batch.color_start);
+            shader.set_uniform4f("color_end", batch.color_end);
+            shader.set_uniform1f("size_start", batch.size_start);
+            shader.set_uniform1f("size_end", batch.size_end);
+
+            glDrawArraysInstanced(GL_TRIANGLES, 0, 6, static_cast<GLsizei>(batch.count));
+        }
+
+        glDepthMask(GL_TRUE);
+        glDisable(GL_BLEND);
+
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindVertexArray(0);
+    }
+
+    /// @brief Destroy the GL objects
+    void destroy()
+    {
+        glDeleteBuffers(1, &quad_VBO);
+        glDeleteBuffers(1, &instance_VBO);
+        glDeleteVertexArrays(1, &VAO);
+
+        shader.destroy();
+    }
+};
@@ -23,6 +23,15 @@ struct Vec3
     static Vec3 from_glm(const glm::vec3 &v) { return {v.x, v.y, v.z}; }
 };
 
+/// @brief Everything that places the camera (recorded by input_recording)
+struct camera_state
+{
+    Vec3 position;
+
+    float yaw;
+    float pitch;
+};
+
 // ======= player_camera_controller =======
 
 class player_camera_controller
@@ -42,17 +51,37 @@ private:
     float speed;
     float sensitivity;
 
-    // ======= MOUSE =======
-
-    float lastX = 0;
-    float lastY = 0;
-    bool firstMouse = true;
-
     // ======= SCREEN =======
 
     float aspectRatio = 1.0f / 1.0f;
 
+    float fov = 45.0f;
+    float nearPlane = 0.1f;
+    float farPlane = 100.0f;
+
+    // ======= CACHED MATRICES (rebuilt on first use after a change) =======
+
+    mutable glm::mat4 viewMatrix{1.0f};
+    mutable glm::mat4 projectionMatrix{1.0f};
+    mutable glm::mat4 viewProjectionMatrix{1.0f};
+
+    mutable bool viewDirty = true;
+    mutable bool projectionDirty = true;
+    mutable bool viewProjectionDirty = true;
+
 private:
+    /// @brief Mark the view matrix stale
+    void invalidateView()
+    {
+        viewDirty = viewProjectionDirty = true;
+    }
+
+    /// @brief Mark the projection matrix stale
+    void invalidateProjection()
+    {
+        projectionDirty = viewProjectionDirty = true;
+    }
+
     /// @brief Transform and update vectors
     void updateVectors()
     {
@@ -69,11 +98,18 @@ private:
         front = Vec3::from_glm(frontNorm);
         right = Vec3::from_glm(rightNorm);
         up = Vec3::from_glm(upNorm);
+
+        invalidateView();
     }
 
     /// @brief Move position along a direction vector
     void move(const Vec3 &direction, float velocity)
     {
+        if (velocity == 0.0f)
+            return;
+
+        invalidateView();
+
         position.x += direction.x * velocity;
         position.y += direction.y * velocity;
         position.z += direction.z * velocity;
@@ -95,42 +131,21 @@ public:
 
     // ======= MAIN API =======
 
-    /// @brief Process keyboard input
-    /// @param keysDown
+    /// @brief Move along the camera axes
+    /// @param forward: -1 .. 1 along front
+    /// @param sideways: -1 .. 1 along right
+    /// @param vertical: -1 .. 1 along up
     /// @param deltaTime
-    void processKeyboard(const std::vector<int> &keysDown, float deltaTime)
+    void processMovement(float forward, float sideways, float vertical, float deltaTime)
     {
         if (deltaTime <= 0.0f || std::isnan(deltaTime) || std::isinf(deltaTime))
             return;
 
         float velocity = speed * deltaTime;
 
-        for (int key : keysDown)
-        {
-            switch (key)
-            {
-            case GLFW_KEY_W:
-                move(front, velocity);
-                break;
-            case GLFW_KEY_S:
-                move(front, -velocity);
-                break;
-            case GLFW_KEY_A:
-                move(right, -velocity);
-                break;
-            case GLFW_KEY_D:
-                move(right, velocity);
-                break;
-            case GLFW_KEY_Q:
-                move(up, velocity);
-                break;
-            case GLFW_KEY_E:
-                move(up, -velocity);
-                break;
-            default:
-                break;
-            }
-        }
+        move(front, forward * velocity);
+        move(right, sideways * velocity);
+        move(up, vertical * velocity);
     }
 
     /// @brief Handler for mouse movement
@@ -150,40 +165,17 @@ public:
         updateVectors();
     }
 
-    /// @brief Mouse callback for GLFW
-    /// @param window: The window to track
-    /// @param xpos: Current X position
-    /// @param ypos: Current Y position
-    static void mouse_callback(GLFWwindow *window, double xpos, double ypos)
-    {
-        player_camera_controller *cam = static_cast<player_camera_controller *>(glfwGetWindowUserPointer(window));
-        if (!cam)
-            return;
-
-        if (cam->firstMouse)
-        {
-            cam->lastX = xpos;
-            cam->lastY = ypos;
-            cam->firstMouse = false;
-        }
-
-        float xoffset = xpos - cam->lastX;
-        float yoffset = cam->lastY - ypos;
-
-        cam->lastX = xpos;
-        cam->lastY = ypos;
-
-        cam->processMouseMovement(xoffset, yoffset);
-    }
-
     // ======= ASPECT RATIO =======
 
     /// @brief Set the aspect ratio
     /// @param ratio
     void setAspectRatio(float ratio)
     {
-        if (ratio > 0.0f)
+        if (ratio > 0.0f && ratio != aspectRatio)
+        {
             aspectRatio = ratio;
+            invalidateProjection();
+        }
     }
 
     /// @brief Get the aspect ratio
@@ -196,26 +188,76 @@ public:
     /// @return Vec3
     Vec3 getPosition() const { return position; }
 
+    /// @brief Get position and orientation
+    /// @return camera_state
+    camera_state getState() const { return {position, yaw, pitch}; }
+
+    /// @brief Place the camera
+    /// @param state
+    void setState(const camera_state &state)
+    {
+        position = state.position;
+        yaw = state.yaw;
+        pitch = state.pitch;
+
+        updateVectors(); // invalidates the view
+    }
+
     /// @brief Get front position
     /// @return Vec3
     Vec3 getFront() const { return front; }
 
-    /// @brief Get view matrix
-    /// @return glm::mat4
-    glm::mat4 getViewMatrix() const
+    /// @brief Set the perspective parameters
+    /// @param fovDegrees: Vertical field of view
+    /// @param nearClip
+    /// @param farClip
+    void setProjection(float fovDegrees, float nearClip, float farClip)
     {
-        return glm::lookAt(position.to_glm(),
-                           (position.to_glm() + front.to_glm()),
-                           up.to_glm());
+        fov = fovDegrees;
+        nearPlane = nearClip;
+        farPlane = farClip;
+
+        invalidateProjection();
     }
 
-    /// @brief Get projection matrix
-    /// @param fov
-    /// @param nearPlane
-    /// @param farPlane
-    /// @return glm::mat4
-    glm::mat4 getProjectionMatrix(float fov = 45.0f, float nearPlane = 0.1f, float farPlane = 100.0f) const
+    /// @brief Get view matrix (cached until the camera moves or turns)
+    /// @return const glm::mat4&
+    const glm::mat4 &getViewMatrix() const
     {
-        return glm::perspective(glm::radians(fov), aspectRatio, nearPlane, farPlane);
+        if (viewDirty)
+        {
+            viewMatrix = glm::lookAt(position.to_glm(),
+                                     (position.to_glm() + front.to_glm()),
+                                     up.to_glm());
+            viewDirty = false;
+        }
+
+        return viewMatrix;
+    }
+
+    /// @brief Get projection matrix (cached until the aspect ratio or perspective parameters change)
+    /// @return const glm::mat4&
+    const glm::mat4 &getProjectionMatrix() const
+    {
+        if (projectionDirty)
+        {
+            projectionMatrix = glm::perspective(glm::radians(fov), aspectRatio, nearPlane, farPlane);
+            projectionDirty = false;
+        }
+
+        return projectionMatrix;
+    }
+
+    /// @brief Get projection * view (cached like its parts)
+    /// @return const glm::mat4&
+    const glm::mat4 &getViewProjectionMatrix() const
+    {
+        if (viewProjectionDirty)
+        {
+            viewProjectionMatrix = getProjectionMatrix() * getViewMatrix();
+            viewProjectionDirty = false;
+        }
+
+        return viewProjectionMatrix;
     }
 };
\ No newline at end of file
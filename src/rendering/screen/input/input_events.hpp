@@ -0,0 +1,115 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// ======= TYPES =======
+
+/// @brief Clock every input timestamp and present time is taken from
+using input_clock = std::chrono::steady_clock;
+
+/// @brief Nanoseconds on input_clock
+/// @return uint64_t
+inline uint64_t input_now_ns()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(input_clock::now().time_since_epoch()).count());
+}
+
+// ======= ENUMS =======
+
+enum class input_event_type : uint8_t
+{
+    key,          // code = key, action = GLFW_PRESS / GLFW_RELEASE / GLFW_REPEAT
+    mouse_button, // code = button, action = GLFW_PRESS / GLFW_RELEASE
+    cursor,       // x, y = cursor position
+    scroll,       // x, y = scroll offset
+    resize        // x, y = framebuffer size
+};
+
+// ======= STRUCTS =======
+
+/// @brief One GLFW callback, stamped when the callback ran
+struct input_event
+{
+    input_event_type type;
+
+    int code;
+    int action;
+
+    double x;
+    double y;
+
+    uint64_t time_ns;
+};
+
+/// @brief Input-to-present latency summary
+struct input_latency_stats
+{
+    double last_ms = 0.0;
+    double mean_ms = 0.0;
+    double max_ms = 0.0;
+
+    uint64_t samples = 0;
+};
+
+// ======= input_latency =======
+
+/// @brief Accumulates input-to-present latency samples; record() may run on the render thread while the logic thread reads
+class input_latency
+{
+private:
+    std::atomic<uint64_t> last_ns{0};
+    std::atomic<uint64_t> max_ns{0};
+    std::atomic<uint64_t> total_ns{0};
+    std::atomic<uint64_t> samples{0};
+
+public:
+    // ======= MAIN API =======
+
+    /// @brief Record one frame: oldest input it consumed -> the moment it was presented
+    /// @param input_ns: input_now_ns() of the oldest event, 0 if the frame consumed no input (ignored)
+    /// @param present_ns: input_now_ns() right after the buffer swap
+    void record(uint64_t input_ns, uint64_t present_ns)
+    {
+        if (input_ns == 0 || present_ns < input_ns)
+            return;
+
+        uint64_t latency = present_ns - input_ns;
+
+        last_ns.store(latency, std::memory_order_relaxed);
+        total_ns.fetch_add(latency, std::memory_order_relaxed);
+        samples.fetch_add(1, std::memory_order_relaxed);
+
+        uint64_t current = max_ns.load(std::memory_order_relaxed);
+
+        while (latency > current && !max_ns.compare_exchange_weak(current, latency, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    /// @brief Forget every sample
+    void reset()
+    {
+        last_ns.store(0, std::memory_order_relaxed);
+        max_ns.store(0, std::memory_order_relaxed);
+        total_ns.store(0, std::memory_order_relaxed);
+        samples.store(0, std::memory_order_relaxed);
+    }
+
+    // ======= UTILITY API =======
+
+    /// @brief Summary of every sample since the last reset
+    /// @return input_latency_stats
+    input_latency_stats get_stats() const
+    {
+        input_latency_stats stats;
+
+        stats.samples = samples.load(std::memory_order_relaxed);
+        stats.last_ms = last_ns.load(std::memory_order_relaxed) / 1e6;
+        stats.max_ms = max_ns.load(std::memory_order_relaxed) / 1e6;
+        stats.mean_ms = stats.samples ? total_ns.load(std::memory_order_relaxed) / 1e6 / stats.samples : 0.0;
+
+        return stats;
+    }
+};
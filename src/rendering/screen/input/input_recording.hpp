@@ -0,0 +1,258 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "./input_events.hpp"
+#include "../camera/player_camera_controller.hpp"
+#include "../../../helpers/io/mapped_file.hpp"
+
+// ======= MACROS =======
+
+#define INPUT_RECORDING_VERSION 1
+
+// ======= STRUCTS =======
+
+/// @brief One recorded frame: its delta_time, where the camera ended up and which events it consumed
+struct recorded_frame
+{
+    float delta_time;
+    camera_state camera;
+
+    uint32_t first_event;
+    uint32_t event_count;
+};
+
+// ======= input_recording =======
+// Timestamped input + camera log for deterministic replays. Binary layout (little or big endian, checked on load):
+//   header | frame_count x disk_frame (28 bytes) | event_count x disk_event (24 bytes)
+// Event times are stored as microseconds since the recording started.
+
+class input_recording
+{
+private:
+    struct header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t endian;
+
+        uint32_t frame_count;
+        uint32_t event_count;
+    };
+
+    struct disk_frame
+    {
+        float delta_time;
+        float position[3];
+        float yaw;
+        float pitch;
+
+        uint32_t event_count;
+    };
+
+    struct disk_event
+    {
+        uint8_t type;
+        uint8_t action;
+        int16_t code;
+        uint32_t time_us;
+
+        double x;
+        double y;
+    };
+
+    static_assert(sizeof(disk_frame) == 28 && sizeof(disk_event) == 24, "input_recording: Unexpected record padding");
+
+    static constexpr char magic[8] = {'I', 'N', 'P', 'U', 'T', 'R', 'E', 'C'};
+    static constexpr uint32_t endian_marker = 0x01020304u;
+
+    std::vector<recorded_frame> frames;
+    std::vector<input_event> events;
+
+    uint64_t start_ns = 0;
+
+public:
+    // ======= RECORDING =======
+
+    /// @brief Start a new recording (drops the current one)
+    /// @param expected_frames: Frames to reserve for up front; reserve_frame() grows past it (default: 1 minute at 60 fps)
+    void begin(size_t expected_frames = 3600)
+    {
+        frames.clear();
+        events.clear();
+
+        frames.reserve(expected_frames);
+        events.reserve(expected_frames * 4);
+
+        start_ns = input_now_ns();
+    }
+
+    /// @brief Make room for one more frame, so the next add_frame() doesn't reallocate; call between frames, before
+    /// the frame's allocation guard opens
+    /// @param max_events: Most events a frame can consume
+    void reserve_frame(size_t max_events)
+    {
+        if (frames.size() == frames.capacity())
+            frames.reserve(frames.capacity() * 2 + 1);
+
+        if (events.capacity() - events.size() < max_events)
+            events.reserve(std::max(events.capacity() * 2, events.size() + max_events));
+    }
+
+    /// @brief Append a frame
+    /// @param delta_time
+    /// @param camera: Camera state after the frame's input was applied
+    /// @param frame_events: Events the frame consumed, oldest first
+    /// @param count
+    void add_frame(float delta_time, const camera_state &camera, const input_event *frame_events, size_t count)
+    {
+        frames.push_back({delta_time, camera, static_cast<uint32_t>(events.size()), static_cast<uint32_t>(count)});
+        events.insert(events.end(), frame_events, frame_events + count);
+    }
+
+    // ======= FILES =======
+
+    /// @brief Write the recording to a file
+    /// @param path
+    void save(const std::string &path) const
+    {
+        std::FILE *file = std::fopen(path.c_str(), "wb");
+
+        if (!file)
+            throw std::runtime_error("input_recording: Failed to open " + path + " for writing");
+
+        bool failed = false;
+
+        auto write = [&](const void *data, size_t size)
+        {
+            if (!failed && std::fwrite(data, 1, size, file) != size)
+                failed = true;
+        };
+
+        header head{};
+        std::memcpy(head.magic, magic, sizeof(magic));
+        head.version = INPUT_RECORDING_VERSION;
+        head.endian = endian_marker;
+        head.frame_count = static_cast<uint32_t>(frames.size());
+        head.event_count = static_cast<uint32_t>(events.size());
+
+        write(&head, sizeof(head));
+
+        for (const recorded_frame &frame : frames)
+        {
+            const camera_state &c = frame.camera;
+
+            disk_frame out{frame.delta_time, {c.position.x, c.position.y, c.position.z}, c.yaw, c.pitch, frame.event_count};
+            write(&out, sizeof(out));
+        }
+
+        for (const input_event &event : events)
+        {
+            uint64_t since_start = event.time_ns > start_ns ? event.time_ns - start_ns : 0;
+
+            disk_event out{static_cast<uint8_t>(event.type), static_cast<uint8_t>(event.action), static_cast<int16_t>(event.code),
+                           static_cast<uint32_t>(since_start / 1000), event.x, event.y};
+            write(&out, sizeof(out));
+        }
+
+        if (std::fclose(file) != 0)
+            failed = true;
+
+        if (failed)
+            throw std::runtime_error("input_recording: Failed to write " + path);
+    }
+
+    /// @brief Read a recording written by save()
+    /// @param path
+    /// @return input_recording: Event timestamps are relative to the recording start
+    static input_recording load(const std::string &path)
+    {
+        mapped_file file(path);
+
+        const unsigned char *data = file.data();
+        size_t size = file.size();
+
+        header head;
+
+        if (size < sizeof(head))
+            throw std::runtime_error("input_recording: Truncated recording " + path);
+
+        std::memcpy(&head, data, sizeof(head));
+
+        if (std::memcmp(head.magic, magic, sizeof(magic)) != 0)
+            throw std::runtime_error("input_recording: Not an input recording " + path);
+
+        if (head.endian != endian_marker)
+            throw std::runtime_error("input_recording: Recording was written on a machine with different endianness");
+
+        if (head.version != INPUT_RECORDING_VERSION)
+            throw std::runtime_error("input_recording: Unsupported recording version " + std::to_string(head.version));
+
+        if (size - sizeof(head) != sizeof(disk_frame) * static_cast<size_t>(head.frame_count) + sizeof(disk_event) * static_cast<size_t>(head.event_count))
+            throw std::runtime_error("input_recording: Truncated recording " + path);
+
+        input_recording recording;
+        recording.frames.resize(head.frame_count);
+        recording.events.resize(head.event_count);
+
+        const unsigned char *at = data + sizeof(head);
+        uint64_t next_event = 0;
+
+        for (recorded_frame &frame : recording.frames)
+        {
+            disk_frame in;
+            std::memcpy(&in, at, sizeof(in));
+            at += sizeof(in);
+
+            if (in.event_count > head.event_count - next_event)
+                throw std::runtime_error("input_recording: Corrupt event count in " + path);
+
+            frame = {in.delta_time, {{in.position[0], in.position[1], in.position[2]}, in.yaw, in.pitch}, static_cast<uint32_t>(next_event), in.event_count};
+            next_event += in.event_count;
+        }
+
+        for (input_event &event : recording.events)
+        {
+            disk_event in;
+            std::memcpy(&in, at, sizeof(in));
+            at += sizeof(in);
+
+            event = {static_cast<input_event_type>(in.type), in.code, in.action, in.x, in.y, in.time_us * 1000ull};
+        }
+
+        return recording;
+    }
+
+    // ======= UTILITY API =======
+
+    /// @brief Amount of recorded frames
+    /// @return size_t
+    size_t size() const { return frames.size(); }
+
+    /// @brief Get a recorded frame
+    /// @param index
+    /// @return const recorded_frame&
+    const recorded_frame &get_frame(size_t index) const { return frames[index]; }
+
+    /// @brief First event of a frame (frame.event_count of them follow)
+    /// @param frame
+    /// @return const input_event*
+    const input_event *get_events(const recorded_frame &frame) const { return events.data() + frame.first_event; }
+
+    /// @brief Total amount of recorded events
+    /// @return size_t
+    size_t event_count() const { return events.size(); }
+
+    /// @brief Drop every frame
+    void clear()
+    {
+        frames.clear();
+        events.clear();
+    }
+};
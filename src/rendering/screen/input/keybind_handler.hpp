@@ -1,39 +1,224 @@
 #pragma once
 
-#include <iostream>
-#include <unordered_set>
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
 #include <functional>
+#include <stdexcept>
 #include <vector>
 
 #include <GLFW/glfw3.h>
 
 #include "../screen_class.hpp"
+#include "./input_events.hpp"
+#include "../../../helpers/threading/spsc_queue.hpp"
+
+// ======= MACROS =======
+
+#define INPUT_QUEUE_CAPACITY 1024 // events buffered between two update() calls
+#define INPUT_MAX_ACTIONS 64      // action IDs are 0 .. INPUT_MAX_ACTIONS - 1
 
 // ======= TYPEDEF =======
 
 typedef std::function<void(int)> callback_func;
 
+// ======= ENUMS =======
+
+/// @brief Actions the engine binds itself; user actions should start at engine_action::count
+enum class engine_action : uint32_t
+{
+    move_forward,
+    move_back,
+    move_left,
+    move_right,
+    move_up,
+    move_down,
+
+    count
+};
+
 // ======= keybind_handler =======
 
+/// @brief Event-driven input: GLFW callbacks push timestamped events into a lock-free queue, update() applies them
+/// to fixed bitsets once per frame, so key, edge and action queries are O(1) and never allocate
+/// @note Owns the window user pointer (see from_window())
 class keybind_handler
 {
+public:
+    static constexpr int key_count = GLFW_KEY_LAST + 1;
+    static constexpr int button_count = GLFW_MOUSE_BUTTON_LAST + 1;
+
 private:
-    std::unordered_set<int> keys_to_track;
+    struct action_binding
+    {
+        uint32_t action;
+        int key;
+    };
+
     GLFWwindow *current_window;
 
+    std::vector<int> keys_to_track;
+    std::bitset<key_count> tracked;
+
+    spsc_queue<input_event, INPUT_QUEUE_CAPACITY> events;
+
+    std::vector<input_event> frame_events; // events the last update() applied, only kept while capturing
+    bool capturing = false;
+
+    // ======= STATE (consumer side, rebuilt by update) =======
+
+    std::bitset<key_count> keys_down, keys_pressed, keys_released;
+    std::bitset<button_count> buttons_down, buttons_pressed, buttons_released;
+
+    std::vector<action_binding> bindings;
+    std::bitset<INPUT_MAX_ACTIONS> actions_down, actions_pressed, actions_released;
+
+    double cursor_x = 0.0, cursor_y = 0.0;
+    double mouse_dx = 0.0, mouse_dy = 0.0;
+    double scroll_x = 0.0, scroll_y = 0.0;
+    bool has_cursor = false;
+
+    int resize_width = 0, resize_height = 0;
+    bool resized = false;
+
+    // ======= LATENCY =======
+
+    uint64_t unpresented_input_ns = 0; // oldest applied event no frame has presented yet
+    input_latency latency;
+
 private:
-    /// @brief Key callback
-    /// @param window
-    /// @param key
-    /// @param scancode
-    /// @param action
-    /// @param mods
+    // ======= CALLBACKS (producer side) =======
+
     static void key_callback(GLFWwindow *window, int key, int scancode, int action, int mods)
     {
         if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
-        {
             glfwSetWindowShouldClose(window, GLFW_TRUE);
+
+        keybind_handler *handler = from_window(window);
+
+        if (handler && key >= 0 && key < key_count && handler->tracked.test(key) && action != GLFW_REPEAT)
+            handler->events.push({input_event_type::key, key, action, 0.0, 0.0, input_now_ns()});
+    }
+
+    static void mouse_button_callback(GLFWwindow *window, int button, int action, int mods)
+    {
+        if (keybind_handler *handler = from_window(window))
+            handler->events.push({input_event_type::mouse_button, button, action, 0.0, 0.0, input_now_ns()});
+    }
+
+    static void cursor_callback(GLFWwindow *window, double xpos, double ypos)
+    {
+        if (keybind_handler *handler = from_window(window))
+            handler->events.push({input_event_type::cursor, 0, 0, xpos, ypos, input_now_ns()});
+    }
+
+    static void scroll_callback(GLFWwindow *window, double xoffset, double yoffset)
+    {
+        if (keybind_handler *handler = from_window(window))
+            handler->events.push({input_event_type::scroll, 0, 0, xoffset, yoffset, input_now_ns()});
+    }
+
+    // ======= CONSUMER =======
+
+    /// @brief Apply one event to the state bitsets
+    /// @param event
+    void apply(const input_event &event)
+    {
+        switch (event.type)
+        {
+        case input_event_type::key:
+            if (event.action == GLFW_PRESS && !keys_down.test(event.code))
+            {
+                keys_down.set(event.code);
+                keys_pressed.set(event.code);
+            }
+            else if (event.action == GLFW_RELEASE && keys_down.test(event.code))
+            {
+                keys_down.reset(event.code);
+                keys_released.set(event.code);
+            }
+            break;
+
+        case input_event_type::mouse_button:
+            if (event.code < 0 || event.code >= button_count)
+                return;
+
+            if (event.action == GLFW_PRESS && !buttons_down.test(event.code))
+            {
+                buttons_down.set(event.code);
+                buttons_pressed.set(event.code);
+            }
+            else if (event.action == GLFW_RELEASE && buttons_down.test(event.code))
+            {
+                buttons_down.reset(event.code);
+                buttons_released.set(event.code);
+            }
+            break;
+
+        case input_event_type::cursor:
+            // ======= the first position only anchors the cursor, so the camera doesn't jump =======
+
+            if (has_cursor)
+            {
+                mouse_dx += event.x - cursor_x;
+                mouse_dy += event.y - cursor_y;
+            }
+
+            cursor_x = event.x;
+            cursor_y = event.y;
+            has_cursor = true;
+            break;
+
+        case input_event_type::scroll:
+            scroll_x += event.x;
+            scroll_y += event.y;
+            break;
+
+        case input_event_type::resize:
+            resize_width = static_cast<int>(event.x);
+            resize_height = static_cast<int>(event.y);
+            resized = true;
+            return; // not user input, so it doesn't count towards latency
+        }
+
+        if (unpresented_input_ns == 0)
+            unpresented_input_ns = event.time_ns;
+    }
+
+    /// @brief Clear last frame's edges and deltas
+    void begin_frame()
+    {
+        keys_pressed.reset();
+        keys_released.reset();
+        buttons_pressed.reset();
+        buttons_released.reset();
+
+        mouse_dx = mouse_dy = 0.0;
+        scroll_x = scroll_y = 0.0;
+        resized = false;
+
+        frame_events.clear();
+    }
+
+    /// @brief Rebuild the action bitsets from the key state; a key tapped within one frame still reports pressed and released
+    void update_actions()
+    {
+        std::bitset<INPUT_MAX_ACTIONS> previous = actions_down;
+        std::bitset<INPUT_MAX_ACTIONS> tapped;
+
+        actions_down.reset();
+
+        for (const action_binding &binding : bindings)
+        {
+            if (keys_down.test(binding.key))
+                actions_down.set(binding.action);
+
+            if (keys_pressed.test(binding.key))
+                tapped.set(binding.action);
         }
+
+        actions_pressed = (actions_down | tapped) & ~previous;
+        actions_released = (previous | tapped) & ~actions_down;
     }
 
 public:
@@ -41,26 +226,247 @@ public:
 
     /// @brief Constructor for keybind_handler
     /// @param screen: The screen to track
-    /// @param tracked_keys: The keys that will be tracked
+    /// @param tracked_keys: The keys that will be tracked (other keys never reach the queue)
     keybind_handler(screen_class &screen, const std::vector<int> &tracked_keys)
+        : current_window(screen.get_window())
     {
-        current_window = screen.get_window();
-        keys_to_track = std::unordered_set<int>(tracked_keys.begin(), tracked_keys.end());
+        for (int key : tracked_keys)
+        {
+            if (key < 0 || key >= key_count || tracked.test(key))
+                continue;
+
+            tracked.set(key);
+            keys_to_track.push_back(key);
+        }
+
+        glfwSetWindowUserPointer(current_window, this);
 
         glfwSetKeyCallback(current_window, key_callback);
+        glfwSetMouseButtonCallback(current_window, mouse_button_callback);
+        glfwSetCursorPosCallback(current_window, cursor_callback);
+        glfwSetScrollCallback(current_window, scroll_callback);
+    }
+
+    keybind_handler(const keybind_handler &) = delete;
+    keybind_handler &operator=(const keybind_handler &) = delete;
+
+    // ======= STATIC HELPERS =======
+
+    /// @brief The handler installed on a window
+    /// @param window
+    /// @return keybind_handler*: nullptr if none
+    static keybind_handler *from_window(GLFWwindow *window)
+    {
+        return static_cast<keybind_handler *>(glfwGetWindowUserPointer(window));
     }
 
     // ======= MAIN API =======
 
+    /// @brief Queue an event from outside GLFW (e.g. a framebuffer resize callback or a replay); same thread as the GLFW callbacks
+    /// @param event
+    /// @return bool: false if the queue was full
+    bool push_event(const input_event &event) { return events.push(event); }
+
+    /// @brief Apply every queued event; call once per frame before querying (clears last frame's edges and deltas)
+    void update()
+    {
+        begin_frame();
+
+        events.drain([this](const input_event &event)
+                     {
+                         apply(event);
+
+                         if (capturing)
+                             frame_events.push_back(event); });
+
+        update_actions();
+    }
+
+    /// @brief Like update(), but apply the given events instead of the live ones (which are discarded)
+    /// @param replayed: Events of one recorded frame, oldest first; they are stamped with the current time
+    /// @param count
+    void replay(const input_event *replayed, size_t count)
+    {
+        begin_frame();
+
+        events.drain([](const input_event &) {});
+
+        uint64_t now = input_now_ns();
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            input_event event = replayed[i];
+            event.time_ns = now;
+
+            apply(event);
+        }
+
+        update_actions();
+    }
+
+    /// @brief Keep the events each update() applies (see get_frame_events()); used for recording
+    /// @param capture
+    void set_capture(bool capture)
+    {
+        capturing = capture;
+        frame_events.clear();
+
+        // ======= one update() drains at most a full queue =======
+
+        if (capture)
+            frame_events.reserve(INPUT_QUEUE_CAPACITY);
+    }
+
+    /// @brief Events the last update() applied, oldest first (empty unless capturing)
+    /// @return const std::vector<input_event>&
+    const std::vector<input_event> &get_frame_events() const { return frame_events; }
+
     /// @brief Check if a specific valid key is held down
     /// @param key
     /// @return bool
-    bool is_key_down(int key)
+    bool is_key_down(int key) const { return key >= 0 && key < key_count && keys_down.test(key); }
+
+    /// @brief If a key went down since the previous update()
+    /// @param key
+    /// @return bool
+    bool was_key_pressed(int key) const { return key >= 0 && key < key_count && keys_pressed.test(key); }
+
+    /// @brief If a key went up since the previous update()
+    /// @param key
+    /// @return bool
+    bool was_key_released(int key) const { return key >= 0 && key < key_count && keys_released.test(key); }
+
+    /// @brief Check if a mouse button is held down
+    /// @param button
+    /// @return bool
+    bool is_button_down(int button) const { return button >= 0 && button < button_count && buttons_down.test(button); }
+
+    /// @brief If a mouse button went down since the previous update()
+    /// @param button
+    /// @return bool
+    bool was_button_pressed(int button) const { return button >= 0 && button < button_count && buttons_pressed.test(button); }
+
+    /// @brief If a mouse button went up since the previous update()
+    /// @param button
+    /// @return bool
+    bool was_button_released(int button) const { return button >= 0 && button < button_count && buttons_released.test(button); }
+
+    // ======= ACTIONS =======
+
+    /// @brief Bind a key to an action; an action can have several keys and a key several actions
+    /// @param action: 0 .. INPUT_MAX_ACTIONS - 1
+    /// @param key: Must be one of the tracked keys to ever fire
+    void bind_action(uint32_t action, int key)
+    {
+        if (action >= INPUT_MAX_ACTIONS)
+            throw std::out_of_range("keybind_handler: Action ID out of range");
+
+        if (key < 0 || key >= key_count)
+            return;
+
+        for (const action_binding &binding : bindings)
+            if (binding.action == action && binding.key == key)
+                return;
+
+        bindings.push_back({action, key});
+    }
+
+    void bind_action(engine_action action, int key) { bind_action(static_cast<uint32_t>(action), key); }
+
+    /// @brief Remove every key bound to an action
+    /// @param action
+    void unbind_action(uint32_t action)
+    {
+        bindings.erase(std::remove_if(bindings.begin(), bindings.end(), [action](const action_binding &binding)
+                                      { return binding.action == action; }),
+                       bindings.end());
+    }
+
+    void unbind_action(engine_action action) { unbind_action(static_cast<uint32_t>(action)); }
+
+    /// @brief If any key bound to an action is held down
+    /// @param action
+    /// @return bool
+    bool is_action_down(uint32_t action) const { return action < INPUT_MAX_ACTIONS && actions_down.test(action); }
+
+    bool is_action_down(engine_action action) const { return is_action_down(static_cast<uint32_t>(action)); }
+
+    /// @brief If an action started since the previous update()
+    /// @param action
+    /// @return bool
+    bool was_action_pressed(uint32_t action) const { return action < INPUT_MAX_ACTIONS && actions_pressed.test(action); }
+
+    bool was_action_pressed(engine_action action) const { return was_action_pressed(static_cast<uint32_t>(action)); }
+
+    /// @brief If an action ended since the previous update()
+    /// @param action
+    /// @return bool
+    bool was_action_released(uint32_t action) const { return action < INPUT_MAX_ACTIONS && actions_released.test(action); }
+
+    bool was_action_released(engine_action action) const { return was_action_released(static_cast<uint32_t>(action)); }
+
+    // ======= MOUSE / WINDOW =======
+
+    /// @brief Cursor movement since the previous update()
+    /// @param dx
+    /// @param dy
+    void get_mouse_delta(double &dx, double &dy) const
+    {
+        dx = mouse_dx;
+        dy = mouse_dy;
+    }
+
+    /// @brief Scrolling since the previous update()
+    /// @param dx
+    /// @param dy
+    void get_scroll_delta(double &dx, double &dy) const
+    {
+        dx = scroll_x;
+        dy = scroll_y;
+    }
+
+    /// @brief If the framebuffer was resized since the previous update(), and to what size
+    /// @param width
+    /// @param height
+    /// @return bool
+    bool get_resize(int &width, int &height) const
     {
-        return glfwGetKey(current_window, key) == GLFW_PRESS;
+        width = resize_width;
+        height = resize_height;
+
+        return resized;
     }
 
+    // ======= LATENCY =======
+
+    /// @brief Timestamp of the oldest input applied since the last call, which the frame being built now will present
+    /// @return uint64_t: 0 if no input arrived
+    uint64_t take_unpresented_input()
+    {
+        uint64_t input_ns = unpresented_input_ns;
+        unpresented_input_ns = 0;
+
+        return input_ns;
+    }
+
+    /// @brief Record that a frame built from input at input_ns was presented just now (safe from the render thread)
+    /// @param input_ns: Value of take_unpresented_input() for that frame
+    void presented(uint64_t input_ns) { latency.record(input_ns, input_now_ns()); }
+
+    /// @brief Input-to-present latency; the input side is when GLFW delivered the event during poll_events
+    /// @return input_latency_stats
+    input_latency_stats get_latency_stats() const { return latency.get_stats(); }
+
+    /// @brief Forget every latency sample
+    void reset_latency_stats() { latency.reset(); }
+
+    // ======= UTILITY API =======
+
     /// @brief Get all keys that can be pressed
-    /// @return std::unordered_set<int>
-    std::unordered_set<int> get_valid_keys() const { return keys_to_track; }
-};
\ No newline at end of file
+    /// @return const std::vector<int>&
+    const std::vector<int> &get_valid_keys() const { return keys_to_track; }
+
+    /// @brief Events rejected because the queue was full (update() not called often enough)
+    /// @return uint64_t
+    uint64_t dropped_events() const { return events.dropped_count(); }
+};
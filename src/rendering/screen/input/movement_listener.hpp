@@ -10,33 +10,52 @@
 class movement_listener
 {
 private:
-    float lastTime;
-
     keybind_handler &keys;
     player_camera_controller &camera;
 
+    /// @brief -1, 0 or 1 from a pair of opposing actions
+    float axis(engine_action positive, engine_action negative) const
+    {
+        return (keys.is_action_down(positive) ? 1.0f : 0.0f) - (keys.is_action_down(negative) ? 1.0f : 0.0f);
+    }
+
 public:
     // ======= CONSTRUCTOR =======
 
-    /// @brief Constructor for movement_listener
+    /// @brief Constructor for movement_listener; binds WASD + Q / E to the engine movement actions (rebind through keybind_handler)
     /// @param key_handler: The keybind_handler object
     /// @param camera_object: The player_camera_controller object
     movement_listener(keybind_handler &key_handler, player_camera_controller &camera_object)
-        : keys(key_handler), camera(camera_object), lastTime(glfwGetTime()) {}
+        : keys(key_handler), camera(camera_object)
+    {
+        keys.bind_action(engine_action::move_forward, GLFW_KEY_W);
+        keys.bind_action(engine_action::move_back, GLFW_KEY_S);
+        keys.bind_action(engine_action::move_left, GLFW_KEY_A);
+        keys.bind_action(engine_action::move_right, GLFW_KEY_D);
+        keys.bind_action(engine_action::move_up, GLFW_KEY_Q);
+        keys.bind_action(engine_action::move_down, GLFW_KEY_E);
+    }
 
-    /// @brief Update the camera based on movement
-    void update()
+    /// @brief Apply this frame's input events, then update the camera from them
+    /// @param delta_time: The engine's frame delta_time
+    void update(float delta_time)
     {
-        float now = glfwGetTime();
-        float deltaTime = now - lastTime;
-        lastTime = now;
+        keys.update();
+
+        int width, height;
+
+        if (keys.get_resize(width, height) && height > 0)
+            camera.setAspectRatio(width / (float)height);
 
-        std::vector<int> pressed;
+        double dx, dy;
+        keys.get_mouse_delta(dx, dy);
 
-        for (int key : keys.get_valid_keys())
-            if (keys.is_key_down(key))
-                pressed.push_back(key);
+        if (dx != 0.0 || dy != 0.0)
+            camera.processMouseMovement(static_cast<float>(dx), static_cast<float>(-dy));
 
-        camera.processKeyboard(pressed, deltaTime);
+        camera.processMovement(axis(engine_action::move_forward, engine_action::move_back),
+                               axis(engine_action::move_right, engine_action::move_left),
+                               axis(engine_action::move_up, engine_action::move_down),
+                               delta_time);
     }
-};
\ No newline at end of file
+};
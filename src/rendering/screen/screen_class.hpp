@@ -1,6 +1,10 @@
 #pragma once
 
 #include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <stdexcept>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -16,8 +20,43 @@ private:
     int height;
     const char *name;
 
+    bool headless;
+
     GLFWwindow *window = nullptr;
 
+    // ======= OFFSCREEN TARGET (headless) =======
+
+    unsigned int offscreen_fbo = 0;
+    unsigned int offscreen_color = 0;
+    unsigned int offscreen_depth = 0;
+
+private:
+    /// @brief Create the framebuffer headless mode renders into
+    /// @return int: 0 on success, -1 if the framebuffer is incomplete
+    int create_offscreen_target()
+    {
+        glGenFramebuffers(1, &offscreen_fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, offscreen_fbo);
+
+        glGenRenderbuffers(1, &offscreen_color);
+        glBindRenderbuffer(GL_RENDERBUFFER, offscreen_color);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, offscreen_color);
+
+        glGenRenderbuffers(1, &offscreen_depth);
+        glBindRenderbuffer(GL_RENDERBUFFER, offscreen_depth);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, offscreen_depth);
+
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        {
+            std::cerr << "create_offscreen_target(): Framebuffer is incomplete" << std::endl;
+            return -1;
+        }
+
+        return 0;
+    }
+
 public:
     // ======= CONSTRUCTOR =======
 
@@ -25,8 +64,9 @@ public:
     /// @param window_width
     /// @param window_height
     /// @param window_name
-    screen_class(int window_width, int window_height, const char *window_name)
-        : width(window_width), height(window_height), name(window_name)
+    /// @param headless_mode: Render offscreen into a framebuffer without a display or GPU (GLFW null platform + OSMesa)
+    screen_class(int window_width, int window_height, const char *window_name, bool headless_mode = false)
+        : width(window_width), height(window_height), name(window_name), headless(headless_mode)
     {
         if (create_window() != 0)
         {
@@ -45,6 +85,9 @@ public:
     /// @return int: 0 on success, -1 if something failed
     int create_window()
     {
+        if (headless)
+            glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+
         if (!glfwInit())
             return -1;
 
@@ -54,6 +97,15 @@ public:
             return -1;
         }
 
+        if (headless)
+        {
+            glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+            glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        }
+
         window = glfwCreateWindow(width, height, name, nullptr, nullptr);
 
         if (!window)
@@ -70,6 +122,9 @@ public:
             return -1;
         }
 
+        if (headless && create_offscreen_target() != 0)
+            return -1;
+
         glViewport(0, 0, width, height);
 
         return 0;
@@ -84,6 +139,26 @@ public:
         return window;
     }
 
+    /// @brief Make the window's GL context current on the calling thread
+    void make_context_current()
+    {
+        glfwMakeContextCurrent(window);
+    }
+
+    /// @brief Detach the GL context from the calling thread
+    void release_context()
+    {
+        glfwMakeContextCurrent(nullptr);
+    }
+
+    /// @brief Get the current framebuffer size (main thread only)
+    /// @param out_width
+    /// @param out_height
+    void get_framebuffer_size(int &out_width, int &out_height) const
+    {
+        glfwGetFramebufferSize(window, &out_width, &out_height);
+    }
+
     /// @brief Return screen width
     /// @return int
     int getWidth() const { return width; }
@@ -108,9 +183,21 @@ public:
     /// @brief Wrapper for swap_buffers()
     void swap_buffers()
     {
+        if (headless)
+        {
+            glFlush();
+            return;
+        }
+
         glfwSwapBuffers(window);
     }
 
+    /// @brief Block until every submitted GL command has finished
+    void finish()
+    {
+        glFinish();
+    }
+
     /// @brief Clears the color buffer
     /// @param r
     /// @param g
@@ -121,11 +208,65 @@ public:
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     }
 
+    /// @brief Draw into the screen again after rendering into another framebuffer (the offscreen target when headless)
+    void bind_target() const
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, offscreen_fbo);
+    }
+
+    /// @brief If the screen renders offscreen
+    /// @return bool
+    bool is_headless() const { return headless; }
+
+    /// @brief Read back the current framebuffer
+    /// @param out: RGBA8 pixels, rows bottom to top
+    void read_pixels(std::vector<unsigned char> &out) const
+    {
+        out.resize(static_cast<size_t>(width) * height * 4);
+
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, out.data());
+    }
+
+    /// @brief Save the current framebuffer as a binary PPM image
+    /// @param path: Output file path
+    /// @return bool: false if the file could not be opened
+    bool save_ppm(const std::string &path) const
+    {
+        std::vector<unsigned char> pixels;
+        read_pixels(pixels);
+
+        std::ofstream file(path, std::ios::binary);
+
+        if (!file.is_open())
+            return false;
+
+        file << "P6\n"
+             << width << " " << height << "\n255\n";
+
+        for (int y = height - 1; y >= 0; --y)
+            for (int x = 0; x < width; ++x)
+                file.write(reinterpret_cast<const char *>(&pixels[(static_cast<size_t>(y) * width + x) * 4]), 3);
+
+        return true;
+    }
+
     /// @brief Destroys the window
     void destroy()
     {
         if (window)
         {
+            if (offscreen_fbo)
+            {
+                glfwMakeContextCurrent(window);
+
+                glDeleteFramebuffers(1, &offscreen_fbo);
+                glDeleteRenderbuffers(1, &offscreen_color);
+                glDeleteRenderbuffers(1, &offscreen_depth);
+
+                offscreen_fbo = offscreen_color = offscreen_depth = 0;
+            }
+
             glfwDestroyWindow(window);
             glfwTerminate();
             window = nullptr;
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "../../helpers/memory/aligned_allocator.hpp"
+
+// ======= STRUCTS =======
+
+/// @brief CPU copy of a mesh: positions as SoA streams (padded with zeroes to a multiple of 8) and r, g, b, u, v per vertex
+struct software_mesh
+{
+    aligned_vector<float> x, y, z;
+    std::vector<float> attributes;
+
+    size_t vertex_count = 0;
+    uint64_t hash = 0; // content hash, the deduplication key
+};
+
+/// @brief CPU copy of a texture as RGBA8 texels (R in the low byte), rows bottom to top
+struct software_texture
+{
+    std::vector<uint32_t> texels;
+
+    int width = 0;
+    int height = 0;
+
+    uint64_t hash = 0; // content hash, the deduplication key
+};
+
+// ======= software_assets =======
+
+/// @brief CPU copies of the meshes and textures uploaded to GL, looked up by VAO / texture ID for the software rasterizer
+/// @note Only captures while enabled, so the GL backend pays nothing. Identical uploads share one copy (object_manager
+/// creates a VAO per object even for the same shape). Like GL itself it's meant for the thread that owns the context
+class software_assets
+{
+private:
+    bool capture = false;
+
+    std::unordered_map<unsigned int, std::shared_ptr<const software_mesh>> meshes;
+    std::unordered_map<unsigned int, std::shared_ptr<const software_texture>> textures;
+
+    std::unordered_multimap<uint64_t, std::shared_ptr<const software_mesh>> unique_meshes;
+    std::unordered_multimap<uint64_t, std::shared_ptr<const software_texture>> unique_textures;
+
+    /// @brief FNV-1a over a byte range, chained through seed
+    static uint64_t hash_bytes(const void *data, size_t size, uint64_t seed = 14695981039346656037ull)
+    {
+        const unsigned char *bytes = static_cast<const unsigned char *>(data);
+
+        for (size_t i = 0; i < size; ++i)
+            seed = (seed ^ bytes[i]) * 1099511628211ull;
+
+        return seed;
+    }
+
+    /// @brief Return an identical entry of a content-keyed map, or store and return the new one
+    template <typename Asset>
+    static std::shared_ptr<const Asset> deduplicate(std::unordered_multimap<uint64_t, std::shared_ptr<const Asset>> &unique, uint64_t hash,
+                                                    std::shared_ptr<const Asset> asset, bool (*equal)(const Asset &, const Asset &))
+    {
+        auto range = unique.equal_range(hash);
+
+        for (auto it = range.first; it != range.second; ++it)
+            if (equal(*it->second, *asset))
+                return it->second;
+
+        unique.emplace(hash, asset);
+        return asset;
+    }
+
+    /// @brief Point an ID at a new asset, dropping the old copy if no other ID shares it (e.g. a texture re-uploaded every frame)
+    template <typename Asset>
+    static void replace(std::unordered_multimap<uint64_t, std::shared_ptr<const Asset>> &unique, std::shared_ptr<const Asset> &slot, std::shared_ptr<const Asset> asset)
+    {
+        std::shared_ptr<const Asset> old = std::move(slot);
+        slot = std::move(asset);
+
+        if (!old || old == slot || old.use_count() > 2)
+            return;
+
+        auto range = unique.equal_range(old->hash);
+
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (it->second == old)
+            {
+                unique.erase(it);
+                return;
+            }
+        }
+    }
+
+public:
+    // ======= GETTER =======
+
+    /// @brief Get the process-wide registry
+    /// @return software_assets&
+    static software_assets &get()
+    {
+        static software_assets instance;
+        return instance;
+    }
+
+    // ======= CAPTURE =======
+
+    /// @brief Start or stop copying uploads (vertices_class::create_object, texture_handler::load_pixels)
+    /// @param enabled
+    void set_capture(bool enabled) { capture = enabled; }
+
+    /// @brief If uploads are being copied
+    /// @return bool
+    bool capturing() const { return capture; }
+
+    /// @brief Copy a mesh uploaded with vertices_class::create_object
+    /// @param VAO
+    /// @param vertices: x, y, z per vertex
+    /// @param colors: r, g, b per vertex
+    /// @param texcoords: u, v per vertex (empty: all 0)
+    void add_mesh(unsigned int VAO, const std::vector<float> &vertices, const std::vector<float> &colors, const std::vector<float> &texcoords)
+    {
+        auto mesh = std::make_shared<software_mesh>();
+
+        size_t count = vertices.size() / 3;
+        size_t padded = (count + 7) / 8 * 8;
+
+        mesh->vertex_count = count;
+        mesh->x.assign(padded, 0.0f);
+        mesh->y.assign(padded, 0.0f);
+        mesh->z.assign(padded, 0.0f);
+        mesh->attributes.assign(count * 5, 0.0f);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            mesh->x[i] = vertices[i * 3];
+            mesh->y[i] = vertices[i * 3 + 1];
+            mesh->z[i] = vertices[i * 3 + 2];
+
+            for (size_t c = 0; c < 3 && i * 3 + c < colors.size(); ++c)
+                mesh->attributes[i * 5 + c] = colors[i * 3 + c];
+
+            for (size_t c = 0; c < 2 && i * 2 + c < texcoords.size(); ++c)
+                mesh->attributes[i * 5 + 3 + c] = texcoords[i * 2 + c];
+        }
+
+        uint64_t hash = hash_bytes(vertices.data(), vertices.size() * sizeof(float));
+        mesh->hash = hash = hash_bytes(mesh->attributes.data(), mesh->attributes.size() * sizeof(float), hash);
+
+        replace(unique_meshes, meshes[VAO], deduplicate<software_mesh>(unique_meshes, hash, std::move(mesh), [](const software_mesh &a, const software_mesh &b)
+                                                                       { return a.vertex_count == b.vertex_count && a.x == b.x && a.y == b.y && a.z == b.z && a.attributes == b.attributes; }));
+    }
+
+    /// @brief Copy a texture uploaded with texture_handler::load_pixels
+    /// @param ID: GL texture ID
+    /// @param data: 8-bit pixels, rows bottom to top
+    /// @param width
+    /// @param height
+    /// @param channels: 1, 3 or 4
+    void add_texture(unsigned int ID, const unsigned char *data, int width, int height, int channels)
+    {
+        auto texture = std::make_shared<software_texture>();
+
+        texture->width = width;
+        texture->height = height;
+        texture->texels.resize(static_cast<size_t>(width) * height);
+
+        for (size_t i = 0; i < texture->texels.size(); ++i)
+        {
+            const unsigned char *p = data + i * channels;
+
+            // ======= GL_RED samples as (r, 0, 0, 1), like the GL path =======
+
+            uint32_t r = p[0];
+            uint32_t g = channels >= 3 ? p[1] : 0;
+            uint32_t b = channels >= 3 ? p[2] : 0;
+            uint32_t a = channels == 4 ? p[3] : 255;
+
+            texture->texels[i] = r | (g << 8) | (b << 16) | (a << 24);
+        }
+
+        uint64_t hash = hash_bytes(texture->texels.data(), texture->texels.size() * sizeof(uint32_t), static_cast<uint64_t>(width) * 31 + height);
+        texture->hash = hash;
+
+        replace(unique_textures, textures[ID], deduplicate<software_texture>(unique_textures, hash, std::move(texture), [](const software_texture &a, const software_texture &b)
+                                                                             { return a.width == b.width && a.height == b.height && a.texels == b.texels; }));
+    }
+
+    // ======= LOOKUP =======
+
+    /// @brief Mesh copied for a VAO
+    /// @param VAO
+    /// @return const software_mesh*: nullptr if it was uploaded while capture was off
+    const software_mesh *find_mesh(unsigned int VAO) const
+    {
+        auto it = meshes.find(VAO);
+        return it == meshes.end() ? nullptr : it->second.get();
+    }
+
+    /// @brief Texture copied for a GL texture ID
+    /// @param ID
+    /// @return const software_texture*: nullptr if it was uploaded while capture was off
+    const software_texture *find_texture(unsigned int ID) const
+    {
+        auto it = textures.find(ID);
+        return it == textures.end() ? nullptr : it->second.get();
+    }
+
+    // ======= UTILITY API =======
+
+    /// @brief Distinct mesh copies held (after deduplication)
+    /// @return size_t
+    size_t unique_mesh_count() const { return unique_meshes.size(); }
+
+    /// @brief Distinct texture copies held (after deduplication)
+    /// @return size_t
+    size_t unique_texture_count() const { return unique_textures.size(); }
+
+    /// @brief Drop every copy
+    void clear()
+    {
+        meshes.clear();
+        textures.clear();
+        unique_meshes.clear();
+        unique_textures.clear();
+    }
+};
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "../../helpers/memory/aligned_allocator.hpp"
+
+// ======= software_framebuffer =======
+
+/// @brief CPU color + depth target of the software rasterizer; same layout as a GL framebuffer read back with
+/// glReadPixels (RGBA8, rows bottom to top), depth in [0, 1]
+class software_framebuffer
+{
+private:
+    int width = 0;
+    int height = 0;
+
+    aligned_vector<uint32_t> color; // R in the low byte
+    aligned_vector<float> depth;
+
+public:
+    // ======= STATIC HELPERS =======
+
+    /// @brief Pack a [0, 1] color into an RGBA8 texel
+    /// @param r
+    /// @param g
+    /// @param b
+    /// @param a (default: 1)
+    /// @return uint32_t
+    static uint32_t pack(float r, float g, float b, float a = 1.0f)
+    {
+        auto channel = [](float value)
+        { return static_cast<uint32_t>(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f); };
+
+        return channel(r) | (channel(g) << 8) | (channel(b) << 16) | (channel(a) << 24);
+    }
+
+    // ======= MAIN API =======
+
+    /// @brief Resize the buffers (contents are undefined until the next clear)
+    /// @param new_width
+    /// @param new_height
+    void resize(int new_width, int new_height)
+    {
+        if (new_width == width && new_height == height)
+            return;
+
+        width = std::max(new_width, 0);
+        height = std::max(new_height, 0);
+
+        color.resize(static_cast<size_t>(width) * height);
+        depth.resize(static_cast<size_t>(width) * height);
+    }
+
+    /// @brief Clear color and depth, like screen_class::clear
+    /// @param r
+    /// @param g
+    /// @param b
+    void clear(float r = 0.1f, float g = 0.1f, float b = 0.1f)
+    {
+        std::fill(color.begin(), color.end(), pack(r, g, b));
+        std::fill(depth.begin(), depth.end(), 1.0f);
+    }
+
+    /// @brief Clear depth inside a rectangle (views drawn over another view)
+    /// @param rect: x, y, width, height in pixels
+    void clear_depth(const int rect[4])
+    {
+        int x0 = std::max(rect[0], 0), x1 = std::min(rect[0] + rect[2], width);
+        int y0 = std::max(rect[1], 0), y1 = std::min(rect[1] + rect[3], height);
+
+        for (int y = y0; y < y1; ++y)
+            std::fill(depth.begin() + static_cast<size_t>(y) * width + x0, depth.begin() + static_cast<size_t>(y) * width + std::max(x0, x1), 1.0f);
+    }
+
+    // ======= OUTPUT =======
+
+    /// @brief Copy the color buffer out as bytes
+    /// @param out: RGBA8 pixels, rows bottom to top (screen_class::read_pixels layout)
+    void read_pixels(std::vector<unsigned char> &out) const
+    {
+        out.resize(color.size() * 4);
+
+        for (size_t i = 0; i < color.size(); ++i)
+        {
+            out[i * 4] = color[i] & 0xFF;
+            out[i * 4 + 1] = (color[i] >> 8) & 0xFF;
+            out[i * 4 + 2] = (color[i] >> 16) & 0xFF;
+            out[i * 4 + 3] = color[i] >> 24;
+        }
+    }
+
+    /// @brief Save the color buffer as a binary PPM image
+    /// @param path: Output file path
+    /// @return bool: false if the file could not be opened
+    bool save_ppm(const std::string &path) const
+    {
+        std::ofstream file(path, std::ios::binary);
+
+        if (!file.is_open())
+            return false;
+
+        file << "P6\n"
+             << width << " " << height << "\n255\n";
+
+        std::vector<unsigned char> row(static_cast<size_t>(width) * 3);
+
+        for (int y = height - 1; y >= 0; --y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                uint32_t texel = color[static_cast<size_t>(y) * width + x];
+
+                row[x * 3] = texel & 0xFF;
+                row[x * 3 + 1] = (texel >> 8) & 0xFF;
+                row[x * 3 + 2] = (texel >> 16) & 0xFF;
+            }
+
+            file.write(reinterpret_cast<const char *>(row.data()), row.size());
+        }
+
+        return true;
+    }
+
+    // ======= UTILITY API =======
+
+    /// @brief Width in pixels
+    /// @return int
+    int get_width() const { return width; }
+
+    /// @brief Height in pixels
+    /// @return int
+    int get_height() const { return height; }
+
+    /// @brief Color texels, row-major from the bottom row
+    /// @return uint32_t*
+    uint32_t *color_data() { return color.data(); }
+    const uint32_t *color_data() const { return color.data(); }
+
+    /// @brief Depth values, same layout as color_data()
+    /// @return float*
+    float *depth_data() { return depth.data(); }
+    const float *depth_data() const { return depth.data(); }
+};
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include "./software_framebuffer.hpp"
+#include "../graphics/shaders/shader_class.hpp"
+
+// ======= software_presenter =======
+
+/// @brief Shows a software_framebuffer through GL: uploads it into a texture and draws it over the current viewport
+class software_presenter
+{
+private:
+    shader_class shader;
+
+    unsigned int VAO = 0;
+    unsigned int VBO = 0;
+    unsigned int texture = 0;
+
+    int texture_width = 0;
+    int texture_height = 0;
+
+public:
+    // ======= CONSTRUCTOR =======
+
+    /// @brief Constructor for software_presenter (needs the GL context)
+    /// @param vertexPath: File path for the present vertex code (.glsl)
+    /// @param fragmentPath: File path for the present fragment code (.glsl)
+    software_presenter(const char *vertexPath, const char *fragmentPath)
+        : shader(vertexPath, fragmentPath)
+    {
+        const float corners[] = {
+            -1.0f, -1.0f, 1.0f, -1.0f, 1.0f, 1.0f,
+            -1.0f, -1.0f, 1.0f, 1.0f, -1.0f, 1.0f};
+
+        glGenVertexArrays(1, &VAO);
+        glGenBuffers(1, &VBO);
+
+        glBindVertexArray(VAO);
+
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void *)0);
+        glEnableVertexAttribArray(0);
+
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindVertexArray(0);
+
+        // ======= pixels map 1:1, so no filtering and no mipmaps =======
+
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    }
+
+    // ======= MAIN API =======
+
+    /// @brief Upload a framebuffer and draw it over the current viewport; leaves the present shader bound
+    /// @param frame
+    void render(const software_framebuffer &frame)
+    {
+        if (frame.get_width() == 0 || frame.get_height() == 0)
+            return;
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+        // ======= reallocate only on resize, otherwise overwrite the existing storage =======
+
+        if (frame.get_width() != texture_width || frame.get_height() != texture_height)
+        {
+            texture_width = frame.get_width();
+            texture_height = frame.get_height();
+
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, texture_width, texture_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, frame.color_data());
+        }
+        else
+        {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, texture_width, texture_height, GL_RGBA, GL_UNSIGNED_BYTE, frame.color_data());
+        }
+
+        glDisable(GL_DEPTH_TEST);
+
+        shader.use();
+        shader.set_uniform1i("frame", 0);
+
+        glBindVertexArray(VAO);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+        glBindVertexArray(0);
+
+        glEnable(GL_DEPTH_TEST);
+    }
+
+    /// @brief Destroy the GL objects
+    void destroy()
+    {
+        glDeleteTextures(1, &texture);
+        glDeleteBuffers(1, &VBO);
+        glDeleteVertexArrays(1, &VAO);
+
+        shader.destroy();
+    }
+};
@@ -0,0 +1,556 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "./software_assets.hpp"
+#include "./software_framebuffer.hpp"
+#include "../../helpers/math/simd.hpp"
+#include "../../helpers/memory/aligned_allocator.hpp"
+#include "../../helpers/threading/thread_pool.hpp"
+
+// ======= MACROS =======
+
+#define SOFTWARE_TILE_SIZE 64           // tiles are SOFTWARE_TILE_SIZE x SOFTWARE_TILE_SIZE pixels, one raster task each
+#define SOFTWARE_BATCH_TRIANGLES 262144 // triangles set up before the tiles are drawn and the bins reused
+
+// ======= ENUMS =======
+
+/// @brief Which renderer draws the world
+enum class render_backend
+{
+    gl,       // OpenGL (GPU driver or Mesa)
+    software, // software_rasterizer into a CPU framebuffer, presented through GL afterwards
+};
+
+// ======= STRUCTS =======
+
+/// @brief What the last draw() did
+struct software_raster_stats
+{
+    size_t draws = 0;
+    size_t triangles = 0;  // submitted
+    size_t rasterized = 0; // left after clipping and off-screen rejection
+    size_t batches = 0;
+    size_t missing = 0; // draws skipped because their mesh was uploaded while software_assets wasn't capturing
+};
+
+// ======= software_rasterizer =======
+
+/// @brief Tile-based software renderer for the engine's shading (vertex color x optional texture, depth test GL_LESS)
+/// @note Draws are split into chunks whose vertices are transformed with SIMD, near-clipped, set up and binned into
+/// screen tiles in parallel; then every tile is rasterized by one task, 8 pixels at a time, walking the chunks in
+/// submission order so the result matches GL's draw order. Attributes are perspective-correct; textures are sampled
+/// nearest with GL_REPEAT wrapping (the GL path filters with mipmaps, so minified textures differ slightly)
+class software_rasterizer
+{
+private:
+    struct draw_call
+    {
+        glm::mat4 model;
+
+        const software_mesh *mesh;
+        const software_texture *texture; // nullptr: vertex color only
+
+        size_t vertex_count;
+    };
+
+    struct clip_vertex
+    {
+        glm::vec4 position;
+        float attributes[5]; // r, g, b, u, v
+    };
+
+    /// @brief Screen-space triangle; every interpolated value is a plane a*x + b*y + c over pixel centers
+    struct raster_triangle
+    {
+        float edge[3][3];  // barycentric weight of vertex i, >= 0 inside
+        float plane[7][3]; // depth, 1/w, r/w, g/w, b/w, u/w, v/w
+
+        const software_texture *texture;
+
+        int min_x, min_y, max_x, max_y; // inclusive, clamped to the viewport
+    };
+
+    struct geometry_chunk
+    {
+        aligned_vector<float> clip_x, clip_y, clip_z, clip_w;
+
+        std::vector<raster_triangle> triangles;
+        std::vector<std::vector<uint32_t>> bins; // triangle indices per tile
+    };
+
+    std::vector<draw_call> draws;
+    std::vector<geometry_chunk> chunks;
+
+    int tiles_x = 0;
+    int tiles_y = 0;
+
+    size_t missing = 0;
+
+    software_raster_stats stats;
+
+private:
+    // ======= GEOMETRY =======
+
+    /// @brief Set up a projected triangle and bin it into the tiles it touches
+    void setup_triangle(geometry_chunk &chunk, const clip_vertex *a, const clip_vertex *b, const clip_vertex *c,
+                        const software_texture *texture, const int bounds[4], const int viewport[4])
+    {
+        const clip_vertex *source[3] = {a, b, c};
+
+        float x[3], y[3], value[3][7];
+
+        for (int i = 0; i < 3; ++i)
+        {
+            const clip_vertex &v = *source[i];
+            float inverse_w = 1.0f / v.position.w;
+
+            x[i] = viewport[0] + (v.position.x * inverse_w * 0.5f + 0.5f) * viewport[2];
+            y[i] = viewport[1] + (v.position.y * inverse_w * 0.5f + 0.5f) * viewport[3];
+
+            value[i][0] = v.position.z * inverse_w * 0.5f + 0.5f;
+            value[i][1] = inverse_w;
+
+            for (int k = 0; k < 5; ++k)
+                value[i][2 + k] = v.attributes[k] * inverse_w;
+        }
+
+        float area = (x[2] - x[0]) * (y[1] - y[0]) - (y[2] - y[0]) * (x[1] - x[0]);
+
+        if (std::abs(area) < 1e-8f)
+            return;
+
+        // ======= no face culling (the GL path doesn't enable it), so flip clockwise triangles =======
+
+        if (area < 0.0f)
+        {
+            std::swap(x[1], x[2]);
+            std::swap(y[1], y[2]);
+            std::swap(value[1], value[2]);
+            area = -area;
+        }
+
+        raster_triangle triangle;
+
+        triangle.min_x = std::max(bounds[0], static_cast<int>(std::floor(std::min({x[0], x[1], x[2]}))));
+        triangle.min_y = std::max(bounds[1], static_cast<int>(std::floor(std::min({y[0], y[1], y[2]}))));
+        triangle.max_x = std::min(bounds[2], static_cast<int>(std::floor(std::max({x[0], x[1], x[2]}))));
+        triangle.max_y = std::min(bounds[3], static_cast<int>(std::floor(std::max({y[0], y[1], y[2]}))));
+
+        if (triangle.min_x > triangle.max_x || triangle.min_y > triangle.max_y)
+            return;
+
+        for (int i = 0; i < 3; ++i)
+        {
+            int from = (i + 1) % 3;
+            int to = (i + 2) % 3;
+
+            float edge_a = (y[to] - y[from]) / area;
+            float edge_b = (x[from] - x[to]) / area;
+
+            triangle.edge[i][0] = edge_a;
+            triangle.edge[i][1] = edge_b;
+            triangle.edge[i][2] = -(edge_a * x[from] + edge_b * y[from]);
+        }
+
+        for (int k = 0; k < 7; ++k)
+            for (int axis = 0; axis < 3; ++axis)
+                triangle.plane[k][axis] = triangle.edge[0][axis] * value[0][k] + triangle.edge[1][axis] * value[1][k] + triangle.edge[2][axis] * value[2][k];
+
+        triangle.texture = texture;
+
+        uint32_t index = static_cast<uint32_t>(chunk.triangles.size());
+        chunk.triangles.push_back(triangle);
+
+        for (int ty = triangle.min_y / SOFTWARE_TILE_SIZE; ty <= triangle.max_y / SOFTWARE_TILE_SIZE; ++ty)
+            for (int tx = triangle.min_x / SOFTWARE_TILE_SIZE; tx <= triangle.max_x / SOFTWARE_TILE_SIZE; ++tx)
+                chunk.bins[ty * tiles_x + tx].push_back(index);
+    }
+
+    /// @brief Reject a clip-space triangle outside the view volume, clip it against the near plane (z >= -w) and set it up
+    void add_triangle(geometry_chunk &chunk, const clip_vertex (&vertices)[3], const software_texture *texture, const int bounds[4], const int viewport[4])
+    {
+        // ======= outcodes: all three vertices outside the same plane means nothing is visible =======
+
+        unsigned int common = 0x3F;
+        bool crosses_near = false;
+
+        for (const clip_vertex &v : vertices)
+        {
+            const glm::vec4 &p = v.position;
+
+            unsigned int code = (p.x < -p.w) | (p.x > p.w) << 1 | (p.y < -p.w) << 2 | (p.y > p.w) << 3 | (p.z < -p.w) << 4 | (p.z > p.w) << 5;
+
+            common &= code;
+            crosses_near |= (code & 0x10) != 0;
+        }
+
+        if (common)
+            return;
+
+        if (!crosses_near)
+        {
+            setup_triangle(chunk, &vertices[0], &vertices[1], &vertices[2], texture, bounds, viewport);
+            return;
+        }
+
+        clip_vertex polygon[4];
+        int count = 0;
+
+        for (int i = 0; i < 3; ++i)
+        {
+            const clip_vertex &from = vertices[i];
+            const clip_vertex &to = vertices[(i + 1) % 3];
+
+            float from_distance = from.position.z + from.position.w;
+            float to_distance = to.position.z + to.position.w;
+
+            if (from_distance >= 0.0f)
+                polygon[count++] = from;
+
+            if ((from_distance >= 0.0f) != (to_distance >= 0.0f))
+            {
+                float t = from_distance / (from_distance - to_distance);
+                clip_vertex &out = polygon[count++];
+
+                out.position = from.position + (to.position - from.position) * t;
+
+                for (int k = 0; k < 5; ++k)
+                    out.attributes[k] = from.attributes[k] + (to.attributes[k] - from.attributes[k]) * t;
+            }
+        }
+
+        if (count >= 3)
+            setup_triangle(chunk, &polygon[0], &polygon[1], &polygon[2], texture, bounds, viewport);
+
+        if (count == 4)
+            setup_triangle(chunk, &polygon[0], &polygon[2], &polygon[3], texture, bounds, viewport);
+    }
+
+    /// @brief Transform a draw's vertices 8 at a time and emit its triangles
+    void process_draw(geometry_chunk &chunk, const draw_call &draw, const glm::mat4 &view_projection, const int bounds[4], const int viewport[4])
+    {
+        const software_mesh &mesh = *draw.mesh;
+        const glm::mat4 m = view_projection * draw.model;
+
+        size_t padded = mesh.x.size();
+
+        if (chunk.clip_x.size() < padded)
+        {
+            chunk.clip_x.resize(padded);
+            chunk.clip_y.resize(padded);
+            chunk.clip_z.resize(padded);
+            chunk.clip_w.resize(padded);
+        }
+
+        simd_float row[4][4];
+
+        for (int k = 0; k < 4; ++k)
+            for (int c = 0; c < 4; ++c)
+                row[k][c] = simd_float::set1(m[c][k]);
+
+        float *out[4] = {chunk.clip_x.data(), chunk.clip_y.data(), chunk.clip_z.data(), chunk.clip_w.data()};
+
+        for (size_t i = 0; i < padded; i += simd_float::width)
+        {
+            simd_float x = simd_float::load(&mesh.x[i]);
+            simd_float y = simd_float::load(&mesh.y[i]);
+            simd_float z = simd_float::load(&mesh.z[i]);
+
+            for (int k = 0; k < 4; ++k)
+                (row[k][0] * x + row[k][1] * y + row[k][2] * z + row[k][3]).store(out[k] + i);
+        }
+
+        for (size_t first = 0; first + 2 < draw.vertex_count; first += 3)
+        {
+            clip_vertex vertices[3];
+
+            for (int corner = 0; corner < 3; ++corner)
+            {
+                size_t i = first + corner;
+
+                vertices[corner].position = {out[0][i], out[1][i], out[2][i], out[3][i]};
+                std::copy_n(&mesh.attributes[i * 5], 5, vertices[corner].attributes);
+            }
+
+            add_triangle(chunk, vertices, draw.texture, bounds, viewport);
+        }
+    }
+
+    // ======= RASTERIZATION =======
+
+    /// @brief Nearest texel with GL_REPEAT wrapping
+    static uint32_t sample(const software_texture &texture, float u, float v)
+    {
+        u -= std::floor(u);
+        v -= std::floor(v);
+
+        int x = std::min(static_cast<int>(u * texture.width), texture.width - 1);
+        int y = std::min(static_cast<int>(v * texture.height), texture.height - 1);
+
+        return texture.texels[static_cast<size_t>(y) * texture.width + x];
+    }
+
+    /// @brief Rasterize one triangle inside one tile
+    void rasterize(software_framebuffer &target, const raster_triangle &t, int tile_x0, int tile_y0, int tile_x1, int tile_y1) const
+    {
+        const int width = simd_float::width;
+        const int framebuffer_width = target.get_width();
+
+        int x_first = std::max(t.min_x, tile_x0);
+        int x_last = std::min(t.max_x, tile_x1);
+        int y_first = std::max(t.min_y, tile_y0);
+        int y_last = std::min(t.max_y, tile_y1);
+
+        // ======= tiles start on a multiple of the SIMD width, so aligned groups never leave the tile =======
+
+        int x_begin = tile_x0 + (x_first - tile_x0) / width * width;
+
+        alignas(32) float lane_offsets[simd_float::width];
+
+        for (int lane = 0; lane < width; ++lane)
+            lane_offsets[lane] = lane + 0.5f;
+
+        const simd_float lanes = simd_float::load(lane_offsets);
+        const simd_float zero = simd_float::zero();
+        const simd_float one = simd_float::set1(1.0f);
+        const simd_float low = simd_float::set1(static_cast<float>(x_first));
+        const simd_float high = simd_float::set1(static_cast<float>(x_last + 1));
+
+        simd_float edge_a[3], plane_a[7];
+
+        for (int i = 0; i < 3; ++i)
+            edge_a[i] = simd_float::set1(t.edge[i][0]);
+
+        for (int k = 0; k < 7; ++k)
+            plane_a[k] = simd_float::set1(t.plane[k][0]);
+
+        uint32_t *color = target.color_data();
+        float *depth = target.depth_data();
+
+        alignas(32) float old_depth[simd_float::width], new_depth[simd_float::width];
+        alignas(32) float r[simd_float::width], g[simd_float::width], b[simd_float::width];
+        alignas(32) float u[simd_float::width], v[simd_float::width];
+
+        for (int y = y_first; y <= y_last; ++y)
+        {
+            float center_y = y + 0.5f;
+
+            simd_float edge_row[3], plane_row[7];
+
+            for (int i = 0; i < 3; ++i)
+                edge_row[i] = simd_float::set1(t.edge[i][1] * center_y + t.edge[i][2]);
+
+            for (int k = 0; k < 7; ++k)
+                plane_row[k] = simd_float::set1(t.plane[k][1] * center_y + t.plane[k][2]);
+
+            size_t row = static_cast<size_t>(y) * framebuffer_width;
+
+            for (int x = x_begin; x <= x_last; x += width)
+            {
+                simd_float px = simd_float::set1(static_cast<float>(x)) + lanes;
+
+                simd_float outside = simd_float::either(simd_float::less(px, low), simd_float::greater(px, high));
+
+                for (int i = 0; i < 3; ++i)
+                    outside = simd_float::either(outside, simd_float::less(edge_a[i] * px + edge_row[i], zero));
+
+                if (simd_float::movemask(outside) == (1 << width) - 1)
+                    continue;
+
+                // ======= the last group of a row can hang over the framebuffer's right edge =======
+
+                int valid = std::min(width, framebuffer_width - x);
+
+                for (int lane = 0; lane < width; ++lane)
+                    old_depth[lane] = lane < valid ? depth[row + x + lane] : 0.0f;
+
+                simd_float z = plane_a[0] * px + plane_row[0];
+
+                outside = simd_float::either(outside, simd_float::either(simd_float::less(z, zero), simd_float::greater(z, one)));
+
+                // ======= depth test GL_LESS =======
+
+                int passed = simd_float::movemask(simd_float::less(z, simd_float::load(old_depth)));
+                int covered = ~simd_float::movemask(outside) & passed & ((1 << valid) - 1);
+
+                if (!covered)
+                    continue;
+
+                // ======= perspective-correct attributes: interpolate a / w and 1 / w, then divide =======
+
+                simd_float w = one / (plane_a[1] * px + plane_row[1]);
+
+                z.store(new_depth);
+                ((plane_a[2] * px + plane_row[2]) * w).store(r);
+                ((plane_a[3] * px + plane_row[3]) * w).store(g);
+                ((plane_a[4] * px + plane_row[4]) * w).store(b);
+
+                if (t.texture)
+                {
+                    ((plane_a[5] * px + plane_row[5]) * w).store(u);
+                    ((plane_a[6] * px + plane_row[6]) * w).store(v);
+                }
+
+                for (; covered; covered &= covered - 1)
+                {
+                    int lane = __builtin_ctz(covered);
+                    size_t pixel = row + x + lane;
+
+                    depth[pixel] = new_depth[lane];
+
+                    if (t.texture)
+                    {
+                        uint32_t texel = sample(*t.texture, u[lane], v[lane]);
+
+                        color[pixel] = software_framebuffer::pack(r[lane] * (texel & 0xFF) * (1.0f / 255.0f),
+                                                                  g[lane] * ((texel >> 8) & 0xFF) * (1.0f / 255.0f),
+                                                                  b[lane] * ((texel >> 16) & 0xFF) * (1.0f / 255.0f),
+                                                                  (texel >> 24) * (1.0f / 255.0f));
+                    }
+                    else
+                    {
+                        color[pixel] = software_framebuffer::pack(r[lane], g[lane], b[lane]);
+                    }
+                }
+            }
+        }
+    }
+
+    /// @brief Rasterize every binned triangle of a tile, chunk by chunk in submission order
+    void rasterize_tile(software_framebuffer &target, int tile, size_t chunk_count) const
+    {
+        int tile_x0 = (tile % tiles_x) * SOFTWARE_TILE_SIZE;
+        int tile_y0 = (tile / tiles_x) * SOFTWARE_TILE_SIZE;
+        int tile_x1 = std::min(tile_x0 + SOFTWARE_TILE_SIZE, target.get_width()) - 1;
+        int tile_y1 = std::min(tile_y0 + SOFTWARE_TILE_SIZE, target.get_height()) - 1;
+
+        for (size_t c = 0; c < chunk_count; ++c)
+            for (uint32_t index : chunks[c].bins[tile])
+                rasterize(target, chunks[c].triangles[index], tile_x0, tile_y0, tile_x1, tile_y1);
+    }
+
+    /// @brief Set up and rasterize draws [first, last)
+    void run_batch(software_framebuffer &target, const glm::mat4 &view_projection, const int bounds[4], const int viewport[4],
+                   size_t first, size_t last, size_t chunk_count, thread_pool &pool)
+    {
+        size_t used = std::min(chunk_count, last - first);
+
+        for (size_t c = 0; c < used; ++c)
+        {
+            chunks[c].triangles.clear();
+
+            for (std::vector<uint32_t> &bin : chunks[c].bins)
+                bin.clear();
+        }
+
+        pool.parallel_for(0, used, 1, [&](size_t begin, size_t end)
+                          {
+                              for (size_t c = begin; c < end; ++c)
+                                  for (size_t d = first + (last - first) * c / used; d < first + (last - first) * (c + 1) / used; ++d)
+                                      process_draw(chunks[c], draws[d], view_projection, bounds, viewport);
+                          });
+
+        pool.parallel_for(0, static_cast<size_t>(tiles_x) * tiles_y, 1, [&](size_t begin, size_t end)
+                          {
+                              for (size_t tile = begin; tile < end; ++tile)
+                                  rasterize_tile(target, static_cast<int>(tile), used);
+                          });
+
+        for (size_t c = 0; c < used; ++c)
+            stats.rasterized += chunks[c].triangles.size();
+
+        ++stats.batches;
+    }
+
+public:
+    // ======= MAIN API =======
+
+    /// @brief Queue a draw, the software twin of object_interface::render
+    /// @param model: Model matrix
+    /// @param VAO: Mesh::VAO (looked up in software_assets)
+    /// @param vertexCount: Mesh::vertexCount
+    /// @param textureID: GL texture ID (looked up in software_assets)
+    /// @param textured: Multiply the vertex color with the texture
+    void submit(const glm::mat4 &model, unsigned int VAO, int vertexCount, unsigned int textureID, bool textured)
+    {
+        const software_assets &assets = software_assets::get();
+        const software_mesh *mesh = assets.find_mesh(VAO);
+
+        if (!mesh)
+        {
+            ++missing;
+            return;
+        }
+
+        size_t count = std::min(static_cast<size_t>(std::max(vertexCount, 0)), mesh->vertex_count);
+
+        draws.push_back({model, mesh, textured ? assets.find_texture(textureID) : nullptr, count});
+    }
+
+    /// @brief Rasterize every queued draw into a framebuffer, then empty the queue
+    /// @param target: Cleared by the caller
+    /// @param view_projection: projection * view
+    /// @param viewport: x, y, width, height in pixels (like glViewport)
+    /// @param pool: Geometry chunks and tiles are split across it (default: thread_pool::shared())
+    void draw(software_framebuffer &target, const glm::mat4 &view_projection, const int viewport[4], thread_pool &pool = thread_pool::shared())
+    {
+        stats = {};
+        stats.draws = draws.size();
+        stats.missing = missing;
+
+        missing = 0;
+
+        for (const draw_call &call : draws)
+            stats.triangles += call.vertex_count / 3;
+
+        int bounds[4] = {std::max(viewport[0], 0), std::max(viewport[1], 0),
+                         std::min(viewport[0] + viewport[2], target.get_width()) - 1,
+                         std::min(viewport[1] + viewport[3], target.get_height()) - 1};
+
+        if (draws.empty() || bounds[0] > bounds[2] || bounds[1] > bounds[3])
+        {
+            draws.clear();
+            return;
+        }
+
+        tiles_x = (target.get_width() + SOFTWARE_TILE_SIZE - 1) / SOFTWARE_TILE_SIZE;
+        tiles_y = (target.get_height() + SOFTWARE_TILE_SIZE - 1) / SOFTWARE_TILE_SIZE;
+
+        size_t chunk_count = (pool.size() + 1) * 4;
+
+        if (chunks.size() < chunk_count)
+            chunks.resize(chunk_count);
+
+        for (geometry_chunk &chunk : chunks)
+            chunk.bins.resize(static_cast<size_t>(tiles_x) * tiles_y);
+
+        // ======= batches keep the setup data bounded; each one is fully drawn before the next, so order holds =======
+
+        for (size_t first = 0; first < draws.size();)
+        {
+            size_t last = first;
+            size_t triangles = 0;
+
+            while (last < draws.size() && (last == first || triangles + draws[last].vertex_count / 3 <= SOFTWARE_BATCH_TRIANGLES))
+                triangles += draws[last++].vertex_count / 3;
+
+            run_batch(target, view_projection, bounds, viewport, first, last, chunk_count, pool);
+
+            first = last;
+        }
+
+        draws.clear();
+    }
+
+    // ======= UTILITY API =======
+
+    /// @brief Statistics of the last draw()
+    /// @return const software_raster_stats&
+    const software_raster_stats &get_stats() const { return stats; }
+};
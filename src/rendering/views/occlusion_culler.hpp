@@ -0,0 +1,634 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "./view_culler.hpp"
+#include "../objects/modifying/object_interface.hpp"
+#include "../../helpers/math/simd.hpp"
+#include "../../helpers/memory/aligned_allocator.hpp"
+#include "../../helpers/threading/thread_pool.hpp"
+
+// ======= MACROS =======
+
+#define OCCLUSION_WIDTH 256       // depth buffer width in pixels
+#define OCCLUSION_HEIGHT 128      // depth buffer height in pixels
+#define OCCLUSION_TILE_WIDTH 64   // one rasterization task per tile; multiple of the SIMD width
+#define OCCLUSION_TILE_HEIGHT 32  // the buffer has to be a whole number of tiles
+#define OCCLUSION_TEST_GRAIN 2048 // objects per occlusion test task
+
+// ======= STRUCTS =======
+
+/// @brief Simplified occluder geometry in object space, 3 vertices per triangle, counter-clockwise seen from outside
+/// @note Has to stay inside the real mesh, otherwise it hides objects that are actually visible
+struct occluder_mesh
+{
+    std::vector<glm::vec3> triangles;
+
+    bool two_sided = false; // rasterize back faces too (open meshes such as a single wall quad)
+
+    /// @brief Closed box around the origin (object_lib::cube() is a box with half extent 0.5)
+    /// @param half_extent
+    /// @return occluder_mesh
+    static occluder_mesh box(const glm::vec3 &half_extent = glm::vec3(0.5f))
+    {
+        const glm::vec3 &h = half_extent;
+
+        glm::vec3 corners[8];
+
+        for (int i = 0; i < 8; ++i)
+            corners[i] = {(i & 1) ? h.x : -h.x, (i & 2) ? h.y : -h.y, (i & 4) ? h.z : -h.z};
+
+        const int faces[6][4] = {{0, 1, 3, 2}, {4, 6, 7, 5}, {0, 4, 5, 1}, {2, 3, 7, 6}, {0, 2, 6, 4}, {1, 5, 7, 3}};
+
+        occluder_mesh mesh;
+        mesh.triangles.reserve(36);
+
+        for (const auto &face : faces)
+            for (int corner : {0, 2, 1, 0, 3, 2})
+                mesh.triangles.push_back(corners[face[corner]]);
+
+        return mesh;
+    }
+};
+
+/// @brief What the last occlusion pass did
+struct occlusion_stats
+{
+    size_t occluders = 0; // occluders inside the view frustum
+    size_t triangles = 0; // occluder triangles rasterized after clipping
+    size_t tested = 0;    // objects tested against the Hi-Z pyramid
+    size_t occluded = 0;  // objects hidden from the view
+};
+
+// ======= occlusion_culler =======
+
+/// @brief Software hierarchical-Z occlusion culling for one view
+/// @note Occluder meshes are rasterized into a small depth buffer (tiles in parallel, SIMD along rows), reduced into a
+/// max-depth pyramid, and then the screen rectangle of every object still visible after frustum culling is tested
+/// against the pyramid level where it covers at most 2x2 texels. Depth is NDC z mapped to [0, 1], cleared to 1 (far)
+class occlusion_culler
+{
+private:
+    struct occluder
+    {
+        size_t object_id;
+        occluder_mesh mesh;
+    };
+
+    /// @brief A clipped screen-space triangle ready for rasterization: edge functions a*x + b*y + c >= 0 inside,
+    /// depth as a plane over the screen
+    struct raster_triangle
+    {
+        float edge[3][3];
+        float depth[3];
+
+        int min_x, min_y, max_x, max_y; // pixel bounds, inclusive, clamped to the buffer
+    };
+
+    static constexpr int tiles_x = OCCLUSION_WIDTH / OCCLUSION_TILE_WIDTH;
+    static constexpr int tiles_y = OCCLUSION_HEIGHT / OCCLUSION_TILE_HEIGHT;
+
+    static_assert(OCCLUSION_WIDTH % OCCLUSION_TILE_WIDTH == 0 && OCCLUSION_HEIGHT % OCCLUSION_TILE_HEIGHT == 0, "occlusion_culler: The buffer has to be a whole number of tiles");
+    static_assert(OCCLUSION_TILE_WIDTH % simd_float::width == 0, "occlusion_culler: Tile rows have to be a whole number of SIMD lanes");
+
+    std::vector<occluder> occluders;
+
+    std::vector<raster_triangle> triangles;
+    std::vector<uint32_t> bins[tiles_x * tiles_y];
+
+    aligned_vector<float> pyramid; // every level back to back, level 0 is the full resolution buffer
+    std::vector<size_t> level_offset;
+    std::vector<int> level_width;
+    std::vector<int> level_height;
+
+    occlusion_stats stats;
+
+private:
+    // ======= SETUP =======
+
+    /// @brief Clip a clip-space triangle against the near plane (z >= -w), project it and bin it into tiles
+    void add_triangle(const glm::vec4 &a, const glm::vec4 &b, const glm::vec4 &c, bool two_sided)
+    {
+        const glm::vec4 input[3] = {a, b, c};
+
+        glm::vec4 polygon[4];
+        int count = 0;
+
+        for (int i = 0; i < 3; ++i)
+        {
+            const glm::vec4 &from = input[i];
+            const glm::vec4 &to = input[(i + 1) % 3];
+
+            float from_distance = from.z + from.w;
+            float to_distance = to.z + to.w;
+
+            if (from_distance >= 0.0f)
+                polygon[count++] = from;
+
+            if ((from_distance >= 0.0f) != (to_distance >= 0.0f))
+                polygon[count++] = from + (to - from) * (from_distance / (from_distance - to_distance));
+        }
+
+        if (count < 3)
+            return;
+
+        glm::vec3 screen[4];
+
+        for (int i = 0; i < count; ++i)
+        {
+            float inverse_w = 1.0f / polygon[i].w;
+
+            screen[i] = {(polygon[i].x * inverse_w * 0.5f + 0.5f) * OCCLUSION_WIDTH,
+                         (polygon[i].y * inverse_w * 0.5f + 0.5f) * OCCLUSION_HEIGHT,
+                         polygon[i].z * inverse_w * 0.5f + 0.5f};
+        }
+
+        add_screen_triangle(screen[0], screen[1], screen[2], two_sided);
+
+        if (count == 4)
+            add_screen_triangle(screen[0], screen[2], screen[3], two_sided);
+    }
+
+    /// @brief Set up edge and depth planes of a projected triangle and bin it; back faces are dropped unless two_sided
+    void add_screen_triangle(glm::vec3 v0, glm::vec3 v1, glm::vec3 v2, bool two_sided)
+    {
+        // ======= counter-clockwise on screen (front facing) gives a negative area here =======
+
+        float area = (v2.x - v0.x) * (v1.y - v0.y) - (v2.y - v0.y) * (v1.x - v0.x);
+
+        if (std::abs(area) < 1e-6f || (area > 0.0f && !two_sided))
+            return;
+
+        if (area < 0.0f)
+        {
+            std::swap(v1, v2);
+            area = -area;
+        }
+
+        float min_x = std::min({v0.x, v1.x, v2.x});
+        float max_x = std::max({v0.x, v1.x, v2.x});
+        float min_y = std::min({v0.y, v1.y, v2.y});
+        float max_y = std::max({v0.y, v1.y, v2.y});
+
+        if (max_x < 0.0f || max_y < 0.0f || min_x >= OCCLUSION_WIDTH || min_y >= OCCLUSION_HEIGHT)
+            return;
+
+        raster_triangle triangle;
+
+        triangle.min_x = std::max(0, static_cast<int>(std::floor(min_x)));
+        triangle.min_y = std::max(0, static_cast<int>(std::floor(min_y)));
+        triangle.max_x = std::min(OCCLUSION_WIDTH - 1, static_cast<int>(std::floor(max_x)));
+        triangle.max_y = std::min(OCCLUSION_HEIGHT - 1, static_cast<int>(std::floor(max_y)));
+
+        // ======= edge i is opposite vertex i, so its value at a pixel is that vertex's (unnormalized) barycentric =======
+
+        const glm::vec3 *v[3] = {&v0, &v1, &v2};
+
+        for (int i = 0; i < 3; ++i)
+        {
+            const glm::vec3 &from = *v[(i + 1) % 3];
+            const glm::vec3 &to = *v[(i + 2) % 3];
+
+            float a = to.y - from.y;
+            float b = from.x - to.x;
+
+            triangle.edge[i][0] = a;
+            triangle.edge[i][1] = b;
+            triangle.edge[i][2] = -(a * from.x + b * from.y);
+        }
+
+        for (int axis = 0; axis < 3; ++axis)
+            triangle.depth[axis] = (triangle.edge[0][axis] * v0.z + triangle.edge[1][axis] * v1.z + triangle.edge[2][axis] * v2.z) / area;
+
+        uint32_t index = static_cast<uint32_t>(triangles.size());
+        triangles.push_back(triangle);
+
+        for (int ty = triangle.min_y / OCCLUSION_TILE_HEIGHT; ty <= triangle.max_y / OCCLUSION_TILE_HEIGHT; ++ty)
+            for (int tx = triangle.min_x / OCCLUSION_TILE_WIDTH; tx <= triangle.max_x / OCCLUSION_TILE_WIDTH; ++tx)
+                bins[ty * tiles_x + tx].push_back(index);
+    }
+
+    // ======= RASTERIZATION =======
+
+    /// @brief Clear one tile and rasterize its binned triangles, keeping the nearest depth per pixel
+    void rasterize_tile(int tile)
+    {
+        const int tile_x = (tile % tiles_x) * OCCLUSION_TILE_WIDTH;
+        const int tile_y = (tile / tiles_x) * OCCLUSION_TILE_HEIGHT;
+
+        float *depth = pyramid.data();
+
+        for (int y = tile_y; y < tile_y + OCCLUSION_TILE_HEIGHT; ++y)
+            std::fill_n(depth + y * OCCLUSION_WIDTH + tile_x, OCCLUSION_TILE_WIDTH, 1.0f);
+
+        alignas(32) float lane_offsets[simd_float::width];
+
+        for (int lane = 0; lane < simd_float::width; ++lane)
+            lane_offsets[lane] = lane + 0.5f;
+
+        const simd_float lanes = simd_float::load(lane_offsets);
+        const simd_float zero = simd_float::zero();
+
+        for (uint32_t index : bins[tile])
+        {
+            const raster_triangle &t = triangles[index];
+
+            int x_begin = std::max(t.min_x, tile_x) / simd_float::width * simd_float::width;
+            int x_end = std::min(t.max_x, tile_x + OCCLUSION_TILE_WIDTH - 1);
+            int y_begin = std::max(t.min_y, tile_y);
+            int y_end = std::min(t.max_y, tile_y + OCCLUSION_TILE_HEIGHT - 1);
+
+            const simd_float a0 = simd_float::set1(t.edge[0][0]), a1 = simd_float::set1(t.edge[1][0]), a2 = simd_float::set1(t.edge[2][0]);
+            const simd_float depth_a = simd_float::set1(t.depth[0]);
+
+            for (int y = y_begin; y <= y_end; ++y)
+            {
+                float center_y = y + 0.5f;
+
+                // ======= row constants: everything but the x term =======
+
+                simd_float row0 = simd_float::set1(t.edge[0][1] * center_y + t.edge[0][2]);
+                simd_float row1 = simd_float::set1(t.edge[1][1] * center_y + t.edge[1][2]);
+                simd_float row2 = simd_float::set1(t.edge[2][1] * center_y + t.edge[2][2]);
+                simd_float row_depth = simd_float::set1(t.depth[1] * center_y + t.depth[2]);
+
+                float *row = depth + y * OCCLUSION_WIDTH;
+
+                for (int x = x_begin; x <= x_end; x += simd_float::width)
+                {
+                    simd_float px = simd_float::set1(static_cast<float>(x)) + lanes;
+
+                    simd_float outside = simd_float::either(simd_float::less(a0 * px + row0, zero),
+                                                            simd_float::either(simd_float::less(a1 * px + row1, zero),
+                                                                               simd_float::less(a2 * px + row2, zero)));
+
+                    if (simd_float::movemask(outside) == (1 << simd_float::width) - 1)
+                        continue;
+
+                    simd_float old = simd_float::load(row + x);
+                    simd_float nearest = simd_float::min(old, depth_a * px + row_depth);
+
+                    simd_float::select(outside, old, nearest).store(row + x);
+                }
+            }
+        }
+    }
+
+    /// @brief Reduce level 0 into coarser levels, each texel the farthest depth of the 2x2 (or edge) texels under it
+    void build_pyramid()
+    {
+        for (size_t level = 1; level < level_offset.size(); ++level)
+        {
+            const float *source = pyramid.data() + level_offset[level - 1];
+            float *target = pyramid.data() + level_offset[level];
+
+            int source_width = level_width[level - 1];
+            int source_height = level_height[level - 1];
+
+            for (int y = 0; y < level_height[level]; ++y)
+            {
+                int y0 = y * 2;
+                int y1 = std::min(y0 + 1, source_height - 1);
+
+                for (int x = 0; x < level_width[level]; ++x)
+                {
+                    int x0 = x * 2;
+                    int x1 = std::min(x0 + 1, source_width - 1);
+
+                    target[y * level_width[level] + x] = std::max(std::max(source[y0 * source_width + x0], source[y0 * source_width + x1]),
+                                                                  std::max(source[y1 * source_width + x0], source[y1 * source_width + x1]));
+                }
+            }
+        }
+    }
+
+    // ======= TESTING =======
+
+    /// @brief Farthest occluder depth over a pixel rectangle, read from the level where it spans at most 2x2 texels
+    float farthest_depth(int min_x, int min_y, int max_x, int max_y) const
+    {
+        size_t level = 0;
+
+        while (level + 1 < level_offset.size() && ((max_x >> level) - (min_x >> level) > 1 || (max_y >> level) - (min_y >> level) > 1))
+            ++level;
+
+        const float *texels = pyramid.data() + level_offset[level];
+        int width = level_width[level];
+
+        float farthest = 0.0f;
+
+        for (int y = min_y >> level; y <= max_y >> level; ++y)
+            for (int x = min_x >> level; x <= max_x >> level; ++x)
+                farthest = std::max(farthest, texels[y * width + x]);
+
+        return farthest;
+    }
+
+    /// @brief Test the objects of blocks [first_block, last_block) still visible in the view; returns how many got hidden
+    size_t test_blocks(view_culler &culler, const view_cull_spheres &spheres, const glm::mat4 &view_projection, uint32_t view_id,
+                       size_t first_block, size_t last_block, size_t &tested) const
+    {
+        const size_t width = simd_float::width;
+        const glm::mat4 &m = view_projection;
+        const std::vector<uint32_t> &masks = culler.get_masks();
+
+        simd_float row[4][4];
+
+        for (int k = 0; k < 4; ++k)
+            for (int c = 0; c < 4; ++c)
+                row[k][c] = simd_float::set1(m[c][k]);
+
+        const simd_float one = simd_float::set1(1.0f);
+        const simd_float half = simd_float::set1(0.5f);
+        const simd_float buffer_width = simd_float::set1(OCCLUSION_WIDTH);
+        const simd_float buffer_height = simd_float::set1(OCCLUSION_HEIGHT);
+        const simd_float last_x = simd_float::set1(OCCLUSION_WIDTH - 1);
+        const simd_float last_y = simd_float::set1(OCCLUSION_HEIGHT - 1);
+
+        size_t occluded = 0;
+
+        for (size_t block = first_block; block < last_block; ++block)
+        {
+            size_t begin = block * width;
+            size_t end = std::min(begin + width, spheres.count);
+
+            bool any = false;
+
+            for (size_t i = begin; i < end; ++i)
+                any |= (masks[i] >> view_id) & 1u;
+
+            if (!any)
+                continue;
+
+            // ======= project the 8 corners of every lane's sphere box at once =======
+
+            simd_float cx = simd_float::load(spheres.x + begin);
+            simd_float cy = simd_float::load(spheres.y + begin);
+            simd_float cz = simd_float::load(spheres.z + begin);
+            simd_float r = simd_float::load(spheres.radius + begin);
+
+            simd_float min_x = simd_float::set1(FLT_MAX), max_x = simd_float::set1(-FLT_MAX);
+            simd_float min_y = simd_float::set1(FLT_MAX), max_y = simd_float::set1(-FLT_MAX);
+            simd_float min_z = simd_float::set1(FLT_MAX), min_w = simd_float::set1(FLT_MAX);
+
+            for (int corner = 0; corner < 8; ++corner)
+            {
+                simd_float x = (corner & 1) ? cx + r : cx - r;
+                simd_float y = (corner & 2) ? cy + r : cy - r;
+                simd_float z = (corner & 4) ? cz + r : cz - r;
+
+                simd_float clip[4];
+
+                for (int k = 0; k < 4; ++k)
+                    clip[k] = row[k][0] * x + row[k][1] * y + row[k][2] * z + row[k][3];
+
+                simd_float inverse_w = one / clip[3];
+
+                min_w = simd_float::min(min_w, clip[3]);
+                min_x = simd_float::min(min_x, clip[0] * inverse_w);
+                max_x = simd_float::max(max_x, clip[0] * inverse_w);
+                min_y = simd_float::min(min_y, clip[1] * inverse_w);
+                max_y = simd_float::max(max_y, clip[1] * inverse_w);
+                min_z = simd_float::min(min_z, clip[2] * inverse_w);
+            }
+
+            // ======= NDC to clamped pixel bounds and [0, 1] depth, still 8 lanes at a time =======
+
+            alignas(32) float lane_x0[simd_float::width], lane_x1[simd_float::width];
+            alignas(32) float lane_y0[simd_float::width], lane_y1[simd_float::width];
+            alignas(32) float lane_depth[simd_float::width], lane_w[simd_float::width];
+
+            simd_float::max(simd_float::zero(), (min_x * half + half) * buffer_width).store(lane_x0);
+            simd_float::min(last_x, (max_x * half + half) * buffer_width).store(lane_x1);
+            simd_float::max(simd_float::zero(), (min_y * half + half) * buffer_height).store(lane_y0);
+            simd_float::min(last_y, (max_y * half + half) * buffer_height).store(lane_y1);
+            (min_z * half + half).store(lane_depth);
+            min_w.store(lane_w);
+
+            for (size_t i = begin; i < end; ++i)
+            {
+                size_t lane = i - begin;
+
+                // ======= unknown bounds and boxes reaching behind the camera stay visible =======
+
+                if (!((masks[i] >> view_id) & 1u) || spheres.radius[i] == FLT_MAX || lane_w[lane] <= 1e-5f)
+                    continue;
+
+                ++tested;
+
+                int x0 = static_cast<int>(lane_x0[lane]);
+                int x1 = static_cast<int>(std::floor(lane_x1[lane]));
+                int y0 = static_cast<int>(lane_y0[lane]);
+                int y1 = static_cast<int>(std::floor(lane_y1[lane]));
+
+                if (x0 > x1 || y0 > y1)
+                    continue;
+
+                if (lane_depth[lane] > farthest_depth(x0, y0, x1, y1))
+                {
+                    culler.hide(i, view_id);
+                    ++occluded;
+                }
+            }
+        }
+
+        return occluded;
+    }
+
+public:
+    // ======= CONSTRUCTOR =======
+
+    /// @brief Constructor for occlusion_culler; lays out the depth pyramid
+    occlusion_culler()
+    {
+        size_t offset = 0;
+        int width = OCCLUSION_WIDTH;
+        int height = OCCLUSION_HEIGHT;
+
+        while (true)
+        {
+            level_offset.push_back(offset);
+            level_width.push_back(width);
+            level_height.push_back(height);
+
+            offset += static_cast<size_t>(width) * height;
+
+            if (width == 1 && height == 1)
+                break;
+
+            width = std::max(1, (width + 1) / 2);
+            height = std::max(1, (height + 1) / 2);
+        }
+
+        pyramid.assign(offset, 1.0f);
+    }
+
+    // ======= OCCLUDER API =======
+
+    /// @brief Make an object an occluder (replaces its occluder mesh if it already is one)
+    /// @param object_id
+    /// @param mesh: Object space occluder geometry, transformed by the object's model matrix every frame
+    void add_occluder(size_t object_id, const occluder_mesh &mesh)
+    {
+        for (occluder &entry : occluders)
+        {
+            if (entry.object_id == object_id)
+            {
+                entry.mesh = mesh;
+                return;
+            }
+        }
+
+        occluders.push_back({object_id, mesh});
+    }
+
+    /// @brief Stop an object from occluding
+    /// @param object_id
+    void remove_occluder(size_t object_id)
+    {
+        occluders.erase(std::remove_if(occluders.begin(), occluders.end(), [object_id](const occluder &entry)
+                                       { return entry.object_id == object_id; }),
+                        occluders.end());
+    }
+
+    /// @brief Keep object IDs in sync after object_manager::delete_object (later IDs shift down by one)
+    /// @param object_id
+    void object_deleted(size_t object_id)
+    {
+        remove_occluder(object_id);
+
+        for (occluder &entry : occluders)
+            if (entry.object_id > object_id)
+                --entry.object_id;
+    }
+
+    /// @brief Drop every occluder
+    void clear() { occluders.clear(); }
+
+    // ======= MAIN API =======
+
+    /// @brief Rasterize the occluders visible in a view and hide the objects they cover from the culler's masks
+    /// @param objects
+    /// @param view_projection: The view's projection * view
+    /// @param culler: Must have culled this frame's objects already; its spheres are reused and its masks updated
+    /// @param view_id
+    /// @param pool: Tiles and tests are split across it (default: thread_pool::shared())
+    void cull(const std::vector<object_interface> &objects, const glm::mat4 &view_projection, view_culler &culler, uint32_t view_id,
+              thread_pool &pool = thread_pool::shared())
+    {
+        stats = {};
+
+        triangles.clear();
+
+        for (std::vector<uint32_t> &bin : bins)
+            bin.clear();
+
+        // ======= transform, clip and bin (occluders are few and coarse, so this stays serial) =======
+
+        const std::vector<uint32_t> &masks = culler.get_masks();
+
+        for (const occluder &entry : occluders)
+        {
+            if (entry.object_id >= objects.size() || entry.object_id >= masks.size() || !((masks[entry.object_id] >> view_id) & 1u))
+                continue;
+
+            glm::mat4 model_view_projection = view_projection * objects[entry.object_id].get_model_matrix();
+            const std::vector<glm::vec3> &vertices = entry.mesh.triangles;
+
+            for (size_t i = 0; i + 2 < vertices.size(); i += 3)
+                add_triangle(model_view_projection * glm::vec4(vertices[i], 1.0f),
+                             model_view_projection * glm::vec4(vertices[i + 1], 1.0f),
+                             model_view_projection * glm::vec4(vertices[i + 2], 1.0f),
+                             entry.mesh.two_sided);
+
+            ++stats.occluders;
+        }
+
+        stats.triangles = triangles.size();
+
+        pool.parallel_for(0, tiles_x * tiles_y, 1, [this](size_t first, size_t last)
+                          {
+                              for (size_t tile = first; tile < last; ++tile)
+                                  rasterize_tile(static_cast<int>(tile));
+                          });
+
+        build_pyramid();
+
+        // ======= test every object still in the view frustum =======
+
+        view_cull_spheres spheres = culler.get_spheres();
+        size_t blocks = (spheres.count + simd_float::width - 1) / simd_float::width;
+
+        std::atomic<size_t> tested{0};
+        std::atomic<size_t> occluded{0};
+
+        if (stats.triangles > 0)
+        {
+            pool.parallel_for(0, blocks, OCCLUSION_TEST_GRAIN / simd_float::width, [&](size_t first, size_t last)
+                              {
+                                  size_t local_tested = 0;
+                                  size_t local_occluded = test_blocks(culler, spheres, view_projection, view_id, first, last, local_tested);
+
+                                  tested.fetch_add(local_tested, std::memory_order_relaxed);
+                                  occluded.fetch_add(local_occluded, std::memory_order_relaxed);
+                              });
+        }
+
+        stats.tested = tested.load();
+        stats.occluded = occluded.load();
+    }
+
+    // ======= UTILITY API =======
+
+    /// @brief Greyscale image of a pyramid level for debugging; nearer occluders are brighter, empty texels black
+    /// @param out: width * height bytes, rows bottom to top (texture_handler::load_pixels layout)
+    /// @param width
+    /// @param height
+    /// @param level: 0 = full resolution (default: 0)
+    void debug_image(std::vector<unsigned char> &out, int &width, int &height, size_t level = 0) const
+    {
+        level = std::min(level, level_offset.size() - 1);
+
+        width = level_width[level];
+        height = level_height[level];
+
+        const float *texels = pyramid.data() + level_offset[level];
+        size_t count = static_cast<size_t>(width) * height;
+
+        // ======= depth is nonlinear and bunched up near 1, so stretch the occupied range over the whole byte =======
+
+        float nearest = 1.0f;
+
+        for (size_t i = 0; i < count; ++i)
+            nearest = std::min(nearest, texels[i]);
+
+        float scale = nearest < 1.0f ? 223.0f / (1.0f - nearest) : 0.0f;
+
+        out.resize(count);
+
+        for (size_t i = 0; i < count; ++i)
+            out[i] = texels[i] >= 1.0f ? 0 : static_cast<unsigned char>(32.0f + (1.0f - texels[i]) * scale);
+    }
+
+    /// @brief Farthest occluder depth at a pixel of a pyramid level (1 = nothing there)
+    /// @param x
+    /// @param y
+    /// @param level
+    /// @return float
+    float depth_at(int x, int y, size_t level = 0) const { return pyramid[level_offset[level] + static_cast<size_t>(y) * level_width[level] + x]; }
+
+    /// @brief Amount of registered occluders
+    /// @return size_t
+    size_t occluder_count() const { return occluders.size(); }
+
+    /// @brief Statistics of the last pass
+    /// @return const occlusion_stats&
+    const occlusion_stats &get_stats() const { return stats; }
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "../graphics/shaders/shader_class.hpp"
+#include "../graphics/textures/texture_handler.hpp"
+
+// ======= occlusion_debug_view =======
+
+/// @brief Draws an occlusion_culler::debug_image as a greyscale overlay (nearer occluders brighter)
+class occlusion_debug_view
+{
+private:
+    shader_class shader;
+    texture_handler texture;
+
+    unsigned int VAO = 0;
+    unsigned int VBO = 0;
+
+public:
+    // ======= CONSTRUCTOR =======
+
+    /// @brief Constructor for occlusion_debug_view (needs the GL context)
+    /// @param vertexPath: File path for the overlay vertex code (.glsl)
+    /// @param fragmentPath: File path for the overlay fragment code (.glsl)
+    occlusion_debug_view(const char *vertexPath, const char *fragmentPath)
+        : shader(vertexPath, fragmentPath)
+    {
+        // ======= two triangles covering the viewport the overlay is drawn into =======
+
+        const float corners[] = {
+            -1.0f, -1.0f, 1.0f, -1.0f, 1.0f, 1.0f,
+            -1.0f, -1.0f, 1.0f, 1.0f, -1.0f, 1.0f};
+
+        glGenVertexArrays(1, &VAO);
+        glGenBuffers(1, &VBO);
+
+        glBindVertexArray(VAO);
+
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void *)0);
+        glEnableVertexAttribArray(0);
+
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindVertexArray(0);
+    }
+
+    // ======= MAIN API =======
+
+    /// @brief Draw an image into a pixel rectangle of the framebuffer; leaves the viewport there and the overlay shader bound
+    /// @param pixels: One byte per texel, rows bottom to top
+    /// @param width
+    /// @param height
+    /// @param rect: x, y, width, height in pixels
+    void render(const std::vector<unsigned char> &pixels, int width, int height, const int rect[4])
+    {
+        if (pixels.empty())
+            return;
+
+        texture.load_pixels(pixels.data(), width, height, 1);
+
+        glViewport(rect[0], rect[1], rect[2], rect[3]);
+        glDisable(GL_DEPTH_TEST);
+
+        shader.use();
+        texture.bind(0);
+        shader.set_uniform1i("occlusion_buffer", 0);
+
+        glBindVertexArray(VAO);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+        glBindVertexArray(0);
+
+        glEnable(GL_DEPTH_TEST);
+    }
+
+    /// @brief Destroy the GL objects
+    void destroy()
+    {
+        glDeleteBuffers(1, &VBO);
+        glDeleteVertexArrays(1, &VAO);
+
+        shader.destroy();
+    }
+};
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+
+#include <glm/glm.hpp>
+
+// ======= MACROS =======
+
+#define RENDER_VIEW_MAX 32 // one bit per view in a visibility mask
+
+// ======= STRUCTS =======
+
+/// @brief One camera the world is drawn from this frame (main camera, split screen, picture-in-picture, shadow / reflection view)
+struct render_view
+{
+    glm::mat4 view{1.0f};
+    glm::mat4 projection{1.0f};
+
+    glm::vec4 viewport{0.0f, 0.0f, 1.0f, 1.0f}; // x, y, width, height as fractions of the framebuffer
+
+    bool enabled = true;
+    bool clear_depth = false; // clear depth inside the viewport before drawing (views drawn over another view)
+    bool particles = true;    // draw the particle system in this view
+
+    /// @brief Viewport in pixels
+    /// @param framebuffer_width
+    /// @param framebuffer_height
+    /// @param out: x, y, width, height
+    void pixel_rect(int framebuffer_width, int framebuffer_height, int out[4]) const
+    {
+        out[0] = static_cast<int>(viewport.x * framebuffer_width);
+        out[1] = static_cast<int>(viewport.y * framebuffer_height);
+        out[2] = static_cast<int>(viewport.z * framebuffer_width);
+        out[3] = static_cast<int>(viewport.w * framebuffer_height);
+    }
+};
+
+// ======= view_set =======
+
+/// @brief Fixed slots of render views; slot 0 is the engine's main camera and always exists
+class view_set
+{
+public:
+    static constexpr uint32_t main_view = 0;
+
+private:
+    render_view views[RENDER_VIEW_MAX];
+
+    uint32_t used = 1u << main_view;
+
+public:
+    // ======= MAIN API =======
+
+    /// @brief Register a view
+    /// @param view
+    /// @return uint32_t: View ID (its bit in visibility masks is 1 << ID)
+    uint32_t add(const render_view &view)
+    {
+        for (uint32_t id = 0; id < RENDER_VIEW_MAX; ++id)
+        {
+            if (used & (1u << id))
+                continue;
+
+            views[id] = view;
+            used |= 1u << id;
+
+            return id;
+        }
+
+        throw std::runtime_error("view_set: Out of view slots");
+    }
+
+    /// @brief Unregister a view (the main view can only be disabled)
+    /// @param id
+    void remove(uint32_t id)
+    {
+        if (id == main_view || id >= RENDER_VIEW_MAX)
+            return;
+
+        used &= ~(1u << id);
+    }
+
+    /// @brief Get a view
+    /// @param id
+    /// @return render_view&
+    render_view &get(uint32_t id)
+    {
+        if (id >= RENDER_VIEW_MAX || !(used & (1u << id)))
+            throw std::out_of_range("view_set: Unknown view");
+
+        return views[id];
+    }
+
+    const render_view &get(uint32_t id) const { return const_cast<view_set *>(this)->get(id); }
+
+    // ======= UTILITY API =======
+
+    /// @brief Bits of every registered and enabled view
+    /// @return uint32_t
+    uint32_t active_mask() const
+    {
+        uint32_t mask = 0;
+
+        for (uint32_t id = 0; id < RENDER_VIEW_MAX; ++id)
+            if ((used & (1u << id)) && views[id].enabled)
+                mask |= 1u << id;
+
+        return mask;
+    }
+
+    /// @brief Every slot, registered or not (index with the bits of active_mask())
+    /// @return const render_view*
+    const render_view *data() const { return views; }
+
+    /// @brief Unregister every view but the main one
+    void clear() { used = 1u << main_view; }
+};
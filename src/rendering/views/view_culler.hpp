@@ -0,0 +1,232 @@
+#pragma once
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "./render_view.hpp"
+#include "../objects/modifying/object_interface.hpp"
+#include "../../helpers/math/simd.hpp"
+#include "../../helpers/memory/aligned_allocator.hpp"
+#include "../../helpers/threading/thread_pool.hpp"
+
+// ======= MACROS =======
+
+#define VIEW_CULL_GRAIN 2048 // objects per culling task
+
+// ======= STRUCTS =======
+
+/// @brief What the last cull did
+struct view_cull_stats
+{
+    size_t objects = 0;
+    size_t views = 0;
+    size_t visible = 0; // objects inside at least one view frustum (before occlusion)
+};
+
+/// @brief Bounding spheres gathered by the last cull, padded with zeroes to a whole SIMD block
+struct view_cull_spheres
+{
+    const float *x;
+    const float *y;
+    const float *z;
+    const float *radius; // FLT_MAX for objects without known bounds
+
+    size_t count;
+};
+
+// ======= view_culler =======
+
+/// @brief Frustum-culls every object against every active view in one pass and produces one visibility bitmask per object
+/// @note Each object's bounding sphere is gathered once into SoA arrays and tested against all views while it's
+/// in registers, instead of walking the scene once per view; bit N of a mask means "visible in view N"
+class view_culler
+{
+private:
+    struct frustum
+    {
+        float planes[6][4]; // normalized (nx, ny, nz, d), inside when dot(n, p) + d >= 0
+    };
+
+    aligned_vector<float> center_x, center_y, center_z, radius;
+    std::vector<uint32_t> masks;
+
+    frustum frusta[RENDER_VIEW_MAX];
+    uint32_t view_ids[RENDER_VIEW_MAX];
+    uint32_t view_count = 0;
+
+    view_cull_stats stats;
+
+private:
+    /// @brief Gather spheres and test blocks [first_block, last_block); unknown bounds (radius < 0) are always visible
+    void cull_blocks(const std::vector<object_interface> &objects, size_t first_block, size_t last_block)
+    {
+        const size_t width = simd_float::width;
+        const size_t count = objects.size();
+
+        for (size_t block = first_block; block < last_block; ++block)
+        {
+            size_t begin = block * width;
+            size_t end = std::min(begin + width, count);
+
+            for (size_t i = begin; i < end; ++i)
+            {
+                glm::vec4 sphere = objects[i].get_bounding_sphere();
+
+                center_x[i] = sphere.x;
+                center_y[i] = sphere.y;
+                center_z[i] = sphere.z;
+                radius[i] = sphere.w < 0.0f ? FLT_MAX : sphere.w;
+            }
+
+            simd_float cx = simd_float::load(&center_x[begin]);
+            simd_float cy = simd_float::load(&center_y[begin]);
+            simd_float cz = simd_float::load(&center_z[begin]);
+            simd_float r = simd_float::load(&radius[begin]);
+
+            uint32_t lane_masks[simd_float::width] = {};
+
+            for (uint32_t v = 0; v < view_count; ++v)
+            {
+                simd_float outside = simd_float::zero();
+
+                for (const float *plane : frusta[v].planes)
+                {
+                    simd_float distance = simd_float::set1(plane[0]) * cx + simd_float::set1(plane[1]) * cy +
+                                          simd_float::set1(plane[2]) * cz + simd_float::set1(plane[3]);
+
+                    outside = simd_float::either(outside, simd_float::less(distance + r, simd_float::zero()));
+                }
+
+                uint32_t bit = 1u << view_ids[v];
+
+                for (int visible = ~simd_float::movemask(outside) & ((1 << width) - 1); visible; visible &= visible - 1)
+                    lane_masks[__builtin_ctz(visible)] |= bit;
+            }
+
+            for (size_t i = begin; i < end; ++i)
+                masks[i] = lane_masks[i - begin];
+        }
+    }
+
+public:
+    // ======= STATIC HELPERS =======
+
+    /// @brief Extract the six frustum planes of a view-projection matrix (Gribb / Hartmann)
+    /// @param view_projection
+    /// @param out: Normalized planes (left, right, bottom, top, near, far)
+    static void extract_planes(const glm::mat4 &view_projection, float out[6][4])
+    {
+        const glm::mat4 &m = view_projection;
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            for (int side = 0; side < 2; ++side)
+            {
+                float sign = side == 0 ? 1.0f : -1.0f;
+                float *plane = out[axis * 2 + side];
+
+                for (int c = 0; c < 4; ++c)
+                    plane[c] = m[c][3] + sign * m[c][axis];
+
+                float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+
+                if (length > 0.0f)
+                    for (int c = 0; c < 4; ++c)
+                        plane[c] /= length;
+            }
+        }
+    }
+
+    // ======= MAIN API =======
+
+    /// @brief Cull every object against every view in view_mask
+    /// @param objects
+    /// @param views: view_set::data()
+    /// @param view_mask: Views to cull for (view_set::active_mask())
+    /// @param pool: Culling tasks are split across it (default: thread_pool::shared())
+    void cull(const std::vector<object_interface> &objects, const render_view *views, uint32_t view_mask, thread_pool &pool = thread_pool::shared())
+    {
+        view_count = 0;
+
+        for (uint32_t id = 0; id < RENDER_VIEW_MAX; ++id)
+        {
+            if (!(view_mask & (1u << id)))
+                continue;
+
+            extract_planes(views[id].projection * views[id].view, frusta[view_count].planes);
+            view_ids[view_count++] = id;
+        }
+
+        size_t count = objects.size();
+        size_t blocks = (count + simd_float::width - 1) / simd_float::width;
+        size_t padded = blocks * simd_float::width;
+
+        masks.resize(count);
+
+        if (center_x.size() < padded)
+        {
+            center_x.resize(padded, 0.0f);
+            center_y.resize(padded, 0.0f);
+            center_z.resize(padded, 0.0f);
+            radius.resize(padded, 0.0f);
+        }
+
+        // ======= the arrays only grow, so the padding lanes may still hold spheres of a larger earlier cull =======
+
+        std::fill(center_x.begin() + count, center_x.begin() + padded, 0.0f);
+        std::fill(center_y.begin() + count, center_y.begin() + padded, 0.0f);
+        std::fill(center_z.begin() + count, center_z.begin() + padded, 0.0f);
+        std::fill(radius.begin() + count, radius.begin() + padded, 0.0f);
+
+        pool.parallel_for(0, blocks, VIEW_CULL_GRAIN / simd_float::width, [this, &objects](size_t first, size_t last)
+                          { cull_blocks(objects, first, last); });
+
+        stats.objects = count;
+        stats.views = view_count;
+        stats.visible = 0;
+
+        for (uint32_t mask : masks)
+            stats.visible += mask != 0;
+    }
+
+    // ======= UTILITY API =======
+
+    /// @brief Visibility bitmask per object from the last cull
+    /// @return const std::vector<uint32_t>&
+    const std::vector<uint32_t> &get_masks() const { return masks; }
+
+    /// @brief Bounding spheres of the last cull, for later passes (occlusion) that test the same objects
+    /// @return view_cull_spheres
+    view_cull_spheres get_spheres() const { return {center_x.data(), center_y.data(), center_z.data(), radius.data(), masks.size()}; }
+
+    /// @brief Drop an object from one view after the cull (e.g. it's occluded); safe to call for different objects in parallel
+    /// @param index
+    /// @param id: View ID
+    void hide(size_t index, uint32_t id) { masks[index] &= ~(1u << id); }
+
+    /// @brief Drop an object from every view after the cull (e.g. a static batch draws it)
+    /// @param index
+    void hide(size_t index) { masks[index] = 0; }
+
+    /// @brief Objects visible in one view in the last cull
+    /// @param id
+    /// @return size_t
+    size_t count_visible(uint32_t id) const
+    {
+        size_t visible = 0;
+
+        for (uint32_t mask : masks)
+            visible += (mask >> id) & 1u;
+
+        return visible;
+    }
+
+    /// @brief Statistics of the last cull
+    /// @return const view_cull_stats&
+    const view_cull_stats &get_stats() const { return stats; }
+};
@@ -1,6 +1,8 @@
-#include "../src/engine/game_engine.hpp"
+#if ENGINE_ALLOCATION_GUARD
+#define ALLOCATION_TRACKER_IMPLEMENTATION // count heap allocations so steady-state frames can be checked
+#endif
 
-#include "../src/helpers/logic/logic_presets.hpp"
+#include "../src/engine/game_engine.hpp"
 
 int main()
 {
@@ -8,13 +10,9 @@ int main()
 
     size_t obj_id = engine.create_new_object(object_lib::sphere(), {2, 2, 2}, {0, 0, 0}, {0, 0, 0});
 
-    engine.run(
-        [&engine, obj_id](float delta_time)
-        {
-            object_interface &obj_1 = engine.get_object(obj_id);
+    engine.presets.add_gravity(obj_id, 1.0f);
 
-            obj_1.apply_preset(logic_presets::gravity(1.0f, delta_time));
-        });
+    engine.run();
 
     return 0;
 }
\ No newline at end of file